@@ -23,15 +23,13 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
-#include <pico/stdlib.h>
-#include <hardware/i2c.h>
-#include <pico/binary_info.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 #include "ssd1306.h"
 #include "font.h"
+#include "log.h"
 
 inline static void swap(int32_t *a, int32_t *b) {
     int32_t *t=a;
@@ -39,13 +37,13 @@ inline static void swap(int32_t *a, int32_t *b) {
     *b=*t;
 }
 
-inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, char *name) {
-    switch(i2c_write_blocking(i2c, addr, src, len, false)) {
-    case PICO_ERROR_GENERIC:
-        printf("[%s] addr not acknowledged!\n", name);
+inline static void fancy_write(uint8_t i2c, uint8_t addr, const uint8_t *src, size_t len, char *name) {
+    switch(hal_i2c_write(i2c, addr, src, len)) {
+    case HAL_I2C_ERROR_NACK:
+        LOG_ERROR("[%s] addr not acknowledged!\n", name);
         break;
-    case PICO_ERROR_TIMEOUT:
-        printf("[%s] timeout!\n", name);
+    case HAL_I2C_ERROR_TIMEOUT:
+        LOG_ERROR("[%s] timeout!\n", name);
         break;
     default:
         //printf("[%s] wrote successfully %lu bytes!\n", name, len);
@@ -58,7 +56,7 @@ inline static void ssd1306_write(ssd1306_t *p, uint8_t val) {
     fancy_write(p->i2c_i, p->address, d, 2, "ssd1306_write");
 }
 
-bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance) {
+bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, uint8_t i2c_instance) {
     p->width=width;
     p->height=height;
     p->pages=height/8;
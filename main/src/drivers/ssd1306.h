@@ -30,8 +30,7 @@ SOFTWARE.
 
 #ifndef _inc_ssd1306
 #define _inc_ssd1306
-#include <pico/stdlib.h>
-#include <hardware/i2c.h>
+#include "hal.h"
 
 /**
 *	@brief defines commands used in ssd1306
@@ -64,7 +63,7 @@ typedef struct {
     uint8_t height; 	/**< height of display */
     uint8_t pages;		/**< stores pages of display (calculated on initialization*/
     uint8_t address; 	/**< i2c address of display*/
-    i2c_inst_t *i2c_i; 	/**< i2c connection instance */
+    uint8_t i2c_i; 	/**< i2c bus (HAL_I2C0 or HAL_I2C1) */
     bool external_vcc; 	/**< whether display uses external vcc */ 
     uint8_t *buffer;	/**< display buffer */
     size_t bufsize;		/**< buffer size */
@@ -77,13 +76,13 @@ typedef struct {
 *	@param[in] width : width of display
 *	@param[in] height : heigth of display
 *	@param[in] address : i2c address of display
-*	@param[in] i2c_instance : instance of i2c connection
+*	@param[in] i2c_instance : i2c bus (HAL_I2C0 or HAL_I2C1)
 *	
 * 	@return bool.
 *	@retval true for Success
 *	@retval false if initialization failed
 */
-bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance);
+bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, uint8_t i2c_instance);
 
 /**
 *	@brief deinitialize display
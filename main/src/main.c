@@ -1,7 +1,7 @@
 // bibliotecas padrões do C e do SDK do raspberry pi pico w
 #include <stdio.h>
-#include "pico/stdlib.h"
-#include "hardware/timer.h"
+#include <stdlib.h>
+#include "hal.h"
 #include "string.h"
 
 // bibliotecas utilitárias para os sensores e outros componentes
@@ -9,18 +9,35 @@
 #include "mq135.h"
 #include "display.h"
 #include "wifi.h"
-#include "button.h"
+#include "input.h"
 #include "server.h"
-
-// máquina de estados para a aplicação
-typedef enum {
-    IDLE_STATE,
-    SENSOR_READING_STATE,
-    DISPLAY_DATA_STATE
-} StateMachine;
-
-// instância da máquina de estado para a aplicação
-StateMachine global_state;
+#include "http_client.h"
+#include "mqtt_transport.h"
+#include "server_udp.h"
+#include "history.h"
+#include "report.h"
+#include "sample.h"
+#include "store.h"
+#include "queue.h"
+#include "tsblock.h"
+#include "format.h"
+#include "api.h"
+#include "radio.h"
+#include "prof.h"
+#include "memstat.h"
+#include "log.h"
+#include "sched.h"
+
+// período das tarefas de rede (idade do lote, janelas do rádio) e do terminal (memória, log, comandos)
+#define NETWORK_PERIOD_MS 1000
+#define CONSOLE_PERIOD_MS 1000
+
+// tarefas da aplicação, na ordem em que recebem cada evento
+Task input_task;
+Task ui_task;
+Task sensor_task;
+Task network_task;
+Task console_task;
 
 // estrutura para armazenar os dados dos sensores
 typedef struct {
@@ -37,87 +54,78 @@ typedef struct {
 SensorData *global_sensor_data = NULL;
 
 // variáveis de controle
-bool button_is_active = false;          // para controlar quando o botão estará ativo ou não
 #define NUM_MAX_INFO 3                  // quantidade máxima de informações (temperatura, umidade e concentração de gás)
-int current_info = 0;                   // armazena em que informação está sendo exibida atualmente
-
-// estrutura de timer para tratar o efeito bounce do botão
-struct repeating_timer button_debouncing_timer;
-
-// função para iniciar a conexão wifi e exibir os feedbacks de conexão no display
-int init_wifi_connection() {
+int current_info = NUM_MAX_INFO;        // informação exibida atualmente (NUM_MAX_INFO = tela inicial ou resumo)
+bool network_ready = false;             // chip Wi-Fi iniciado (sem ele, leitura e display seguem sem os serviços de rede)
+uint32_t button_posted_us = 0;          // instante do gesto que a tela atual atende
+uint32_t screen_latency_us = 0;         // do toque no botão até a tela desenhada (último e maior)
+uint32_t screen_latency_max_us = 0;
 
-    // exibindo o nome da rede wifi
-    display_clear();
-    display_write("Conectando em:", 23, 20, 1);
-    display_write(WIFI_SSID, 23, 32, 1);
-    display_show();
+// última amostra válida, entregue à API local quando ela é iniciada (depois da primeira leitura no boot)
+SensorSample latest_sample;
+bool latest_valid = false;
 
-    // tentando se conectar com a rede e obtendo o status de conexão
-    int state_connection = wifi_connect();
-
-    // exibindo o estado de conexão no display
-    display_clear();
-    if (state_connection == 0) {
-        display_write("CONEXAO ESTABECIDA", 10, 30, 1);
-        printf("IP do dispositivo: %s\n", ipaddr_ntoa(&netif_default->ip_addr));
-    } else {
-        display_write("FALHA NA CONEXAO", 10, 30, 1);
-    }
-    display_show();
-    sleep_ms(3000);
-
-    return state_connection;
+// instantes das fases do boot (ms desde o boot), exibidos no fim da inicialização
+typedef struct {
+    uint32_t peripherals_ms;    // sensores, display, botão, flash e fila prontos
+    uint32_t first_sample_ms;   // primeira leitura dos sensores registrada
+    uint32_t first_screen_ms;   // primeira tela com os dados desenhada
+    uint32_t network_ms;        // chip Wi-Fi iniciado e serviços de rede configurados (a conexão segue em segundo plano)
+} BootTimes;
+BootTimes boot_times;
+
+// função para exibir os instantes das fases do boot
+void print_boot_times() {
+    printf("Boot: perifericos em %lu ms, primeira amostra em %lu ms, primeira tela em %lu ms, rede iniciada em %lu ms\n",
+        (unsigned long) boot_times.peripherals_ms, (unsigned long) boot_times.first_sample_ms, (unsigned long) boot_times.first_screen_ms, (unsigned long) boot_times.network_ms);
 }
 
-// função para exibir os dados dos sensores no display
-void show_data_on_display(SensorData data) {
-    while (global_state == DISPLAY_DATA_STATE && current_info < NUM_MAX_INFO) {
-        
-        // caso esteja na primeira informação (temeratura)
-        if (current_info == 0) {
-            display_clear();
-            char temperature_value[25];
-            char temperature_status[50];
-            snprintf(temperature_value, sizeof(temperature_value), "Temperatura: %d C", data.temperature);
-            snprintf(temperature_status, sizeof(temperature_status), "Status: %s", data.temperatureCategory);
-            display_write(temperature_value, 0, 10, 1);
-            display_write(temperature_status, 0, 30, 1);
-            display_write("B para avancar", 0, 50, 1);
-            display_show();
-        }
-        
-        // caso esteja na segunda informação (umidade)
-        if (current_info == 1) {
-            display_clear();
-            char humidity_value[25];
-            char humidity_status[50];
-            snprintf(humidity_value, sizeof(humidity_value), "Umidade: %d %%", data.humidity);
-            snprintf(humidity_status, sizeof(humidity_status), "Status: %s", data.humidityCategory);
-            display_write(humidity_value, 0, 10, 1);
-            display_write(humidity_status, 0, 30, 1);
-            display_write("B para avancar", 0, 50, 1);
-            display_show();
-        }
-        
-        // caso esteja na terceita informação (concentração de gás)
-        if (current_info == 2) {
-            display_clear();
-            char polluaton_lv_value[30];
-            char polluaton_lv_status[50];
-            snprintf(polluaton_lv_value, sizeof(polluaton_lv_value), "poluicao ar: %.1f %%", data.pollutionLevel);
-            snprintf(polluaton_lv_status, sizeof(polluaton_lv_status), "Status: %s", data.airQualityCategory);
-            display_write(polluaton_lv_value, 0, 10, 1);
-            display_write(polluaton_lv_status, 0, 30, 1);
-            display_write("B para avancar", 0, 50, 1);
-            display_show();
-        }
+// função para exibir no display uma das informações lidas (0 = temperatura, 1 = umidade, 2 = poluição)
+void show_info_screen(const SensorData *data, int info) {
+    // caso esteja na primeira informação (temeratura)
+    if (info == 0) {
+        display_clear();
+        char temperature_value[25];
+        char temperature_status[50];
+        char number[12];
+        format_int(number, sizeof(number), data->temperature, 0);
+        format_line(temperature_value, sizeof(temperature_value), "Temperatura: ", number, " C");
+        snprintf(temperature_status, sizeof(temperature_status), "Status: %s", data->temperatureCategory);
+        display_write(temperature_value, 0, 10, 1);
+        display_write(temperature_status, 0, 30, 1);
+        display_write("B para avancar", 0, 50, 1);
+        display_show();
+    }
+    
+    // caso esteja na segunda informação (umidade)
+    if (info == 1) {
+        display_clear();
+        char humidity_value[25];
+        char humidity_status[50];
+        char number[12];
+        format_int(number, sizeof(number), data->humidity, 0);
+        format_line(humidity_value, sizeof(humidity_value), "Umidade: ", number, " %");
+        snprintf(humidity_status, sizeof(humidity_status), "Status: %s", data->humidityCategory);
+        display_write(humidity_value, 0, 10, 1);
+        display_write(humidity_status, 0, 30, 1);
+        display_write("B para avancar", 0, 50, 1);
+        display_show();
+    }
+    
+    // caso esteja na terceita informação (concentração de gás)
+    if (info == 2) {
+        display_clear();
+        char polluaton_lv_value[30];
+        char polluaton_lv_status[50];
+        char number[16];
+        format_float(number, sizeof(number), data->pollutionLevel, 1, 0);
+        format_line(polluaton_lv_value, sizeof(polluaton_lv_value), "poluicao ar: ", number, " %");
+        snprintf(polluaton_lv_status, sizeof(polluaton_lv_status), "Status: %s", data->airQualityCategory);
+        display_write(polluaton_lv_value, 0, 10, 1);
+        display_write(polluaton_lv_status, 0, 30, 1);
+        display_write("B para avancar", 0, 50, 1);
+        display_show();
     }
-
-    // zerando o valor de current info
-    current_info = 0;
-    // exibindo no display a tela inicial
-    display_initial_screen();
 }
 
 // função para obter e armazenar as mensagens de alerta com base nos dados dos sensores
@@ -147,46 +155,96 @@ void get_and_store_alerts_message(SensorData *data) {
     );
 }
 
-// callback para reativar o botão
-bool reenable_button_callback() {
-    button_is_active = true;
-    return false;
-}
-
-// função para tratar o efeito bounce
-void debouncing() {
-    button_is_active = false;
-    cancel_repeating_timer(&button_debouncing_timer);
-    add_repeating_timer_ms(300, reenable_button_callback, NULL, &button_debouncing_timer);
-}
-
-// callback para tratar as interrupções dos pinos GPIO
-void gpio_irq_callback(uint gpio, uint32_t event) {
+// função para ler os sensores e registrar a amostra (históricos, API local e fila de envio); retorna se o DHT11 respondeu
+bool read_and_record_sensors() {
+    // lendo os dados de temperatura e umidade
+    // envia pulso inicial para o dht11
+    dht11_send_pulse_start();
 
-    // caso o botão não esteja ativo
-    if (!button_is_active) return;
+    // obtenho e armazeno os dados de temperatura e umidade
+    bool reading_status = dht11_get(&global_sensor_data->temperature, &global_sensor_data->humidity);
+    if (!reading_status) {
+        LOG_WARN("Falha ao ler os dados no DHT11\n");
+    }
+    
+    // obtendo e armazenando os dados de concentração de gases no sensor de gás MQ135
+    int raw_value = mq135_read_raw();       // valor bruto ADC
+    global_sensor_data->pollutionLevel = mq135_read_percentage(raw_value);  // valor convertido para porcentagem
+
+    // acumulando a leitura no histórico agregado (minuto/hora/dia)
+    if (reading_status) {
+        float values[HISTORY_NUM_CHANNELS] = {
+            [HISTORY_TEMPERATURE] = global_sensor_data->temperature,
+            [HISTORY_HUMIDITY] = global_sensor_data->humidity,
+            [HISTORY_POLLUTION] = global_sensor_data->pollutionLevel,
+        };
+        SensorSample raw_sample;
+        sample_make(&raw_sample, hal_time_ms() / 1000,
+            global_sensor_data->temperature, global_sensor_data->humidity, global_sensor_data->pollutionLevel);
+
+        // os históricos também são lidos pela API local no contexto do lwIP: gravação com o lwIP travado
+        if (network_ready) hal_lwip_begin();
+        history_add_sample(hal_time_ms() / 1000, values);
+
+        // guardando a amostra bruta no histórico comprimido em blocos
+        tsblock_ring_append(&raw_sample);
+        if (network_ready) hal_lwip_end();
+
+        // atualizando a resposta pré-serializada de /latest da API local
+        latest_sample = raw_sample;
+        latest_valid = true;
+        if (network_ready) api_update_latest(&raw_sample);
+    }
 
-    // tratando efeito bounce
-    debouncing();
+    // armazenando as mensagens de alerta com base nos dados
+    get_and_store_alerts_message(global_sensor_data);
 
-    // caso pressione o botão B esteja no estado inicial da alicaçaõ
-    if(global_state == IDLE_STATE) {
-        // muda o estado da aplicação para o modo leitura dos sensores
-        global_state = SENSOR_READING_STATE;
+    // decidindo quais canais mudaram o suficiente para serem reportados (banda morta, categoria ou heartbeat);
+    // sem resposta do DHT11 temperatura e umidade ficam de fora, só a poluição pode seguir
+    uint8_t valid_channels = REPORT_CHANNEL_BIT(HISTORY_POLLUTION);
+    if (reading_status) {
+        valid_channels |= REPORT_CHANNEL_BIT(HISTORY_TEMPERATURE) | REPORT_CHANNEL_BIT(HISTORY_HUMIDITY);
     }
+    float report_values[HISTORY_NUM_CHANNELS] = {
+        [HISTORY_TEMPERATURE] = global_sensor_data->temperature,
+        [HISTORY_HUMIDITY] = global_sensor_data->humidity,
+        [HISTORY_POLLUTION] = global_sensor_data->pollutionLevel,
+    };
+    const char *report_categories[HISTORY_NUM_CHANNELS] = {
+        [HISTORY_TEMPERATURE] = dht11_get_temperature_category(global_sensor_data->temperature),
+        [HISTORY_HUMIDITY] = dht11_get_humidity_category(global_sensor_data->humidity),
+        [HISTORY_POLLUTION] = mq135_get_category(global_sensor_data->pollutionLevel),
+    };
+    uint8_t report_channels = report_evaluate(
+        hal_time_ms() / 1000,
+        valid_channels,
+        report_values,
+        report_categories
+    );
 
-    // caso esteja no estado de exibição dos dados no display
-    if (global_state == DISPLAY_DATA_STATE && current_info < NUM_MAX_INFO) {
-        current_info++;
+    // enfileira a amostra com os canais selecionados (a fila também a persiste na flash)
+    if (report_channels != 0) {
+        SensorSample sample;
+        sample_make(&sample, hal_time_ms() / 1000,
+            global_sensor_data->temperature, global_sensor_data->humidity, global_sensor_data->pollutionLevel);
+        if (!queue_push(&sample, report_channels)) {
+            LOG_WARN("Falha ao enfileirar amostra\n");
+        }
     }
-    
+
+    return reading_status;
+}
+
+// callback do terminal serial: caracteres recebidos acordam a tarefa do terminal
+void serial_chars_available(void *param) {
+    sched_signal(EVENT_SERIAL);
 }
 
 // Função responsável por inicializar os componentes
 void setup() {
     
     // inicializando a comunicação serial
-    stdio_init_all();
+    hal_stdio_init(serial_chars_available, NULL);
 
     // inicializando o sensor DHT22
     dht11_init();
@@ -197,81 +255,336 @@ void setup() {
     // inicializa o display
     display_init();
     
-    // iniciando o botão B e configurando interrupção
-    button_init();
-    button_is_active = true;
-    gpio_set_irq_enabled_with_callback(BTN_B, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_callback); 
+    // iniciando os botões e o joystick: B e direita avançam (B segurado volta à tela inicial), A e esquerda
+    // voltam, o botão do joystick pede uma leitura nova e, com dois toques, exibe o resumo
+    input_init();
+    input_set_gestures(INPUT_BUTTON_B, INPUT_GESTURE_BIT(INPUT_DOWN) | INPUT_GESTURE_BIT(INPUT_LONG));
+    input_set_gestures(INPUT_BUTTON_A, INPUT_GESTURE_BIT(INPUT_DOWN));
+    input_set_gestures(INPUT_JOYSTICK_BUTTON, INPUT_GESTURE_BIT(INPUT_CLICK) | INPUT_GESTURE_BIT(INPUT_DOUBLE));
+    input_set_gestures(INPUT_JOYSTICK_LEFT, INPUT_GESTURE_BIT(INPUT_DOWN));
+    input_set_gestures(INPUT_JOYSTICK_RIGHT, INPUT_GESTURE_BIT(INPUT_DOWN));
+    input_set_gestures(INPUT_JOYSTICK_UP, 0);
+    input_set_gestures(INPUT_JOYSTICK_DOWN, 0);
 
     // alocando memória para a estrutura que armazena os dados dos sensores
     global_sensor_data = (SensorData*) malloc(sizeof(SensorData));
+    memset(global_sensor_data, 0, sizeof(SensorData));
+
+    // inicializando o histórico agregado dos sensores
+    history_init();
+
+    // inicializando o histórico comprimido das amostras brutas
+    tsblock_ring_init();
+
+    // inicializando a política de envio por banda morta
+    report_init();
+
+    // montando o log de amostras na flash (registros sobrevivem a quedas de energia e de rede)
+    if (store_mount()) {
+        StoreStats store_stats;
+        store_get_stats(&store_stats);
+        printf("Flash: montagem em %lu us, %lu amostras pendentes, apagamentos %lu-%lu\n",
+            (unsigned long) store_stats.mount_us, (unsigned long) store_pending(), (unsigned long) store_stats.min_erase_count, (unsigned long) store_stats.max_erase_count);
+    } else {
+        printf("Falha ao montar o armazenamento na flash\n");
+    }
+
+    // inicializando a fila de envio (retoma o backlog que ficou na flash)
+    queue_init();
 }
 
-int main()
-{
+// função para exibir no terminal os dados lidos e as estatísticas da estação; chamada no fim do ciclo do
+// laço principal, fora do caminho entre a leitura e o display (o printf pode bloquear no USB)
+void print_station_report() {
+    printf("\n==== DADOS DOS SENSORES ====\n");
 
-    // inicializando os dispositivos
-    setup();
+    // o USB costuma ainda não estar enumerado no fim do boot: os instantes são repetidos na primeira leitura
+    static bool boot_times_reported = false;
+    if (!boot_times_reported) {
+        print_boot_times();
+        boot_times_reported = true;
+    }
+    printf("Temperatura: %d °C\n", global_sensor_data->temperature);
+    printf("Categoria de Temperatura: %s\n", global_sensor_data->temperatureCategory);
+
+    printf("Umidade: %d %%\n", global_sensor_data->humidity);
+    printf("Categoria de Umidade: %s\n", global_sensor_data->humidityCategory);
+
+    char pollution_text[16];
+    format_float(pollution_text, sizeof(pollution_text), global_sensor_data->pollutionLevel, 2, 0);
+    printf("Qualidade do Ar (Poluição): %s %%\n", pollution_text);
+    printf("Categoria de Qualidade do Ar: %s\n", global_sensor_data->airQualityCategory);
+
+    ReportCounters report_counters;
+    report_get_counters(&report_counters);
+    QueueStats queue_stats;
+    queue_get_stats(&queue_stats);
+    printf("Envios (T/U/P): %lu/%lu/%lu | Suprimidos: %lu/%lu/%lu\n",
+        (unsigned long) report_counters.sent[HISTORY_TEMPERATURE], (unsigned long) report_counters.sent[HISTORY_HUMIDITY], (unsigned long) report_counters.sent[HISTORY_POLLUTION],
+        (unsigned long) report_counters.suppressed[HISTORY_TEMPERATURE], (unsigned long) report_counters.suppressed[HISTORY_HUMIDITY], (unsigned long) report_counters.suppressed[HISTORY_POLLUTION]);
+    printf("Fila: %lu pendentes, %lu confirmadas, %lu lotes, %lu reenvios (RAM %lu bytes)\n",
+        (unsigned long) queue_pending(), (unsigned long) queue_stats.acked, (unsigned long) queue_stats.batches, (unsigned long) queue_stats.retries, (unsigned long) queue_stats.ram_bytes);
+#if SERVER_USE_MQTT
+    // mensagens por segundo desde o relatório anterior e latência até a confirmação do broker
+    static uint32_t last_completed = 0;
+    static uint32_t last_report_ms = 0;
+    MqttTransportStats mqtt_stats;
+    mqtt_transport_get_stats(&mqtt_stats);
+    uint32_t report_ms = hal_time_ms();
+    uint32_t messages_per_s = report_ms > last_report_ms
+        ? (mqtt_stats.completed - last_completed) * 1000 / (report_ms - last_report_ms) : 0;
+    last_completed = mqtt_stats.completed;
+    last_report_ms = report_ms;
+    printf("MQTT: %lu publicadas, %lu confirmadas, %lu erros, %lu conexoes, %lu msg/s, latencia %lu/%lu/%lu ms, %lu bytes/amostra\n",
+        (unsigned long) mqtt_stats.published, (unsigned long) mqtt_stats.completed, (unsigned long) mqtt_stats.errors, (unsigned long) mqtt_stats.connects, (unsigned long) messages_per_s,
+        (unsigned long) mqtt_stats.latency_min_ms, (unsigned long) (mqtt_stats.completed ? mqtt_stats.latency_sum_ms / mqtt_stats.completed : 0),
+        (unsigned long) mqtt_stats.latency_max_ms, (unsigned long) server_bytes_per_sample());
+#elif SERVER_USE_UDP
+    ServerUdpStats udp_stats;
+    server_udp_get_stats(&udp_stats);
+    printf("UDP: %lu datagramas, %lu erros, %lu ACKs, %lu NACKs, %lu timeouts, %lu bytes/amostra\n",
+        (unsigned long) udp_stats.datagrams, (unsigned long) udp_stats.send_errors, (unsigned long) udp_stats.acks, (unsigned long) udp_stats.nacks, (unsigned long) udp_stats.timeouts,
+        (unsigned long) server_bytes_per_sample());
+#else
+    HttpClientStats http_stats;
+    http_client_get_stats(&http_stats);
+    printf("HTTP: %lu requisicoes, %lu respostas, %lu erros, %lu conexoes, %lu bytes/amostra\n",
+        (unsigned long) http_stats.requests, (unsigned long) http_stats.responses, (unsigned long) http_stats.errors, (unsigned long) http_stats.connects, (unsigned long) server_bytes_per_sample());
+#if HTTP_CLIENT_TLS
+    printf("TLS: %lu handshakes completos (ultimo %lu ms), %lu retomados (ultimo %lu ms), heap %lu bytes, pico %lu bytes\n",
+        (unsigned long) http_stats.tls_full_handshakes, (unsigned long) http_stats.tls_full_ms, (unsigned long) http_stats.tls_resumed_handshakes,
+        (unsigned long) http_stats.tls_resumed_ms, (unsigned long) http_stats.tls_heap_bytes, (unsigned long) http_stats.tls_heap_peak);
+#endif
+#endif
+    WifiStats wifi_stats;
+    wifi_get_stats(&wifi_stats);
+    printf("Wi-Fi: %s, %lu associacoes completas, %lu rapidas (%lu falharam), %lu quedas, ultima em %lu ms\n",
+        wifi_is_connected() ? "conectado" : connection_state_name(wifi_connection_state()),
+        (unsigned long) wifi_stats.full_joins, (unsigned long) wifi_stats.fast_joins, (unsigned long) wifi_stats.fast_join_failures, (unsigned long) wifi_stats.link_losses,
+        (unsigned long) wifi_stats.last_join_ms);
+    uint32_t uptime_ms = hal_time_ms();
+    RadioStats radio_stats;
+    radio_get_stats(&radio_stats);
+    printf("Radio: ativo %lu ms nesta hora, %lu ms na ultima hora, media %lu ms/h (%lu%%), %lu janelas (%lu incompletas)\n",
+        (unsigned long) wifi_stats.radio_on_hour_ms, (unsigned long) wifi_stats.radio_on_last_hour_ms,
+        (unsigned long) (uptime_ms ? wifi_stats.radio_on_ms * 3600000u / uptime_ms : 0),
+        (unsigned long) (uptime_ms ? wifi_stats.radio_on_ms * 100u / uptime_ms : 0),
+        (unsigned long) radio_stats.windows, (unsigned long) radio_stats.expired);
+    UpstreamStats upstream_stats;
+    upstream_get_stats(server_upstream(), &upstream_stats);
+    printf("Conexao: %s com %s, proxima tentativa em %lu ms\n", connection_state_name(server_connection_state()),
+        upstream_host(server_upstream()), (unsigned long) server_connection_retry_in_ms());
+    printf("DNS: %lu consultas, %lu enderecos do cache, %lu falhas, %lu trocas de servidor\n",
+        (unsigned long) upstream_stats.lookups, (unsigned long) upstream_stats.cache_hits, (unsigned long) upstream_stats.dns_failures, (unsigned long) upstream_stats.failovers);
+    ApiStats api_stats;
+    api_get_stats(&api_stats);
+    printf("API local: %lu requisicoes, %lu erros, %lu recusadas, %lu bytes\n",
+        (unsigned long) api_stats.requests, (unsigned long) api_stats.errors, (unsigned long) api_stats.rejected, (unsigned long) api_stats.bytes_sent);
+    MemstatSnapshot memory;
+    if (network_ready) hal_lwip_begin();
+    memstat_get(&memory);
+    if (network_ready) hal_lwip_end();
+    SchedStats sched_stats;
+    sched_get_stats(&sched_stats);
+    uint64_t sched_elapsed_us = hal_time_us_64() - sched_stats.started_us;
+    printf("Agendador: %lu eventos (%lu descartados), latencia %lu us (max %lu us), carga da CPU %lu%%, botao-tela %lu us (max %lu us)\n",
+        (unsigned long) sched_stats.dispatched, (unsigned long) sched_stats.dropped, (unsigned long) sched_stats.last_latency_us, (unsigned long) sched_stats.max_latency_us,
+        (unsigned long) (sched_elapsed_us ? 100 - sched_stats.idle_us * 100 / sched_elapsed_us : 0),
+        (unsigned long) screen_latency_us, (unsigned long) screen_latency_max_us);
+    InputStats input_stats;
+    input_get_stats(&input_stats);
+    printf("Entrada: %lu bordas (%lu de bounce, %lu perdidas), %lu gestos, interrupcao max %lu us, atraso max %lu us\n",
+        (unsigned long) input_stats.edges, (unsigned long) input_stats.bounces, (unsigned long) input_stats.overflows, (unsigned long) input_stats.gestures,
+        (unsigned long) input_stats.irq_max_us, (unsigned long) input_stats.max_delay_us);
+    LogStats log_stats;
+    log_get_stats(&log_stats);
+    printf("Log: %lu mensagens, %lu descartadas, pico de %u de %u vagas\n",
+        (unsigned long) log_stats.written, (unsigned long) log_stats.dropped, log_stats.peak, LOG_RING_SIZE);
+    printf("Memoria: heap %lu bytes (pico %lu, arena %lu de %lu), pilhas %lu/%lu e %lu/%lu bytes, lwIP %lu/%lu bytes (pico %lu), %lu falhas\n",
+        (unsigned long) memory.heap_used, (unsigned long) memory.heap_peak, (unsigned long) memory.heap_arena, (unsigned long) memory.heap_size,
+        (unsigned long) memory.stack_used[0], (unsigned long) memory.stack_size[0], (unsigned long) memory.stack_used[1], (unsigned long) memory.stack_size[1],
+        (unsigned long) memory.lwip_heap.used, (unsigned long) memory.lwip_heap.avail, (unsigned long) memory.lwip_heap.max,
+        (unsigned long) (memory.lwip_heap.err + memory.pool_errors));
+    printf("============================\n");
+}
 
-    // tentando se conectar a rede wifi e caso a conexão coma rede falhar ele finalza a aplicação
-    if (init_wifi_connection() == 1) return 1;
+// registra no relatório o tempo do toque no botão até a tela desenhada
+void record_screen_latency() {
+    screen_latency_us = hal_time_us() - button_posted_us;
+    if (screen_latency_us > screen_latency_max_us) screen_latency_max_us = screen_latency_us;
+}
 
-    // carrega tela inicial
-    display_initial_screen();
+// ações da interface
+typedef enum {
+    UI_NONE,
+    UI_NEXT,                    // próxima tela (na tela inicial, nova leitura)
+    UI_PREVIOUS,                // tela anterior
+    UI_HOME,                    // tela inicial
+    UI_READ,                    // nova leitura e primeira tela
+    UI_SUMMARY                  // resumo da última leitura
+} UiAction;
+
+// função para traduzir um gesto de entrada na ação da interface
+UiAction ui_action(uint32_t arg) {
+    InputId input = INPUT_EVENT_INPUT(arg);
+    InputGesture gesture = INPUT_EVENT_GESTURE(arg);
+
+    if (gesture == INPUT_DOWN && (input == INPUT_BUTTON_B || input == INPUT_JOYSTICK_RIGHT)) return UI_NEXT;
+    if (gesture == INPUT_DOWN && (input == INPUT_BUTTON_A || input == INPUT_JOYSTICK_LEFT)) return UI_PREVIOUS;
+    if (gesture == INPUT_LONG && input == INPUT_BUTTON_B) return UI_HOME;
+    if (gesture == INPUT_CLICK && input == INPUT_JOYSTICK_BUTTON) return UI_READ;
+    if (gesture == INPUT_DOUBLE && input == INPUT_JOYSTICK_BUTTON) return UI_SUMMARY;
+    return UI_NONE;
+}
 
-    // configurando o estado da aplicação para o estado inicial
-    global_state = IDLE_STATE;  
+// tarefa da interface: na tela inicial avançar pede uma leitura; depois as telas de temperatura, umidade e
+// poluição são percorridas nos dois sentidos e, passando da última, volta a tela inicial
+void ui_task_run(Task *task, const Event *event) {
+    // a ação precisa sobreviver à espera pela leitura
+    static UiAction action;
 
+    TASK_BEGIN();
     while (true) {
+        TASK_WAIT_EVENT(EVENT_INPUT);
+        action = ui_action(event->arg);
+        if (action == UI_NONE) continue;
+        button_posted_us = event->posted_us;
+
+        if (action == UI_NEXT && current_info == NUM_MAX_INFO) action = UI_READ;
+        if (action == UI_READ) {
+            sched_post(EVENT_READ, 0);
+            TASK_WAIT_EVENT(EVENT_SAMPLE);
+            current_info = 0;
+        } else if (action == UI_NEXT) {
+            current_info++;
+        } else if (action == UI_PREVIOUS) {
+            current_info = current_info > 0 && current_info < NUM_MAX_INFO ? current_info - 1 : NUM_MAX_INFO;
+        } else {
+            current_info = NUM_MAX_INFO;
+        }
+
+        if (action == UI_SUMMARY) {
+            display_data(global_sensor_data->temperature, global_sensor_data->humidity, global_sensor_data->airQualityCategory);
+        } else if (current_info < NUM_MAX_INFO) {
+            show_info_screen(global_sensor_data, current_info);
+        } else {
+            display_initial_screen();
+        }
+        record_screen_latency();
 
-        // caso tenha mudado o estado da aplicação para a de leitura dos sensores
-        if (global_state == SENSOR_READING_STATE) {
+        // o joystick só é lido enquanto as telas das informações estão sendo percorridas
+        input_joystick_enable(current_info < NUM_MAX_INFO);
+    }
+    TASK_END();
+}
+
+// tarefa dos sensores: lê e registra a amostra a cada pedido de leitura
+void sensor_task_run(Task *task, const Event *event) {
+    TASK_BEGIN();
+    while (true) {
+        TASK_WAIT_EVENT(EVENT_READ);
+        sched_post(EVENT_SAMPLE, read_and_record_sensors());
+    }
+    TASK_END();
+}
 
-            // lendo os dados de temperatura e umidade
-            // envia pulso inicial para o dht11
-            dht11_send_pulse_start();
+// tarefa de rede: abre ou fecha a janela do rádio e envia o que estiver pendente a cada amostra nova,
+// a cada aviso de rede (enlace, conexão, lote confirmado) e periodicamente (idade do lote)
+void network_task_run(Task *task, const Event *event) {
+    TASK_BEGIN();
+    while (true) {
+        radio_update();
+        server_process_queue();
+        TASK_WAIT(NETWORK_PERIOD_MS);
+    }
+    TASK_END();
+}
 
-            // obtenho e armazeno os dados de temperatura e umidade
-            bool reading_status = dht11_get(&global_sensor_data->temperature, &global_sensor_data->humidity);
-            if (!reading_status) {
-                printf("\nFalha ao ler os dados no DHT11");
+// tarefa do terminal: relatório de cada leitura, amostragem da memória, comandos e mensagens do log adiado;
+// é a última a receber cada evento, o ponto de menor prioridade
+void console_task_run(Task *task, const Event *event) {
+    TASK_BEGIN();
+    while (true) {
+        // relatório da leitura nova, já depois da tela e do envio
+        if (event->type == EVENT_SAMPLE) print_station_report();
+
+        // amostragem periódica da memória (avisa no terminal de falhas de alocação novas)
+        if (network_ready) hal_lwip_begin();
+        memstat_update();
+        if (network_ready) hal_lwip_end();
+
+        // comandos pelo terminal serial: 'p' exibe os histogramas de tempo das sondas, 'z' zera as medições,
+        // 'm' exibe o uso de memória com todos os pools do lwIP
+        int command;
+        while ((command = hal_getchar()) != HAL_NO_CHAR) {
+            if (command == 'p') prof_dump();
+            else if (command == 'z') prof_reset();
+            else if (command == 'm') {
+                if (network_ready) hal_lwip_begin();
+                memstat_print();
+                if (network_ready) hal_lwip_end();
             }
-            
-            // obtendo e armazenando os dados de concentração de gases no sensor de gás MQ135
-            int raw_value = mq135_read_raw();       // valor bruto ADC
-            global_sensor_data->pollutionLevel = mq135_read_percentage(raw_value);  // valor convertido para porcentagem
-
-            // envia os dados para o servidor
-            server_send_data(
-                global_sensor_data->temperature,
-                global_sensor_data->humidity,
-                global_sensor_data->pollutionLevel
-            );
-
-            // armazenando as mensagens de alerta com base nos dados
-            get_and_store_alerts_message(global_sensor_data);
-
-            // exibindo os dados lidos no terminal
-            printf("\n==== DADOS DOS SENSORES ====\n");
-            printf("Temperatura: %d °C\n", global_sensor_data->temperature);
-            printf("Categoria de Temperatura: %s\n", global_sensor_data->temperatureCategory);
-
-            printf("Umidade: %d %%\n", global_sensor_data->humidity);
-            printf("Categoria de Umidade: %s\n", global_sensor_data->humidityCategory);
-
-            printf("Qualidade do Ar (Poluição): %.2f %%\n", global_sensor_data->pollutionLevel);
-            printf("Categoria de Qualidade do Ar: %s\n", global_sensor_data->airQualityCategory);
-            printf("============================\n");
-
-            // exibe os dados localmente no display
-            // muda o estado da aplicação para o estado de exibição dos dados locais
-            global_state = DISPLAY_DATA_STATE;
-            show_data_on_display(*global_sensor_data);
-
-            // ao finalizar esse ciclo, coloca o estado novamente para o inicial (IDLE)
-            global_state = IDLE_STATE;
-            
         }
 
-        sleep_ms(1000);
+        log_flush();
+        TASK_WAIT(CONSOLE_PERIOD_MS);
+    }
+    TASK_END();
+}
+
+int main()
+{
+
+    // pintando as pilhas para medir o pico de uso (antes de qualquer outra chamada)
+    memstat_init();
+
+    // inicializando os dispositivos
+    setup();
+    boot_times.peripherals_ms = hal_time_ms();
+
+    // primeira leitura logo no boot, antes da rede (o DHT11 pode ainda não responder no primeiro segundo)
+    bool first_reading = read_and_record_sensors();
+    boot_times.first_sample_ms = hal_time_ms();
+
+    // primeira tela: leitura atual ou, sem o DHT11, a tela inicial
+    if (first_reading) {
+        display_data(global_sensor_data->temperature, global_sensor_data->humidity, global_sensor_data->airQualityCategory);
+    } else {
+        display_initial_screen();
+    }
+    boot_times.first_screen_ms = hal_time_ms();
+
+    // iniciando a rede: associação e conexão com o servidor seguem em segundo plano (o supervisor reconecta
+    // sozinho e os transportes esperam o enlace), sem segurar o laço principal
+    network_ready = wifi_init();
+    if (network_ready) {
+        // configurando o cliente HTTP persistente
+        server_init();
+
+        // abrindo a API local de consulta (/latest, /history, /summary e /memory)
+        api_init();
+        if (latest_valid) api_update_latest(&latest_sample);
+
+        // janelas de envio do rádio (no modo contínuo o rádio fica sempre ligado)
+        radio_init();
+    } else {
+        printf("Wi-Fi indisponivel: leitura e display seguem sem rede\n");
+    }
+    boot_times.network_ms = hal_time_ms();
+
+    print_boot_times();
+
+    // tarefas orientadas a eventos: o núcleo dorme (hal_wait_for_event) enquanto não houver evento nem prazo vencido
+    sched_add(&input_task, "entrada", input_task_run, EVENT_BIT(EVENT_EDGE));
+    sched_add(&ui_task, "interface", ui_task_run, EVENT_BIT(EVENT_INPUT) | EVENT_BIT(EVENT_SAMPLE));
+    sched_add(&sensor_task, "sensores", sensor_task_run, EVENT_BIT(EVENT_READ));
+    if (network_ready) {
+        sched_add(&network_task, "rede", network_task_run, EVENT_BIT(EVENT_SAMPLE) | EVENT_BIT(EVENT_NETWORK));
     }
+    sched_add(&console_task, "terminal", console_task_run, EVENT_BIT(EVENT_SAMPLE) | EVENT_BIT(EVENT_SERIAL));
+    sched_run();
+#if !PICO_ON_DEVICE
+    // com o relógio virtual sched_run retorna quando nada mais pode acontecer
+    return 0;
+#endif
 }
@@ -0,0 +1,703 @@
+#include "api.h"
+#include <stdio.h>
+#include <string.h>
+#include "hal.h"
+#include "lwip/tcp.h"
+#include "format.h"
+#include "history.h"
+#include "tsblock.h"
+#include "memstat.h"
+#include "log.h"
+
+// intervalo do callback de poll do lwIP (em unidades de 500 ms): um poll por segundo
+#define API_POLL_INTERVAL 2
+
+// canal "todos" nas respostas de /history
+#define API_ALL_CHANNELS HISTORY_NUM_CHANNELS
+
+// rotas atendidas
+typedef enum {
+    API_ROUTE_NONE,
+    API_ROUTE_HISTORY,
+    API_ROUTE_SUMMARY,
+    API_ROUTE_MEMORY
+} ApiRoute;
+
+// etapas da resposta gerada aos pedaços
+typedef enum {
+    API_STAGE_HEADER,
+    API_STAGE_BODY,
+    API_STAGE_DONE
+} ApiStage;
+
+// resposta pré-serializada de /latest (cabeçalhos e corpo)
+typedef struct {
+    char text[API_LATEST_SIZE];
+    uint16_t length;
+    uint8_t users;              // respostas em andamento que referenciam o texto sem cópia
+} ApiLatest;
+
+// conexão de um cliente
+typedef struct {
+    struct tcp_pcb *pcb;        // NULL = vaga livre
+
+    // requisição: só a linha de requisição é guardada, os cabeçalhos são apenas consumidos
+    char request[API_REQUEST_MAX];
+    uint16_t request_length;
+    bool line_done;
+    bool blank_line;            // a linha atual está vazia até agora (fim dos cabeçalhos)
+    bool responding;
+
+    // resposta pronta referenciada sem cópia (texto estático ou /latest)
+    const char *direct;
+    uint16_t direct_length;
+    int8_t latest;              // cache de /latest referenciado (-1 = nenhum)
+
+    // resposta gerada aos pedaços (/history, /summary e /memory)
+    ApiRoute route;
+    ApiStage stage;
+    uint32_t from_s;
+    uint32_t to_s;
+    uint32_t next_s;            // próximo instante a enviar (o histórico pode mudar entre os pedaços)
+    uint8_t channel;
+    uint16_t items;             // itens já escritos no array/objeto atual
+    char chunk[API_CHUNK_SIZE];
+    uint16_t chunk_length;
+    uint16_t chunk_sent;
+
+    uint32_t unacked;           // bytes escritos ainda não confirmados pelo TCP
+    uint8_t idle_polls;
+} ApiClient;
+
+static struct tcp_pcb *listen_pcb = NULL;
+static ApiClient clients[API_MAX_CLIENTS];
+static ApiStats stats;
+
+// /latest com buffer duplo: uma amostra nova é serializada no buffer livre enquanto o outro ainda
+// pode estar sendo enviado
+static ApiLatest latest[2];
+static uint8_t latest_current = 0;
+static bool latest_valid = false;
+static bool latest_dirty = false;
+static SensorSample latest_sample;
+
+// nomes dos canais (parâmetro channel e chaves JSON, os mesmos usados no envio ao servidor)
+static const char *const channel_names[HISTORY_NUM_CHANNELS] = {
+    [HISTORY_TEMPERATURE] = "temperature",
+    [HISTORY_HUMIDITY] = "humidity",
+    [HISTORY_POLLUTION] = "pollutionLevel",
+};
+
+// nomes dos tiers do histórico agregado
+static const char *const tier_names[HISTORY_NUM_TIERS] = {
+    [HISTORY_TIER_MINUTE] = "minute",
+    [HISTORY_TIER_HOUR] = "hour",
+    [HISTORY_TIER_DAY] = "day",
+};
+
+// cabeçalhos comuns das respostas de sucesso
+static const char header_ok[] = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nCache-Control: no-cache\r\nConnection: close\r\n";
+
+// respostas de erro completas
+static const char response_bad_request[] = "HTTP/1.1 400 Bad Request\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n{\"error\":\"requisicao invalida\"}";
+static const char response_not_found[] = "HTTP/1.1 404 Not Found\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n{\"error\":\"rota desconhecida\"}";
+static const char response_method[] = "HTTP/1.1 405 Method Not Allowed\r\nAllow: GET\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n{\"error\":\"somente GET\"}";
+static const char response_unavailable[] = "HTTP/1.1 503 Service Unavailable\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n{\"error\":\"sem amostras\"}";
+
+// implementação das funções
+
+// Acumula o tamanho de um trecho formatado; falha se o trecho não coube
+static bool api_put(int *length, int written) {
+    if (written < 0) return false;
+    *length += written;
+    return true;
+}
+
+// Valor de um canal da amostra em texto
+static int api_channel_value(char *buffer, size_t size, const SensorSample *sample, uint8_t channel) {
+    switch (channel) {
+        case HISTORY_TEMPERATURE: return format_int(buffer, size, sample->temperature, 0);
+        case HISTORY_HUMIDITY: return format_int(buffer, size, sample->humidity, 0);
+        default: return format_fixed(buffer, size, sample->pollution_x10, 1, 0);
+    }
+}
+
+// Uma amostra em JSON: [timestamp,valor] para um único canal ou um objeto com todos os canais
+static int api_sample_json(char *buffer, size_t size, const SensorSample *sample, uint8_t channel) {
+    int length = 0;
+    bool fits;
+
+    if (channel != API_ALL_CHANNELS) {
+        fits = api_put(&length, format_str(buffer, size, "["))
+            && api_put(&length, format_uint(buffer + length, size - length, sample->timestamp_s, 0))
+            && api_put(&length, format_str(buffer + length, size - length, ","))
+            && api_put(&length, api_channel_value(buffer + length, size - length, sample, channel))
+            && api_put(&length, format_str(buffer + length, size - length, "]"));
+        return fits ? length : -1;
+    }
+
+    fits = api_put(&length, format_str(buffer, size, "{\"timestamp\":"))
+        && api_put(&length, format_uint(buffer + length, size - length, sample->timestamp_s, 0));
+    for (uint8_t i = 0; fits && i < HISTORY_NUM_CHANNELS; i++) {
+        fits = api_put(&length, format_str(buffer + length, size - length, ",\""))
+            && api_put(&length, format_str(buffer + length, size - length, channel_names[i]))
+            && api_put(&length, format_str(buffer + length, size - length, "\":"))
+            && api_put(&length, api_channel_value(buffer + length, size - length, sample, i));
+    }
+    fits = fits && api_put(&length, format_str(buffer + length, size - length, "}"));
+    return fits ? length : -1;
+}
+
+// Serializa a resposta de /latest no buffer livre, se houver amostra nova e o buffer não estiver em uso
+static void api_refresh_latest(void) {
+    if (!latest_dirty) return;
+
+    uint8_t spare = 1 - latest_current;
+    ApiLatest *cache = &latest[spare];
+    if (cache->users > 0) return;   // ainda sendo enviado: refeito quando a resposta terminar
+
+    char body[128];
+    int body_length = api_sample_json(body, sizeof(body), &latest_sample, API_ALL_CHANNELS);
+    int length = 0;
+    bool fits = body_length >= 0
+        && api_put(&length, format_str(cache->text, sizeof(cache->text), header_ok))
+        && api_put(&length, format_str(cache->text + length, sizeof(cache->text) - length, "Content-Length: "))
+        && api_put(&length, format_uint(cache->text + length, sizeof(cache->text) - length, body_length, 0))
+        && api_put(&length, format_str(cache->text + length, sizeof(cache->text) - length, "\r\n\r\n"))
+        && api_put(&length, format_str(cache->text + length, sizeof(cache->text) - length, body));
+    if (!fits) return;
+
+    cache->length = length;
+    latest_current = spare;
+    latest_valid = true;
+    latest_dirty = false;
+    stats.latest_builds++;
+}
+
+// Procura o valor de um parâmetro na query string (terminada em ' ' ou '\0'); NULL se não existir
+static const char *api_query_get(const char *query, const char *name) {
+    size_t name_length = strlen(name);
+
+    while (*query != '\0' && *query != ' ') {
+        if (strncmp(query, name, name_length) == 0 && query[name_length] == '=') return query + name_length + 1;
+        while (*query != '\0' && *query != ' ' && *query != '&') query++;
+        if (*query == '&') query++;
+    }
+    return NULL;
+}
+
+// Tamanho do valor de um parâmetro (até '&', ' ' ou '\0')
+static size_t api_value_length(const char *value) {
+    return strcspn(value, "& ");
+}
+
+// Converte o valor de um parâmetro em inteiro sem sinal; false se não for um número válido
+static bool api_parse_uint(const char *value, uint32_t *out) {
+    size_t length = api_value_length(value);
+    uint32_t result = 0;
+
+    if (length == 0) return false;
+    for (size_t i = 0; i < length; i++) {
+        if (value[i] < '0' || value[i] > '9') return false;
+        uint32_t digit = value[i] - '0';
+        if (result > (UINT32_MAX - digit) / 10) return false;
+        result = result * 10 + digit;
+    }
+    *out = result;
+    return true;
+}
+
+// Interpreta os parâmetros de /history; false se algum for inválido
+static bool api_parse_history(ApiClient *client, const char *query) {
+    const char *value;
+
+    client->from_s = 0;
+    client->to_s = UINT32_MAX;
+    client->channel = API_ALL_CHANNELS;
+
+    if ((value = api_query_get(query, "from")) != NULL && !api_parse_uint(value, &client->from_s)) return false;
+    if ((value = api_query_get(query, "to")) != NULL && !api_parse_uint(value, &client->to_s)) return false;
+    if ((value = api_query_get(query, "channel")) != NULL) {
+        size_t length = api_value_length(value);
+        uint8_t channel = 0;
+        while (channel < HISTORY_NUM_CHANNELS
+               && (strlen(channel_names[channel]) != length || strncmp(value, channel_names[channel], length) != 0)) {
+            channel++;
+        }
+        if (channel == HISTORY_NUM_CHANNELS) return false;
+        client->channel = channel;
+    }
+    return client->from_s <= client->to_s;
+}
+
+// Responde com um erro pronto, enviado sem cópia
+static void api_respond_static(ApiClient *client, const char *response) {
+    stats.errors++;
+    client->direct = response;
+    client->direct_length = strlen(response);
+    client->stage = API_STAGE_DONE;
+}
+
+// Interpreta a linha de requisição e prepara a resposta
+static void api_dispatch(ApiClient *client) {
+    const char *request = client->request;
+    client->responding = true;
+    stats.requests++;
+
+    if (strncmp(request, "GET ", 4) != 0) {
+        api_respond_static(client, response_method);
+        return;
+    }
+
+    const char *path = request + 4;
+    size_t path_length = strcspn(path, " ?");
+    const char *query = path[path_length] == '?' ? path + path_length + 1 : "";
+
+    if (path_length == 7 && strncmp(path, "/latest", 7) == 0) {
+        api_refresh_latest();
+        if (!latest_valid) {
+            api_respond_static(client, response_unavailable);
+            return;
+        }
+        client->latest = latest_current;
+        latest[latest_current].users++;
+        client->direct = latest[latest_current].text;
+        client->direct_length = latest[latest_current].length;
+        client->stage = API_STAGE_DONE;
+    } else if (path_length == 8 && strncmp(path, "/history", 8) == 0) {
+        if (!api_parse_history(client, query)) {
+            api_respond_static(client, response_bad_request);
+            return;
+        }
+        client->route = API_ROUTE_HISTORY;
+        client->next_s = client->from_s;
+    } else if (path_length == 8 && strncmp(path, "/summary", 8) == 0) {
+        client->route = API_ROUTE_SUMMARY;
+    } else if (path_length == 7 && strncmp(path, "/memory", 7) == 0) {
+        client->route = API_ROUTE_MEMORY;
+    } else {
+        api_respond_static(client, response_not_found);
+    }
+}
+
+// Consome os bytes recebidos: guarda a linha de requisição e detecta o fim dos cabeçalhos
+static bool api_consume(ApiClient *client, const uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        char c = data[i];
+
+        if (c == '\n') {
+            if (client->line_done && client->blank_line) return true;
+            client->line_done = true;
+            client->blank_line = true;
+        } else if (c != '\r') {
+            client->blank_line = false;
+            if (!client->line_done && client->request_length < API_REQUEST_MAX - 1) {
+                client->request[client->request_length++] = c;
+            }
+        }
+    }
+    return false;
+}
+
+// Uso de um heap ou pool do lwIP em JSON
+static int api_pool_json(char *buffer, size_t size, const MemstatPool *pool) {
+    int length = 0;
+    bool fits = api_put(&length, format_str(buffer, size, "{\"used\":"))
+        && api_put(&length, format_uint(buffer + length, size - length, pool->used, 0))
+        && api_put(&length, format_str(buffer + length, size - length, ",\"max\":"))
+        && api_put(&length, format_uint(buffer + length, size - length, pool->max, 0))
+        && api_put(&length, format_str(buffer + length, size - length, ",\"avail\":"))
+        && api_put(&length, format_uint(buffer + length, size - length, pool->avail, 0))
+        && api_put(&length, format_str(buffer + length, size - length, ",\"err\":"))
+        && api_put(&length, format_uint(buffer + length, size - length, pool->err, 0))
+        && api_put(&length, format_str(buffer + length, size - length, "}"));
+    return fits ? length : -1;
+}
+
+// Abre a resposta gerada aos pedaços: cabeçalhos e início do corpo JSON
+static int api_fill_header(ApiClient *client, char *buffer, size_t size) {
+    int length = 0;
+    bool fits = api_put(&length, format_str(buffer, size, header_ok))
+        && api_put(&length, format_str(buffer + length, size - length, "\r\n"));
+
+    if (client->route == API_ROUTE_SUMMARY) {
+        fits = fits
+            && api_put(&length, format_str(buffer + length, size - length, "{\"uptime\":"))
+            && api_put(&length, format_uint(buffer + length, size - length, hal_time_ms() / 1000, 0))
+            && api_put(&length, format_str(buffer + length, size - length, ",\"tiers\":{"));
+        return fits ? length : -1;
+    }
+
+    if (client->route == API_ROUTE_MEMORY) {
+        MemstatSnapshot memory;
+        memstat_get(&memory);
+        fits = fits
+            && api_put(&length, format_str(buffer + length, size - length, "{\"uptime\":"))
+            && api_put(&length, format_uint(buffer + length, size - length, hal_time_ms() / 1000, 0))
+            && api_put(&length, format_str(buffer + length, size - length, ",\"heap\":{\"used\":"))
+            && api_put(&length, format_uint(buffer + length, size - length, memory.heap_used, 0))
+            && api_put(&length, format_str(buffer + length, size - length, ",\"peak\":"))
+            && api_put(&length, format_uint(buffer + length, size - length, memory.heap_peak, 0))
+            && api_put(&length, format_str(buffer + length, size - length, ",\"arena\":"))
+            && api_put(&length, format_uint(buffer + length, size - length, memory.heap_arena, 0))
+            && api_put(&length, format_str(buffer + length, size - length, ",\"size\":"))
+            && api_put(&length, format_uint(buffer + length, size - length, memory.heap_size, 0))
+            && api_put(&length, format_str(buffer + length, size - length, "},\"stacks\":["));
+        for (uint8_t core = 0; fits && core < MEMSTAT_NUM_CORES; core++) {
+            fits = api_put(&length, format_str(buffer + length, size - length, core > 0 ? ",{\"used\":" : "{\"used\":"))
+                && api_put(&length, format_uint(buffer + length, size - length, memory.stack_used[core], 0))
+                && api_put(&length, format_str(buffer + length, size - length, ",\"size\":"))
+                && api_put(&length, format_uint(buffer + length, size - length, memory.stack_size[core], 0))
+                && api_put(&length, format_str(buffer + length, size - length, "}"));
+        }
+        fits = fits
+            && api_put(&length, format_str(buffer + length, size - length, "],\"lwip\":{\"heap\":"))
+            && api_put(&length, api_pool_json(buffer + length, size - length, &memory.lwip_heap))
+            && api_put(&length, format_str(buffer + length, size - length, ",\"pools\":{"));
+        return fits ? length : -1;
+    }
+
+    fits = fits
+        && api_put(&length, format_str(buffer + length, size - length, "{\"from\":"))
+        && api_put(&length, format_uint(buffer + length, size - length, client->from_s, 0))
+        && api_put(&length, format_str(buffer + length, size - length, ",\"to\":"))
+        && api_put(&length, format_uint(buffer + length, size - length, client->to_s, 0));
+    if (fits && client->channel != API_ALL_CHANNELS) {
+        fits = api_put(&length, format_str(buffer + length, size - length, ",\"channel\":\""))
+            && api_put(&length, format_str(buffer + length, size - length, channel_names[client->channel]))
+            && api_put(&length, format_str(buffer + length, size - length, "\""));
+    }
+    fits = fits && api_put(&length, format_str(buffer + length, size - length, ",\"samples\":["));
+    return fits ? length : -1;
+}
+
+// Escreve as amostras do histórico que couberem no pedaço, a partir de next_s
+static int api_fill_history(ApiClient *client, int length) {
+    char *buffer = client->chunk;
+    size_t size = API_CHUNK_SIZE - 2;     // reserva para o fechamento "]}"
+    uint16_t blocks = tsblock_ring_count();
+
+    // o bloco é procurado de novo a cada pedaço: amostras novas podem ter reciclado blocos antigos
+    for (uint16_t block = tsblock_ring_find(client->next_s); block < blocks; block++) {
+        TsBlockDecoder decoder;
+        SensorSample sample;
+        tsblock_decoder_init(&decoder, tsblock_ring_get(block));
+
+        while (tsblock_decoder_next(&decoder, &sample)) {
+            if (sample.timestamp_s < client->next_s) continue;
+            if (sample.timestamp_s > client->to_s) {
+                block = blocks;
+                break;
+            }
+
+            int separator = client->items > 0 ? 1 : 0;
+            if (length + separator >= (int) size) return length;
+            int written = api_sample_json(buffer + length + separator, size - length - separator, &sample, client->channel);
+            if (written < 0) return length;     // não coube: continua no próximo pedaço
+
+            if (separator) buffer[length] = ',';
+            length += separator + written;
+            client->items++;
+            client->next_s = sample.timestamp_s + 1;
+        }
+    }
+
+    memcpy(buffer + length, "]}", 2);
+    client->stage = API_STAGE_DONE;
+    return length + 2;
+}
+
+// Estatística de um canal em JSON
+static int api_stats_json(char *buffer, size_t size, const HistoryStats *channel_stats) {
+    int length = 0;
+    bool fits = api_put(&length, format_str(buffer, size, "{\"count\":"))
+        && api_put(&length, format_uint(buffer + length, size - length, channel_stats->count, 0));
+
+    if (fits && channel_stats->count > 0) {
+        fits = api_put(&length, format_str(buffer + length, size - length, ",\"min\":"))
+            && api_put(&length, format_float(buffer + length, size - length, channel_stats->min, 1, 0))
+            && api_put(&length, format_str(buffer + length, size - length, ",\"max\":"))
+            && api_put(&length, format_float(buffer + length, size - length, channel_stats->max, 1, 0))
+            && api_put(&length, format_str(buffer + length, size - length, ",\"mean\":"))
+            && api_put(&length, format_float(buffer + length, size - length, channel_stats->mean, 1, 0));
+    }
+    fits = fits && api_put(&length, format_str(buffer + length, size - length, "}"));
+    return fits ? length : -1;
+}
+
+// Janela em andamento de um tier em JSON ("minute":{...})
+static int api_tier_json(char *buffer, size_t size, HistoryTier tier) {
+    HistorySummary summary;
+    int length = 0;
+    bool fits = api_put(&length, format_str(buffer, size, "\""))
+        && api_put(&length, format_str(buffer + length, size - length, tier_names[tier]))
+        && api_put(&length, format_str(buffer + length, size - length, "\":"));
+
+    if (!history_get_open(tier, &summary)) {
+        fits = fits && api_put(&length, format_str(buffer + length, size - length, "null"));
+        return fits ? length : -1;
+    }
+
+    fits = fits
+        && api_put(&length, format_str(buffer + length, size - length, "{\"start\":"))
+        && api_put(&length, format_uint(buffer + length, size - length, summary.start_s, 0))
+        && api_put(&length, format_str(buffer + length, size - length, ",\"duration\":"))
+        && api_put(&length, format_uint(buffer + length, size - length, history_tier_duration(tier), 0));
+    for (uint8_t i = 0; fits && i < HISTORY_NUM_CHANNELS; i++) {
+        fits = api_put(&length, format_str(buffer + length, size - length, ",\""))
+            && api_put(&length, format_str(buffer + length, size - length, channel_names[i]))
+            && api_put(&length, format_str(buffer + length, size - length, "\":"))
+            && api_put(&length, api_stats_json(buffer + length, size - length, &summary.channels[i]));
+    }
+    fits = fits && api_put(&length, format_str(buffer + length, size - length, "}"));
+    return fits ? length : -1;
+}
+
+// Escreve os tiers do resumo que couberem no pedaço (items conta os tiers já escritos)
+static int api_fill_summary(ApiClient *client, int length) {
+    char *buffer = client->chunk;
+    size_t size = API_CHUNK_SIZE - 2;     // reserva para o fechamento "}}"
+
+    while (client->items < HISTORY_NUM_TIERS) {
+        int separator = client->items > 0 ? 1 : 0;
+        if (length + separator >= (int) size) return length;
+        int written = api_tier_json(buffer + length + separator, size - length - separator, (HistoryTier) client->items);
+        if (written < 0) return length;
+
+        if (separator) buffer[length] = ',';
+        length += separator + written;
+        client->items++;
+    }
+
+    memcpy(buffer + length, "}}", 2);
+    client->stage = API_STAGE_DONE;
+    return length + 2;
+}
+
+// Escreve os pools do lwIP que couberem no pedaço (items conta os pools já escritos)
+static int api_fill_memory(ApiClient *client, int length) {
+    char *buffer = client->chunk;
+    size_t size = API_CHUNK_SIZE - 3;     // reserva para o fechamento "}}}"
+
+    while (client->items < memstat_pool_count()) {
+        MemstatPool pool;
+        memstat_pool_get(client->items, &pool);
+
+        int start = length;
+        bool fits = api_put(&length, format_str(buffer + length, size - length, client->items > 0 ? ",\"" : "\""))
+            && api_put(&length, format_str(buffer + length, size - length, memstat_pool_name(client->items)))
+            && api_put(&length, format_str(buffer + length, size - length, "\":"))
+            && api_put(&length, api_pool_json(buffer + length, size - length, &pool));
+        if (!fits) return start;
+
+        client->items++;
+    }
+
+    memcpy(buffer + length, "}}}", 3);
+    client->stage = API_STAGE_DONE;
+    return length + 3;
+}
+
+// Gera o próximo pedaço da resposta
+static uint16_t api_fill(ApiClient *client) {
+    int length = 0;
+
+    if (client->stage == API_STAGE_HEADER) {
+        length = api_fill_header(client, client->chunk, API_CHUNK_SIZE);
+        if (length < 0) {
+            client->stage = API_STAGE_DONE;
+            return 0;
+        }
+        client->stage = API_STAGE_BODY;
+    }
+
+    if (client->route == API_ROUTE_HISTORY) return api_fill_history(client, length);
+    if (client->route == API_ROUTE_MEMORY) return api_fill_memory(client, length);
+    return api_fill_summary(client, length);
+}
+
+// Escreve a resposta no TCP enquanto houver espaço na janela de envio
+static void api_send(ApiClient *client) {
+    struct tcp_pcb *pcb = client->pcb;
+
+    while (true) {
+        uint16_t space = tcp_sndbuf(pcb);
+        if (space == 0) break;
+
+        // resposta pronta: referenciada sem cópia
+        if (client->direct_length > 0) {
+            uint16_t length = client->direct_length < space ? client->direct_length : space;
+            if (tcp_write(pcb, client->direct, length, 0) != ERR_OK) break;
+            client->direct += length;
+            client->direct_length -= length;
+            client->unacked += length;
+            stats.bytes_sent += length;
+            continue;
+        }
+
+        // resposta gerada: o pedaço é copiado para o lwIP e o buffer reaproveitado para o próximo
+        if (client->chunk_sent == client->chunk_length) {
+            if (client->stage == API_STAGE_DONE) break;
+            client->chunk_length = api_fill(client);
+            client->chunk_sent = 0;
+            continue;
+        }
+
+        uint16_t remaining = client->chunk_length - client->chunk_sent;
+        uint16_t length = remaining < space ? remaining : space;
+        if (tcp_write(pcb, client->chunk + client->chunk_sent, length, TCP_WRITE_FLAG_COPY) != ERR_OK) break;
+        client->chunk_sent += length;
+        client->unacked += length;
+        stats.bytes_sent += length;
+    }
+    tcp_output(pcb);
+}
+
+// Indica se a resposta foi toda escrita no TCP
+static bool api_written(const ApiClient *client) {
+    return client->responding && client->direct_length == 0
+        && client->chunk_sent == client->chunk_length && client->stage == API_STAGE_DONE;
+}
+
+// Libera a vaga do cliente (e a referência ao cache de /latest)
+static void api_client_release(ApiClient *client) {
+    client->pcb = NULL;
+    if (client->latest >= 0) {
+        latest[client->latest].users--;
+        client->latest = -1;
+        api_refresh_latest();   // uma amostra nova pode estar esperando este buffer
+    }
+}
+
+// Encerra a conexão; com bytes ainda não confirmados ela é abortada, para que o lwIP não retransmita
+// dados sem cópia depois de o buffer ser liberado
+static err_t api_client_close(ApiClient *client, bool abort) {
+    struct tcp_pcb *pcb = client->pcb;
+    abort = abort || client->unacked > 0;
+
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_err(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+    api_client_release(client);
+
+    if (!abort && tcp_close(pcb) == ERR_OK) return ERR_OK;
+    tcp_abort(pcb);
+    return ERR_ABRT;
+}
+
+// Continua a resposta e fecha a conexão quando tudo foi confirmado
+static err_t api_continue(ApiClient *client) {
+    if (!client->responding) return ERR_OK;
+
+    api_send(client);
+    if (api_written(client) && client->unacked == 0) return api_client_close(client, false);
+    return ERR_OK;
+}
+
+// callback de dados recebidos do cliente
+static err_t api_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    ApiClient *client = arg;
+
+    if (p == NULL) {
+        // cliente fechou a conexão
+        return api_client_close(client, false);
+    }
+
+    bool complete = false;
+    for (struct pbuf *q = p; q != NULL && !complete && !client->responding; q = q->next) {
+        complete = api_consume(client, (const uint8_t *) q->payload, q->len);
+    }
+    tcp_recved(tpcb, p->tot_len);
+    pbuf_free(p);
+
+    client->idle_polls = 0;
+    if (!complete) return ERR_OK;
+
+    client->request[client->request_length] = '\0';
+    api_dispatch(client);
+    return api_continue(client);
+}
+
+// callback de confirmação dos bytes enviados
+static err_t api_sent(void *arg, struct tcp_pcb *tpcb, u16_t len) {
+    ApiClient *client = arg;
+
+    client->unacked = len >= client->unacked ? 0 : client->unacked - len;
+    client->idle_polls = 0;
+    return api_continue(client);
+}
+
+// callback periódico: retoma escritas que não couberam e expira conexões paradas
+static err_t api_poll(void *arg, struct tcp_pcb *tpcb) {
+    ApiClient *client = arg;
+
+    if (++client->idle_polls > API_TIMEOUT_S) return api_client_close(client, true);
+    return api_continue(client);
+}
+
+// callback de erro: o pcb já foi liberado pelo lwIP
+static void api_error(void *arg, err_t err) {
+    ApiClient *client = arg;
+    if (client != NULL) api_client_release(client);
+}
+
+// callback de nova conexão
+static err_t api_accept(void *arg, struct tcp_pcb *newpcb, err_t err) {
+    if (err != ERR_OK || newpcb == NULL) return ERR_VAL;
+
+    ApiClient *client = NULL;
+    for (int i = 0; i < API_MAX_CLIENTS && client == NULL; i++) {
+        if (clients[i].pcb == NULL) client = &clients[i];
+    }
+    if (client == NULL) {
+        stats.rejected++;
+        tcp_abort(newpcb);
+        return ERR_ABRT;
+    }
+
+    memset(client, 0, sizeof(*client));
+    client->pcb = newpcb;
+    client->latest = -1;
+
+    tcp_arg(newpcb, client);
+    tcp_recv(newpcb, api_recv);
+    tcp_sent(newpcb, api_sent);
+    tcp_err(newpcb, api_error);
+    tcp_poll(newpcb, api_poll, API_POLL_INTERVAL);
+    return ERR_OK;
+}
+
+bool api_init(void) {
+    hal_lwip_begin();
+    struct tcp_pcb *pcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
+    if (pcb != NULL && tcp_bind(pcb, IP_ANY_TYPE, API_PORT) == ERR_OK) {
+        listen_pcb = tcp_listen(pcb);
+    }
+    if (listen_pcb != NULL) {
+        tcp_accept(listen_pcb, api_accept);
+    } else if (pcb != NULL) {
+        tcp_close(pcb);
+    }
+    hal_lwip_end();
+
+    if (listen_pcb == NULL) {
+        LOG_ERROR("API: falha ao abrir a porta %d\n", API_PORT);
+        return false;
+    }
+    LOG_INFO("API: servidor local na porta %d\n", API_PORT);
+    return true;
+}
+
+void api_update_latest(const SensorSample *sample) {
+    hal_lwip_begin();
+    latest_sample = *sample;
+    latest_dirty = true;
+    api_refresh_latest();
+    hal_lwip_end();
+}
+
+void api_get_stats(ApiStats *out) {
+    *out = stats;
+}
@@ -0,0 +1,65 @@
+#ifndef API_H
+#define API_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+#include "sample.h"
+
+/**
+ * @file api.h
+ *
+ * @brief Servidor HTTP embarcado para consulta local da estação (API raw do lwIP).
+ *
+ * @note Rotas (somente GET, respostas JSON com "Connection: close"):
+ *   - /latest: última amostra; a resposta completa fica pré-serializada e só é refeita quando
+ *     chega uma amostra nova (api_update_latest), sendo enviada sem cópia.
+ *   - /history?from=&to=&channel=: amostras do histórico comprimido em RAM (tsblock) entre os
+ *     instantes from e to (segundos desde o boot, inclusive); channel limita a resposta a um canal
+ *     (temperature, humidity ou pollutionLevel). A resposta é gerada aos pedaços, à medida que há
+ *     espaço na janela de envio do TCP, sem montar o corpo inteiro em memória.
+ *   - /summary: estatística (contagem, mínimo, máximo e média) das janelas em andamento do
+ *     histórico agregado (minuto, hora e dia).
+ *   - /memory: uso do heap, pico de uso das pilhas e uso, pico e falhas do heap e dos pools do lwIP
+ *     (ver memstat.h).
+ *
+ * @warning O histórico é lido no contexto do lwIP: quem grava no histórico (history e tsblock)
+ * fora dos callbacks do lwIP deve fazê-lo com o lwIP travado (hal_lwip_begin/end).
+ */
+
+// porta do servidor local
+#define API_PORT 80
+
+// conexões atendidas ao mesmo tempo (as demais são recusadas)
+#define API_MAX_CLIENTS 3
+
+// tamanho máximo da linha de requisição e dos cabeçalhos recebidos
+#define API_REQUEST_MAX 256
+
+// tamanho de cada pedaço da resposta gerado por vez
+#define API_CHUNK_SIZE 512
+
+// tamanho da resposta pré-serializada de /latest (cabeçalhos e corpo)
+#define API_LATEST_SIZE 256
+
+// tempo máximo de uma conexão sem atividade
+#define API_TIMEOUT_S 10
+
+// estatísticas do servidor
+typedef struct {
+    uint32_t requests;          // requisições atendidas
+    uint32_t rejected;          // conexões recusadas por falta de vaga
+    uint32_t errors;            // requisições respondidas com erro (4xx/5xx)
+    uint32_t latest_builds;     // vezes que a resposta de /latest foi serializada
+    uint32_t bytes_sent;        // bytes de resposta escritos no TCP
+} ApiStats;
+
+// definição das funções
+
+// abre o servidor na porta API_PORT; retorna false se não foi possível escutar
+bool api_init(void);
+// informa uma amostra nova: a resposta de /latest é serializada de novo
+void api_update_latest(const SensorSample *sample);
+// copia as estatísticas do servidor
+void api_get_stats(ApiStats *out);
+
+#endif
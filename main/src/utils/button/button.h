@@ -1,13 +0,0 @@
-#ifndef BUTTONS_H
-#define BUTTONS_H
-
-// inclusão de bibliotecas
-#include "pico/stdlib.h"
-
-// definição da pinagem
-#define BTN_B 6
-
-// definição das funções
-void button_init();
-
-#endif
\ No newline at end of file
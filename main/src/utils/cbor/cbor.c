@@ -0,0 +1,278 @@
+#include "cbor.h"
+#include <string.h>
+
+// tag de fração decimal (RFC 8949, seção 3.4.4)
+#define CBOR_TAG_DECIMAL 4
+
+// profundidade máxima de itens aninhados aceita por cbor_skip
+#define CBOR_MAX_DEPTH 8
+
+// implementação das funções
+
+// Escreve o byte inicial e o argumento na menor forma possível (1, 2, 3, 5 ou 9 bytes)
+static void cbor_put_head(CborWriter *writer, CborType type, uint64_t argument) {
+    uint8_t head[9];
+    size_t length;
+
+    if (argument < 24) {
+        head[0] = (type << 5) | (uint8_t) argument;
+        length = 1;
+    } else if (argument <= 0xFF) {
+        head[0] = (type << 5) | 24;
+        length = 2;
+    } else if (argument <= 0xFFFF) {
+        head[0] = (type << 5) | 25;
+        length = 3;
+    } else if (argument <= 0xFFFFFFFF) {
+        head[0] = (type << 5) | 26;
+        length = 5;
+    } else {
+        head[0] = (type << 5) | 27;
+        length = 9;
+    }
+
+    // argumento em big-endian logo após o byte inicial
+    for (size_t i = 1; i < length; i++) {
+        head[i] = argument >> (8 * (length - 1 - i));
+    }
+
+    if (writer->overflow || writer->length + length > writer->size) {
+        writer->overflow = true;
+        return;
+    }
+    memcpy(writer->buffer + writer->length, head, length);
+    writer->length += length;
+}
+
+void cbor_writer_init(CborWriter *writer, uint8_t *buffer, size_t size) {
+    writer->buffer = buffer;
+    writer->size = size;
+    writer->length = 0;
+    writer->overflow = false;
+}
+
+void cbor_put_uint(CborWriter *writer, uint32_t value) {
+    cbor_put_head(writer, CBOR_TYPE_UINT, value);
+}
+
+void cbor_put_int(CborWriter *writer, int32_t value) {
+    // negativos são codificados como -1 - n
+    if (value < 0) cbor_put_head(writer, CBOR_TYPE_NEGINT, (uint64_t) (-1 - (int64_t) value));
+    else cbor_put_head(writer, CBOR_TYPE_UINT, value);
+}
+
+void cbor_put_text(CborWriter *writer, const char *text) {
+    size_t length = strlen(text);
+    cbor_put_head(writer, CBOR_TYPE_TEXT, length);
+
+    if (writer->overflow || writer->length + length > writer->size) {
+        writer->overflow = true;
+        return;
+    }
+    memcpy(writer->buffer + writer->length, text, length);
+    writer->length += length;
+}
+
+void cbor_put_array(CborWriter *writer, uint32_t count) {
+    cbor_put_head(writer, CBOR_TYPE_ARRAY, count);
+}
+
+void cbor_put_map(CborWriter *writer, uint32_t count) {
+    cbor_put_head(writer, CBOR_TYPE_MAP, count);
+}
+
+void cbor_put_decimal(CborWriter *writer, int32_t mantissa, int32_t exponent) {
+    cbor_put_head(writer, CBOR_TYPE_TAG, CBOR_TAG_DECIMAL);
+    cbor_put_array(writer, 2);
+    cbor_put_int(writer, exponent);
+    cbor_put_int(writer, mantissa);
+}
+
+void cbor_put_sample(CborWriter *writer, uint32_t seq, const SensorSample *sample, uint8_t channels) {
+    // seq, timestamp e boot sempre presentes, mais um par por canal da máscara
+    uint32_t pairs = 3 + ((channels & CBOR_CHANNEL_TEMPERATURE) != 0) + ((channels & CBOR_CHANNEL_HUMIDITY) != 0)
+                   + ((channels & CBOR_CHANNEL_POLLUTION) != 0);
+
+    cbor_put_map(writer, pairs);
+    cbor_put_uint(writer, CBOR_KEY_SEQ);
+    cbor_put_uint(writer, seq);
+    cbor_put_uint(writer, CBOR_KEY_TIMESTAMP);
+    cbor_put_uint(writer, sample->timestamp_s);
+    cbor_put_uint(writer, CBOR_KEY_BOOT);
+    cbor_put_uint(writer, sample->boot);
+
+    if (channels & CBOR_CHANNEL_TEMPERATURE) {
+        cbor_put_uint(writer, CBOR_KEY_TEMPERATURE);
+        cbor_put_int(writer, sample->temperature);
+    }
+    if (channels & CBOR_CHANNEL_HUMIDITY) {
+        cbor_put_uint(writer, CBOR_KEY_HUMIDITY);
+        cbor_put_int(writer, sample->humidity);
+    }
+    if (channels & CBOR_CHANNEL_POLLUTION) {
+        cbor_put_uint(writer, CBOR_KEY_POLLUTION);
+        cbor_put_decimal(writer, sample->pollution_x10, -1);
+    }
+}
+
+void cbor_reader_init(CborReader *reader, const uint8_t *buffer, size_t size) {
+    reader->buffer = buffer;
+    reader->size = size;
+    reader->position = 0;
+    reader->error = false;
+}
+
+bool cbor_read_head(CborReader *reader, CborType *type, uint64_t *argument) {
+    if (reader->error || reader->position >= reader->size) {
+        reader->error = true;
+        return false;
+    }
+
+    uint8_t initial = reader->buffer[reader->position++];
+    uint8_t info = initial & 0x1F;
+    *type = (CborType) (initial >> 5);
+
+    // argumento no próprio byte inicial
+    if (info < 24) {
+        *argument = info;
+        return true;
+    }
+
+    // 24..27: argumento em 1, 2, 4 ou 8 bytes; tamanhos indefinidos (31) não são aceitos
+    if (info > 27) {
+        reader->error = true;
+        return false;
+    }
+    size_t length = (size_t) 1 << (info - 24);
+    if (reader->position + length > reader->size) {
+        reader->error = true;
+        return false;
+    }
+
+    *argument = 0;
+    for (size_t i = 0; i < length; i++) {
+        *argument = (*argument << 8) | reader->buffer[reader->position++];
+    }
+    return true;
+}
+
+bool cbor_read_int(CborReader *reader, int64_t *value) {
+    CborType type;
+    uint64_t argument;
+    if (!cbor_read_head(reader, &type, &argument)) return false;
+
+    if ((type != CBOR_TYPE_UINT && type != CBOR_TYPE_NEGINT) || argument > INT64_MAX) {
+        reader->error = true;
+        return false;
+    }
+    *value = type == CBOR_TYPE_UINT ? (int64_t) argument : -1 - (int64_t) argument;
+    return true;
+}
+
+bool cbor_read_decimal(CborReader *reader, int64_t *mantissa, int64_t *exponent) {
+    // inteiro simples: expoente zero
+    if (reader->position < reader->size && (reader->buffer[reader->position] >> 5) != CBOR_TYPE_TAG) {
+        *exponent = 0;
+        return cbor_read_int(reader, mantissa);
+    }
+
+    CborType type;
+    uint64_t argument;
+    if (!cbor_read_head(reader, &type, &argument) || argument != CBOR_TAG_DECIMAL
+        || !cbor_read_head(reader, &type, &argument) || type != CBOR_TYPE_ARRAY || argument != 2) {
+        reader->error = true;
+        return false;
+    }
+    return cbor_read_int(reader, exponent) && cbor_read_int(reader, mantissa);
+}
+
+bool cbor_skip(CborReader *reader) {
+    // itens ainda por pular em cada nível de aninhamento
+    uint64_t remaining[CBOR_MAX_DEPTH];
+    int depth = 0;
+    remaining[0] = 1;
+
+    while (true) {
+        CborType type;
+        uint64_t argument;
+        if (!cbor_read_head(reader, &type, &argument)) return false;
+        remaining[depth]--;
+
+        if (type == CBOR_TYPE_BYTES || type == CBOR_TYPE_TEXT) {
+            if (argument > reader->size - reader->position) {
+                reader->error = true;
+                return false;
+            }
+            reader->position += argument;
+        } else if (type == CBOR_TYPE_ARRAY || type == CBOR_TYPE_MAP || type == CBOR_TYPE_TAG) {
+            // uma tag é seguida de exatamente um item
+            uint64_t items = type == CBOR_TYPE_MAP ? argument * 2 : type == CBOR_TYPE_TAG ? 1 : argument;
+            if (items > 0) {
+                if (depth + 1 >= CBOR_MAX_DEPTH) {
+                    reader->error = true;
+                    return false;
+                }
+                remaining[++depth] = items;
+            }
+        }
+
+        // sobe enquanto os níveis estiverem completos
+        while (depth > 0 && remaining[depth] == 0) depth--;
+        if (depth == 0 && remaining[0] == 0) return true;
+    }
+}
+
+bool cbor_read_sample(CborReader *reader, uint32_t *seq, SensorSample *sample, uint8_t *channels) {
+    CborType type;
+    uint64_t pairs;
+    if (!cbor_read_head(reader, &type, &pairs) || type != CBOR_TYPE_MAP) {
+        reader->error = true;
+        return false;
+    }
+
+    memset(sample, 0, sizeof(*sample));
+    *seq = 0;
+    *channels = 0;
+
+    for (uint64_t i = 0; i < pairs; i++) {
+        int64_t key, value, exponent;
+        if (!cbor_read_int(reader, &key)) return false;
+
+        switch (key) {
+            case CBOR_KEY_SEQ:
+                if (!cbor_read_int(reader, &value)) return false;
+                *seq = (uint32_t) value;
+                break;
+            case CBOR_KEY_TIMESTAMP:
+                if (!cbor_read_int(reader, &value)) return false;
+                sample->timestamp_s = (uint32_t) value;
+                break;
+            case CBOR_KEY_BOOT:
+                if (!cbor_read_int(reader, &value)) return false;
+                sample->boot = (uint16_t) value;
+                break;
+            case CBOR_KEY_TEMPERATURE:
+                if (!cbor_read_int(reader, &value)) return false;
+                sample->temperature = (int16_t) value;
+                *channels |= CBOR_CHANNEL_TEMPERATURE;
+                break;
+            case CBOR_KEY_HUMIDITY:
+                if (!cbor_read_int(reader, &value)) return false;
+                sample->humidity = (int16_t) value;
+                *channels |= CBOR_CHANNEL_HUMIDITY;
+                break;
+            case CBOR_KEY_POLLUTION:
+                if (!cbor_read_decimal(reader, &value, &exponent)) return false;
+                // normaliza para décimos
+                while (exponent < -1) { value /= 10; exponent++; }
+                while (exponent > -1) { value *= 10; exponent--; }
+                sample->pollution_x10 = (uint16_t) value;
+                *channels |= CBOR_CHANNEL_POLLUTION;
+                break;
+            default:
+                if (!cbor_skip(reader)) return false;
+                break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+#ifndef CBOR_H
+#define CBOR_H
+
+// inclusão de bibliotecas
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sample.h"
+
+/**
+ * @file cbor.h
+ *
+ * @brief Codificação binária CBOR (RFC 8949) das amostras, alternativa compacta ao JSON.
+ *
+ * @note Cada amostra é um mapa com chaves inteiras (CBOR_KEY_*), sem texto nem float:
+ * temperatura e umidade são inteiros e a poluição é uma fração decimal (tag 4, [-1, décimos]),
+ * exata e sem conversão de ponto flutuante. Canais ausentes da máscara são omitidos do mapa.
+ * Um lote é um array de tamanho definido com os mapas das amostras.
+ *
+ * O leitor (CborReader) é usado pelas ferramentas no computador para decodificar e conferir
+ * os lotes; o firmware só usa o escritor.
+ */
+
+// chaves do mapa de uma amostra
+#define CBOR_KEY_SEQ 0
+#define CBOR_KEY_TIMESTAMP 1
+#define CBOR_KEY_TEMPERATURE 2
+#define CBOR_KEY_HUMIDITY 3
+#define CBOR_KEY_POLLUTION 4
+#define CBOR_KEY_BOOT 5
+
+// máscara de canais de uma amostra (mesma ordem dos canais do histórico e do servidor)
+#define CBOR_CHANNEL_TEMPERATURE (1u << 0)
+#define CBOR_CHANNEL_HUMIDITY (1u << 1)
+#define CBOR_CHANNEL_POLLUTION (1u << 2)
+
+// maior amostra codificada em bytes
+#define CBOR_SAMPLE_MAX 36
+
+// tipos principais do CBOR (3 bits mais altos do byte inicial)
+typedef enum {
+    CBOR_TYPE_UINT = 0,
+    CBOR_TYPE_NEGINT = 1,
+    CBOR_TYPE_BYTES = 2,
+    CBOR_TYPE_TEXT = 3,
+    CBOR_TYPE_ARRAY = 4,
+    CBOR_TYPE_MAP = 5,
+    CBOR_TYPE_TAG = 6,
+    CBOR_TYPE_SIMPLE = 7
+} CborType;
+
+// escritor sobre um buffer do chamador; ao faltar espaço marca overflow e ignora o restante
+typedef struct {
+    uint8_t *buffer;
+    size_t size;
+    size_t length;              // bytes escritos
+    bool overflow;              // algum item não coube
+} CborWriter;
+
+// leitor sobre um buffer; qualquer item malformado ou truncado marca error
+typedef struct {
+    const uint8_t *buffer;
+    size_t size;
+    size_t position;            // próximo byte a ler
+    bool error;
+} CborReader;
+
+// definição das funções
+
+// inicia a escrita em um buffer
+void cbor_writer_init(CborWriter *writer, uint8_t *buffer, size_t size);
+// inteiro sem sinal
+void cbor_put_uint(CborWriter *writer, uint32_t value);
+// inteiro com sinal (tipos 0 e 1)
+void cbor_put_int(CborWriter *writer, int32_t value);
+// texto UTF-8
+void cbor_put_text(CborWriter *writer, const char *text);
+// cabeçalho de um array com count itens
+void cbor_put_array(CborWriter *writer, uint32_t count);
+// cabeçalho de um mapa com count pares
+void cbor_put_map(CborWriter *writer, uint32_t count);
+// fração decimal mantissa * 10^exponent (tag 4)
+void cbor_put_decimal(CborWriter *writer, int32_t mantissa, int32_t exponent);
+// amostra como mapa com chaves inteiras, apenas com os canais da máscara
+void cbor_put_sample(CborWriter *writer, uint32_t seq, const SensorSample *sample, uint8_t channels);
+
+// inicia a leitura de um buffer
+void cbor_reader_init(CborReader *reader, const uint8_t *buffer, size_t size);
+// lê o cabeçalho do próximo item: tipo principal e argumento (valor, tamanho ou quantidade)
+bool cbor_read_head(CborReader *reader, CborType *type, uint64_t *argument);
+// lê um inteiro (tipos 0 e 1)
+bool cbor_read_int(CborReader *reader, int64_t *value);
+// lê uma fração decimal (tag 4) ou um inteiro (expoente 0)
+bool cbor_read_decimal(CborReader *reader, int64_t *mantissa, int64_t *exponent);
+// pula o próximo item, inclusive arrays, mapas e tags aninhados
+bool cbor_skip(CborReader *reader);
+// lê uma amostra gravada por cbor_put_sample; chaves desconhecidas são ignoradas
+bool cbor_read_sample(CborReader *reader, uint32_t *seq, SensorSample *sample, uint8_t *channels);
+
+#endif
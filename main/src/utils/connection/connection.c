@@ -0,0 +1,159 @@
+#include "connection.h"
+#include "log.h"
+#include <stdio.h>
+#include "lwip/timeouts.h"
+
+static void connection_timer(void *arg);
+static void connection_attempt_timeout(void *arg);
+
+// implementação das funções
+
+static uint32_t connection_now_ms(void) {
+    return hal_time_ms();
+}
+
+// Agenda a próxima tentativa para daqui a delay_ms, no estado informado
+static void connection_schedule(ConnectionManager *manager, ConnectionState state, uint32_t delay_ms) {
+    manager->state = state;
+    manager->retry_at_ms = connection_now_ms() + delay_ms;
+    sys_untimeout(connection_timer, manager);
+    sys_timeout(delay_ms, connection_timer, manager);
+}
+
+// Espera da próxima tentativa: base * 2^(falhas - 1), limitada ao máximo, com jitter na metade
+// superior do intervalo para que várias estações não reconectem juntas após uma queda do servidor
+static uint32_t connection_backoff_ms(uint8_t failures) {
+    uint32_t delay = CONNECTION_BACKOFF_BASE_MS;
+    for (uint8_t i = 1; i < failures && delay < CONNECTION_BACKOFF_MAX_MS; i++) delay *= 2;
+    if (delay > CONNECTION_BACKOFF_MAX_MS) delay = CONNECTION_BACKOFF_MAX_MS;
+
+    return delay / 2 + hal_random_32() % (delay / 2 + 1);
+}
+
+// Inicia uma tentativa de conexão
+static void connection_attempt(ConnectionManager *manager) {
+    manager->state = CONNECTION_CONNECTING;
+    manager->stats.attempts++;
+
+    sys_untimeout(connection_attempt_timeout, manager);
+    if (!manager->start()) {
+        connection_lost(manager);
+        return;
+    }
+    sys_timeout(CONNECTION_ATTEMPT_TIMEOUT_MS, connection_attempt_timeout, manager);
+}
+
+// Timer do backoff ou do circuito aberto: hora de tentar de novo
+static void connection_timer(void *arg) {
+    ConnectionManager *manager = arg;
+
+    if (manager->state != CONNECTION_BACKOFF && manager->state != CONNECTION_CIRCUIT_OPEN) return;
+    if (manager->state == CONNECTION_CIRCUIT_OPEN) {
+        LOG_INFO("%s: circuito meio aberto, tentativa de teste\n", manager->name);
+    }
+    connection_attempt(manager);
+}
+
+// Timer da tentativa: sem resposta a tempo, ela é abortada e contada como falha
+static void connection_attempt_timeout(void *arg) {
+    ConnectionManager *manager = arg;
+
+    if (manager->state != CONNECTION_CONNECTING) return;
+    LOG_WARN("%s: tempo de conexao esgotado\n", manager->name);
+    manager->abort();
+    connection_lost(manager);
+}
+
+void connection_init(ConnectionManager *manager, const char *name, connection_start_fn start, connection_abort_fn abort) {
+    manager->name = name;
+    manager->start = start;
+    manager->abort = abort;
+    manager->state = CONNECTION_IDLE;
+    manager->wanted = false;
+    manager->failures = 0;
+    manager->retry_at_ms = 0;
+    manager->stats = (ConnectionStats) {0};
+}
+
+void connection_request(ConnectionManager *manager) {
+    manager->wanted = true;
+    if (manager->state == CONNECTION_IDLE) connection_attempt(manager);
+}
+
+void connection_connected(ConnectionManager *manager) {
+    sys_untimeout(connection_attempt_timeout, manager);
+    sys_untimeout(connection_timer, manager);
+
+    if (manager->failures >= CONNECTION_BREAKER_THRESHOLD) {
+        LOG_INFO("%s: circuito fechado\n", manager->name);
+    }
+    manager->state = CONNECTION_CONNECTED;
+    manager->failures = 0;
+    manager->stats.connects++;
+}
+
+void connection_lost(ConnectionManager *manager) {
+    sys_untimeout(connection_attempt_timeout, manager);
+
+    if (manager->state == CONNECTION_CONNECTED) {
+        // queda de uma conexão estabelecida: reconecta após a espera base, sem contar como falha
+        manager->stats.drops++;
+        if (manager->wanted) connection_schedule(manager, CONNECTION_BACKOFF, connection_backoff_ms(1));
+        else manager->state = CONNECTION_IDLE;
+        return;
+    }
+    if (manager->state != CONNECTION_CONNECTING) return;   // aviso repetido da mesma falha
+
+    manager->stats.failures++;
+    if (manager->failures < UINT8_MAX) manager->failures++;
+
+    if (manager->failures >= CONNECTION_BREAKER_THRESHOLD) {
+        if (manager->failures == CONNECTION_BREAKER_THRESHOLD) {
+            manager->stats.circuit_opens++;
+            LOG_WARN("%s: %u falhas seguidas, circuito aberto por %lu s\n", manager->name, manager->failures,
+                     (unsigned long) (CONNECTION_BREAKER_COOLDOWN_MS / 1000));
+        }
+        connection_schedule(manager, CONNECTION_CIRCUIT_OPEN, CONNECTION_BREAKER_COOLDOWN_MS);
+        return;
+    }
+
+    uint32_t delay = connection_backoff_ms(manager->failures);
+    LOG_WARN("%s: falha na conexao (%u seguidas), nova tentativa em %lu ms\n", manager->name, manager->failures,
+             (unsigned long) delay);
+    connection_schedule(manager, CONNECTION_BACKOFF, delay);
+}
+
+void connection_release(ConnectionManager *manager) {
+    sys_untimeout(connection_attempt_timeout, manager);
+    sys_untimeout(connection_timer, manager);
+
+    // avisos de queda que o fechamento do transporte ainda gerar são ignorados no estado ocioso
+    manager->state = CONNECTION_IDLE;
+    manager->wanted = false;
+}
+
+ConnectionState connection_state(const ConnectionManager *manager) {
+    return manager->state;
+}
+
+uint32_t connection_retry_in_ms(const ConnectionManager *manager) {
+    if (manager->state != CONNECTION_BACKOFF && manager->state != CONNECTION_CIRCUIT_OPEN) return 0;
+
+    int32_t remaining = (int32_t) (manager->retry_at_ms - connection_now_ms());
+    return remaining > 0 ? (uint32_t) remaining : 0;
+}
+
+const char *connection_state_name(ConnectionState state) {
+    switch (state) {
+        case CONNECTION_IDLE: return "ociosa";
+        case CONNECTION_CONNECTING: return "conectando";
+        case CONNECTION_CONNECTED: return "conectada";
+        case CONNECTION_BACKOFF: return "aguardando";
+        case CONNECTION_CIRCUIT_OPEN: return "circuito aberto";
+        default: return "?";
+    }
+}
+
+void connection_get_stats(const ConnectionManager *manager, ConnectionStats *out) {
+    *out = manager->stats;
+}
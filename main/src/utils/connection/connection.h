@@ -0,0 +1,93 @@
+#ifndef CONNECTION_H
+#define CONNECTION_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+
+/**
+ * @file connection.h
+ *
+ * @brief Gerenciador de conexão não bloqueante, com backoff exponencial, jitter e circuit breaker.
+ *
+ * @note O transporte informa como iniciar e abortar uma tentativa e avisa o gerenciador quando a
+ * conexão é estabelecida ou perdida (nos seus callbacks do lwIP). O gerenciador agenda as novas
+ * tentativas com os timers do lwIP (sys_timeout), então o laço principal só pede a conexão
+ * (connection_request) e consulta o estado; ele nunca espera pela rede.
+ *
+ * Após CONNECTION_BREAKER_THRESHOLD falhas seguidas o circuito abre: nenhuma tentativa é feita por
+ * CONNECTION_BREAKER_COOLDOWN_MS e, em seguida, uma única tentativa de teste decide se ele fecha
+ * (sucesso) ou volta a abrir (falha).
+ *
+ * @warning Todas as funções devem ser chamadas com o lwIP travado (hal_lwip_begin/end) ou
+ * de dentro de um callback do lwIP.
+ */
+
+// espera antes da primeira nova tentativa; dobra a cada falha seguida, até o máximo
+#define CONNECTION_BACKOFF_BASE_MS 1000
+#define CONNECTION_BACKOFF_MAX_MS 60000
+
+// tempo máximo de uma tentativa antes de ela ser abortada e contada como falha
+#define CONNECTION_ATTEMPT_TIMEOUT_MS 10000
+
+// falhas seguidas que abrem o circuito e tempo que ele fica aberto
+#define CONNECTION_BREAKER_THRESHOLD 6
+#define CONNECTION_BREAKER_COOLDOWN_MS 300000
+
+// estados da conexão
+typedef enum {
+    CONNECTION_IDLE,            // sem conexão e sem tentativa agendada
+    CONNECTION_CONNECTING,      // tentativa em andamento
+    CONNECTION_CONNECTED,       // conexão estabelecida
+    CONNECTION_BACKOFF,         // aguardando a próxima tentativa
+    CONNECTION_CIRCUIT_OPEN     // muitas falhas seguidas: tentativas suspensas
+} ConnectionState;
+
+// inicia uma tentativa sem bloquear; false se ela falhou de imediato
+typedef bool (*connection_start_fn)(void);
+// aborta a tentativa em andamento (sem avisar o gerenciador)
+typedef void (*connection_abort_fn)(void);
+
+// estatísticas de um gerenciador
+typedef struct {
+    uint32_t attempts;          // tentativas iniciadas
+    uint32_t connects;          // tentativas bem-sucedidas
+    uint32_t failures;          // tentativas que falharam (inclusive por timeout)
+    uint32_t drops;             // conexões estabelecidas que caíram
+    uint32_t circuit_opens;     // vezes que o circuito abriu
+} ConnectionStats;
+
+// gerenciador de uma conexão
+typedef struct {
+    const char *name;               // nome usado nas mensagens de log
+    connection_start_fn start;
+    connection_abort_fn abort;
+    ConnectionState state;
+    bool wanted;                    // algum chamador pediu a conexão
+    uint8_t failures;               // falhas seguidas desde a última conexão
+    uint32_t retry_at_ms;           // instante da próxima tentativa (backoff ou circuito aberto)
+    ConnectionStats stats;
+} ConnectionManager;
+
+// definição das funções
+
+// configura o gerenciador com as funções do transporte
+void connection_init(ConnectionManager *manager, const char *name, connection_start_fn start, connection_abort_fn abort);
+// pede a conexão: inicia uma tentativa se estiver ocioso; em backoff ou com o circuito aberto, aguarda o timer
+void connection_request(ConnectionManager *manager);
+// avisa que a conexão foi estabelecida
+void connection_connected(ConnectionManager *manager);
+// avisa que a tentativa falhou ou que a conexão caiu
+void connection_lost(ConnectionManager *manager);
+// desiste da conexão por decisão própria (ex.: rádio desligado entre janelas): volta a ociosa, sem
+// contar falha e sem agendar nova tentativa; quem chama fecha o transporte
+void connection_release(ConnectionManager *manager);
+// estado atual
+ConnectionState connection_state(const ConnectionManager *manager);
+// tempo até a próxima tentativa agendada (0 se não houver)
+uint32_t connection_retry_in_ms(const ConnectionManager *manager);
+// nome do estado, para o log
+const char *connection_state_name(ConnectionState state);
+// copia as estatísticas do gerenciador
+void connection_get_stats(const ConnectionManager *manager, ConnectionStats *out);
+
+#endif
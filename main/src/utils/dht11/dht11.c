@@ -1,4 +1,6 @@
-#include "DHT11.h"
+#include "dht11.h"
+#include "prof.h"
+#include "log.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -20,7 +22,7 @@
  * para garantir que o pino esteja devidamente configurado.
  */
 void dht11_init() {
-    gpio_init(DHT_PIN);
+    hal_gpio_init(DHT_PIN);
 }
 
 /**
@@ -35,17 +37,17 @@ void dht11_init() {
  * e separa os bits de temp e humid.
  */
 static uint32_t dht11_read_pulse(bool level) {  
-    uint32_t init = time_us_32();
+    uint32_t init = hal_time_us();
 
     // Se o nível atual passar o tempo limite sem mudar, interrompe o loop
-    while(gpio_get(DHT_PIN) == level) {
-        if(time_us_32() - init > TIMEOUT_DHT) {
+    while(hal_gpio_get(DHT_PIN) == level) {
+        if(hal_time_us() - init > TIMEOUT_DHT) {
             return TIMEOUT_DHT;
         }
     }
 
     // Se o nível mudar no tempo padrão, calcula o tempo que o DHT passou em um pulso específico
-    return time_us_32() - init;
+    return hal_time_us() - init;
 }
 
 /**
@@ -55,12 +57,12 @@ static uint32_t dht11_read_pulse(bool level) {
  *
  */
 void dht11_send_pulse_start() {
-    gpio_set_dir(DHT_PIN, GPIO_OUT);
-    gpio_put(DHT_PIN, 0);
-    sleep_ms(18);
-    gpio_put(DHT_PIN, 1);
-    sleep_us(30);
-    gpio_set_dir(DHT_PIN, GPIO_IN);
+    hal_gpio_set_output(DHT_PIN, true);
+    hal_gpio_put(DHT_PIN, 0);
+    hal_sleep_ms(18);
+    hal_gpio_put(DHT_PIN, 1);
+    hal_sleep_us(30);
+    hal_gpio_set_output(DHT_PIN, false);
 }
 
 /**
@@ -77,7 +79,7 @@ bool dht11_read_dht11_data(uint8_t *data) {
 
     // Se os pulsos de inicialização forem igual ao limite, falha na leitura
     if (dht11_read_pulse(0) == TIMEOUT_DHT || dht11_read_pulse(1) == TIMEOUT_DHT) {
-        printf("Error: No sensor DHT11 response");
+        LOG_WARN("Error: No sensor DHT11 response\n");
         return false;
     }
 
@@ -85,14 +87,14 @@ bool dht11_read_dht11_data(uint8_t *data) {
     for (int i = 0; i < 40; i++) {
         // Cada bit de dados, começa pelo pulso baixo e se chegar no tempo limite, falha.
         if (dht11_read_pulse(0) == TIMEOUT_DHT) {
-            printf("Error: Low pulse too long");
+            LOG_WARN("Error: Low pulse too long\n");
             return false;
         }
 
         // O próximo nível é o alto, 
         uint32_t pulse_duration = dht11_read_pulse(1);
         if (pulse_duration == TIMEOUT_DHT) {
-            printf("Error: High pulse too long");
+            LOG_WARN("Error: High pulse too long\n");
             return false;
         }
 
@@ -105,7 +107,7 @@ bool dht11_read_dht11_data(uint8_t *data) {
     // Soma dos 4 primeiros bits do vetor deve ser igual ao checksum(bit de verificação) enviado para verificar se a leitura está correta.
     uint8_t checksum = data[0] + data[1] + data[2] + data[3];
     if (checksum != data[4]) {
-        printf("Erro: Invalid checksum\n");
+        LOG_WARN("Erro: Invalid checksum\n");
         return false;
     }
 
@@ -121,7 +123,8 @@ bool dht11_read_dht11_data(uint8_t *data) {
  * @return true se a leitura e conversão forem bem-sucedidas; false em caso de erro.
  */
 bool dht11_get(int *temperature, int *humidity) {
-    
+    PROF_SCOPE(PROF_DHT11_READ);
+
     // Obtém dados brutos e armazena no vetor
     uint8_t data[5];
 
@@ -2,7 +2,7 @@
 #define DHT11_H
 
 // inclusão de bibliotecas
-#include "pico/stdlib.h"
+#include "hal.h"
 
 // PINO PARA O DHT
 #define DHT_PIN 18
@@ -1,25 +1,26 @@
 #include "display.h"
+#include "format.h"
+#include "prof.h"
+#include "log.h"
 #include <stdio.h>
 #include <string.h>
 
 
 void display_init() {
-    i2c_init(i2c1, 400 * 1000);
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
-
-    if (!ssd1306_init(&display, SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_ADDRESS, i2c1)) {
-        printf("Falha ao inicializar display SSD1306\n");
+    hal_i2c_init(HAL_I2C1, 400 * 1000, I2C_SDA, I2C_SCL);
+
+    if (!ssd1306_init(&display, SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_ADDRESS, HAL_I2C1)) {
+        LOG_ERROR("Falha ao inicializar display SSD1306\n");
     }
 }
 
-void display_write(const char *msg, uint x, uint y, uint size) {
+void display_write(const char *msg, uint32_t x, uint32_t y, uint32_t size) {
+    PROF_SCOPE(PROF_DISPLAY_DRAW);
     ssd1306_draw_string(&display, x, y, size, msg);
 }
 
 void display_show() {
+    PROF_SCOPE(PROF_DISPLAY_FLUSH);
     ssd1306_show(&display);
 }
 
@@ -42,13 +43,13 @@ void display_message(const char *message) {
         strncpy(temp_msg, message + start, len);
         temp_msg[len] = '\0';  // Garantir a terminação nula
 
-        ssd1306_draw_string(&display, 0, line * 10, 1, temp_msg);
+        display_write(temp_msg, 0, line * 10, 1);
         line++;
 
         start += len;
     }
 
-    ssd1306_show(&display);
+    display_show();
 
 }
 
@@ -58,12 +59,15 @@ void display_data(int temperature, int humidty, const char* alert_msg) {
 
     ssd1306_clear(&display);
 
-    snprintf(buffer, sizeof(buffer), "Temperatura: %d °C", temperature);
-    ssd1306_draw_string(&display, 0, line * 10, 1, buffer);
+    char number[12];
+    format_int(number, sizeof(number), temperature, 0);
+    format_line(buffer, sizeof(buffer), "Temperatura: ", number, " °C");
+    display_write(buffer, 0, line * 10, 1);
     line++;
 
-    snprintf(buffer, sizeof(buffer), "Humidade: %d %%", humidty);
-    ssd1306_draw_string(&display, 0, line * 10, 1, buffer);
+    format_int(number, sizeof(number), humidty, 0);
+    format_line(buffer, sizeof(buffer), "Humidade: ", number, " %");
+    display_write(buffer, 0, line * 10, 1);
     line++;
 
     // Quebra a mensagem de alerta em várias linhas, se necessário
@@ -75,13 +79,13 @@ void display_data(int temperature, int humidty, const char* alert_msg) {
         strncpy(temp_msg, alert_msg + start, len);
         temp_msg[len] = '\0';  // Garantir a terminação nula
 
-        ssd1306_draw_string(&display, 0, line * 10, 1, temp_msg);
+        display_write(temp_msg, 0, line * 10, 1);
         line++;
 
         start += len;
     }
 
-    ssd1306_show(&display);
+    display_show();
 }
 
 void display_initial_screen() {
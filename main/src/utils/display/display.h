@@ -1,7 +1,7 @@
 #ifndef DISPLAY_H
 #define DISPLAY_H
 
-#include "pico/stdlib.h"
+#include "hal.h"
 #include "ssd1306.h" // Controla o display OLED SSD1306 para exibir informações na tela
 
 // Definições do display SSD1306
@@ -13,7 +13,7 @@ static ssd1306_t display;
 #define I2C_SCL 15
 
 void display_init();
-void display_write(const char *msg, uint x, uint y, uint size);
+void display_write(const char *msg, uint32_t x, uint32_t y, uint32_t size);
 void display_show();
 void display_clear();
 
@@ -0,0 +1,106 @@
+#include "format.h"
+
+#include <math.h>
+#include <stdbool.h>
+
+// potências de 10 usadas para escalar floats
+static const uint32_t powers_of_10[FORMAT_MAX_PRECISION + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+// implementação das funções
+
+// Escreve o módulo do número com o ponto decimal, o sinal e o preenchimento; base de todas as funções
+static int format_decimal(char *buffer, size_t size, uint32_t magnitude, bool negative, uint8_t decimals, uint8_t width) {
+    // os dígitos são gerados do menos para o mais significativo
+    char digits[12];
+    int count = 0;
+
+    do {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    // garante ao menos um dígito antes do ponto (0.05 e não .05)
+    while (count <= decimals) digits[count++] = '0';
+
+    int length = count + (decimals > 0) + negative;
+    int padding = width > length ? width - length : 0;
+
+    if ((size_t) (padding + length) >= size) {
+        if (size > 0) buffer[0] = '\0';
+        return -1;
+    }
+
+    char *out = buffer;
+    while (padding-- > 0) *out++ = ' ';
+    if (negative) *out++ = '-';
+    while (count > 0) {
+        if (count == decimals) *out++ = '.';
+        *out++ = digits[--count];
+    }
+    *out = '\0';
+
+    return out - buffer;
+}
+
+int format_uint(char *buffer, size_t size, uint32_t value, uint8_t width) {
+    return format_decimal(buffer, size, value, false, 0, width);
+}
+
+int format_int(char *buffer, size_t size, int32_t value, uint8_t width) {
+    // o módulo é calculado em 32 bits sem sinal para aceitar INT32_MIN
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t) value : (uint32_t) value;
+    return format_decimal(buffer, size, magnitude, value < 0, 0, width);
+}
+
+int format_fixed(char *buffer, size_t size, int32_t value, uint8_t decimals, uint8_t width) {
+    if (decimals > FORMAT_MAX_PRECISION) decimals = FORMAT_MAX_PRECISION;
+
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t) value : (uint32_t) value;
+    return format_decimal(buffer, size, magnitude, value < 0, decimals, width);
+}
+
+int format_float(char *buffer, size_t size, float value, uint8_t precision, uint8_t width) {
+    if (precision > FORMAT_MAX_PRECISION) precision = FORMAT_MAX_PRECISION;
+
+    // NaN não é comparável: é escrito como texto, como faria o printf
+    if (value != value) return format_str(buffer, size, "nan");
+
+    // uma multiplicação e uma conversão em float; o restante é aritmética inteira. O sinal vem do bit
+    // de sinal (signbit é uma macro, sem custo de libm), então -0.0 é negativo como no printf
+    bool negative = signbit(value);
+    float scaled = (negative ? -value : value) * powers_of_10[precision] + 0.5f;
+    uint32_t magnitude = scaled >= 4294967040.0f ? UINT32_MAX : (uint32_t) scaled;
+
+    // -0.0 e os negativos que arredondam para zero são escritos com sinal ("-0.0"), como no printf
+    return format_decimal(buffer, size, magnitude, negative, precision, width);
+}
+
+int format_str(char *buffer, size_t size, const char *text) {
+    size_t length = 0;
+
+    while (text[length] != '\0') {
+        if (length + 1 >= size) {
+            if (size > 0) buffer[0] = '\0';
+            return -1;
+        }
+        buffer[length] = text[length];
+        length++;
+    }
+    if (size == 0) return -1;
+
+    buffer[length] = '\0';
+    return length;
+}
+
+int format_line(char *buffer, size_t size, const char *label, const char *value, const char *unit) {
+    int label_length = format_str(buffer, size, label);
+    if (label_length < 0) return -1;
+
+    int value_length = format_str(buffer + label_length, size - label_length, value);
+    if (value_length < 0) return -1;
+
+    int unit_length = format_str(buffer + label_length + value_length, size - label_length - value_length, unit);
+    if (unit_length < 0) return -1;
+
+    return label_length + value_length + unit_length;
+}
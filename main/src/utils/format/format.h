@@ -0,0 +1,38 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+/**
+ * @file format.h
+ * @brief Conversão de inteiros e valores de ponto fixo para texto decimal, sem printf.
+ *
+ * Substitui o snprintf nos caminhos quentes (serialização JSON e telas do display): no RP2040
+ * (Cortex-M0+, sem FPU) o "%f" puxa o suporte a float do printf, que é grande e lento.
+ *
+ * Todas as funções escrevem em um buffer do chamador, sempre terminado em '\0', e retornam o
+ * número de caracteres escritos (sem o '\0') ou -1 se o texto não couber em @p size bytes.
+ * A largura @p width completa o texto com espaços à esquerda (0 = sem preenchimento).
+ */
+
+// inclusão de bibliotecas
+#include <stddef.h>
+#include <stdint.h>
+
+// maior número de casas decimais aceito por format_fixed e format_float
+#define FORMAT_MAX_PRECISION 6
+
+// definição das funções
+
+// escreve um inteiro sem sinal em decimal
+int format_uint(char *buffer, size_t size, uint32_t value, uint8_t width);
+// escreve um inteiro com sinal em decimal
+int format_int(char *buffer, size_t size, int32_t value, uint8_t width);
+// escreve um valor de ponto fixo: value é o número multiplicado por 10^decimals (ex.: 253, 1 -> "25.3")
+int format_fixed(char *buffer, size_t size, int32_t value, uint8_t decimals, uint8_t width);
+// escreve um float com precision casas decimais, arredondando; |value| * 10^precision deve caber em int32
+int format_float(char *buffer, size_t size, float value, uint8_t precision, uint8_t width);
+// copia um texto
+int format_str(char *buffer, size_t size, const char *text);
+// monta "<label><value><unit>" (ex.: "Umidade: " + "61" + " %"), com o valor já convertido para texto
+int format_line(char *buffer, size_t size, const char *label, const char *value, const char *unit);
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef HAL_H
+#define HAL_H
+
+// inclusão de bibliotecas
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file hal.h
+ *
+ * @brief Camada de abstração do hardware: relógio, espera por eventos, interrupções, GPIO, ADC, I2C,
+ * terminal serial e o enlace Wi-Fi (netif do lwIP). Os módulos da estação falam só com ela, sem incluir
+ * os cabeçalhos do Pico SDK, e a mesma aplicação compila para a placa e para o computador.
+ *
+ * @note No dispositivo (PICO_ON_DEVICE = 1, hal_pico.c) cada função repassa ao SDK e ao driver cyw43.
+ * Fora dele (hal_host.c e hal_net_host.c) a estação roda num simulador com relógio virtual: o tempo só
+ * anda com o trabalho simulado (esperas ativas, pulsos do DHT11, bytes no I2C) e, com a CPU ociosa, salta
+ * direto para o próximo prazo, ação do roteiro ou timer do lwIP. Enquanto uma requisição real estiver em
+ * andamento na rede, o relógio virtual acompanha o tempo real de espera pelos sockets.
+ *
+ * O simulador emula o DHT11 (forma de onda completa, lida pelo mesmo bit-banging do firmware), valores
+ * roteirizados no ADC, botões com borda e interrupção, o SSD1306 no I2C (framebuffer reconstruído a
+ * partir dos comandos) e o lwIP raw API ligado a sockets do sistema, para falar com um servidor local.
+ * As funções hal_sim_* só existem fora do dispositivo.
+ *
+ * @warning As funções de rede (hal_net_*) seguem a regra do lwIP: fora dos callbacks da pilha, chamá-las
+ * com o lwIP travado (hal_lwip_begin/end).
+ */
+
+// bordas da interrupção de GPIO (mesmos valores do SDK)
+#define HAL_GPIO_EDGE_FALL 0x4u
+#define HAL_GPIO_EDGE_RISE 0x8u
+
+// barramentos I2C
+#define HAL_I2C0 0
+#define HAL_I2C1 1
+
+// erros de hal_i2c_write (mesmos valores de PICO_ERROR_GENERIC, endereço sem ACK, e PICO_ERROR_TIMEOUT)
+#define HAL_I2C_ERROR_NACK -1
+#define HAL_I2C_ERROR_TIMEOUT -2
+
+// hal_getchar sem caractere disponível
+#define HAL_NO_CHAR -1
+
+// espera por evento sem prazo
+#define HAL_WAIT_FOREVER UINT32_MAX
+
+// contador de ciclos de 24 bits (SysTick): dá a volta a cada 2^24 ciclos (~134 ms a 125 MHz)
+#define HAL_CYCLE_COUNT_MASK 0xFFFFFFu
+
+// associação sem AP guardado (canal desconhecido: varredura completa)
+#define HAL_NET_CHANNEL_ANY 0xffffffffu
+
+// segurança da rede (mesmo valor de CYW43_AUTH_WPA2_AES_PSK)
+#define HAL_NET_AUTH_WPA2 0x00400004u
+
+// estado do enlace (os mesmos valores de CYW43_LINK_*)
+typedef enum {
+    HAL_LINK_BADAUTH = -3,      // senha recusada
+    HAL_LINK_NONET = -2,        // rede não encontrada
+    HAL_LINK_FAIL = -1,         // falha na associação
+    HAL_LINK_DOWN = 0,          // sem associação
+    HAL_LINK_JOIN = 1,          // associado, sem IP
+    HAL_LINK_NOIP = 2,          // associado, DHCP em andamento
+    HAL_LINK_UP = 3,            // associado e com IP
+} HalLinkStatus;
+
+// barreira do compilador entre a interrupção e o código principal (filas de um produtor e um consumidor)
+#define HAL_MEMORY_BARRIER() __asm__ volatile("" ::: "memory")
+
+typedef void (*HalGpioIrq)(uint32_t pin, uint32_t edges);
+
+struct netif;
+
+// definição das funções
+
+// relógio: 32 bits do timer de 1 µs (dá a volta em ~71 min), 64 bits e ms desde o boot
+uint32_t hal_time_us(void);
+uint64_t hal_time_us_64(void);
+uint32_t hal_time_ms(void);
+// ciclos do clk_sys (crescente, módulo HAL_CYCLE_COUNT_MASK + 1) e a frequência do clk_sys, para medir
+// trechos curtos com mais resolução do que o timer de 1 µs
+uint32_t hal_cycle_count(void);
+uint32_t hal_cpu_hz(void);
+// esperas ativas (a CPU fica ocupada)
+void hal_sleep_ms(uint32_t ms);
+void hal_sleep_us(uint32_t us);
+
+// dorme até um evento (interrupção ou hal_signal_event) ou até timeout_ms (HAL_WAIT_FOREVER sem prazo)
+void hal_wait_for_event(uint32_t timeout_ms);
+// acorda hal_wait_for_event, mesmo que o sinal chegue antes dela começar
+void hal_signal_event(void);
+
+// desliga as interrupções; devolve o estado anterior para hal_irq_restore
+uint32_t hal_irq_disable(void);
+void hal_irq_restore(uint32_t state);
+
+// GPIO
+void hal_gpio_init(uint32_t pin);
+void hal_gpio_set_output(uint32_t pin, bool output);
+void hal_gpio_put(uint32_t pin, bool level);
+bool hal_gpio_get(uint32_t pin);
+void hal_gpio_pull_up(uint32_t pin);
+// interrupção nas bordas do pino; o callback é um só para todos os pinos (o último registrado vale)
+void hal_gpio_set_irq(uint32_t pin, uint32_t edges, HalGpioIrq callback);
+
+// ADC: prepara o pino como entrada analógica (o bloco é iniciado uma vez só) e lê um canal (0 a 4095)
+void hal_adc_init(uint32_t pin);
+uint16_t hal_adc_read(uint8_t channel);
+
+// I2C: inicia o barramento nos pinos com pull-up; hal_i2c_write devolve os bytes escritos ou HAL_I2C_ERROR_*
+void hal_i2c_init(uint8_t bus, uint32_t baudrate, uint32_t sda, uint32_t scl);
+int hal_i2c_write(uint8_t bus, uint8_t address, const uint8_t *data, size_t length);
+
+// número aleatório de 32 bits
+uint32_t hal_random_32(void);
+
+// terminal serial: o callback avisa que chegaram caracteres (pode rodar numa interrupção)
+void hal_stdio_init(void (*chars_available)(void *), void *param);
+// próximo caractere recebido, sem esperar; HAL_NO_CHAR se não houver
+int hal_getchar(void);
+
+// rede: inicia o chip em modo cliente; false se não foi possível
+bool hal_net_init(void);
+// trava e destrava o lwIP fora dos seus callbacks
+void hal_lwip_begin(void);
+void hal_lwip_end(void);
+// inicia a associação (bssid NULL e HAL_NET_CHANNEL_ANY: varredura completa); 0 ou o erro do driver
+int hal_net_join(const char *ssid, const char *password, uint32_t auth, const uint8_t *bssid, uint32_t channel);
+void hal_net_leave(void);
+HalLinkStatus hal_net_link_status(void);
+// BSSID e canal do AP associado; false se não estiver associado
+bool hal_net_get_ap(uint8_t bssid[6], uint32_t *channel);
+// netif do modo cliente
+struct netif *hal_net_netif(void);
+// liga e desliga a interface do modo cliente; desligada, o rádio do chip fica parado (nem beacons nem
+// varreduras) e a netif sai do lwIP, voltando ao ligar sem os callbacks registrados nela
+void hal_net_set_power(bool on);
+
+#if !PICO_ON_DEVICE
+
+#include <stdio.h>
+
+// simulador: ação do roteiro, rodada como uma interrupção no instante marcado
+typedef void (*HalSimAction)(void *arg);
+
+// ações do roteiro pendentes ao mesmo tempo
+#define HAL_SIM_MAX_ACTIONS 32
+
+// simulador do DHT11: custo de cada leitura do pino no laço de bit-banging
+#define HAL_SIM_GPIO_READ_US 1
+// simulador do I2C: tempo de um byte a 400 kHz (9 bits)
+#define HAL_SIM_I2C_BYTE_US 23
+
+// ganchos da rede simulada (hal_net_host.c), chamados com a CPU ociosa
+typedef struct {
+    // roda os timers do lwIP vencidos e atende os sockets sem esperar; true com uma requisição em
+    // andamento (o relógio deve acompanhar o tempo real); *next_us recebe o próximo timer (ou UINT64_MAX)
+    bool (*service)(uint64_t now_us, uint64_t *next_us);
+    // espera até wait_us reais por atividade nos sockets
+    void (*wait)(uint32_t wait_us);
+} HalSimNet;
+
+// avança o relógio virtual (trabalho da CPU), rodando as ações que vencerem no caminho
+void hal_sim_advance_us(uint64_t us);
+// agenda uma ação do roteiro para o instante at_us do relógio virtual; false sem vaga
+bool hal_sim_schedule(uint64_t at_us, HalSimAction action, void *arg);
+// valores devolvidos pelo DHT11 simulado (sem resposta: o sensor não puxa a linha)
+void hal_sim_set_dht11(uint32_t pin, int temperature, int humidity, bool responding);
+// valor do canal do ADC (padrão: 2048, o meio da escala)
+void hal_sim_set_adc(uint8_t channel, uint16_t value);
+// botão ligado ao GND no pino: muda o nível e gera a interrupção da borda
+void hal_sim_set_button(uint32_t pin, bool pressed);
+// caracteres "digitados" no terminal serial
+void hal_sim_type(const char *text);
+// imprime o framebuffer do display emulado em texto (um caractere por bloco de 2x4 pixels)
+void hal_sim_display_dump(FILE *file);
+// bytes enviados ao display emulado
+uint64_t hal_sim_display_bytes(void);
+// liga a rede simulada à espera ociosa
+void hal_sim_set_net(const HalSimNet *net);
+// AP simulado no ar ou fora do ar (fora: o enlace cai e as associações falham com HAL_LINK_NONET)
+void hal_sim_set_ap(bool available);
+// tempo total da CPU ociosa no relógio virtual
+uint64_t hal_sim_idle_us(void);
+
+#endif
+
+#endif
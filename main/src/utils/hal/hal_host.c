@@ -0,0 +1,456 @@
+#if !PICO_ON_DEVICE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "hal.h"
+
+#if !PICO_ON_DEVICE
+
+#include <string.h>
+#include <time.h>
+
+// pinos do RP2040 e clk_sys padrão
+#define HAL_SIM_PINS 30
+#define HAL_SIM_CPU_HZ 125000000u
+// canais do ADC (quatro entradas e o sensor de temperatura interno)
+#define HAL_SIM_ADC_CHANNELS 5
+// conversão do ADC
+#define HAL_SIM_ADC_READ_US 2
+// espera real máxima por volta com uma requisição em andamento
+#define HAL_SIM_NET_WAIT_US 10000
+
+// DHT11: atraso da resposta após a soltura da linha, pulsos de resposta e de cada bit
+#define HAL_SIM_DHT_DELAY_US 20
+#define HAL_SIM_DHT_RESPONSE_US 80
+#define HAL_SIM_DHT_BIT_LOW_US 50
+#define HAL_SIM_DHT_ZERO_US 27
+#define HAL_SIM_DHT_ONE_US 70
+
+// SSD1306 emulado: endereço, geometria e o byte de controle dos dados (o resto são comandos)
+#define HAL_SIM_DISPLAY_ADDRESS 0x3C
+#define HAL_SIM_DISPLAY_WIDTH 128
+#define HAL_SIM_DISPLAY_PAGES 8
+#define HAL_SIM_DISPLAY_DATA 0x40
+
+// terminal serial simulado
+#define HAL_SIM_STDIN_SIZE 256
+
+// estado de um pino
+typedef struct {
+    bool output;
+    bool level;                 // nível escrito (saída)
+    bool pull_up;
+    bool grounded;              // botão pressionado puxando a entrada para o GND
+    uint32_t irq_edges;
+} HalSimPin;
+
+// ação do roteiro
+typedef struct {
+    bool used;
+    uint64_t at_us;
+    HalSimAction action;
+    void *arg;
+} HalSimScheduled;
+
+// relógio virtual e interrupções
+static uint64_t virtual_us = 0;
+static uint64_t idle_us = 0;
+static bool irq_enabled = true;
+static bool in_irq = false;
+static bool event_pending = false;
+
+static HalSimScheduled actions[HAL_SIM_MAX_ACTIONS];
+
+static HalSimPin pins[HAL_SIM_PINS];
+static HalGpioIrq gpio_callback = NULL;
+
+// DHT11 simulado
+static int dht_pin = -1;
+static uint8_t dht_frame[5];
+static bool dht_responding = true;
+static bool dht_started = false;
+static uint64_t dht_start_us = 0;
+
+static uint16_t adc_values[HAL_SIM_ADC_CHANNELS] = {2048, 2048, 2048, 2048, 2048};
+
+// SSD1306 emulado: RAM do display e o estado do parser de comandos
+static uint8_t display_ram[HAL_SIM_DISPLAY_PAGES][HAL_SIM_DISPLAY_WIDTH];
+static uint8_t display_command = 0;
+static uint8_t display_args[2];
+static uint8_t display_arg_count = 0;
+static uint8_t display_args_wanted = 0;
+static uint8_t display_col_start = 0, display_col_end = HAL_SIM_DISPLAY_WIDTH - 1;
+static uint8_t display_page_start = 0, display_page_end = HAL_SIM_DISPLAY_PAGES - 1;
+static uint8_t display_col = 0, display_page = 0;
+static uint64_t display_bytes = 0;
+
+static char stdin_buffer[HAL_SIM_STDIN_SIZE];
+static uint32_t stdin_head = 0, stdin_tail = 0;
+static void (*stdin_callback)(void *) = NULL;
+static void *stdin_param = NULL;
+
+static uint32_t random_state = 0x2545f491u;
+
+static const HalSimNet *net = NULL;
+
+// implementação das funções
+
+// Ação do roteiro mais próxima; UINT64_MAX sem nenhuma
+static uint64_t hal_sim_next_action_us(void) {
+    uint64_t next = UINT64_MAX;
+    for (uint32_t i = 0; i < HAL_SIM_MAX_ACTIONS; i++) {
+        if (actions[i].used && actions[i].at_us < next) next = actions[i].at_us;
+    }
+    return next;
+}
+
+// Roda, como interrupções, as ações vencidas (não com as interrupções desligadas nem dentro de outra)
+static void hal_sim_run_due(void) {
+    while (irq_enabled && !in_irq) {
+        HalSimScheduled *due = NULL;
+        for (uint32_t i = 0; i < HAL_SIM_MAX_ACTIONS; i++) {
+            if (!actions[i].used || actions[i].at_us > virtual_us) continue;
+            if (due == NULL || actions[i].at_us < due->at_us) due = &actions[i];
+        }
+        if (due == NULL) return;
+
+        HalSimScheduled action = *due;
+        due->used = false;
+        in_irq = true;
+        action.action(action.arg);
+        in_irq = false;
+
+        // a entrada e a saída de uma interrupção acordam o __wfe()
+        event_pending = true;
+    }
+}
+
+// Tempo real, para acompanhar a espera pelos sockets
+static uint64_t hal_sim_real_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000u + now.tv_nsec / 1000;
+}
+
+void hal_sim_advance_us(uint64_t us) {
+    uint64_t target = virtual_us + us;
+    while (true) {
+        uint64_t next = irq_enabled && !in_irq ? hal_sim_next_action_us() : UINT64_MAX;
+        if (next > target) break;
+        if (next > virtual_us) virtual_us = next;
+        hal_sim_run_due();
+    }
+    virtual_us = target;
+}
+
+bool hal_sim_schedule(uint64_t at_us, HalSimAction action, void *arg) {
+    for (uint32_t i = 0; i < HAL_SIM_MAX_ACTIONS; i++) {
+        if (actions[i].used) continue;
+        actions[i] = (HalSimScheduled) {true, at_us, action, arg};
+        return true;
+    }
+    return false;
+}
+
+uint32_t hal_time_us(void) {
+    return (uint32_t) virtual_us;
+}
+
+uint64_t hal_time_us_64(void) {
+    return virtual_us;
+}
+
+uint32_t hal_cycle_count(void) {
+    // CPU simulada de HAL_SIM_CPU_HZ, no relógio virtual
+    return (uint32_t) (virtual_us * (HAL_SIM_CPU_HZ / 1000000)) & HAL_CYCLE_COUNT_MASK;
+}
+
+uint32_t hal_cpu_hz(void) {
+    return HAL_SIM_CPU_HZ;
+}
+
+uint32_t hal_time_ms(void) {
+    return (uint32_t) (virtual_us / 1000);
+}
+
+void hal_sleep_ms(uint32_t ms) {
+    hal_sim_advance_us((uint64_t) ms * 1000);
+}
+
+void hal_sleep_us(uint32_t us) {
+    hal_sim_advance_us(us);
+}
+
+// CPU ociosa: salta até o próximo prazo, ação do roteiro ou timer do lwIP; com uma requisição em
+// andamento, espera pelos sockets em tempo real
+void hal_wait_for_event(uint32_t timeout_ms) {
+    uint64_t started = virtual_us;
+    uint64_t deadline = timeout_ms == HAL_WAIT_FOREVER ? UINT64_MAX : virtual_us + (uint64_t) timeout_ms * 1000;
+
+    while (!event_pending && virtual_us < deadline) {
+        uint64_t next = deadline;
+        bool in_flight = false;
+        if (net != NULL) {
+            uint64_t net_next = UINT64_MAX;
+            in_flight = net->service(virtual_us, &net_next);
+            if (event_pending) break;
+            if (net_next < next) next = net_next;
+        }
+        uint64_t action_at = hal_sim_next_action_us();
+        if (action_at < next) next = action_at;
+
+        if (in_flight) {
+            uint64_t wait = next == UINT64_MAX ? HAL_SIM_NET_WAIT_US : next > virtual_us ? next - virtual_us : 0;
+            if (wait > HAL_SIM_NET_WAIT_US) wait = HAL_SIM_NET_WAIT_US;
+            uint64_t real_started = hal_sim_real_us();
+            net->wait((uint32_t) wait);
+            uint64_t elapsed = hal_sim_real_us() - real_started;
+            hal_sim_advance_us(elapsed < wait ? elapsed : wait);
+        } else if (next == UINT64_MAX) {
+            // nada mais pode acontecer: no dispositivo o núcleo dormiria para sempre
+            break;
+        } else {
+            hal_sim_advance_us(next > virtual_us ? next - virtual_us : 0);
+        }
+    }
+    event_pending = false;
+    idle_us += virtual_us - started;
+}
+
+void hal_signal_event(void) {
+    event_pending = true;
+}
+
+uint32_t hal_irq_disable(void) {
+    uint32_t state = irq_enabled;
+    irq_enabled = false;
+    return state;
+}
+
+void hal_irq_restore(uint32_t state) {
+    irq_enabled = state != 0;
+    // interrupções que chegaram com elas desligadas rodam agora
+    hal_sim_run_due();
+}
+
+void hal_gpio_init(uint32_t pin) {
+    // o botão pressionado é externo ao pino: continua puxando a linha
+    if (pin < HAL_SIM_PINS) pins[pin] = (HalSimPin) {.grounded = pins[pin].grounded};
+}
+
+void hal_gpio_set_output(uint32_t pin, bool output) {
+    if (pin < HAL_SIM_PINS) pins[pin].output = output;
+}
+
+void hal_gpio_put(uint32_t pin, bool level) {
+    if (pin >= HAL_SIM_PINS) return;
+
+    // soltura da linha do DHT11 depois do pulso de início: a resposta começa em seguida
+    if ((int) pin == dht_pin && pins[pin].output) {
+        if (level && !pins[pin].level) {
+            dht_started = true;
+            dht_start_us = virtual_us + HAL_SIM_DHT_DELAY_US;
+        } else if (!level) {
+            dht_started = false;
+        }
+    }
+    pins[pin].level = level;
+}
+
+// Nível da linha do DHT11 no instante atual: resposta (80 µs baixo e 80 µs alto), 40 bits
+// (50 µs baixo e 27 ou 70 µs alto) e o pulso baixo final; fora da resposta a linha fica alta
+static bool hal_sim_dht_level(void) {
+    if (!dht_started || !dht_responding || virtual_us < dht_start_us) return true;
+
+    uint64_t t = virtual_us - dht_start_us;
+    if (t < HAL_SIM_DHT_RESPONSE_US) return false;
+    if (t < 2 * HAL_SIM_DHT_RESPONSE_US) return true;
+    t -= 2 * HAL_SIM_DHT_RESPONSE_US;
+
+    for (uint32_t bit = 0; bit < 40; bit++) {
+        if (t < HAL_SIM_DHT_BIT_LOW_US) return false;
+        t -= HAL_SIM_DHT_BIT_LOW_US;
+        uint64_t high = (dht_frame[bit / 8] >> (7 - bit % 8)) & 1 ? HAL_SIM_DHT_ONE_US : HAL_SIM_DHT_ZERO_US;
+        if (t < high) return true;
+        t -= high;
+    }
+    return t >= HAL_SIM_DHT_BIT_LOW_US;
+}
+
+bool hal_gpio_get(uint32_t pin) {
+    if (pin >= HAL_SIM_PINS) return false;
+
+    // cada leitura custa tempo de CPU: o laço de bit-banging anda no relógio virtual
+    hal_sim_advance_us(HAL_SIM_GPIO_READ_US);
+
+    const HalSimPin *state = &pins[pin];
+    if (state->output) return state->level;
+    if ((int) pin == dht_pin) return hal_sim_dht_level();
+    return state->grounded ? false : state->pull_up;
+}
+
+void hal_gpio_pull_up(uint32_t pin) {
+    if (pin < HAL_SIM_PINS) pins[pin].pull_up = true;
+}
+
+void hal_gpio_set_irq(uint32_t pin, uint32_t edges, HalGpioIrq callback) {
+    if (pin >= HAL_SIM_PINS) return;
+    pins[pin].irq_edges = edges;
+    gpio_callback = callback;
+}
+
+void hal_adc_init(uint32_t pin) {
+    (void) pin;
+}
+
+uint16_t hal_adc_read(uint8_t channel) {
+    hal_sim_advance_us(HAL_SIM_ADC_READ_US);
+    return channel < HAL_SIM_ADC_CHANNELS ? adc_values[channel] : 0;
+}
+
+void hal_i2c_init(uint8_t bus, uint32_t baudrate, uint32_t sda, uint32_t scl) {
+    (void) bus;
+    (void) baudrate;
+    hal_gpio_pull_up(sda);
+    hal_gpio_pull_up(scl);
+}
+
+// Argumentos de cada comando do SSD1306 usado pelo driver
+static uint8_t hal_sim_display_args(uint8_t command) {
+    switch (command) {
+        case 0x21: case 0x22:                   // janela de colunas e de páginas
+            return 2;
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void hal_sim_display_command(uint8_t byte) {
+    if (display_args_wanted == 0) {
+        display_command = byte;
+        display_arg_count = 0;
+        display_args_wanted = hal_sim_display_args(byte);
+        return;
+    }
+
+    display_args[display_arg_count++] = byte;
+    if (display_arg_count < display_args_wanted) return;
+    display_args_wanted = 0;
+
+    if (display_command == 0x21) {
+        display_col_start = display_args[0] % HAL_SIM_DISPLAY_WIDTH;
+        display_col_end = display_args[1] % HAL_SIM_DISPLAY_WIDTH;
+        display_col = display_col_start;
+    } else if (display_command == 0x22) {
+        display_page_start = display_args[0] % HAL_SIM_DISPLAY_PAGES;
+        display_page_end = display_args[1] % HAL_SIM_DISPLAY_PAGES;
+        display_page = display_page_start;
+    }
+}
+
+// Dado na RAM do display, com o endereçamento horizontal que o driver configura
+static void hal_sim_display_data(uint8_t byte) {
+    display_ram[display_page][display_col] = byte;
+    if (display_col++ < display_col_end) return;
+    display_col = display_col_start;
+    display_page = display_page < display_page_end ? display_page + 1 : display_page_start;
+}
+
+int hal_i2c_write(uint8_t bus, uint8_t address, const uint8_t *data, size_t length) {
+    (void) bus;
+    // endereço e dados no barramento a 400 kHz
+    hal_sim_advance_us((uint64_t) (length + 1) * HAL_SIM_I2C_BYTE_US);
+    if (address != HAL_SIM_DISPLAY_ADDRESS) return HAL_I2C_ERROR_NACK;
+    if (length == 0) return 0;
+
+    display_bytes += length;
+    bool is_data = data[0] == HAL_SIM_DISPLAY_DATA;
+    for (size_t i = 1; i < length; i++) {
+        if (is_data) hal_sim_display_data(data[i]);
+        else hal_sim_display_command(data[i]);
+    }
+    return (int) length;
+}
+
+void hal_sim_display_dump(FILE *file) {
+    static const char shades[] = " .:-=+*#%@";
+
+    // a orientação é a do framebuffer do driver (remapeamento de segmentos e de COM ignorados)
+    for (uint32_t y = 0; y < HAL_SIM_DISPLAY_PAGES * 8; y += 4) {
+        fputc('|', file);
+        for (uint32_t x = 0; x < HAL_SIM_DISPLAY_WIDTH; x += 2) {
+            uint32_t lit = 0;
+            for (uint32_t dy = 0; dy < 4; dy++) {
+                const uint8_t *page = display_ram[(y + dy) / 8];
+                lit += ((page[x] >> ((y + dy) % 8)) & 1) + ((page[x + 1] >> ((y + dy) % 8)) & 1);
+            }
+            fputc(shades[lit], file);
+        }
+        fputs("|\n", file);
+    }
+}
+
+uint64_t hal_sim_display_bytes(void) {
+    return display_bytes;
+}
+
+uint32_t hal_random_32(void) {
+    // xorshift32: determinístico, para simulações reproduzíveis
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+void hal_stdio_init(void (*chars_available)(void *), void *param) {
+    stdin_callback = chars_available;
+    stdin_param = param;
+}
+
+int hal_getchar(void) {
+    if (stdin_tail == stdin_head) return HAL_NO_CHAR;
+    return (unsigned char) stdin_buffer[stdin_tail++ % HAL_SIM_STDIN_SIZE];
+}
+
+void hal_sim_type(const char *text) {
+    while (*text != '\0' && stdin_head - stdin_tail < HAL_SIM_STDIN_SIZE) {
+        stdin_buffer[stdin_head++ % HAL_SIM_STDIN_SIZE] = *text++;
+    }
+    if (stdin_callback != NULL) stdin_callback(stdin_param);
+    event_pending = true;
+}
+
+void hal_sim_set_dht11(uint32_t pin, int temperature, int humidity, bool responding) {
+    dht_pin = (int) pin;
+    dht_responding = responding;
+    dht_frame[0] = (uint8_t) humidity;
+    dht_frame[1] = 0;
+    dht_frame[2] = (uint8_t) temperature;
+    dht_frame[3] = 0;
+    dht_frame[4] = (uint8_t) (dht_frame[0] + dht_frame[2]);
+}
+
+void hal_sim_set_adc(uint8_t channel, uint16_t value) {
+    if (channel < HAL_SIM_ADC_CHANNELS) adc_values[channel] = value;
+}
+
+void hal_sim_set_button(uint32_t pin, bool pressed) {
+    if (pin >= HAL_SIM_PINS || pins[pin].grounded == pressed) return;
+    pins[pin].grounded = pressed;
+
+    uint32_t edge = pressed ? HAL_GPIO_EDGE_FALL : HAL_GPIO_EDGE_RISE;
+    if ((pins[pin].irq_edges & edge) && gpio_callback != NULL) gpio_callback(pin, edge);
+    event_pending = true;
+}
+
+void hal_sim_set_net(const HalSimNet *hooks) {
+    net = hooks;
+}
+
+uint64_t hal_sim_idle_us(void) {
+    return idle_us;
+}
+
+#endif
@@ -0,0 +1,815 @@
+#if !PICO_ON_DEVICE
+#define _GNU_SOURCE
+#endif
+
+#include "hal.h"
+
+#if !PICO_ON_DEVICE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+// netinet/tcp.h define TCP_MSS como opção de socket; aqui vale o MSS do lwipopts.h
+#undef TCP_MSS
+
+#include "lwip/dns.h"
+#include "lwip/netif.h"
+#include "lwip/stats.h"
+#include "lwip/tcp.h"
+#include "lwip/timeouts.h"
+#include "lwip/udp.h"
+
+// associação simulada: varredura completa ou direto ao AP guardado, já com o DHCP
+#define HAL_SIM_JOIN_MS 1500
+#define HAL_SIM_FAST_JOIN_MS 400
+// endereço da estação e AP simulado
+#define HAL_SIM_STATION_IP "127.0.0.1"
+#define HAL_SIM_AP_CHANNEL 6
+// portas abaixo de 1024 (a API local na 80) são abertas com este deslocamento
+#define HAL_SIM_PORT_OFFSET 10000
+// timer lento do TCP do lwIP: o intervalo de tcp_poll conta nessa unidade
+#define HAL_SIM_TCP_SLOW_MS 500
+// espera real por uma resposta antes de liberar o relógio virtual (servidor travado ou sem resposta)
+#define HAL_SIM_TCP_REPLY_US 500000
+#define HAL_SIM_UDP_REPLY_US 20000
+// timers agendados: as vagas do pool do lwIP que sobram para a estação, mais o da associação
+#define HAL_SIM_TIMERS (MEMP_NUM_SYS_TIMEOUT - LWIP_NUM_SYS_TIMEOUT_INTERNAL + 1)
+
+// estado de uma conexão TCP
+typedef enum {
+    HAL_SIM_TCP_NEW,
+    HAL_SIM_TCP_LISTEN,
+    HAL_SIM_TCP_CONNECTING,
+    HAL_SIM_TCP_CONNECTED,
+    HAL_SIM_TCP_FREED,          // fechada ou abortada: liberada no fim da volta
+} HalSimTcpState;
+
+struct tcp_pcb {
+    HalSimTcpState state;
+    int fd;
+    u16_t port;
+    void *arg;
+    tcp_accept_fn accept;
+    tcp_recv_fn recv;
+    tcp_sent_fn sent;
+    tcp_poll_fn poll;
+    tcp_err_fn err;
+    tcp_connected_fn connected;
+    u8_t poll_interval;
+    uint64_t poll_next_us;
+    bool client;                // aberta com tcp_connect: espera respostas do servidor
+    bool awaiting;              // enviou e ainda não recebeu resposta
+    uint64_t awaiting_since_us; // tempo real
+    bool peer_closed;
+    uint8_t out[TCP_SND_BUF];   // escrito e ainda não entregue ao socket
+    uint32_t out_length;
+    uint32_t acked;             // entregue ao socket, à espera do callback de envio
+    u16_t queued;               // escritas na fila (segmentos)
+    struct tcp_pcb *next;
+};
+
+struct udp_pcb {
+    int fd;
+    udp_recv_fn recv;
+    void *recv_arg;
+    bool awaiting;
+    uint64_t awaiting_since_us;
+    struct udp_pcb *next;
+};
+
+// timer do lwIP
+typedef struct {
+    bool used;
+    bool pooled;        // ocupa uma vaga do pool (o timer da associação é do driver, não do lwIP)
+    uint64_t due_us;
+    sys_timeout_handler handler;
+    void *arg;
+} HalSimTimer;
+
+const ip_addr_t ip_addr_any = {0};
+struct stats_ lwip_stats;
+
+static struct stats_mem pool_stats[MEMP_MAX];
+
+static struct netif station_netif;
+static HalLinkStatus link_status = HAL_LINK_DOWN;
+static bool ap_available = true;
+static bool joining = false;
+static bool interface_up = true;
+
+static struct tcp_pcb *tcp_pcbs = NULL;
+static struct udp_pcb *udp_pcbs = NULL;
+static HalSimTimer timers[HAL_SIM_TIMERS];
+
+static bool hal_sim_net_service(uint64_t now_us, uint64_t *next_us);
+static void hal_sim_net_wait(uint32_t wait_us);
+
+static const HalSimNet net_hooks = {hal_sim_net_service, hal_sim_net_wait};
+
+// implementação das funções
+
+// Contabiliza uma alocação no pool; false com o pool esgotado (conta a falha, como o lwIP)
+static bool hal_sim_pool_take(memp_t pool) {
+    struct stats_mem *stats = &pool_stats[pool];
+    if (stats->used >= stats->avail) {
+        stats->err++;
+        return false;
+    }
+    stats->used++;
+    if (stats->used > stats->max) stats->max = stats->used;
+    return true;
+}
+
+static void hal_sim_pool_give(memp_t pool, mem_size_t count) {
+    pool_stats[pool].used -= count <= pool_stats[pool].used ? count : pool_stats[pool].used;
+}
+
+static void hal_sim_stats_init(void) {
+    static const mem_size_t capacities[MEMP_MAX] = {
+#define LWIP_MEMPOOL(name, num, size, desc) num,
+#include "lwip/priv/memp_std.h"
+    };
+    for (uint32_t i = 0; i < MEMP_MAX; i++) {
+        pool_stats[i] = (struct stats_mem) {.avail = capacities[i]};
+        lwip_stats.memp[i] = &pool_stats[i];
+    }
+    lwip_stats.mem = (struct stats_mem) {.avail = MEM_SIZE};
+
+    // os timers cíclicos do lwIP não rodam na ponte, mas ocupam as suas vagas do pool como no firmware
+    pool_stats[MEMP_SYS_TIMEOUT].used = LWIP_NUM_SYS_TIMEOUT_INTERNAL;
+    pool_stats[MEMP_SYS_TIMEOUT].max = LWIP_NUM_SYS_TIMEOUT_INTERNAL;
+}
+
+static uint64_t hal_sim_net_real_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000u + now.tv_nsec / 1000;
+}
+
+static void hal_sim_nonblocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+// --- timers ---
+
+// Agenda um timer; os do lwIP ocupam uma vaga do pool e falham (contados em err) com ele esgotado
+static void hal_sim_timer_add(u32_t msecs, sys_timeout_handler handler, void *arg, bool pooled) {
+    if (pooled && !hal_sim_pool_take(MEMP_SYS_TIMEOUT)) return;
+    for (uint32_t i = 0; i < HAL_SIM_TIMERS; i++) {
+        if (timers[i].used) continue;
+        timers[i] = (HalSimTimer) {true, pooled, hal_time_us_64() + (uint64_t) msecs * 1000, handler, arg};
+        return;
+    }
+}
+
+void sys_timeout(u32_t msecs, sys_timeout_handler handler, void *arg) {
+    hal_sim_timer_add(msecs, handler, arg, true);
+}
+
+void sys_untimeout(sys_timeout_handler handler, void *arg) {
+    for (uint32_t i = 0; i < HAL_SIM_TIMERS; i++) {
+        if (!timers[i].used || timers[i].handler != handler || timers[i].arg != arg) continue;
+        timers[i].used = false;
+        if (timers[i].pooled) hal_sim_pool_give(MEMP_SYS_TIMEOUT, 1);
+        return;
+    }
+}
+
+// Roda os timers vencidos (cada um no máximo uma vez por volta: um timer de 0 ms não prende o laço)
+static void hal_sim_run_timers(uint64_t now_us) {
+    bool due[HAL_SIM_TIMERS];
+    for (uint32_t i = 0; i < HAL_SIM_TIMERS; i++) due[i] = timers[i].used && timers[i].due_us <= now_us;
+
+    for (uint32_t i = 0; i < HAL_SIM_TIMERS; i++) {
+        if (!due[i] || !timers[i].used) continue;
+        HalSimTimer timer = timers[i];
+        timers[i].used = false;
+        if (timer.pooled) hal_sim_pool_give(MEMP_SYS_TIMEOUT, 1);
+        timer.handler(timer.arg);
+    }
+}
+
+// --- enlace ---
+
+void netif_set_status_callback(struct netif *netif, netif_status_callback_fn status_callback) {
+    netif->status_callback = status_callback;
+}
+
+void netif_set_link_callback(struct netif *netif, netif_status_callback_fn link_callback) {
+    netif->link_callback = link_callback;
+}
+
+static void hal_sim_netif_changed(void) {
+    if (station_netif.link_callback != NULL) station_netif.link_callback(&station_netif);
+    if (station_netif.status_callback != NULL) station_netif.status_callback(&station_netif);
+}
+
+// Fim da associação: com IP se o AP está no ar, senão "rede não encontrada"
+static void hal_sim_join_done(void *arg) {
+    (void) arg;
+    joining = false;
+    if (!ap_available) {
+        link_status = HAL_LINK_NONET;
+        return;
+    }
+    link_status = HAL_LINK_UP;
+    station_netif.flags = NETIF_FLAG_UP | NETIF_FLAG_LINK_UP;
+    ipaddr_aton(HAL_SIM_STATION_IP, &station_netif.ip_addr);
+    hal_sim_netif_changed();
+}
+
+bool hal_net_init(void) {
+    hal_sim_stats_init();
+    hal_sim_set_net(&net_hooks);
+    return true;
+}
+
+void hal_lwip_begin(void) {
+    // os callbacks da ponte rodam só com a CPU ociosa: não há o que travar
+}
+
+void hal_lwip_end(void) {
+}
+
+int hal_net_join(const char *ssid, const char *password, uint32_t auth, const uint8_t *bssid, uint32_t channel) {
+    (void) ssid;
+    (void) password;
+    (void) auth;
+    (void) channel;
+    if (!interface_up) return -1;
+    if (joining) sys_untimeout(hal_sim_join_done, NULL);
+    joining = true;
+    link_status = HAL_LINK_JOIN;
+    hal_sim_timer_add(bssid != NULL ? HAL_SIM_FAST_JOIN_MS : HAL_SIM_JOIN_MS, hal_sim_join_done, NULL, false);
+    return 0;
+}
+
+void hal_net_leave(void) {
+    if (joining) sys_untimeout(hal_sim_join_done, NULL);
+    joining = false;
+    bool was_up = link_status == HAL_LINK_UP;
+    link_status = HAL_LINK_DOWN;
+    station_netif.flags = 0;
+    station_netif.ip_addr.addr = 0;
+    if (was_up) hal_sim_netif_changed();
+}
+
+void hal_net_set_power(bool on) {
+    if (!on) hal_net_leave();
+    interface_up = on;
+    // como no firmware, a netif sai do lwIP e volta sem os callbacks
+    station_netif.status_callback = NULL;
+    station_netif.link_callback = NULL;
+}
+
+HalLinkStatus hal_net_link_status(void) {
+    return link_status;
+}
+
+bool hal_net_get_ap(uint8_t bssid[6], uint32_t *channel) {
+    static const uint8_t ap_bssid[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+    if (link_status != HAL_LINK_UP) return false;
+    memcpy(bssid, ap_bssid, sizeof(ap_bssid));
+    *channel = HAL_SIM_AP_CHANNEL;
+    return true;
+}
+
+struct netif *hal_net_netif(void) {
+    return &station_netif;
+}
+
+void hal_sim_set_ap(bool available) {
+    ap_available = available;
+    if (available || link_status != HAL_LINK_UP) return;
+
+    // AP fora do ar: o enlace cai
+    link_status = HAL_LINK_DOWN;
+    station_netif.flags = 0;
+    hal_sim_netif_changed();
+}
+
+// --- endereços, pbufs e DNS ---
+
+int ipaddr_aton(const char *cp, ip_addr_t *addr) {
+    struct in_addr parsed;
+    if (inet_pton(AF_INET, cp, &parsed) != 1) return 0;
+    addr->addr = parsed.s_addr;
+    return 1;
+}
+
+char *ip4addr_ntoa(const ip4_addr_t *addr) {
+    static char text[INET_ADDRSTRLEN];
+    struct in_addr in = {addr->addr};
+    return (char *) inet_ntop(AF_INET, &in, text, sizeof(text));
+}
+
+struct pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type) {
+    (void) layer;
+    memp_t pool = type == PBUF_POOL ? MEMP_PBUF_POOL : MEMP_MAX;
+    if (pool != MEMP_MAX && !hal_sim_pool_take(pool)) return NULL;
+    if (pool == MEMP_MAX && lwip_stats.mem.used + length > lwip_stats.mem.avail) {
+        lwip_stats.mem.err++;
+        return NULL;
+    }
+
+    struct pbuf *p = malloc(sizeof(struct pbuf) + length + 1);
+    if (p == NULL) return NULL;
+    *p = (struct pbuf) {NULL, p + 1, length, length};
+    if (pool == MEMP_MAX) {
+        lwip_stats.mem.used += length;
+        if (lwip_stats.mem.used > lwip_stats.mem.max) lwip_stats.mem.max = lwip_stats.mem.used;
+    }
+    // o tipo fica no byte depois dos dados, para a devolução ao pool certo
+    ((u8_t *) p->payload)[length] = (u8_t) type;
+    return p;
+}
+
+u8_t pbuf_free(struct pbuf *p) {
+    if (p == NULL) return 0;
+    if (((u8_t *) p->payload)[p->len] == PBUF_POOL) {
+        hal_sim_pool_give(MEMP_PBUF_POOL, 1);
+    } else {
+        lwip_stats.mem.used -= p->len <= lwip_stats.mem.used ? p->len : lwip_stats.mem.used;
+    }
+    free(p);
+    return 1;
+}
+
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset) {
+    if (offset >= p->len) return 0;
+    u16_t copied = p->len - offset < len ? p->len - offset : len;
+    memcpy(dataptr, (const u8_t *) p->payload + offset, copied);
+    return copied;
+}
+
+err_t dns_gethostbyname(const char *hostname, ip_addr_t *addr, dns_found_callback found, void *callback_arg) {
+    (void) found;
+    (void) callback_arg;
+    if (ipaddr_aton(hostname, addr)) return ERR_OK;
+
+    struct addrinfo hints = {.ai_family = AF_INET, .ai_socktype = SOCK_STREAM};
+    struct addrinfo *result = NULL;
+    if (getaddrinfo(hostname, NULL, &hints, &result) != 0 || result == NULL) return ERR_ARG;
+    addr->addr = ((struct sockaddr_in *) result->ai_addr)->sin_addr.s_addr;
+    freeaddrinfo(result);
+    return ERR_OK;
+}
+
+// --- TCP ---
+
+static u16_t hal_sim_port(u16_t port) {
+    return port != 0 && port < 1024 ? port + HAL_SIM_PORT_OFFSET : port;
+}
+
+struct tcp_pcb *tcp_new(void) {
+    if (!hal_sim_pool_take(MEMP_TCP_PCB)) return NULL;
+    struct tcp_pcb *pcb = calloc(1, sizeof(struct tcp_pcb));
+    if (pcb == NULL) return NULL;
+    pcb->fd = -1;
+    pcb->next = tcp_pcbs;
+    tcp_pcbs = pcb;
+    return pcb;
+}
+
+struct tcp_pcb *tcp_new_ip_type(u8_t type) {
+    (void) type;
+    return tcp_new();
+}
+
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port) {
+    (void) ipaddr;
+    pcb->port = port;
+    return ERR_OK;
+}
+
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return NULL;
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons(hal_sim_port(pcb->port))};
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, (struct sockaddr *) &address, sizeof(address)) != 0 || listen(fd, 4) != 0) {
+        close(fd);
+        return NULL;
+    }
+    hal_sim_nonblocking(fd);
+
+    // o pcb de escuta sai do pool dos pcbs comuns para o seu, como no lwIP
+    hal_sim_pool_give(MEMP_TCP_PCB, 1);
+    hal_sim_pool_take(MEMP_TCP_PCB_LISTEN);
+    pcb->fd = fd;
+    pcb->state = HAL_SIM_TCP_LISTEN;
+    return pcb;
+}
+
+err_t tcp_connect(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port, tcp_connected_fn connected) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return ERR_MEM;
+    hal_sim_nonblocking(fd);
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons(port)};
+    address.sin_addr.s_addr = ipaddr->addr;
+    if (connect(fd, (struct sockaddr *) &address, sizeof(address)) != 0 && errno != EINPROGRESS) {
+        close(fd);
+        return ERR_RTE;
+    }
+
+    pcb->fd = fd;
+    pcb->state = HAL_SIM_TCP_CONNECTING;
+    pcb->connected = connected;
+    pcb->client = true;
+    pcb->awaiting = true;
+    pcb->awaiting_since_us = hal_sim_net_real_us();
+    return ERR_OK;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg) {
+    pcb->arg = arg;
+}
+
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept) {
+    pcb->accept = accept;
+}
+
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv) {
+    pcb->recv = recv;
+}
+
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent) {
+    pcb->sent = sent;
+}
+
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval) {
+    pcb->poll = poll;
+    pcb->poll_interval = interval;
+    pcb->poll_next_us = hal_time_us_64() + (uint64_t) interval * HAL_SIM_TCP_SLOW_MS * 1000;
+}
+
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err) {
+    pcb->err = err;
+}
+
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb) {
+    return (u16_t) (TCP_SND_BUF - pcb->out_length - pcb->acked);
+}
+
+u16_t tcp_sndqueuelen(const struct tcp_pcb *pcb) {
+    return pcb->queued;
+}
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags) {
+    (void) apiflags;
+    if (pcb->state != HAL_SIM_TCP_CONNECTED) return ERR_CONN;
+    if (len > tcp_sndbuf(pcb) || pcb->queued >= TCP_SND_QUEUELEN || !hal_sim_pool_take(MEMP_TCP_SEG)) return ERR_MEM;
+
+    // sempre copiado: o socket pode aceitar os dados depois que o chamador reaproveitar o buffer
+    memcpy(pcb->out + pcb->out_length, dataptr, len);
+    pcb->out_length += len;
+    pcb->queued++;
+    return ERR_OK;
+}
+
+// Entrega ao socket o que couber; o que foi aceito conta como confirmado
+static void hal_sim_tcp_flush(struct tcp_pcb *pcb) {
+    if (pcb->state != HAL_SIM_TCP_CONNECTED || pcb->out_length == 0) return;
+
+    ssize_t written = send(pcb->fd, pcb->out, pcb->out_length, MSG_NOSIGNAL);
+    if (written <= 0) return;
+    memmove(pcb->out, pcb->out + written, pcb->out_length - written);
+    pcb->out_length -= (uint32_t) written;
+    pcb->acked += (uint32_t) written;
+    if (pcb->client && !pcb->awaiting) {
+        pcb->awaiting = true;
+        pcb->awaiting_since_us = hal_sim_net_real_us();
+    }
+}
+
+err_t tcp_output(struct tcp_pcb *pcb) {
+    hal_sim_tcp_flush(pcb);
+    return ERR_OK;
+}
+
+void tcp_recved(struct tcp_pcb *pcb, u16_t len) {
+    (void) pcb;
+    (void) len;
+}
+
+// Libera o socket e os segmentos; o pcb sai da lista no fim da volta
+static void hal_sim_tcp_free(struct tcp_pcb *pcb, bool reset) {
+    if (pcb->state == HAL_SIM_TCP_FREED) return;
+    if (pcb->fd >= 0) {
+        if (reset) {
+            struct linger linger = {1, 0};
+            setsockopt(pcb->fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+        }
+        close(pcb->fd);
+    }
+    hal_sim_pool_give(MEMP_TCP_SEG, pcb->queued);
+    hal_sim_pool_give(pcb->state == HAL_SIM_TCP_LISTEN ? MEMP_TCP_PCB_LISTEN : MEMP_TCP_PCB, 1);
+    pcb->fd = -1;
+    pcb->state = HAL_SIM_TCP_FREED;
+}
+
+err_t tcp_close(struct tcp_pcb *pcb) {
+    // o que ainda não saiu é entregue antes do FIN, como o lwIP faria
+    if (pcb->state == HAL_SIM_TCP_CONNECTED && pcb->out_length > 0) {
+        fcntl(pcb->fd, F_SETFL, fcntl(pcb->fd, F_GETFL, 0) & ~O_NONBLOCK);
+        send(pcb->fd, pcb->out, pcb->out_length, MSG_NOSIGNAL);
+    }
+    hal_sim_tcp_free(pcb, false);
+    return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb) {
+    tcp_err_fn err = pcb->err;
+    void *arg = pcb->arg;
+    hal_sim_tcp_free(pcb, true);
+    if (err != NULL) err(arg, ERR_ABRT);
+}
+
+// Erro da conexão: o pcb já não existe quando o callback roda, como no lwIP
+static void hal_sim_tcp_failed(struct tcp_pcb *pcb, err_t reason) {
+    tcp_err_fn err = pcb->err;
+    void *arg = pcb->arg;
+    hal_sim_tcp_free(pcb, false);
+    if (err != NULL) err(arg, reason);
+}
+
+static void hal_sim_tcp_accept(struct tcp_pcb *listener) {
+    int fd = accept(listener->fd, NULL, NULL);
+    if (fd < 0) return;
+
+    struct tcp_pcb *pcb = tcp_new();
+    if (pcb == NULL) {
+        close(fd);
+        return;
+    }
+    hal_sim_nonblocking(fd);
+    pcb->fd = fd;
+    pcb->state = HAL_SIM_TCP_CONNECTED;
+    pcb->arg = listener->arg;
+    if (listener->accept == NULL || listener->accept(listener->arg, pcb, ERR_OK) != ERR_OK) {
+        if (pcb->state != HAL_SIM_TCP_FREED) tcp_abort(pcb);
+    }
+}
+
+static void hal_sim_tcp_connected(struct tcp_pcb *pcb) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    getsockopt(pcb->fd, SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error != 0) {
+        hal_sim_tcp_failed(pcb, ERR_RST);
+        return;
+    }
+
+    pcb->state = HAL_SIM_TCP_CONNECTED;
+    pcb->awaiting = false;
+    if (pcb->connected != NULL) pcb->connected(pcb->arg, pcb, ERR_OK);
+}
+
+static void hal_sim_tcp_receive(struct tcp_pcb *pcb) {
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, TCP_MSS, PBUF_POOL);
+    if (p == NULL) return;
+
+    ssize_t received = recv(pcb->fd, p->payload, TCP_MSS, 0);
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        pbuf_free(p);
+        return;
+    }
+    if (received < 0) {
+        pbuf_free(p);
+        hal_sim_tcp_failed(pcb, ERR_RST);
+        return;
+    }
+
+    pcb->awaiting = false;
+    if (received == 0) {
+        // FIN do outro lado: recv com p = NULL, o pcb continua até a aplicação fechá-lo
+        pbuf_free(p);
+        pcb->peer_closed = true;
+        if (pcb->recv != NULL) pcb->recv(pcb->arg, pcb, NULL, ERR_OK);
+        else tcp_close(pcb);
+        return;
+    }
+
+    // o tamanho real fica no pbuf; o byte do tipo acompanha o fim dos dados
+    ((u8_t *) p->payload)[received] = PBUF_POOL;
+    p->len = p->tot_len = (u16_t) received;
+    if (pcb->recv != NULL) pcb->recv(pcb->arg, pcb, p, ERR_OK);
+    else pbuf_free(p);
+}
+
+// Confirmações, dados recebidos e escrita pendente de uma conexão estabelecida
+static void hal_sim_tcp_transfer(struct tcp_pcb *pcb, short revents) {
+    // tudo entregue ao socket: os segmentos voltam ao pool e o callback de envio é chamado
+    if (pcb->acked > 0 && pcb->out_length == 0) {
+        hal_sim_pool_give(MEMP_TCP_SEG, pcb->queued);
+        pcb->queued = 0;
+    }
+    while (pcb->acked > 0 && pcb->state == HAL_SIM_TCP_CONNECTED) {
+        u16_t length = pcb->acked > 0xffff ? 0xffff : (u16_t) pcb->acked;
+        pcb->acked -= length;
+        if (pcb->sent != NULL) pcb->sent(pcb->arg, pcb, length);
+    }
+    if (pcb->state != HAL_SIM_TCP_CONNECTED) return;
+
+    if ((revents & (POLLIN | POLLHUP | POLLERR)) && !pcb->peer_closed) hal_sim_tcp_receive(pcb);
+    hal_sim_tcp_flush(pcb);
+}
+
+static void hal_sim_tcp_service(struct tcp_pcb *pcb, short revents, uint64_t now_us) {
+    if (pcb->state == HAL_SIM_TCP_LISTEN) {
+        if (revents & POLLIN) hal_sim_tcp_accept(pcb);
+        return;
+    }
+    if (pcb->state == HAL_SIM_TCP_CONNECTING && (revents & (POLLOUT | POLLERR | POLLHUP))) hal_sim_tcp_connected(pcb);
+    else if (pcb->state == HAL_SIM_TCP_CONNECTED) hal_sim_tcp_transfer(pcb, revents);
+
+    // tcp_poll também durante a conexão (o prazo de conexão da aplicação depende dele)
+    bool active = pcb->state == HAL_SIM_TCP_CONNECTING || pcb->state == HAL_SIM_TCP_CONNECTED;
+    if (active && pcb->poll != NULL && pcb->poll_interval > 0 && now_us >= pcb->poll_next_us) {
+        pcb->poll_next_us = now_us + (uint64_t) pcb->poll_interval * HAL_SIM_TCP_SLOW_MS * 1000;
+        pcb->poll(pcb->arg, pcb);
+    }
+}
+
+// --- UDP ---
+
+struct udp_pcb *udp_new(void) {
+    if (!hal_sim_pool_take(MEMP_UDP_PCB)) return NULL;
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        hal_sim_pool_give(MEMP_UDP_PCB, 1);
+        return NULL;
+    }
+    hal_sim_nonblocking(fd);
+
+    struct udp_pcb *pcb = calloc(1, sizeof(struct udp_pcb));
+    pcb->fd = fd;
+    pcb->next = udp_pcbs;
+    udp_pcbs = pcb;
+    return pcb;
+}
+
+struct udp_pcb *udp_new_ip_type(u8_t type) {
+    (void) type;
+    return udp_new();
+}
+
+err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port) {
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons(hal_sim_port(port))};
+    address.sin_addr.s_addr = ipaddr->addr;
+    return bind(pcb->fd, (struct sockaddr *) &address, sizeof(address)) == 0 ? ERR_OK : ERR_USE;
+}
+
+void udp_recv(struct udp_pcb *pcb, udp_recv_fn recv, void *recv_arg) {
+    pcb->recv = recv;
+    pcb->recv_arg = recv_arg;
+}
+
+err_t udp_sendto(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *dst_ip, u16_t dst_port) {
+    struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons(dst_port)};
+    address.sin_addr.s_addr = dst_ip->addr;
+    if (sendto(pcb->fd, p->payload, p->len, 0, (struct sockaddr *) &address, sizeof(address)) < 0) return ERR_RTE;
+
+    pcb->awaiting = true;
+    pcb->awaiting_since_us = hal_sim_net_real_us();
+    return ERR_OK;
+}
+
+void udp_remove(struct udp_pcb *pcb) {
+    for (struct udp_pcb **link = &udp_pcbs; *link != NULL; link = &(*link)->next) {
+        if (*link != pcb) continue;
+        *link = pcb->next;
+        break;
+    }
+    close(pcb->fd);
+    free(pcb);
+    hal_sim_pool_give(MEMP_UDP_PCB, 1);
+}
+
+static void hal_sim_udp_receive(struct udp_pcb *pcb) {
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, TCP_MSS, PBUF_POOL);
+    if (p == NULL) return;
+
+    struct sockaddr_in from;
+    socklen_t from_length = sizeof(from);
+    ssize_t received = recvfrom(pcb->fd, p->payload, TCP_MSS, 0, (struct sockaddr *) &from, &from_length);
+    if (received < 0) {
+        pbuf_free(p);
+        return;
+    }
+
+    pcb->awaiting = false;
+    ((u8_t *) p->payload)[received] = PBUF_POOL;
+    p->len = p->tot_len = (u16_t) received;
+    ip_addr_t address = {from.sin_addr.s_addr};
+    if (pcb->recv != NULL) pcb->recv(pcb->recv_arg, pcb, p, &address, ntohs(from.sin_port));
+    else pbuf_free(p);
+}
+
+// --- ganchos da espera ociosa ---
+
+// Descritores a acompanhar: escuta, conexões (leitura, escrita pendente ou conexão em andamento) e UDP
+static nfds_t hal_sim_poll_fds(struct pollfd *fds, nfds_t max, void **owners, bool *is_udp) {
+    nfds_t count = 0;
+    for (struct tcp_pcb *pcb = tcp_pcbs; pcb != NULL && count < max; pcb = pcb->next) {
+        if (pcb->fd < 0 || pcb->state == HAL_SIM_TCP_FREED) continue;
+        short events = POLLIN;
+        if (pcb->state == HAL_SIM_TCP_CONNECTING || pcb->out_length > 0) events |= POLLOUT;
+        if (pcb->peer_closed) events &= ~POLLIN;
+        fds[count] = (struct pollfd) {pcb->fd, events, 0};
+        owners[count] = pcb;
+        is_udp[count++] = false;
+    }
+    for (struct udp_pcb *pcb = udp_pcbs; pcb != NULL && count < max; pcb = pcb->next) {
+        fds[count] = (struct pollfd) {pcb->fd, POLLIN, 0};
+        owners[count] = pcb;
+        is_udp[count++] = true;
+    }
+    return count;
+}
+
+#define HAL_SIM_MAX_FDS (MEMP_NUM_TCP_PCB + MEMP_NUM_TCP_PCB_LISTEN + MEMP_NUM_UDP_PCB)
+
+// Remove da lista os pcbs fechados durante a volta
+static void hal_sim_tcp_reap(void) {
+    struct tcp_pcb **link = &tcp_pcbs;
+    while (*link != NULL) {
+        struct tcp_pcb *pcb = *link;
+        if (pcb->state != HAL_SIM_TCP_FREED) {
+            link = &pcb->next;
+            continue;
+        }
+        *link = pcb->next;
+        free(pcb);
+    }
+}
+
+static bool hal_sim_net_service(uint64_t now_us, uint64_t *next_us) {
+    hal_sim_run_timers(now_us);
+
+    struct pollfd fds[HAL_SIM_MAX_FDS];
+    void *owners[HAL_SIM_MAX_FDS];
+    bool is_udp[HAL_SIM_MAX_FDS];
+    nfds_t count = hal_sim_poll_fds(fds, HAL_SIM_MAX_FDS, owners, is_udp);
+    if (count > 0) poll(fds, count, 0);
+
+    for (nfds_t i = 0; i < count; i++) {
+        if (is_udp[i]) {
+            if (fds[i].revents & POLLIN) hal_sim_udp_receive(owners[i]);
+        } else {
+            hal_sim_tcp_service(owners[i], fds[i].revents, now_us);
+        }
+    }
+    hal_sim_tcp_reap();
+
+    // próximo timer ou tcp_poll, e se alguma resposta é esperada agora
+    uint64_t next = UINT64_MAX;
+    for (uint32_t i = 0; i < HAL_SIM_TIMERS; i++) {
+        if (timers[i].used && timers[i].due_us < next) next = timers[i].due_us;
+    }
+
+    uint64_t real_now = hal_sim_net_real_us();
+    bool in_flight = false;
+    for (struct tcp_pcb *pcb = tcp_pcbs; pcb != NULL; pcb = pcb->next) {
+        if (pcb->state != HAL_SIM_TCP_CONNECTED && pcb->state != HAL_SIM_TCP_CONNECTING) continue;
+        if (pcb->poll != NULL && pcb->poll_interval > 0 && pcb->poll_next_us < next) next = pcb->poll_next_us;
+        if (pcb->acked > 0) next = now_us;
+        if (pcb->out_length > 0
+            || (pcb->awaiting && real_now - pcb->awaiting_since_us < HAL_SIM_TCP_REPLY_US)) in_flight = true;
+    }
+    for (struct udp_pcb *pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+        if (pcb->awaiting && real_now - pcb->awaiting_since_us < HAL_SIM_UDP_REPLY_US) in_flight = true;
+    }
+
+    *next_us = next;
+    return in_flight;
+}
+
+static void hal_sim_net_wait(uint32_t wait_us) {
+    struct pollfd fds[HAL_SIM_MAX_FDS];
+    void *owners[HAL_SIM_MAX_FDS];
+    bool is_udp[HAL_SIM_MAX_FDS];
+    nfds_t count = hal_sim_poll_fds(fds, HAL_SIM_MAX_FDS, owners, is_udp);
+
+    struct timespec timeout = {wait_us / 1000000, (long) (wait_us % 1000000) * 1000};
+    if (count > 0) ppoll(fds, count, &timeout, NULL);
+    else nanosleep(&timeout, NULL);
+}
+
+#endif
@@ -0,0 +1,201 @@
+#include "hal.h"
+
+#if PICO_ON_DEVICE
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/rand.h"
+#include "pico/cyw43_arch.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "hardware/sync.h"
+#include "hardware/structs/systick.h"
+
+// leitura do canal atual no driver cyw43 (WLC_GET_CHANNEL)
+#ifndef CYW43_IOCTL_GET_CHANNEL
+#define CYW43_IOCTL_GET_CHANNEL 0x3a
+#endif
+
+// callback único da interrupção de GPIO
+static HalGpioIrq gpio_callback = NULL;
+
+static bool adc_ready = false;
+
+// implementação das funções
+
+uint32_t hal_time_us(void) {
+    return time_us_32();
+}
+
+uint64_t hal_time_us_64(void) {
+    return time_us_64();
+}
+
+uint32_t hal_cycle_count(void) {
+    // o SysTick (que o SDK não usa) é ligado na primeira leitura, contando do recarregamento até 0 no clk_sys
+    if (!(systick_hw->csr & M0PLUS_SYST_CSR_ENABLE_BITS)) {
+        systick_hw->rvr = HAL_CYCLE_COUNT_MASK;
+        systick_hw->cvr = 0;
+        systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+    }
+    return HAL_CYCLE_COUNT_MASK - systick_hw->cvr;
+}
+
+uint32_t hal_cpu_hz(void) {
+    return clock_get_hz(clk_sys);
+}
+
+uint32_t hal_time_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+void hal_sleep_ms(uint32_t ms) {
+    sleep_ms(ms);
+}
+
+void hal_sleep_us(uint32_t us) {
+    sleep_us(us);
+}
+
+void hal_wait_for_event(uint32_t timeout_ms) {
+    if (timeout_ms == HAL_WAIT_FOREVER) __wfe();
+    else if (timeout_ms > 0) best_effort_wfe_or_timeout(delayed_by_ms(get_absolute_time(), timeout_ms));
+}
+
+void hal_signal_event(void) {
+    __sev();
+}
+
+uint32_t hal_irq_disable(void) {
+    return save_and_disable_interrupts();
+}
+
+void hal_irq_restore(uint32_t state) {
+    restore_interrupts(state);
+}
+
+void hal_gpio_init(uint32_t pin) {
+    gpio_init(pin);
+}
+
+void hal_gpio_set_output(uint32_t pin, bool output) {
+    gpio_set_dir(pin, output ? GPIO_OUT : GPIO_IN);
+}
+
+void hal_gpio_put(uint32_t pin, bool level) {
+    gpio_put(pin, level);
+}
+
+bool hal_gpio_get(uint32_t pin) {
+    return gpio_get(pin);
+}
+
+void hal_gpio_pull_up(uint32_t pin) {
+    gpio_pull_up(pin);
+}
+
+// Repassa a interrupção do SDK ao callback registrado
+static void hal_gpio_irq(uint gpio, uint32_t events) {
+    gpio_callback(gpio, events);
+}
+
+void hal_gpio_set_irq(uint32_t pin, uint32_t edges, HalGpioIrq callback) {
+    gpio_callback = callback;
+    gpio_set_irq_enabled_with_callback(pin, edges, true, &hal_gpio_irq);
+}
+
+void hal_adc_init(uint32_t pin) {
+    // adc_init reinicia o bloco: só na primeira entrada analógica
+    if (!adc_ready) {
+        adc_init();
+        adc_ready = true;
+    }
+    adc_gpio_init(pin);
+}
+
+uint16_t hal_adc_read(uint8_t channel) {
+    adc_select_input(channel);
+    return adc_read();
+}
+
+static i2c_inst_t *hal_i2c(uint8_t bus) {
+    return bus == HAL_I2C0 ? i2c0 : i2c1;
+}
+
+void hal_i2c_init(uint8_t bus, uint32_t baudrate, uint32_t sda, uint32_t scl) {
+    i2c_init(hal_i2c(bus), baudrate);
+    gpio_set_function(sda, GPIO_FUNC_I2C);
+    gpio_set_function(scl, GPIO_FUNC_I2C);
+    gpio_pull_up(sda);
+    gpio_pull_up(scl);
+}
+
+int hal_i2c_write(uint8_t bus, uint8_t address, const uint8_t *data, size_t length) {
+    return i2c_write_blocking(hal_i2c(bus), address, data, length, false);
+}
+
+uint32_t hal_random_32(void) {
+    return get_rand_32();
+}
+
+void hal_stdio_init(void (*chars_available)(void *), void *param) {
+    stdio_init_all();
+    stdio_set_chars_available_callback(chars_available, param);
+}
+
+int hal_getchar(void) {
+    int c = getchar_timeout_us(0);
+    return c == PICO_ERROR_TIMEOUT ? HAL_NO_CHAR : c;
+}
+
+bool hal_net_init(void) {
+    if (cyw43_arch_init()) return false;
+    cyw43_arch_enable_sta_mode();
+    return true;
+}
+
+void hal_lwip_begin(void) {
+    cyw43_arch_lwip_begin();
+}
+
+void hal_lwip_end(void) {
+    cyw43_arch_lwip_end();
+}
+
+int hal_net_join(const char *ssid, const char *password, uint32_t auth, const uint8_t *bssid, uint32_t channel) {
+    return cyw43_wifi_join(&cyw43_state, strlen(ssid), (const uint8_t *) ssid, strlen(password),
+                           (const uint8_t *) password, auth, bssid, channel);
+}
+
+void hal_net_leave(void) {
+    cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+}
+
+void hal_net_set_power(bool on) {
+    // desligar desfaz a associação e leva a interface a WLC_DOWN; ligar recria a netif do modo cliente
+    if (on) cyw43_arch_enable_sta_mode();
+    else cyw43_arch_disable_sta_mode();
+}
+
+HalLinkStatus hal_net_link_status(void) {
+    return (HalLinkStatus) cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+}
+
+bool hal_net_get_ap(uint8_t bssid[6], uint32_t *channel) {
+    // channel_info_t do driver: canal de hardware, canal alvo e canal da varredura
+    uint32_t channel_info[3] = {0};
+
+    bool found = cyw43_wifi_get_bssid(&cyw43_state, bssid) == 0
+        && cyw43_ioctl(&cyw43_state, CYW43_IOCTL_GET_CHANNEL, sizeof(channel_info), (uint8_t *) channel_info, CYW43_ITF_STA) == 0
+        && channel_info[0] != 0;
+    *channel = channel_info[0];
+    return found;
+}
+
+struct netif *hal_net_netif(void) {
+    return &cyw43_state.netif[CYW43_ITF_STA];
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef LWIP_HDR_ALTCP_H
+#define LWIP_HDR_ALTCP_H
+
+#include "lwip/opt.h"
+#include "lwip/tcp.h"
+
+// Simulador: sem LWIP_ALTCP o altcp é o próprio TCP raw API, como no lwIP (sem TLS no simulador)
+#if LWIP_ALTCP
+#error "simulador: altcp com TLS (HTTP_CLIENT_TLS) nao suportado"
+#endif
+
+#define altcp_accept_fn tcp_accept_fn
+#define altcp_connected_fn tcp_connected_fn
+#define altcp_recv_fn tcp_recv_fn
+#define altcp_sent_fn tcp_sent_fn
+#define altcp_poll_fn tcp_poll_fn
+#define altcp_err_fn tcp_err_fn
+
+#define altcp_pcb tcp_pcb
+#define altcp_tcp_new_ip_type tcp_new_ip_type
+#define altcp_tcp_new tcp_new
+
+#define altcp_new(allocator) tcp_new()
+#define altcp_new_ip_type(allocator, ip_type) tcp_new_ip_type(ip_type)
+
+#define altcp_arg tcp_arg
+#define altcp_accept tcp_accept
+#define altcp_recv tcp_recv
+#define altcp_sent tcp_sent
+#define altcp_poll tcp_poll
+#define altcp_err tcp_err
+
+#define altcp_recved tcp_recved
+#define altcp_bind tcp_bind
+#define altcp_connect tcp_connect
+#define altcp_listen tcp_listen
+#define altcp_abort tcp_abort
+#define altcp_close tcp_close
+#define altcp_write tcp_write
+#define altcp_output tcp_output
+#define altcp_sndbuf tcp_sndbuf
+#define altcp_sndqueuelen tcp_sndqueuelen
+
+#endif
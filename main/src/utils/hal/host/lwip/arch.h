@@ -0,0 +1,16 @@
+#ifndef LWIP_HDR_ARCH_H
+#define LWIP_HDR_ARCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Simulador: tipos do lwIP
+typedef uint8_t u8_t;
+typedef int8_t s8_t;
+typedef uint16_t u16_t;
+typedef int16_t s16_t;
+typedef uint32_t u32_t;
+typedef int32_t s32_t;
+typedef size_t mem_size_t;
+
+#endif
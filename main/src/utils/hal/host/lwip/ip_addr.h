@@ -0,0 +1,33 @@
+#ifndef LWIP_HDR_IP_ADDR_H
+#define LWIP_HDR_IP_ADDR_H
+
+#include "lwip/opt.h"
+#include "lwip/arch.h"
+
+// Simulador: endereços IPv4 (a estação não usa IPv6), na ordem de bytes da rede como no lwIP
+typedef struct ip4_addr {
+    u32_t addr;
+} ip4_addr_t;
+
+typedef ip4_addr_t ip_addr_t;
+
+#define IPADDR_TYPE_V4 0U
+#define IPADDR_TYPE_ANY 46U
+
+extern const ip_addr_t ip_addr_any;
+#define IP_ANY_TYPE (&ip_addr_any)
+#define IP_ADDR_ANY (&ip_addr_any)
+
+#define ip4_addr_get_byte(ipaddr, idx) (((const u8_t *) (&(ipaddr)->addr))[idx])
+#define ip4_addr1(ipaddr) ip4_addr_get_byte(ipaddr, 0)
+#define ip4_addr2(ipaddr) ip4_addr_get_byte(ipaddr, 1)
+#define ip4_addr3(ipaddr) ip4_addr_get_byte(ipaddr, 2)
+#define ip4_addr4(ipaddr) ip4_addr_get_byte(ipaddr, 3)
+
+// converte o texto a.b.c.d; 1 se válido
+int ipaddr_aton(const char *cp, ip_addr_t *addr);
+// texto do endereço (buffer estático)
+char *ip4addr_ntoa(const ip4_addr_t *addr);
+#define ipaddr_ntoa(addr) ip4addr_ntoa(addr)
+
+#endif
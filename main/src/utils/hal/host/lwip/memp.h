@@ -0,0 +1,13 @@
+#ifndef LWIP_HDR_MEMP_H
+#define LWIP_HDR_MEMP_H
+
+#include "lwip/opt.h"
+
+// Simulador: identificadores dos pools, na ordem de memp_std.h
+typedef enum {
+#define LWIP_MEMPOOL(name, num, size, desc) MEMP_##name,
+#include "lwip/priv/memp_std.h"
+    MEMP_MAX
+} memp_t;
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef LWIP_HDR_NETIF_H
+#define LWIP_HDR_NETIF_H
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+#include "lwip/ip_addr.h"
+
+// Simulador: a netif do modo cliente, com os callbacks de status e de enlace
+struct netif;
+
+typedef void (*netif_status_callback_fn)(struct netif *netif);
+
+struct netif {
+    ip4_addr_t ip_addr;
+    netif_status_callback_fn status_callback;
+    netif_status_callback_fn link_callback;
+    u8_t flags;
+};
+
+#define NETIF_FLAG_UP 0x01U
+#define NETIF_FLAG_LINK_UP 0x04U
+
+#define netif_ip4_addr(netif) ((const ip4_addr_t *) &((netif)->ip_addr))
+#define netif_is_up(netif) (((netif)->flags & NETIF_FLAG_UP) != 0)
+#define netif_is_link_up(netif) (((netif)->flags & NETIF_FLAG_LINK_UP) != 0)
+
+void netif_set_status_callback(struct netif *netif, netif_status_callback_fn status_callback);
+void netif_set_link_callback(struct netif *netif, netif_status_callback_fn link_callback);
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef LWIP_HDR_OPT_H
+#define LWIP_HDR_OPT_H
+
+/**
+ * @file opt.h
+ *
+ * @brief Simulador: opções do lwIP. As da estação vêm do mesmo lwipopts.h do firmware; aqui ficam só
+ * os padrões do lwIP que ele não define e que a ponte para sockets usa.
+ */
+
+#define LWIP_DBG_OFF 0x00
+
+#include "lwipopts.h"
+
+#ifndef LWIP_ALTCP
+#define LWIP_ALTCP 0
+#endif
+#ifndef MEMP_NUM_UDP_PCB
+#define MEMP_NUM_UDP_PCB 4
+#endif
+#ifndef MEMP_NUM_TCP_PCB_LISTEN
+#define MEMP_NUM_TCP_PCB_LISTEN 8
+#endif
+// timers cíclicos do próprio lwIP (a fórmula do lwIP para as opções de lwipopts.h): TCP, remontagem
+// de IP, ARP, os dois do DHCP e DNS; a ponte para sockets não os roda, mas as vagas ficam ocupadas no
+// pool, e o MEMP_NUM_SYS_TIMEOUT de lwipopts.h deixa para a estação as mesmas vagas do firmware
+#ifndef IP_REASSEMBLY
+#define IP_REASSEMBLY 1
+#endif
+#define LWIP_NUM_SYS_TIMEOUT_INTERNAL (LWIP_TCP + IP_REASSEMBLY + LWIP_ARP + 2 * LWIP_DHCP + LWIP_DNS)
+
+#endif
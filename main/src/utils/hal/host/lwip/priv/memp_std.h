@@ -0,0 +1,14 @@
+// Simulador: pools do lwIP contabilizados pela ponte para sockets (sem include guard, como no lwIP:
+// cada inclusão expande LWIP_MEMPOOL de novo)
+#ifndef LWIP_MEMPOOL
+#define LWIP_MEMPOOL(name, num, size, desc)
+#endif
+
+LWIP_MEMPOOL(UDP_PCB, MEMP_NUM_UDP_PCB, 0, "UDP_PCB")
+LWIP_MEMPOOL(TCP_PCB, MEMP_NUM_TCP_PCB, 0, "TCP_PCB")
+LWIP_MEMPOOL(TCP_PCB_LISTEN, MEMP_NUM_TCP_PCB_LISTEN, 0, "TCP_PCB_LISTEN")
+LWIP_MEMPOOL(TCP_SEG, MEMP_NUM_TCP_SEG, 0, "TCP_SEG")
+LWIP_MEMPOOL(SYS_TIMEOUT, MEMP_NUM_SYS_TIMEOUT, 0, "SYS_TIMEOUT")
+LWIP_MEMPOOL(PBUF_POOL, PBUF_POOL_SIZE, 0, "PBUF_POOL")
+
+#undef LWIP_MEMPOOL
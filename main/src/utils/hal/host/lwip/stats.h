@@ -0,0 +1,25 @@
+#ifndef LWIP_HDR_STATS_H
+#define LWIP_HDR_STATS_H
+
+#include "lwip/opt.h"
+#include "lwip/arch.h"
+#include "lwip/memp.h"
+
+// Simulador: contadores do heap e dos pools, mantidos pela ponte para sockets
+struct stats_mem {
+    const char *name;
+    u16_t err;
+    mem_size_t avail;
+    mem_size_t used;
+    mem_size_t max;
+    u16_t illegal;
+};
+
+struct stats_ {
+    struct stats_mem mem;
+    struct stats_mem *memp[MEMP_MAX];
+};
+
+extern struct stats_ lwip_stats;
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef LWIP_HDR_TIMEOUTS_H
+#define LWIP_HDR_TIMEOUTS_H
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+
+// Simulador: timers do lwIP no relógio virtual
+typedef void (*sys_timeout_handler)(void *arg);
+
+void sys_timeout(u32_t msecs, sys_timeout_handler handler, void *arg);
+void sys_untimeout(sys_timeout_handler handler, void *arg);
+
+#endif
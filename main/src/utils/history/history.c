@@ -0,0 +1,189 @@
+#include "history.h"
+#include <string.h>
+
+// duração das janelas de cada tier em segundos
+static const uint32_t tier_duration_s[HISTORY_NUM_TIERS] = { 60, 60 * 60, 24 * 60 * 60 };
+
+// capacidade dos buffers circulares de cada tier
+static const uint16_t tier_slots[HISTORY_NUM_TIERS] = {
+    HISTORY_MINUTE_SLOTS, HISTORY_HOUR_SLOTS, HISTORY_DAY_SLOTS
+};
+
+// armazenamento estático dos buffers circulares (sem malloc)
+static HistorySummary minute_ring[HISTORY_MINUTE_SLOTS];
+static HistorySummary hour_ring[HISTORY_HOUR_SLOTS];
+static HistorySummary day_ring[HISTORY_DAY_SLOTS];
+
+// estado de um tier: janela aberta + buffer circular de janelas fechadas
+typedef struct {
+    HistorySummary open;    // janela em andamento
+    bool open_valid;        // indica se a janela em andamento recebeu dados
+    HistorySummary *ring;   // janelas fechadas
+    uint16_t head;          // próxima posição de escrita
+    uint16_t count;         // quantidade de janelas válidas no buffer
+} HistoryTierState;
+
+static HistoryTierState tiers[HISTORY_NUM_TIERS] = {
+    { .ring = minute_ring },
+    { .ring = hour_ring },
+    { .ring = day_ring },
+};
+
+// zera a estatística de um canal
+static void stats_reset(HistoryStats *stats) {
+    memset(stats, 0, sizeof(HistoryStats));
+}
+
+// atualização de Welford com um novo valor
+static void stats_add(HistoryStats *stats, float value) {
+    if (stats->count == 0) {
+        stats->min = value;
+        stats->max = value;
+    } else {
+        if (value < stats->min) stats->min = value;
+        if (value > stats->max) stats->max = value;
+    }
+
+    stats->count++;
+    float delta = value - stats->mean;
+    stats->mean += delta / stats->count;
+    stats->m2 += delta * (value - stats->mean);
+}
+
+// combina duas estatísticas (variante paralela de Chan do algoritmo de Welford)
+static void stats_merge(HistoryStats *dst, const HistoryStats *src) {
+    if (src->count == 0) return;
+    if (dst->count == 0) {
+        *dst = *src;
+        return;
+    }
+
+    uint32_t count = dst->count + src->count;
+    float delta = src->mean - dst->mean;
+    float weight = (float) src->count / count;
+
+    dst->m2 += src->m2 + delta * delta * dst->count * weight;
+    dst->mean += delta * weight;
+    dst->count = count;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+// combina todos os canais de dois resumos
+static void summary_merge(HistorySummary *dst, const HistorySummary *src) {
+    for (int channel = 0; channel < HISTORY_NUM_CHANNELS; channel++) {
+        stats_merge(&dst->channels[channel], &src->channels[channel]);
+    }
+}
+
+// abre uma nova janela alinhada à duração do tier
+static void tier_open(HistoryTier tier, uint32_t timestamp_s) {
+    HistoryTierState *state = &tiers[tier];
+    state->open.start_s = timestamp_s - (timestamp_s % tier_duration_s[tier]);
+    for (int channel = 0; channel < HISTORY_NUM_CHANNELS; channel++) {
+        stats_reset(&state->open.channels[channel]);
+    }
+    state->open_valid = true;
+}
+
+static void tier_accumulate(HistoryTier tier, uint32_t timestamp_s, const HistorySummary *summary);
+
+// fecha a janela em andamento: grava no buffer circular e propaga para o tier superior
+static void tier_close(HistoryTier tier) {
+    HistoryTierState *state = &tiers[tier];
+    if (!state->open_valid) return;
+
+    state->ring[state->head] = state->open;
+    state->head = (state->head + 1) % tier_slots[tier];
+    if (state->count < tier_slots[tier]) state->count++;
+    state->open_valid = false;
+
+    if (tier + 1 < HISTORY_NUM_TIERS) {
+        tier_accumulate(tier + 1, state->open.start_s, &state->open);
+    }
+}
+
+// garante que a janela aberta do tier contém o instante informado, fechando a anterior se necessário
+static void tier_advance(HistoryTier tier, uint32_t timestamp_s) {
+    HistoryTierState *state = &tiers[tier];
+    if (state->open_valid && timestamp_s - state->open.start_s >= tier_duration_s[tier]) {
+        tier_close(tier);
+    }
+    if (!state->open_valid) {
+        tier_open(tier, timestamp_s);
+    }
+}
+
+// acumula um resumo fechado de um tier inferior no tier informado
+static void tier_accumulate(HistoryTier tier, uint32_t timestamp_s, const HistorySummary *summary) {
+    tier_advance(tier, timestamp_s);
+    summary_merge(&tiers[tier].open, summary);
+}
+
+// implementação das funções
+
+void history_init(void) {
+    for (int tier = 0; tier < HISTORY_NUM_TIERS; tier++) {
+        tiers[tier].open_valid = false;
+        tiers[tier].head = 0;
+        tiers[tier].count = 0;
+    }
+}
+
+void history_add_sample(uint32_t timestamp_s, const float values[HISTORY_NUM_CHANNELS]) {
+    tier_advance(HISTORY_TIER_MINUTE, timestamp_s);
+    for (int channel = 0; channel < HISTORY_NUM_CHANNELS; channel++) {
+        stats_add(&tiers[HISTORY_TIER_MINUTE].open.channels[channel], values[channel]);
+    }
+
+    // fecha horas e dias que já terminaram, para que uma janela sem amostras novas
+    // não fique aberta indefinidamente (no máximo um fechamento por tier)
+    for (int tier = HISTORY_TIER_HOUR; tier < HISTORY_NUM_TIERS; tier++) {
+        HistoryTierState *state = &tiers[tier];
+        if (state->open_valid && timestamp_s - state->open.start_s >= tier_duration_s[tier]) {
+            tier_close(tier);
+        }
+    }
+}
+
+uint16_t history_count(HistoryTier tier) {
+    return tiers[tier].count;
+}
+
+bool history_get(HistoryTier tier, uint16_t age, HistorySummary *out) {
+    HistoryTierState *state = &tiers[tier];
+    if (age >= state->count) return false;
+
+    uint16_t index = (state->head + tier_slots[tier] - 1 - age) % tier_slots[tier];
+    *out = state->ring[index];
+    return true;
+}
+
+bool history_get_open(HistoryTier tier, HistorySummary *out) {
+    bool valid = false;
+
+    // começa pelo tier pedido e soma as janelas abertas dos tiers inferiores, que ainda não foram propagadas
+    for (int lower = tier; lower >= HISTORY_TIER_MINUTE; lower--) {
+        HistoryTierState *state = &tiers[lower];
+        if (!state->open_valid) continue;
+
+        if (!valid) {
+            *out = state->open;
+            out->start_s = state->open.start_s - (state->open.start_s % tier_duration_s[tier]);
+            valid = true;
+        } else {
+            summary_merge(out, &state->open);
+        }
+    }
+
+    return valid;
+}
+
+uint32_t history_tier_duration(HistoryTier tier) {
+    return tier_duration_s[tier];
+}
+
+float history_stats_variance(const HistoryStats *stats) {
+    if (stats->count == 0) return 0.0f;
+    return stats->m2 / stats->count;
+}
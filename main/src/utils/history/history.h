@@ -0,0 +1,60 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+
+// canais de medição agregados pelo histórico
+typedef enum {
+    HISTORY_TEMPERATURE,
+    HISTORY_HUMIDITY,
+    HISTORY_POLLUTION,
+    HISTORY_NUM_CHANNELS
+} HistoryChannel;
+
+// níveis (tiers) de agregação do histórico
+typedef enum {
+    HISTORY_TIER_MINUTE,
+    HISTORY_TIER_HOUR,
+    HISTORY_TIER_DAY,
+    HISTORY_NUM_TIERS
+} HistoryTier;
+
+// quantidade de janelas fechadas mantidas em cada tier (buffers circulares de tamanho fixo)
+#define HISTORY_MINUTE_SLOTS 60     // última hora, minuto a minuto
+#define HISTORY_HOUR_SLOTS 24       // último dia, hora a hora
+#define HISTORY_DAY_SLOTS 7         // última semana, dia a dia
+
+// estatística incremental de um canal (algoritmo de Welford)
+typedef struct {
+    uint32_t count;     // quantidade de amostras na janela
+    float min;          // menor valor observado
+    float max;          // maior valor observado
+    float mean;         // média corrente
+    float m2;           // soma dos quadrados das diferenças para a média (variância = m2 / count)
+} HistoryStats;
+
+// resumo de uma janela de tempo com a estatística de todos os canais
+typedef struct {
+    uint32_t start_s;                               // início da janela em segundos desde o boot
+    HistoryStats channels[HISTORY_NUM_CHANNELS];    // estatística por canal
+} HistorySummary;
+
+// definição das funções
+
+// limpa todos os tiers do histórico
+void history_init(void);
+// adiciona uma amostra (um valor por canal) e propaga as janelas fechadas para os tiers superiores em O(1)
+void history_add_sample(uint32_t timestamp_s, const float values[HISTORY_NUM_CHANNELS]);
+// quantidade de janelas fechadas disponíveis em um tier
+uint16_t history_count(HistoryTier tier);
+// obtém uma janela fechada de um tier (age = 0 é a mais recente)
+bool history_get(HistoryTier tier, uint16_t age, HistorySummary *out);
+// obtém a janela em andamento de um tier, já incluindo os dados ainda não propagados dos tiers inferiores
+bool history_get_open(HistoryTier tier, HistorySummary *out);
+// duração de uma janela do tier em segundos
+uint32_t history_tier_duration(HistoryTier tier);
+// variância populacional de uma estatística
+float history_stats_variance(const HistoryStats *stats);
+
+#endif
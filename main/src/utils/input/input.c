@@ -0,0 +1,260 @@
+#include "input.h"
+
+// borda anotada pela interrupção
+typedef struct {
+    uint32_t time_us;
+    uint8_t input;
+    bool pressed;               // borda de descida (os botões ligam ao GND)
+} InputEdge;
+
+// estado de uma entrada, mantido pela tarefa
+typedef struct {
+    bool pressed;               // estado já sem bounce
+    uint32_t changed_us;        // última mudança aceita
+    bool verify;                // conferir o nível do pino no fim da janela de bounce
+    uint32_t pressed_us;
+    bool long_sent;             // toque longo já postado: a soltura não vira toque
+    bool click_pending;         // toque curto esperando a janela do toque duplo
+    uint32_t click_us;
+    uint8_t gestures;           // gestos postados
+} InputState;
+
+// pinos dos botões, na ordem de InputId
+static const uint8_t button_pins[INPUT_NUM_BUTTONS] = {BTN_A, BTN_B, JOYSTICK_SW};
+
+static const char *const input_names[INPUT_NUM] = {
+    [INPUT_BUTTON_A] = "botao A",
+    [INPUT_BUTTON_B] = "botao B",
+    [INPUT_JOYSTICK_BUTTON] = "joystick",
+    [INPUT_JOYSTICK_UP] = "joystick cima",
+    [INPUT_JOYSTICK_DOWN] = "joystick baixo",
+    [INPUT_JOYSTICK_LEFT] = "joystick esquerda",
+    [INPUT_JOYSTICK_RIGHT] = "joystick direita",
+};
+
+// fila de bordas: escrita só pela interrupção (edge_head), lida só pela tarefa (edge_tail)
+static InputEdge edges[INPUT_EDGE_QUEUE];
+static volatile uint32_t edge_head = 0;
+static volatile uint32_t edge_tail = 0;
+
+static InputState states[INPUT_NUM];
+
+static bool joystick_enabled = false;
+static uint32_t joystick_polled_us = 0;
+
+static InputStats stats = {0};
+
+// implementação das funções
+
+// Interrupção de GPIO: anota a borda e acorda a tarefa, nada mais
+static void input_gpio_irq(uint32_t gpio, uint32_t events) {
+    uint32_t now = hal_time_us();
+
+    uint8_t input = 0;
+    while (input < INPUT_NUM_BUTTONS && button_pins[input] != gpio) input++;
+    if (input == INPUT_NUM_BUTTONS) return;
+
+    if (edge_head - edge_tail >= INPUT_EDGE_QUEUE) {
+        stats.overflows++;
+    } else {
+        // as duas bordas juntas (bounce mais rápido que a interrupção): vale o nível atual
+        bool pressed = events == HAL_GPIO_EDGE_FALL ? true : events == HAL_GPIO_EDGE_RISE ? false : !hal_gpio_get(gpio);
+        edges[edge_head % INPUT_EDGE_QUEUE] = (InputEdge) {now, input, pressed};
+        HAL_MEMORY_BARRIER();
+        edge_head++;
+    }
+    stats.edges++;
+    sched_signal(EVENT_EDGE);
+
+    uint32_t elapsed = hal_time_us() - now;
+    if (elapsed > stats.irq_max_us) stats.irq_max_us = elapsed;
+}
+
+// Posta o gesto, se a entrada o usa; time_us é a borda ou o prazo que o gerou
+static void input_post(InputId input, InputGesture gesture, uint32_t time_us) {
+    if (!(states[input].gestures & INPUT_GESTURE_BIT(gesture))) return;
+
+    sched_post(EVENT_INPUT, INPUT_EVENT_ARG(input, gesture));
+    stats.gestures++;
+    uint32_t delay = hal_time_us() - time_us;
+    if (delay > stats.max_delay_us) stats.max_delay_us = delay;
+}
+
+// Mudança de estado já sem bounce: pressionar, toque curto e toque duplo
+static void input_change(InputId input, bool pressed, uint32_t time_us) {
+    InputState *state = &states[input];
+    state->pressed = pressed;
+    state->changed_us = time_us;
+
+    if (pressed) {
+        state->pressed_us = time_us;
+        state->long_sent = false;
+        input_post(input, INPUT_DOWN, time_us);
+    } else if (state->long_sent) {
+        // a soltura do toque longo não é um toque
+    } else if (!(state->gestures & INPUT_GESTURE_BIT(INPUT_DOUBLE))) {
+        input_post(input, INPUT_CLICK, time_us);
+    } else if (state->click_pending) {
+        state->click_pending = false;
+        input_post(input, INPUT_DOUBLE, time_us);
+    } else {
+        state->click_pending = true;
+        state->click_us = time_us;
+    }
+}
+
+// Borda anotada pela interrupção: a primeira muda o estado, as seguintes dentro da janela são bounce
+static void input_edge(const InputEdge *edge) {
+    InputState *state = &states[edge->input];
+
+    if (edge->time_us - state->changed_us < INPUT_DEBOUNCE_MS * 1000u || edge->pressed == state->pressed) {
+        stats.bounces++;
+        state->verify = true;
+        return;
+    }
+    state->verify = true;
+    input_change(edge->input, edge->pressed, edge->time_us);
+}
+
+// Direção do joystick com histerese: mais longe do centro para pressionar do que para soltar
+static bool input_axis(uint16_t raw, bool positive, bool was_pressed) {
+    int32_t offset = (int32_t) raw - INPUT_JOYSTICK_CENTER;
+    if (!positive) offset = -offset;
+    return offset > (was_pressed ? INPUT_JOYSTICK_RELEASE : INPUT_JOYSTICK_PRESS);
+}
+
+// Lê os dois eixos do joystick (o canal do ADC é escolhido a cada leitura, como no MQ-135)
+static void input_poll_joystick(uint32_t now) {
+    joystick_polled_us = now;
+
+    uint16_t x = hal_adc_read(JOYSTICK_X_ADC);
+    uint16_t y = hal_adc_read(JOYSTICK_Y_ADC);
+
+    const struct { InputId input; uint16_t raw; bool positive; } directions[] = {
+        {INPUT_JOYSTICK_UP, y, true},
+        {INPUT_JOYSTICK_DOWN, y, false},
+        {INPUT_JOYSTICK_LEFT, x, false},
+        {INPUT_JOYSTICK_RIGHT, x, true},
+    };
+    for (uint8_t i = 0; i < sizeof(directions) / sizeof(directions[0]); i++) {
+        InputState *state = &states[directions[i].input];
+        bool pressed = input_axis(directions[i].raw, directions[i].positive, state->pressed);
+        if (pressed != state->pressed) input_change(directions[i].input, pressed, now);
+    }
+}
+
+// Bordas pendentes, conferência do nível depois do bounce, joystick e prazos dos gestos
+static void input_process(uint32_t now) {
+    while (edge_tail != edge_head) {
+        InputEdge edge = edges[edge_tail % INPUT_EDGE_QUEUE];
+        HAL_MEMORY_BARRIER();
+        edge_tail++;
+        input_edge(&edge);
+    }
+
+    for (uint8_t input = 0; input < INPUT_NUM_BUTTONS; input++) {
+        InputState *state = &states[input];
+        if (!state->verify || now - state->changed_us < INPUT_DEBOUNCE_MS * 1000u) continue;
+
+        // nível estável diferente do estado: a borda final do bounce se perdeu
+        state->verify = false;
+        bool pressed = !hal_gpio_get(button_pins[input]);
+        if (pressed != state->pressed) input_change(input, pressed, now);
+    }
+
+    if (joystick_enabled && now - joystick_polled_us >= INPUT_JOYSTICK_PERIOD_MS * 1000u) input_poll_joystick(now);
+
+    for (uint8_t input = 0; input < INPUT_NUM; input++) {
+        InputState *state = &states[input];
+        if (state->pressed && !state->long_sent && (state->gestures & INPUT_GESTURE_BIT(INPUT_LONG))
+            && now - state->pressed_us >= INPUT_LONG_PRESS_MS * 1000u) {
+            state->long_sent = true;
+            input_post(input, INPUT_LONG, state->pressed_us + INPUT_LONG_PRESS_MS * 1000u);
+        }
+        if (state->click_pending && now - state->click_us >= INPUT_DOUBLE_PRESS_MS * 1000u) {
+            state->click_pending = false;
+            input_post(input, INPUT_CLICK, state->click_us + INPUT_DOUBLE_PRESS_MS * 1000u);
+        }
+    }
+}
+
+// Encurta a espera até o prazo (em µs a partir de now)
+static void input_deadline(uint32_t now, uint32_t deadline_us, uint32_t *wait_us) {
+    int32_t remaining = (int32_t) (deadline_us - now);
+    uint32_t wait = remaining > 0 ? (uint32_t) remaining : 0;
+    if (wait < *wait_us) *wait_us = wait;
+}
+
+// Tempo até o próximo prazo da entrada, em ms (SCHED_FOREVER sem nenhum)
+static uint32_t input_next_timeout_ms(uint32_t now) {
+    uint32_t wait_us = UINT32_MAX;
+
+    for (uint8_t input = 0; input < INPUT_NUM; input++) {
+        const InputState *state = &states[input];
+        if (state->verify) input_deadline(now, state->changed_us + INPUT_DEBOUNCE_MS * 1000u, &wait_us);
+        if (state->pressed && !state->long_sent && (state->gestures & INPUT_GESTURE_BIT(INPUT_LONG))) {
+            input_deadline(now, state->pressed_us + INPUT_LONG_PRESS_MS * 1000u, &wait_us);
+        }
+        if (state->click_pending) input_deadline(now, state->click_us + INPUT_DOUBLE_PRESS_MS * 1000u, &wait_us);
+    }
+    if (joystick_enabled) input_deadline(now, joystick_polled_us + INPUT_JOYSTICK_PERIOD_MS * 1000u, &wait_us);
+
+    return wait_us == UINT32_MAX ? SCHED_FOREVER : (wait_us + 999) / 1000;
+}
+
+void input_init(void) {
+    for (uint8_t input = 0; input < INPUT_NUM; input++) {
+        states[input] = (InputState) {0};
+        states[input].gestures = INPUT_GESTURE_BIT(INPUT_CLICK);
+    }
+
+    for (uint8_t input = 0; input < INPUT_NUM_BUTTONS; input++) {
+        uint8_t pin = button_pins[input];
+        hal_gpio_init(pin);
+        hal_gpio_set_output(pin, false);
+        hal_gpio_pull_up(pin);
+        states[input].pressed = !hal_gpio_get(pin);
+        hal_gpio_set_irq(pin, HAL_GPIO_EDGE_FALL | HAL_GPIO_EDGE_RISE, input_gpio_irq);
+    }
+
+    // eixos do joystick (o MQ-135 escolhe o seu canal a cada leitura)
+    hal_adc_init(26 + JOYSTICK_Y_ADC);
+    hal_adc_init(26 + JOYSTICK_X_ADC);
+}
+
+void input_set_gestures(InputId input, uint8_t gestures) {
+    if (input < INPUT_NUM) states[input].gestures = gestures;
+}
+
+void input_joystick_enable(bool enabled) {
+    if (enabled == joystick_enabled) return;
+    joystick_enabled = enabled;
+
+    // o joystick desligado volta ao centro sem postar gestos; ligado, a primeira leitura é imediata
+    for (uint8_t input = INPUT_JOYSTICK_UP; input <= INPUT_JOYSTICK_RIGHT; input++) {
+        uint8_t gestures = states[input].gestures;
+        states[input] = (InputState) {0};
+        states[input].gestures = gestures;
+    }
+    joystick_polled_us = hal_time_us() - INPUT_JOYSTICK_PERIOD_MS * 1000u;
+    if (enabled) sched_signal(EVENT_EDGE);
+}
+
+void input_task_run(Task *task, const Event *event) {
+    TASK_BEGIN();
+    while (true) {
+        input_process(hal_time_us());
+        TASK_WAIT(input_next_timeout_ms(hal_time_us()));
+    }
+    TASK_END();
+}
+
+const char *input_name(InputId input) {
+    return input < INPUT_NUM ? input_names[input] : "?";
+}
+
+void input_get_stats(InputStats *out) {
+    uint32_t interrupts = hal_irq_disable();
+    *out = stats;
+    hal_irq_restore(interrupts);
+}
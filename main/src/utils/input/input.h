@@ -0,0 +1,104 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+#include "sched.h"
+
+/**
+ * @file input.h
+ *
+ * @brief Entrada da estação: botões A e B e o joystick da placa (botão e quatro direções), com os
+ * gestos pressionar, toque, toque longo e toque duplo entregues ao agendador como EVENT_INPUT.
+ *
+ * @note A interrupção de GPIO só anota a borda (instante do timer, entrada e sentido) numa fila
+ * circular e sinaliza EVENT_EDGE: alguns µs, sem timers nem estado da aplicação. O bounce e os gestos
+ * são tratados em input_task_run, fora da interrupção. A primeira borda muda o estado na hora (o toque
+ * não espera o bounce acabar); as bordas nos INPUT_DEBOUNCE_MS seguintes são descartadas e, no fim
+ * desse intervalo, o nível do pino é conferido, para não perder uma soltura que caiu no meio do bounce.
+ *
+ * As direções do joystick vêm do ADC (canais 0 e 1, lidos a cada INPUT_JOYSTICK_PERIOD_MS só enquanto
+ * input_joystick_enable estiver ligado), com histerese em torno do centro, e viram entradas como os
+ * botões. Cada entrada posta só os gestos escolhidos em input_set_gestures; sem INPUT_DOUBLE o toque é
+ * postado na soltura, sem esperar a janela do toque duplo.
+ *
+ * O arg do evento é INPUT_EVENT_ARG(entrada, gesto).
+ */
+
+// definição da pinagem
+#define BTN_A 5
+#define BTN_B 6
+#define JOYSTICK_SW 22
+#define JOYSTICK_X_ADC 1                // GPIO 27
+#define JOYSTICK_Y_ADC 0                // GPIO 26
+
+// bordas seguintes à mudança de estado descartadas como bounce
+#define INPUT_DEBOUNCE_MS 20
+// tempo pressionado até o toque longo
+#define INPUT_LONG_PRESS_MS 800
+// janela entre dois toques para o toque duplo
+#define INPUT_DOUBLE_PRESS_MS 300
+// leitura do joystick enquanto ligado
+#define INPUT_JOYSTICK_PERIOD_MS 30
+// desvio do centro do ADC (0 a 4095) para a direção contar como pressionada e para voltar ao centro
+#define INPUT_JOYSTICK_CENTER 2048
+#define INPUT_JOYSTICK_PRESS 1200
+#define INPUT_JOYSTICK_RELEASE 600
+// bordas anotadas aguardando a tarefa
+#define INPUT_EDGE_QUEUE 16
+
+// entradas (os botões de GPIO primeiro)
+typedef enum {
+    INPUT_BUTTON_A,
+    INPUT_BUTTON_B,
+    INPUT_JOYSTICK_BUTTON,
+    INPUT_JOYSTICK_UP,
+    INPUT_JOYSTICK_DOWN,
+    INPUT_JOYSTICK_LEFT,
+    INPUT_JOYSTICK_RIGHT,
+    INPUT_NUM
+} InputId;
+
+#define INPUT_NUM_BUTTONS 3
+
+// gestos
+typedef enum {
+    INPUT_DOWN,                 // pressionado (na primeira borda, para a resposta mais rápida)
+    INPUT_CLICK,                // toque curto, na soltura (ou no fim da janela do toque duplo)
+    INPUT_LONG,                 // segurado por INPUT_LONG_PRESS_MS (postado sem esperar a soltura)
+    INPUT_DOUBLE,               // dois toques curtos dentro de INPUT_DOUBLE_PRESS_MS
+    INPUT_NUM_GESTURES
+} InputGesture;
+
+#define INPUT_GESTURE_BIT(gesture) (1u << (gesture))
+
+#define INPUT_EVENT_ARG(input, gesture) (((uint32_t) (input) << 8) | (gesture))
+#define INPUT_EVENT_INPUT(arg) ((InputId) ((arg) >> 8))
+#define INPUT_EVENT_GESTURE(arg) ((InputGesture) ((arg) & 0xff))
+
+// estatísticas da entrada
+typedef struct {
+    uint32_t edges;             // bordas anotadas pela interrupção
+    uint32_t overflows;         // bordas perdidas com a fila cheia
+    uint32_t bounces;           // bordas descartadas como bounce
+    uint32_t gestures;          // gestos postados
+    uint32_t irq_max_us;        // maior tempo dentro da interrupção (resolução de 1 µs)
+    uint32_t max_delay_us;      // maior atraso da borda (ou do prazo do gesto) até a postagem
+} InputStats;
+
+// definição das funções
+
+// configura os botões (pull-up e interrupção nas duas bordas) e o ADC do joystick
+void input_init(void);
+// escolhe os gestos postados pela entrada (máscara de INPUT_GESTURE_BIT; padrão: só INPUT_CLICK)
+void input_set_gestures(InputId input, uint8_t gestures);
+// liga ou desliga a leitura periódica do joystick (desligada, as direções voltam ao centro sem gestos)
+void input_joystick_enable(bool enabled);
+// tarefa da entrada (inscrita em EVENT_EDGE): bounce, joystick e gestos
+void input_task_run(Task *task, const Event *event);
+// nome da entrada, para o log
+const char *input_name(InputId input);
+// copia as estatísticas da entrada
+void input_get_stats(InputStats *out);
+
+#endif
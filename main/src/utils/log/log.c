@@ -0,0 +1,102 @@
+#include "log.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include "hal.h"
+
+// mensagem gravada
+typedef struct {
+    const char *format;             // identificador da mensagem: endereço da string de formato
+    uint32_t timestamp_us;          // instante da gravação (32 bits do timer)
+    uint8_t count;
+    volatile bool ready;            // preenchida pelo produtor, pronta para a formatação
+    uintptr_t args[LOG_MAX_ARGS];
+} LogRecord;
+
+static LogRecord ring[LOG_RING_SIZE];
+
+// posições (só crescem): head é avançado por quem grava, tail só por log_flush
+static volatile uint32_t head = 0;
+static volatile uint32_t tail = 0;
+
+static LogStats stats = {0};
+static uint32_t reported_dropped = 0;
+
+// implementação das funções
+
+// Escreve uma mensagem com o instante em que foi gravada (ms desde o boot)
+static void log_print(const char *format, uint32_t timestamp_us, const uintptr_t *args) {
+    // o instante completo é recuperado a partir do timer de 64 bits (os 32 bits dão a volta em ~71 min)
+    uint64_t now_us = hal_time_us_64();
+    uint64_t at_us = now_us - (uint32_t) ((uint32_t) now_us - timestamp_us);
+    uint32_t at_ms = (uint32_t) (at_us / 1000);
+
+    printf("[%lu.%03lu] ", (unsigned long) (at_ms / 1000), (unsigned long) (at_ms % 1000));
+    printf(format, args[0], args[1], args[2], args[3]);
+}
+
+void log_write(uint8_t level, const char *format, uint8_t count, ...) {
+    (void) level;
+    uint32_t timestamp_us = hal_time_us();
+    uintptr_t args[LOG_MAX_ARGS] = {0};
+
+    va_list list;
+    va_start(list, count);
+    for (uint8_t i = 0; i < count && i < LOG_MAX_ARGS; i++) args[i] = va_arg(list, uintptr_t);
+    va_end(list);
+
+    if (!LOG_DEFERRED) {
+        stats.written++;
+        stats.flushed++;
+        log_print(format, timestamp_us, args);
+        return;
+    }
+
+    // reserva da vaga: as interrupções ficam desligadas só durante a comparação e o incremento
+    uint32_t interrupts = hal_irq_disable();
+    uint32_t used = head - tail;
+    if (used >= LOG_RING_SIZE) {
+        stats.dropped++;
+        hal_irq_restore(interrupts);
+        return;
+    }
+    LogRecord *record = &ring[head % LOG_RING_SIZE];
+    head++;
+    stats.written++;
+    if (used + 1 > stats.peak) stats.peak = used + 1;
+    hal_irq_restore(interrupts);
+
+    record->format = format;
+    record->timestamp_us = timestamp_us;
+    record->count = count;
+    for (uint8_t i = 0; i < LOG_MAX_ARGS; i++) record->args[i] = args[i];
+    HAL_MEMORY_BARRIER();
+    record->ready = true;
+}
+
+void log_flush(void) {
+    while (tail != head) {
+        LogRecord *record = &ring[tail % LOG_RING_SIZE];
+
+        // vaga reservada por uma gravação interrompida: o resto fica para a próxima chamada
+        if (!record->ready) break;
+
+        // a cópia libera a vaga antes do printf, que pode demorar no USB
+        LogRecord copy = *record;
+        record->ready = false;
+        HAL_MEMORY_BARRIER();
+        tail++;
+
+        log_print(copy.format, copy.timestamp_us, copy.args);
+        stats.flushed++;
+    }
+
+    uint32_t dropped = stats.dropped;
+    if (dropped != reported_dropped) {
+        printf("Log: %lu mensagens descartadas com o buffer cheio\n", (unsigned long) (dropped - reported_dropped));
+        reported_dropped = dropped;
+    }
+}
+
+void log_get_stats(LogStats *out) {
+    *out = stats;
+}
@@ -0,0 +1,98 @@
+#ifndef LOG_H
+#define LOG_H
+
+// inclusão de bibliotecas
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file log.h
+ *
+ * @brief Log adiado: as mensagens são gravadas em binário num buffer circular e formatadas depois,
+ * fora dos trechos críticos.
+ *
+ * @note LOG_ERROR/LOG_WARN/LOG_INFO/LOG_DEBUG(formato, ...) gravam só o endereço da string de
+ * formato (o identificador da mensagem, em flash), o instante em µs e até LOG_MAX_ARGS argumentos
+ * brutos. Nada é formatado nem escrito no USB: a gravação leva alguns µs e pode ser feita nos
+ * callbacks do lwIP, no decodificador do DHT11 e em interrupções. log_flush, chamada no laço
+ * principal no ponto de menor prioridade (antes do sleep), formata e escreve as mensagens pendentes
+ * com o instante em que foram gravadas.
+ *
+ * O buffer não usa trava: a vaga é reservada com as interrupções desligadas por alguns ciclos (o
+ * Cortex-M0+ não tem instruções atômicas) e preenchida depois; log_flush para na primeira vaga ainda
+ * não preenchida. Com o buffer cheio a mensagem é descartada e contada.
+ *
+ * Mensagens acima de LOG_LEVEL (build com -DSTATION_LOG_LEVEL=ERROR|WARN|INFO|DEBUG) somem do código.
+ * Com LOG_DEFERRED = 0 as mensagens são escritas na hora, como printf (útil para depurar travamentos).
+ *
+ * @warning Os argumentos são copiados como inteiros de até 32 bits (no dispositivo): sem float nem
+ * %llu, e strings (%s) só com duração estática (literais, nomes de configuração), já que o texto é
+ * lido só na formatação.
+ */
+
+// níveis de log
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_DEFERRED
+#define LOG_DEFERRED 1
+#endif
+
+// mensagens guardadas até a próxima formatação (28 bytes cada)
+#define LOG_RING_SIZE 32
+
+// argumentos por mensagem
+#define LOG_MAX_ARGS 4
+
+// estatísticas do log
+typedef struct {
+    uint32_t written;           // mensagens gravadas
+    uint32_t dropped;           // mensagens descartadas com o buffer cheio
+    uint32_t flushed;           // mensagens formatadas e escritas
+    uint16_t peak;              // maior ocupação do buffer
+} LogStats;
+
+// definição das funções
+
+// grava uma mensagem (use as macros LOG_*, que convertem os argumentos e aplicam o filtro de nível)
+void log_write(uint8_t level, const char *format, uint8_t count, ...);
+// formata e escreve as mensagens pendentes; deve ser chamada no laço principal
+void log_flush(void);
+// copia as estatísticas do log
+void log_get_stats(LogStats *out);
+
+// conversão dos argumentos para o tamanho de uma vaga
+#define LOG_ARG(x) ((uintptr_t) (x))
+#define LOG_ARGS_0(format)
+#define LOG_ARGS_1(format, a) , LOG_ARG(a)
+#define LOG_ARGS_2(format, a, b) , LOG_ARG(a), LOG_ARG(b)
+#define LOG_ARGS_3(format, a, b, c) , LOG_ARG(a), LOG_ARG(b), LOG_ARG(c)
+#define LOG_ARGS_4(format, a, b, c, d) , LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d)
+
+// contagem dos argumentos depois do formato (mais de LOG_MAX_ARGS não compila)
+#define LOG_COUNT_(format, a, b, c, d, n, ...) n
+#define LOG_COUNT(...) LOG_COUNT_(__VA_ARGS__, 4, 3, 2, 1, 0, _)
+#define LOG_FORMAT_(format, ...) format
+#define LOG_CONCAT_(a, b) a##b
+#define LOG_CONCAT(a, b) LOG_CONCAT_(a, b)
+
+#define LOG_AT(level, ...)                                                                      \
+    do {                                                                                        \
+        if (LOG_LEVEL >= (level)) {                                                             \
+            log_write((level), LOG_FORMAT_(__VA_ARGS__, _), LOG_COUNT(__VA_ARGS__)              \
+                LOG_CONCAT(LOG_ARGS_, LOG_COUNT(__VA_ARGS__))(__VA_ARGS__));                    \
+        }                                                                                       \
+    } while (0)
+
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#endif
@@ -0,0 +1,183 @@
+#include "memstat.h"
+#include <stdio.h>
+#include <malloc.h>
+#include "lwip/stats.h"
+#include "lwip/memp.h"
+#include "log.h"
+
+#if PICO_ON_DEVICE
+// limites do heap e das pilhas, definidos pelo linker script do SDK
+extern char __end__;
+extern char __HeapLimit;
+extern uint32_t __StackBottom[];
+extern uint32_t __StackTop[];
+extern uint32_t __StackOneBottom[];
+extern uint32_t __StackOneTop[];
+#endif
+
+// margem abaixo do ponto atual da pilha que não é pintada no núcleo 0 (quadros de memstat_init)
+#define MEMSTAT_PAINT_MARGIN_WORDS 16
+
+// nomes dos pools, na ordem do enum memp_t
+static const char *const pool_names[MEMP_MAX] = {
+#define LWIP_MEMPOOL(name, num, size, desc) #name,
+#include "lwip/priv/memp_std.h"
+};
+
+static MemstatSnapshot snapshot = {0};
+static uint32_t last_sample_ms = 0;
+
+// falhas já informadas no terminal
+static uint32_t reported_heap_err = 0;
+static uint32_t reported_pool_err[MEMP_MAX] = {0};
+
+// implementação das funções
+
+#if PICO_ON_DEVICE
+
+// Pinta a região da pilha entre bottom e limit
+static void memstat_paint(uint32_t *bottom, uint32_t *limit) {
+    for (uint32_t *word = bottom; word < limit; word++) *word = MEMSTAT_STACK_PAINT;
+}
+
+// Pico de uso da pilha: do topo até a primeira palavra da pintura que ficou intacta
+static uint32_t memstat_stack_used(const uint32_t *bottom, const uint32_t *top) {
+    const uint32_t *word = bottom;
+    while (word < top && *word == MEMSTAT_STACK_PAINT) word++;
+    return (uint32_t) (top - word) * sizeof(uint32_t);
+}
+
+#endif
+
+// Converte os contadores do lwIP (ausentes com os STATS desligados)
+static void memstat_lwip_pool(const struct stats_mem *lwip, MemstatPool *out) {
+    *out = (MemstatPool) {0};
+    if (lwip == NULL) return;
+
+    out->used = lwip->used;
+    out->max = lwip->max;
+    out->avail = lwip->avail;
+    out->err = lwip->err;
+}
+
+// Atualiza o retrato da memória
+static void memstat_sample() {
+#if PICO_ON_DEVICE
+    struct mallinfo heap = mallinfo();
+    snapshot.heap_used = heap.uordblks;
+    snapshot.heap_arena = heap.arena;
+    snapshot.heap_size = (uint32_t) (&__HeapLimit - &__end__);
+
+    snapshot.stack_used[0] = memstat_stack_used(__StackBottom, __StackTop);
+    snapshot.stack_size[0] = (uint32_t) (__StackTop - __StackBottom) * sizeof(uint32_t);
+    snapshot.stack_used[1] = memstat_stack_used(__StackOneBottom, __StackOneTop);
+    snapshot.stack_size[1] = (uint32_t) (__StackOneTop - __StackOneBottom) * sizeof(uint32_t);
+#else
+    // simulador: heap do processo, sem limite fixo nem pilhas pintadas
+    struct mallinfo2 heap = mallinfo2();
+    snapshot.heap_used = (uint32_t) heap.uordblks;
+    snapshot.heap_arena = (uint32_t) heap.arena;
+    snapshot.heap_size = (uint32_t) heap.arena;
+#endif
+    if (snapshot.heap_used > snapshot.heap_peak) snapshot.heap_peak = snapshot.heap_used;
+
+#if MEM_STATS
+    memstat_lwip_pool(&lwip_stats.mem, &snapshot.lwip_heap);
+#endif
+
+    snapshot.pool_errors = 0;
+    for (uint8_t i = 0; i < MEMP_MAX; i++) {
+        MemstatPool pool;
+        memstat_pool_get(i, &pool);
+        snapshot.pool_errors += pool.err;
+    }
+    snapshot.samples++;
+}
+
+// Avisa no terminal das falhas de alocação novas desde a última amostragem
+static void memstat_report_failures() {
+    if (snapshot.lwip_heap.err > reported_heap_err) {
+        LOG_WARN("Memoria: %lu falhas de alocacao no heap do lwIP (pico %lu de %lu bytes)\n",
+            (unsigned long) snapshot.lwip_heap.err, (unsigned long) snapshot.lwip_heap.max, (unsigned long) snapshot.lwip_heap.avail);
+        reported_heap_err = snapshot.lwip_heap.err;
+    }
+
+    for (uint8_t i = 0; i < MEMP_MAX; i++) {
+        MemstatPool pool;
+        memstat_pool_get(i, &pool);
+        if (pool.err <= reported_pool_err[i]) continue;
+
+        LOG_WARN("Memoria: %lu falhas de alocacao no pool %s (pico %lu de %lu)\n",
+            (unsigned long) pool.err, pool_names[i], (unsigned long) pool.max, (unsigned long) pool.avail);
+        reported_pool_err[i] = pool.err;
+    }
+}
+
+void memstat_init() {
+#if PICO_ON_DEVICE
+    // núcleo 0: pinta até um pouco abaixo do quadro atual, que está em uso
+    volatile uint32_t marker = 0;
+    uint32_t *limit = (uint32_t *) &marker - MEMSTAT_PAINT_MARGIN_WORDS;
+    if (limit > __StackBottom) memstat_paint(__StackBottom, limit);
+
+    // núcleo 1: ainda não iniciado, a pilha toda
+    memstat_paint(__StackOneBottom, __StackOneTop);
+#endif
+
+    memstat_sample();
+    last_sample_ms = hal_time_ms();
+}
+
+void memstat_update() {
+    uint32_t now = hal_time_ms();
+    if (now - last_sample_ms < MEMSTAT_PERIOD_MS) return;
+    last_sample_ms = now;
+
+    memstat_sample();
+    memstat_report_failures();
+}
+
+void memstat_get(MemstatSnapshot *out) {
+    memstat_sample();
+    *out = snapshot;
+}
+
+uint8_t memstat_pool_count() {
+    return MEMP_MAX;
+}
+
+const char *memstat_pool_name(uint8_t pool) {
+    return pool < MEMP_MAX ? pool_names[pool] : "?";
+}
+
+void memstat_pool_get(uint8_t pool, MemstatPool *out) {
+    *out = (MemstatPool) {0};
+#if MEMP_STATS
+    // os ponteiros são preenchidos por memp_init, na inicialização do lwIP
+    if (pool < MEMP_MAX) memstat_lwip_pool(lwip_stats.memp[pool], out);
+#endif
+}
+
+void memstat_print() {
+    MemstatSnapshot memory;
+    memstat_get(&memory);
+
+    printf("==== MEMORIA ====\n");
+    printf("Heap: %lu bytes em uso, pico %lu, arena %lu de %lu bytes\n", (unsigned long) memory.heap_used,
+        (unsigned long) memory.heap_peak, (unsigned long) memory.heap_arena, (unsigned long) memory.heap_size);
+    for (uint8_t core = 0; core < MEMSTAT_NUM_CORES; core++) {
+        printf("Pilha do nucleo %u: pico de %lu de %lu bytes\n", core, (unsigned long) memory.stack_used[core],
+            (unsigned long) memory.stack_size[core]);
+    }
+    printf("Heap do lwIP: %lu de %lu bytes, pico %lu, %lu falhas\n", (unsigned long) memory.lwip_heap.used,
+        (unsigned long) memory.lwip_heap.avail, (unsigned long) memory.lwip_heap.max, (unsigned long) memory.lwip_heap.err);
+
+    printf("Pools do lwIP (em uso/pico/capacidade, falhas):\n");
+    for (uint8_t i = 0; i < MEMP_MAX; i++) {
+        MemstatPool pool;
+        memstat_pool_get(i, &pool);
+        printf("  %-16s %3lu/%3lu/%3lu  %lu\n", pool_names[i], (unsigned long) pool.used, (unsigned long) pool.max,
+            (unsigned long) pool.avail, (unsigned long) pool.err);
+    }
+    printf("=================\n");
+}
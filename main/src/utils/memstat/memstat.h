@@ -0,0 +1,73 @@
+#ifndef MEMSTAT_H
+#define MEMSTAT_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+
+/**
+ * @file memstat.h
+ *
+ * @brief Telemetria de memória: heap do malloc, pico de uso das pilhas dos dois núcleos e heap e
+ * pools do lwIP, com os contadores de falha de alocação.
+ *
+ * @note As pilhas são pintadas com um padrão no boot (memstat_init, a primeira chamada de main) e o
+ * pico de uso é a parte do padrão que já foi sobrescrita. O heap do malloc vem de mallinfo: o uso
+ * atual, o maior uso observado nas amostragens e a arena (área já reservada ao malloc, que nunca
+ * diminui e por isso também marca o pico entre amostragens). O lwIP mantém sozinho o uso, o pico e
+ * as falhas do seu heap (MEM_SIZE) e de cada pool (MEMP_STATS, ligado em lwipopts.h).
+ *
+ * A amostragem é feita a cada MEMSTAT_PERIOD_MS por memstat_update, que avisa no terminal quando
+ * algum contador de falha aumenta. Os valores são exibidos no terminal e na rota /memory da API local.
+ *
+ * @warning memstat_update e memstat_get leem os contadores do lwIP: devem ser chamadas com o lwIP
+ * travado (hal_lwip_begin/end) depois que a rede foi iniciada.
+ */
+
+// intervalo entre amostragens
+#define MEMSTAT_PERIOD_MS 5000
+
+// núcleos do RP2040 (pilhas separadas, nas memórias SCRATCH_Y e SCRATCH_X)
+#define MEMSTAT_NUM_CORES 2
+
+// padrão de pintura das pilhas
+#define MEMSTAT_STACK_PAINT 0xA5A5A5A5u
+
+// uso de um heap ou pool do lwIP (em bytes no heap, em elementos nos pools)
+typedef struct {
+    uint32_t used;
+    uint32_t max;               // maior uso desde o boot
+    uint32_t avail;             // capacidade
+    uint32_t err;               // alocações que falharam
+} MemstatPool;
+
+// retrato da memória
+typedef struct {
+    uint32_t heap_used;                         // bytes em uso no malloc
+    uint32_t heap_peak;                         // maior uso observado nas amostragens
+    uint32_t heap_arena;                        // área reservada ao malloc (pico real de uso do heap)
+    uint32_t heap_size;                         // espaço do heap entre o fim dos dados e o limite
+    uint32_t stack_used[MEMSTAT_NUM_CORES];     // pico de uso da pilha de cada núcleo
+    uint32_t stack_size[MEMSTAT_NUM_CORES];
+    MemstatPool lwip_heap;                      // heap do lwIP (MEM_SIZE)
+    uint32_t pool_errors;                       // falhas somadas de todos os pools do lwIP
+    uint32_t samples;                           // amostragens feitas
+} MemstatSnapshot;
+
+// definição das funções
+
+// pinta as pilhas; deve ser a primeira chamada de main (e antes de iniciar o núcleo 1)
+void memstat_init();
+// amostra a memória se o intervalo venceu; deve ser chamada no laço principal
+void memstat_update();
+// copia o retrato da memória (com o uso atual do heap)
+void memstat_get(MemstatSnapshot *out);
+// pools do lwIP (pbufs, pcbs, segmentos TCP...)
+uint8_t memstat_pool_count();
+// nome do pool, como em memp_std.h do lwIP
+const char *memstat_pool_name(uint8_t pool);
+// uso de um pool do lwIP
+void memstat_pool_get(uint8_t pool, MemstatPool *out);
+// exibe o retrato completo, com todos os pools do lwIP
+void memstat_print();
+
+#endif
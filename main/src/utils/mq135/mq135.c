@@ -1,5 +1,5 @@
 #include "mq135.h"
-#include "hardware/adc.h"
+#include "prof.h"
 
 // Define qual canal ADC o MQ-135 está conectado (ADC2 no GPIO28)
 #define MQ135_ADC_INPUT 2
@@ -12,15 +12,13 @@
 
 // Função para inicializar o ADC e configurar o pino GPIO usado pelo MQ-135
 void mq135_init(void) {
-    adc_init();                         // Inicializa o ADC
-    adc_gpio_init(28);                  // Configura o GPIO28 (canal ADC2) como entrada analógica
-    adc_select_input(MQ135_ADC_INPUT);  // Seleciona o canal ADC2 como ativo
+    hal_adc_init(28);                   // Configura o GPIO28 (canal ADC2) como entrada analógica
 }
 
 // Função que realiza a leitura do valor bruto (0 a 4095) do ADC conectado ao MQ-135
 uint16_t mq135_read_raw(void) {
-    adc_select_input(MQ135_ADC_INPUT); // Garante que o canal ADC correto está selecionado
-    return adc_read();                 // Retorna a leitura analógica bruta
+    PROF_SCOPE(PROF_ADC_READ);
+    return hal_adc_read(MQ135_ADC_INPUT); // Seleciona o canal ADC2 e retorna a leitura analógica bruta
 }
 
 // Função que converte o valor bruto lido pelo ADC em tensão (0 a 3.3V)
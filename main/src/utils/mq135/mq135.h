@@ -2,7 +2,7 @@
 #define MQ135_H
 
 // inclusão de bibliotecas
-#include "pico/stdlib.h"
+#include "hal.h"
 
 // definição das funções
 
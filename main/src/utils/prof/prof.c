@@ -0,0 +1,162 @@
+#if !PICO_ON_DEVICE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "prof.h"
+#include <stdio.h>
+
+#if PICO_ON_DEVICE
+#include "hal.h"
+#else
+#include <time.h>
+#endif
+
+// largura máxima das barras do histograma no log
+#define PROF_BAR_WIDTH 30
+
+static ProfHistogram probes[PROF_NUM_PROBES];
+static bool probes_ready = false;
+
+static const char *const probe_names[PROF_NUM_PROBES] = {
+    [PROF_DHT11_READ] = "dht11_read",
+    [PROF_ADC_READ] = "adc_read",
+    [PROF_DISPLAY_DRAW] = "display_draw",
+    [PROF_DISPLAY_FLUSH] = "display_flush",
+    [PROF_JSON_FORMAT] = "json_format",
+    [PROF_TCP_WRITE] = "tcp_write",
+};
+
+// implementação das funções
+
+uint64_t prof_now_ns(void) {
+#if PICO_ON_DEVICE
+    return hal_time_us_64() * 1000;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+#endif
+}
+
+uint32_t prof_cycles(void) {
+#if PICO_ON_DEVICE
+    return hal_cycle_count();
+#else
+    return 0;
+#endif
+}
+
+uint64_t prof_elapsed_ns(uint64_t started_ns, uint32_t started_cycles) {
+#if PICO_ON_DEVICE
+    uint32_t cycles = (hal_cycle_count() - started_cycles) & HAL_CYCLE_COUNT_MASK;
+    uint64_t elapsed_ns = prof_now_ns() - started_ns;
+
+    // trecho curto: o SysTick não pode ter dado a volta e os ciclos valem (o timer só tem 1 µs de resolução)
+    uint32_t hz = hal_cpu_hz();
+    uint64_t wrap_ns = (uint64_t) (HAL_CYCLE_COUNT_MASK + 1) * 1000000000u / hz;
+    if (elapsed_ns < wrap_ns / 2) return (uint64_t) cycles * 1000000000u / hz;
+    return elapsed_ns;
+#else
+    (void) started_cycles;
+    return prof_now_ns() - started_ns;
+#endif
+}
+
+void prof_histogram_reset(ProfHistogram *histogram) {
+    *histogram = (ProfHistogram) {0};
+    histogram->min_ns = UINT32_MAX;
+}
+
+void prof_histogram_record(ProfHistogram *histogram, uint64_t elapsed_ns) {
+    uint32_t ns = elapsed_ns > UINT32_MAX ? UINT32_MAX : (uint32_t) elapsed_ns;
+
+    // faixa = posição do bit mais significativo
+    uint8_t bucket = ns == 0 ? 0 : 31 - __builtin_clz(ns);
+    if (bucket >= PROF_BUCKETS) bucket = PROF_BUCKETS - 1;
+
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->total_ns += elapsed_ns;
+    if (ns < histogram->min_ns) histogram->min_ns = ns;
+    if (ns > histogram->max_ns) histogram->max_ns = ns;
+}
+
+// Escreve uma duração na maior unidade em que ela fica com até 4 dígitos
+static void prof_print_duration(uint64_t ns) {
+    static const char *const units[] = {"ns", "us", "ms", "s"};
+    uint8_t unit = 0;
+
+    while (ns >= 10000 && unit < 3) {
+        ns /= 1000;
+        unit++;
+    }
+    printf("%lu %s", (unsigned long) ns, units[unit]);
+}
+
+void prof_histogram_print(const char *name, const ProfHistogram *histogram) {
+    printf("%s: %lu medidas", name, (unsigned long) histogram->count);
+    if (histogram->count == 0) {
+        printf("\n");
+        return;
+    }
+
+    printf(", min ");
+    prof_print_duration(histogram->min_ns);
+    printf(", media ");
+    prof_print_duration(histogram->total_ns / histogram->count);
+    printf(", max ");
+    prof_print_duration(histogram->max_ns);
+    printf("\n");
+
+    uint32_t peak = 0;
+    for (int i = 0; i < PROF_BUCKETS; i++) {
+        if (histogram->buckets[i] > peak) peak = histogram->buckets[i];
+    }
+
+    for (int i = 0; i < PROF_BUCKETS; i++) {
+        if (histogram->buckets[i] == 0) continue;
+
+        printf("  ");
+        prof_print_duration(i == 0 ? 0 : 1ull << i);
+        printf(" - ");
+        prof_print_duration(1ull << (i + 1));
+        printf(": %lu ", (unsigned long) histogram->buckets[i]);
+
+        uint32_t bar = (uint32_t) ((uint64_t) histogram->buckets[i] * PROF_BAR_WIDTH / peak);
+        for (uint32_t j = 0; j < (bar > 0 ? bar : 1); j++) putchar('#');
+        printf("\n");
+    }
+}
+
+void prof_reset(void) {
+    for (int i = 0; i < PROF_NUM_PROBES; i++) prof_histogram_reset(&probes[i]);
+    probes_ready = true;
+}
+
+void prof_record(ProfProbe probe, uint64_t elapsed_ns) {
+    if (!probes_ready) prof_reset();
+    prof_histogram_record(&probes[probe], elapsed_ns);
+}
+
+void prof_get(ProfProbe probe, ProfHistogram *out) {
+    if (!probes_ready) prof_reset();
+    *out = probes[probe];
+}
+
+const char *prof_probe_name(ProfProbe probe) {
+    return probe < PROF_NUM_PROBES ? probe_names[probe] : "?";
+}
+
+void prof_dump(void) {
+    if (!PROF_ENABLED) {
+        printf("Perfil: sondas desligadas (build com -DSTATION_PROFILING=ON)\n");
+        return;
+    }
+    if (!probes_ready) prof_reset();
+
+    printf("==== PERFIL (tempo por chamada) ====\n");
+    for (int i = 0; i < PROF_NUM_PROBES; i++) {
+        if (probes[i].count > 0) prof_histogram_print(probe_names[i], &probes[i]);
+    }
+    printf("====================================\n");
+}
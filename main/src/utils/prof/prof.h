@@ -0,0 +1,105 @@
+#ifndef PROF_H
+#define PROF_H
+
+// inclusão de bibliotecas
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file prof.h
+ *
+ * @brief Medição de tempo dos trechos críticos, com histograma log2 de latência por sonda.
+ *
+ * @note PROF_SCOPE(sonda) mede do ponto em que aparece até o fim do bloco (atributo cleanup do GCC)
+ * e acumula contagem, mínimo, máximo, total e a faixa do histograma (faixa i = [2^i, 2^(i+1)) ns).
+ * Com PROF_ENABLED = 0 (padrão; build com -DSTATION_PROFILING=ON liga) as sondas somem do código.
+ *
+ * O tempo é contado em nanossegundos. No dispositivo prof_now_ns vem do timer de 1 µs (hal_time_us_64),
+ * e as sondas também leem o SysTick (hal_cycle_count): trechos mais curtos do que metade da volta dele
+ * (~67 ms a 125 MHz) são medidos em ciclos do clk_sys (8 ns a 125 MHz) e os mais longos pelo
+ * timer. No computador tudo vem de CLOCK_MONOTONIC. Os histogramas e prof_now_ns ficam disponíveis
+ * mesmo com as sondas desligadas e são usados pelos benchmarks em tools/.
+ *
+ * @warning Cada sonda deve ser registrada sempre a partir do mesmo contexto (laço principal ou
+ * com o lwIP travado), já que os contadores não são atômicos.
+ */
+
+#ifndef PROF_ENABLED
+#define PROF_ENABLED 0
+#endif
+
+// faixas do histograma: de 1 ns a 2^31 ns (~2,1 s); tempos maiores caem na última
+#define PROF_BUCKETS 32
+
+// trechos medidos
+typedef enum {
+    PROF_DHT11_READ,            // leitura dos 40 bits do DHT11
+    PROF_ADC_READ,              // conversão do ADC do MQ-135
+    PROF_DISPLAY_DRAW,          // desenho dos glifos de um texto no framebuffer
+    PROF_DISPLAY_FLUSH,         // envio do framebuffer ao SSD1306 (ssd1306_show)
+    PROF_JSON_FORMAT,           // serialização JSON de uma amostra
+    PROF_TCP_WRITE,             // escrita no TCP (altcp_write)
+    PROF_NUM_PROBES
+} ProfProbe;
+
+// histograma de latência
+typedef struct {
+    uint32_t count;
+    uint32_t min_ns;
+    uint32_t max_ns;
+    uint64_t total_ns;
+    uint32_t buckets[PROF_BUCKETS];
+} ProfHistogram;
+
+// medição em andamento de PROF_SCOPE
+typedef struct {
+    ProfProbe probe;
+    uint64_t started_ns;
+    uint32_t started_cycles;    // SysTick no início (só no dispositivo)
+} ProfTimer;
+
+// definição das funções
+
+// relógio monotônico em nanossegundos
+uint64_t prof_now_ns(void);
+// ciclos do SysTick para prof_elapsed_ns (0 no computador)
+uint32_t prof_cycles(void);
+// tempo desde started_ns/started_cycles: em ciclos se o trecho foi curto, senão pelo relógio
+uint64_t prof_elapsed_ns(uint64_t started_ns, uint32_t started_cycles);
+// zera um histograma
+void prof_histogram_reset(ProfHistogram *histogram);
+// acumula uma medida no histograma
+void prof_histogram_record(ProfHistogram *histogram, uint64_t elapsed_ns);
+// exibe contagem, mínimo, média, máximo e as faixas ocupadas do histograma
+void prof_histogram_print(const char *name, const ProfHistogram *histogram);
+// acumula uma medida na sonda
+void prof_record(ProfProbe probe, uint64_t elapsed_ns);
+// copia o histograma de uma sonda
+void prof_get(ProfProbe probe, ProfHistogram *out);
+// nome da sonda, para o log
+const char *prof_probe_name(ProfProbe probe);
+// exibe os histogramas de todas as sondas com alguma medida
+void prof_dump(void);
+// zera as sondas
+void prof_reset(void);
+
+static inline ProfTimer prof_timer_start(ProfProbe probe) {
+    // o SysTick por último e, no fim, primeiro: o trecho medido fica entre as duas leituras dele
+    uint64_t started_ns = prof_now_ns();
+    return (ProfTimer) {probe, started_ns, prof_cycles()};
+}
+
+static inline void prof_timer_stop(ProfTimer *timer) {
+    prof_record(timer->probe, prof_elapsed_ns(timer->started_ns, timer->started_cycles));
+}
+
+#if PROF_ENABLED
+#define PROF_CONCAT_(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT_(a, b)
+#define PROF_SCOPE(probe) \
+    ProfTimer PROF_CONCAT(prof_timer_, __LINE__) __attribute__((cleanup(prof_timer_stop))) = prof_timer_start(probe)
+#else
+#define PROF_SCOPE(probe) do {} while (0)
+#endif
+
+#endif
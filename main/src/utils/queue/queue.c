@@ -0,0 +1,217 @@
+#include "queue.h"
+#include <string.h>
+
+#if QUEUE_SPILL_TO_FLASH
+#include "store.h"
+#endif
+
+// tamanho do registro gravado na flash: amostra compactada + máscara de canais
+#define QUEUE_RECORD_SIZE (SAMPLE_PACKED_SIZE + 1)
+// registro gravado antes do boot fazer parte da amostra
+#define QUEUE_RECORD_SIZE_V1 (SAMPLE_PACKED_SIZE_V1 + 1)
+
+// buffer circular em RAM com as amostras mais recentes
+static QueueEntry ring[QUEUE_CAPACITY];
+static uint16_t ring_tail = 0;      // entrada mais antiga
+static uint16_t ring_count = 0;
+
+static uint32_t next_seq = 1;       // sequência da próxima amostra (única fonte de sequências)
+static uint32_t acked_seq = 0;      // última sequência confirmada
+static uint16_t boot = 0;           // boot atual, gravado em cada amostra (0 sem spill)
+
+// lotes em voo, do mais antigo para o mais recente
+static uint32_t inflight_last_seq[QUEUE_MAX_IN_FLIGHT];
+static uint16_t inflight_count[QUEUE_MAX_IN_FLIGHT];
+static uint8_t inflight_batches = 0;
+
+static QueueStats stats;
+
+// descarta da RAM as entradas já confirmadas
+static void queue_release_acked(void) {
+    while (ring_count > 0 && ring[ring_tail].seq <= acked_seq) {
+        ring_tail = (ring_tail + 1) % QUEUE_CAPACITY;
+        ring_count--;
+    }
+}
+
+#if QUEUE_SPILL_TO_FLASH
+// lê do log da flash as amostras posteriores a after_seq e mais antigas do que a primeira entrada em RAM
+static uint16_t queue_read_flash(uint32_t after_seq, uint32_t ram_first_seq, QueueEntry *entries, uint16_t max_entries) {
+    uint8_t record[STORE_MAX_PAYLOAD];
+    uint8_t len;
+    uint32_t seq;
+    uint16_t count = 0;
+
+    StoreCursor cursor;
+    store_cursor_begin(&cursor);
+    while (count < max_entries && store_read_next(&cursor, record, &len, &seq)) {
+        if (seq >= ram_first_seq) break;
+        if (seq <= after_seq) continue;
+
+        // registro antigo, sem o boot: a máscara de canais vai para o fim e o boot fica desconhecido (0)
+        if (len == QUEUE_RECORD_SIZE_V1) {
+            record[SAMPLE_PACKED_SIZE] = record[SAMPLE_PACKED_SIZE_V1];
+            memset(record + SAMPLE_PACKED_SIZE_V1, 0, SAMPLE_PACKED_SIZE - SAMPLE_PACKED_SIZE_V1);
+        } else if (len != QUEUE_RECORD_SIZE) {
+            continue;
+        }
+
+        entries[count].seq = seq;
+        sample_unpack(&entries[count].sample, record);
+        entries[count].channels = record[SAMPLE_PACKED_SIZE];
+        count++;
+    }
+
+    stats.from_flash += count;
+    return count;
+}
+#endif
+
+// implementação das funções
+
+void queue_init(void) {
+    ring_tail = 0;
+    ring_count = 0;
+    inflight_batches = 0;
+    memset(&stats, 0, sizeof(stats));
+    stats.ram_bytes = sizeof(ring);
+
+#if QUEUE_SPILL_TO_FLASH
+    // o backlog que ficou na flash antes da reinicialização continua pendente
+    acked_seq = store_acked_seq();
+    next_seq = store_next_seq();
+    boot = (uint16_t) store_boot_id();
+#else
+    acked_seq = 0;
+    next_seq = 1;
+    boot = 0;
+#endif
+}
+
+bool queue_push(const SensorSample *sample, uint8_t channels) {
+    QueueEntry entry = { .seq = next_seq++, .sample = *sample, .channels = channels };
+    entry.sample.boot = boot;
+    bool stored = false;
+
+#if QUEUE_SPILL_TO_FLASH
+    // a sequência é da fila: se a gravação falhar, ela fica só em RAM e vira uma lacuna no log
+    uint8_t record[QUEUE_RECORD_SIZE];
+    sample_pack(&entry.sample, record);
+    record[SAMPLE_PACKED_SIZE] = channels;
+    stored = store_append(entry.seq, record, QUEUE_RECORD_SIZE);
+#endif
+
+    // RAM cheia: a entrada mais antiga sai da RAM (continua na flash se foi gravada lá)
+    if (ring_count == QUEUE_CAPACITY) {
+        QueueEntry *oldest = &ring[ring_tail];
+        if (inflight_batches > 0 && oldest->seq <= inflight_last_seq[inflight_batches - 1]) {
+            // não descarta amostras de um lote em voo; a nova amostra fica só na flash
+            stats.pushed++;
+            if (!stored) stats.dropped++;
+            return stored;
+        }
+        if (!QUEUE_SPILL_TO_FLASH || !stored) stats.dropped++;
+        ring_tail = (ring_tail + 1) % QUEUE_CAPACITY;
+        ring_count--;
+    }
+
+    ring[(ring_tail + ring_count) % QUEUE_CAPACITY] = entry;
+    ring_count++;
+    stats.pushed++;
+    return true;
+}
+
+uint32_t queue_pending(void) {
+#if QUEUE_SPILL_TO_FLASH
+    // com spill, todas as amostras pendentes estão na flash
+    uint32_t flash_pending = store_pending();
+    if (flash_pending >= ring_count) return flash_pending;
+#endif
+    return ring_count;
+}
+
+bool queue_oldest_timestamp(uint32_t *timestamp_s) {
+    uint32_t after_seq = inflight_batches > 0 ? inflight_last_seq[inflight_batches - 1] : acked_seq;
+
+    for (uint16_t i = 0; i < ring_count; i++) {
+        const QueueEntry *entry = &ring[(ring_tail + i) % QUEUE_CAPACITY];
+        if (entry->seq <= after_seq) continue;
+
+        // há amostras mais antigas do que a RAM esperando na flash
+        if (entry->seq != after_seq + 1) return false;
+        *timestamp_s = entry->sample.timestamp_s;
+        return true;
+    }
+    return false;
+}
+
+uint8_t queue_in_flight(void) {
+    return inflight_batches;
+}
+
+uint16_t queue_next_batch(QueueEntry *entries, uint16_t max_entries) {
+    if (inflight_batches == QUEUE_MAX_IN_FLIGHT || max_entries == 0) return 0;
+
+    // o novo lote começa logo após o último lote em voo
+    uint32_t after_seq = inflight_batches > 0 ? inflight_last_seq[inflight_batches - 1] : acked_seq;
+    uint16_t count = 0;
+
+    // a RAM em ordem de sequência; a posição i == ring_count representa a próxima amostra (next_seq),
+    // para que também a lacuna depois da última entrada em RAM seja vista
+    for (uint16_t i = 0; i <= ring_count && count < max_entries; i++) {
+        const QueueEntry *entry = i < ring_count ? &ring[(ring_tail + i) % QUEUE_CAPACITY] : NULL;
+        uint32_t seq = entry != NULL ? entry->seq : next_seq;
+        if (seq <= after_seq) continue;
+
+#if QUEUE_SPILL_TO_FLASH
+        // lacuna antes desta entrada: amostras que só estão na flash (backfill mais antigo do que a
+        // RAM, ou gravadas com a RAM cheia e o lote mais antigo em voo); sem elas no lote, a
+        // confirmação seguinte as descartaria do log sem terem sido enviadas
+        uint32_t expected_seq = count > 0 ? entries[count - 1].seq + 1 : after_seq + 1;
+        if (seq > expected_seq) {
+            count += queue_read_flash(expected_seq - 1, seq, entries + count, max_entries - count);
+            if (count == max_entries) break;
+        }
+#endif
+
+        if (entry != NULL) entries[count++] = *entry;
+    }
+
+    if (count > 0) {
+        inflight_last_seq[inflight_batches] = entries[count - 1].seq;
+        inflight_count[inflight_batches] = count;
+        inflight_batches++;
+    }
+    return count;
+}
+
+void queue_ack(void) {
+    if (inflight_batches == 0) return;
+
+    acked_seq = inflight_last_seq[0];
+#if QUEUE_SPILL_TO_FLASH
+    store_ack(acked_seq);
+#endif
+    queue_release_acked();
+
+    stats.acked += inflight_count[0];
+    stats.batches++;
+
+    // remove o lote confirmado do início da lista de lotes em voo
+    inflight_batches--;
+    for (uint8_t i = 0; i < inflight_batches; i++) {
+        inflight_last_seq[i] = inflight_last_seq[i + 1];
+        inflight_count[i] = inflight_count[i + 1];
+    }
+}
+
+void queue_nack(void) {
+    if (inflight_batches == 0) return;
+
+    stats.retries += inflight_batches;
+    inflight_batches = 0;
+}
+
+void queue_get_stats(QueueStats *out) {
+    *out = stats;
+}
@@ -0,0 +1,70 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+#include "sample.h"
+
+// quantidade máxima de amostras mantidas em RAM (teto de memória da fila)
+#ifndef QUEUE_CAPACITY
+#define QUEUE_CAPACITY 64
+#endif
+
+// quantidade máxima de amostras enviadas em uma única requisição
+#ifndef QUEUE_BATCH_SIZE
+#define QUEUE_BATCH_SIZE 32
+#endif
+
+// quantidade máxima de lotes aguardando confirmação ao mesmo tempo (pipelining)
+#ifndef QUEUE_MAX_IN_FLIGHT
+#define QUEUE_MAX_IN_FLIGHT 2
+#endif
+
+// quando 1, toda amostra também é gravada no log da flash (store), de onde o backlog é lido
+// quando não cabe mais em RAM ou após uma reinicialização
+#ifndef QUEUE_SPILL_TO_FLASH
+#define QUEUE_SPILL_TO_FLASH 1
+#endif
+
+// amostra aguardando envio
+typedef struct {
+    uint32_t seq;           // sequência única (a mesma do log na flash quando o spill está ativo)
+    SensorSample sample;    // dados da leitura
+    uint8_t channels;       // máscara dos canais que devem ser reportados
+} QueueEntry;
+
+// estatísticas da fila
+typedef struct {
+    uint32_t pushed;            // amostras enfileiradas
+    uint32_t acked;             // amostras confirmadas pelo servidor
+    uint32_t batches;           // lotes confirmados
+    uint32_t retries;           // lotes devolvidos para reenvio
+    uint32_t dropped;           // amostras descartadas por falta de espaço (sem spill)
+    uint32_t from_flash;        // amostras lidas do log da flash durante o backfill
+    uint32_t ram_bytes;         // memória reservada para a fila em RAM
+} QueueStats;
+
+// definição das funções
+
+// inicializa a fila (com spill, o log da flash já deve estar montado)
+void queue_init(void);
+// enfileira uma amostra; retorna false se ela precisou ser descartada
+bool queue_push(const SensorSample *sample, uint8_t channels);
+// quantidade de amostras ainda não confirmadas (RAM + flash)
+uint32_t queue_pending(void);
+// timestamp da amostra pendente mais antiga ainda não enviada; retorna false se ela só existe na flash
+// (backlog de antes da reinicialização, cujo relógio não é comparável com o atual)
+bool queue_oldest_timestamp(uint32_t *timestamp_s);
+// quantidade de lotes aguardando confirmação
+uint8_t queue_in_flight(void);
+// separa o próximo lote (em ordem de sequência, após os lotes já em voo) e o marca como em voo;
+// retorna o tamanho do lote (0 se não há amostras ou se o limite de lotes em voo foi atingido)
+uint16_t queue_next_batch(QueueEntry *entries, uint16_t max_entries);
+// confirma o lote em voo mais antigo: as amostras saem da fila e não serão reenviadas
+void queue_ack(void);
+// devolve todos os lotes em voo para a fila, para serem reenviados em ordem
+void queue_nack(void);
+// copia as estatísticas da fila
+void queue_get_stats(QueueStats *out);
+
+#endif
@@ -0,0 +1,84 @@
+#include "radio.h"
+#include <stdio.h>
+#include "wifi.h"
+#include "queue.h"
+#include "log.h"
+
+// estado da janela
+static bool window_open = true;
+static uint32_t window_started_ms = 0;
+static uint32_t next_window_ms = 0;
+// a última janela esgotou o tempo sem esvaziar a fila: a próxima espera o período inteiro
+static bool backing_off = false;
+
+static RadioStats stats = {0};
+
+// implementação das funções
+
+// Período das janelas: a idade máxima atual do lote
+static uint32_t radio_window_period_ms(void) {
+    return server_batch_max_age_s() * 1000;
+}
+
+void radio_init() {
+    window_open = true;
+    window_started_ms = hal_time_ms();
+    next_window_ms = window_started_ms + radio_window_period_ms();
+    backing_off = false;
+
+    if (RADIO_DUTY_CYCLE) {
+        stats.windows++;
+        server_flush();
+    }
+}
+
+void radio_update() {
+    if (!RADIO_DUTY_CYCLE) return;
+
+    uint32_t now = hal_time_ms();
+
+    if (window_open) {
+        bool flushed = queue_pending() == 0 && queue_in_flight() == 0;
+        bool expired = now - window_started_ms >= RADIO_WINDOW_MAX_MS;
+        if (!flushed && !expired) return;
+
+        // fim da janela: fecha a conexão antes de sair da rede, para não deixar lotes presos nela
+        server_disconnect();
+        wifi_suspend();
+
+        window_open = false;
+        stats.last_window_ms = now - window_started_ms;
+        // servidor inalcançável: com a fila cheia o lote estaria sempre pronto e o rádio reabriria a
+        // janela logo em seguida, então o período conta a partir do fim desta
+        backing_off = expired && !flushed;
+        if (backing_off) next_window_ms = now + radio_window_period_ms();
+        if (flushed) stats.flushed++;
+        else stats.expired++;
+        LOG_INFO("Radio: janela de %lu ms encerrada (%s), proxima em ate %lu s\n", (unsigned long) stats.last_window_ms,
+                 flushed ? "fila vazia" : "tempo esgotado", (unsigned long) server_batch_max_age_s());
+        return;
+    }
+
+    // lote cheio (exceto após uma janela esgotada), ou período vencido com alguma amostra à espera
+    uint32_t pending = queue_pending();
+    bool full = !backing_off && pending >= server_batch_min_samples();
+    bool due = pending > 0 && (int32_t) (now - next_window_ms) >= 0;
+    if (!full && !due) return;
+
+    wifi_resume();
+    server_flush();
+
+    window_open = true;
+    window_started_ms = now;
+    next_window_ms = now + radio_window_period_ms();
+    backing_off = false;
+    stats.windows++;
+}
+
+bool radio_window_open() {
+    return window_open;
+}
+
+void radio_get_stats(RadioStats *out) {
+    *out = stats;
+}
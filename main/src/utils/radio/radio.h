@@ -0,0 +1,54 @@
+#ifndef RADIO_H
+#define RADIO_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+#include "server.h"
+
+/**
+ * @file radio.h
+ *
+ * @brief Ciclo de trabalho do rádio: envios agrupados em janelas, com o Wi-Fi desligado entre elas.
+ *
+ * @note Com RADIO_DUTY_CYCLE = 1 (build com -DSTATION_DUTY_CYCLE=ON) a estação só se associa à rede
+ * durante as janelas de envio. Uma janela abre quando o lote estaria pronto no modo contínuo: a cada
+ * idade máxima do lote se houver amostras pendentes, ou antes disso se a fila juntar a quantidade
+ * mínima do lote (os limites atuais de server_set_batching). Assim nenhuma amostra espera mais do que
+ * esperaria com o rádio sempre ligado. Depois de uma janela que esgotou o tempo, a próxima espera o
+ * período inteiro.
+ *
+ * Na janela o enlace é refeito (direto ao AP guardado, ver wifi.h), a fila é esvaziada sem esperar
+ * pelos limites do lote (server_flush) e, com tudo confirmado ou após RADIO_WINDOW_MAX_MS, a conexão
+ * com o servidor é fechada e o rádio volta a ficar ocioso. O que sobrar fica para a próxima janela.
+ *
+ * Com RADIO_DUTY_CYCLE = 0 o rádio fica sempre ligado e radio_update não faz nada; o tempo de rádio
+ * ativo por hora é informado pelo wifi nos dois modos.
+ */
+
+#ifndef RADIO_DUTY_CYCLE
+#define RADIO_DUTY_CYCLE 0
+#endif
+
+// duração máxima de uma janela (associação, conexão e envio)
+#define RADIO_WINDOW_MAX_MS 30000
+
+// estatísticas das janelas
+typedef struct {
+    uint32_t windows;           // janelas abertas
+    uint32_t flushed;           // janelas encerradas com a fila vazia
+    uint32_t expired;           // janelas encerradas pelo tempo máximo, com amostras pendentes
+    uint32_t last_window_ms;    // duração da última janela
+} RadioStats;
+
+// definição das funções
+
+// começa com uma janela aberta, para enviar o backlog do boot; depois o rádio segue o ciclo
+void radio_init();
+// abre ou fecha a janela de envio; deve ser chamada no laço principal, antes de server_process_queue
+void radio_update();
+// janela de envio aberta (no modo contínuo, sempre)
+bool radio_window_open();
+// copia as estatísticas das janelas
+void radio_get_stats(RadioStats *out);
+
+#endif
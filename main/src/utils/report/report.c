@@ -0,0 +1,82 @@
+#include "report.h"
+#include <math.h>
+#include <string.h>
+
+// último valor reportado de cada canal
+typedef struct {
+    bool valid;             // se o canal já foi reportado alguma vez
+    float value;            // último valor enviado
+    const char *category;   // última categoria enviada
+    uint32_t sent_at_s;     // instante do último envio
+} ReportChannelState;
+
+static ReportChannelState channels[HISTORY_NUM_CHANNELS];
+static float deadbands[HISTORY_NUM_CHANNELS];
+static uint32_t heartbeat_s = REPORT_HEARTBEAT_S;
+static ReportCounters counters;
+
+// implementação das funções
+
+void report_init(void) {
+    memset(channels, 0, sizeof(channels));
+    memset(&counters, 0, sizeof(counters));
+
+    deadbands[HISTORY_TEMPERATURE] = REPORT_DEADBAND_TEMPERATURE;
+    deadbands[HISTORY_HUMIDITY] = REPORT_DEADBAND_HUMIDITY;
+    deadbands[HISTORY_POLLUTION] = REPORT_DEADBAND_POLLUTION;
+    heartbeat_s = REPORT_HEARTBEAT_S;
+}
+
+void report_set_deadband(HistoryChannel channel, float deadband) {
+    deadbands[channel] = deadband;
+}
+
+void report_set_heartbeat(uint32_t heartbeat) {
+    heartbeat_s = heartbeat;
+}
+
+uint8_t report_evaluate(uint32_t now_s, uint8_t valid, const float values[HISTORY_NUM_CHANNELS],
+                        const char *categories[HISTORY_NUM_CHANNELS]) {
+    uint8_t mask = 0;
+
+    for (int channel = 0; channel < HISTORY_NUM_CHANNELS; channel++) {
+        ReportChannelState *state = &channels[channel];
+        bool send = false;
+
+        // leitura falhou: o canal fica de fora e o último valor enviado continua sendo a referência
+        if (!(valid & REPORT_CHANNEL_BIT(channel))) continue;
+
+        if (!state->valid) {
+            // primeira leitura sempre é enviada
+            send = true;
+        } else if (fabsf(values[channel] - state->value) >= deadbands[channel]) {
+            send = true;
+            counters.by_delta++;
+        } else if (categories != NULL && categories[channel] != NULL && state->category != NULL
+                   && strcmp(categories[channel], state->category) != 0) {
+            send = true;
+            counters.by_category++;
+        } else if (now_s - state->sent_at_s >= heartbeat_s) {
+            send = true;
+            counters.by_heartbeat++;
+        }
+
+        if (!send) {
+            counters.suppressed[channel]++;
+            continue;
+        }
+
+        state->valid = true;
+        state->value = values[channel];
+        state->category = categories != NULL ? categories[channel] : NULL;
+        state->sent_at_s = now_s;
+        counters.sent[channel]++;
+        mask |= REPORT_CHANNEL_BIT(channel);
+    }
+
+    return mask;
+}
+
+void report_get_counters(ReportCounters *out) {
+    *out = counters;
+}
@@ -0,0 +1,45 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+#include "history.h"
+
+// bandas mortas padrão: variação mínima em relação ao último valor enviado para reportar o canal
+#define REPORT_DEADBAND_TEMPERATURE 1.0f    // °C
+#define REPORT_DEADBAND_HUMIDITY 3.0f       // %
+#define REPORT_DEADBAND_POLLUTION 2.0f      // %
+
+// tempo máximo sem reportar um canal (heartbeat), em segundos
+#define REPORT_HEARTBEAT_S 600
+
+// máscara de bits com os canais que devem ser enviados
+#define REPORT_CHANNEL_BIT(channel) (1u << (channel))
+#define REPORT_ALL_CHANNELS ((1u << HISTORY_NUM_CHANNELS) - 1)
+
+// contadores para medir a redução de tráfego
+typedef struct {
+    uint32_t sent[HISTORY_NUM_CHANNELS];        // leituras enviadas por canal
+    uint32_t suppressed[HISTORY_NUM_CHANNELS];  // leituras descartadas por canal
+    uint32_t by_delta;                          // envios motivados pela banda morta
+    uint32_t by_category;                       // envios motivados por mudança de categoria
+    uint32_t by_heartbeat;                      // envios motivados pelo heartbeat
+} ReportCounters;
+
+// definição das funções
+
+// restaura as bandas mortas padrão e esquece os últimos valores enviados
+void report_init(void);
+// altera em tempo de execução a banda morta de um canal
+void report_set_deadband(HistoryChannel channel, float deadband);
+// altera em tempo de execução o intervalo de heartbeat
+void report_set_heartbeat(uint32_t heartbeat_s);
+// decide quais canais devem ser enviados e os marca como reportados; retorna a máscara de canais
+// (valid: máscara dos canais com leitura válida, os demais nunca são reportados; as categorias devem ser
+// strings estáticas, como as retornadas por dht11_get_*_category e mq135_get_category)
+uint8_t report_evaluate(uint32_t now_s, uint8_t valid, const float values[HISTORY_NUM_CHANNELS],
+                        const char *categories[HISTORY_NUM_CHANNELS]);
+// copia os contadores de envio/supressão
+void report_get_counters(ReportCounters *out);
+
+#endif
@@ -0,0 +1,39 @@
+#include "sample.h"
+
+// implementação das funções
+
+void sample_make(SensorSample *sample, uint32_t timestamp_s, int temperature, int humidity, float pollution_level) {
+    sample->timestamp_s = timestamp_s;
+    sample->temperature = (int16_t) temperature;
+    sample->humidity = (int16_t) humidity;
+    sample->pollution_x10 = (uint16_t) (pollution_level * 10.0f + 0.5f);  // arredonda para o décimo mais próximo
+    sample->boot = 0;
+}
+
+float sample_pollution(const SensorSample *sample) {
+    return sample->pollution_x10 / 10.0f;
+}
+
+void sample_pack(const SensorSample *sample, uint8_t *buffer) {
+    buffer[0] = sample->timestamp_s;
+    buffer[1] = sample->timestamp_s >> 8;
+    buffer[2] = sample->timestamp_s >> 16;
+    buffer[3] = sample->timestamp_s >> 24;
+    buffer[4] = (uint16_t) sample->temperature;
+    buffer[5] = (uint16_t) sample->temperature >> 8;
+    buffer[6] = (uint16_t) sample->humidity;
+    buffer[7] = (uint16_t) sample->humidity >> 8;
+    buffer[8] = sample->pollution_x10;
+    buffer[9] = sample->pollution_x10 >> 8;
+    buffer[10] = sample->boot;
+    buffer[11] = sample->boot >> 8;
+}
+
+void sample_unpack(SensorSample *sample, const uint8_t *buffer) {
+    sample->timestamp_s = (uint32_t) buffer[0] | ((uint32_t) buffer[1] << 8)
+                        | ((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+    sample->temperature = (int16_t) (buffer[4] | (buffer[5] << 8));
+    sample->humidity = (int16_t) (buffer[6] | (buffer[7] << 8));
+    sample->pollution_x10 = (uint16_t) (buffer[8] | (buffer[9] << 8));
+    sample->boot = (uint16_t) (buffer[10] | (buffer[11] << 8));
+}
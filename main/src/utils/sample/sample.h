@@ -0,0 +1,42 @@
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+// inclusão de bibliotecas
+#include <stdint.h>
+#include <stdbool.h>
+
+// tamanho de uma amostra serializada em bytes (formato little-endian compacto); o boot fica nos dois
+// últimos bytes, então uma amostra de SAMPLE_PACKED_SIZE_V1 bytes (anterior ao boot) é lida com boot 0
+#define SAMPLE_PACKED_SIZE 12
+#define SAMPLE_PACKED_SIZE_V1 10
+
+// amostra dos sensores em formato compacto, usada pelo armazenamento e pelo envio
+//
+// A estação não tem relógio de parede: timestamp_s conta a partir do boot em que a leitura foi feita, e
+// boot identifica esse boot (contador gravado na flash, que cresce a cada reinicialização). Para o
+// receptor, o par (boot, timestamp_s) ordena as amostras; o maior boot já recebido é o boot atual, e
+// amostras dele podem ser levadas para o horário de parede pela hora de chegada da amostra mais recente
+// (hora de chegada - (timestamp_s mais recente - timestamp_s), com erro da latência de envio). Amostras
+// de boots anteriores (backlog enviado após a reinicialização) só podem ser ordenadas e posicionadas
+// entre si, pois o tempo em que a estação ficou desligada é desconhecido. Boot 0 indica uma estação
+// sem o log na flash, cuja sequência também recomeça a cada boot.
+typedef struct {
+    uint32_t timestamp_s;       // instante da leitura em segundos desde o boot indicado em boot
+    int16_t temperature;        // temperatura em °C
+    int16_t humidity;           // umidade relativa em %
+    uint16_t pollution_x10;     // poluição do ar em décimos de %
+    uint16_t boot;              // boot em que a leitura foi feita (preenchido pela fila; 0 = desconhecido)
+} SensorSample;
+
+// definição das funções
+
+// preenche uma amostra a partir dos valores lidos dos sensores
+void sample_make(SensorSample *sample, uint32_t timestamp_s, int temperature, int humidity, float pollution_level);
+// converte a poluição em décimos de % para porcentagem
+float sample_pollution(const SensorSample *sample);
+// serializa a amostra em SAMPLE_PACKED_SIZE bytes
+void sample_pack(const SensorSample *sample, uint8_t *buffer);
+// desserializa uma amostra de SAMPLE_PACKED_SIZE bytes
+void sample_unpack(SensorSample *sample, const uint8_t *buffer);
+
+#endif
@@ -0,0 +1,206 @@
+#include "sched.h"
+#include <stddef.h>
+#include "hal.h"
+
+static Event queue[SCHED_QUEUE_SIZE];
+static volatile uint32_t head = 0;
+static volatile uint32_t tail = 0;
+
+// tarefas na ordem de registro (a entrega de um evento segue essa ordem)
+static Task *tasks = NULL;
+
+static SchedStats stats = {0};
+
+// implementação das funções
+
+static uint64_t sched_now_us(void) {
+    return hal_time_us_64();
+}
+
+static uint32_t sched_lock(void) {
+    return hal_irq_disable();
+}
+
+static void sched_unlock(uint32_t interrupts) {
+    hal_irq_restore(interrupts);
+}
+
+#if !PICO_ON_DEVICE
+
+void sched_clock_advance_ms(uint32_t ms) {
+    hal_sim_advance_us((uint64_t) ms * 1000);
+}
+
+#endif
+
+uint32_t sched_now_ms(void) {
+    return (uint32_t) (sched_now_us() / 1000);
+}
+
+// Enfileira o evento; com coalesce, um evento igual já na fila basta
+static bool sched_push(EventType type, uint32_t arg, bool coalesce) {
+    uint32_t posted_us = (uint32_t) sched_now_us();
+    bool queued = true;
+
+    uint32_t interrupts = sched_lock();
+    stats.posted++;
+    if (coalesce) {
+        for (uint32_t i = tail; i != head; i++) {
+            const Event *pending = &queue[i % SCHED_QUEUE_SIZE];
+            if (pending->type == type && pending->arg == arg) {
+                stats.coalesced++;
+                sched_unlock(interrupts);
+                return true;
+            }
+        }
+    }
+    if (head - tail >= SCHED_QUEUE_SIZE) {
+        stats.dropped++;
+        queued = false;
+    } else {
+        queue[head % SCHED_QUEUE_SIZE] = (Event) {type, arg, posted_us};
+        head++;
+    }
+    sched_unlock(interrupts);
+
+    // acorda o laço mesmo que o evento chegue entre a verificação da fila e a espera
+    hal_signal_event();
+    return queued;
+}
+
+// Retira o evento mais antigo da fila
+static bool sched_pop(Event *out) {
+    uint32_t interrupts = sched_lock();
+    bool found = tail != head;
+    if (found) {
+        *out = queue[tail % SCHED_QUEUE_SIZE];
+        tail++;
+    }
+    sched_unlock(interrupts);
+    return found;
+}
+
+// Roda a tarefa até a próxima espera
+static void sched_dispatch(Task *task, const Event *event) {
+    uint64_t started = sched_now_us();
+
+    // a entrega encerra a espera em andamento: o prazo vale só para ela
+    task->has_deadline = false;
+    task->run(task, event);
+
+    uint32_t elapsed = (uint32_t) (sched_now_us() - started);
+    task->runs++;
+    if (elapsed > task->max_run_us) task->max_run_us = elapsed;
+}
+
+// Tarefa com o prazo vencido há mais tempo
+static Task *sched_due_task(uint32_t now_ms) {
+    Task *due = NULL;
+    for (Task *task = tasks; task != NULL; task = task->next) {
+        if (!task->has_deadline || (int32_t) (now_ms - task->deadline_ms) < 0) continue;
+        if (due == NULL || (int32_t) (task->deadline_ms - due->deadline_ms) < 0) due = task;
+    }
+    return due;
+}
+
+// Dorme até o próximo evento ou prazo
+static void sched_idle(void) {
+    uint32_t deadline_ms = 0;
+    bool timed = sched_next_deadline(&deadline_ms);
+
+    uint64_t started = sched_now_us();
+    if (head == tail) {
+        if (timed) {
+            int32_t remaining_ms = (int32_t) (deadline_ms - sched_now_ms());
+            if (remaining_ms > 0) hal_wait_for_event(remaining_ms);
+        } else {
+            hal_wait_for_event(HAL_WAIT_FOREVER);
+        }
+    }
+    stats.idle_us += sched_now_us() - started;
+    stats.wakeups++;
+}
+
+void sched_add(Task *task, const char *name, TaskFn run, uint32_t events) {
+    *task = (Task) {0};
+    task->name = name;
+    task->run = run;
+    task->events = events;
+
+    // primeira execução logo no início, até a primeira espera
+    task->has_deadline = true;
+    task->deadline_ms = sched_now_ms();
+
+    Task **last = &tasks;
+    while (*last != NULL) last = &(*last)->next;
+    *last = task;
+
+    if (stats.started_us == 0) stats.started_us = sched_now_us();
+}
+
+bool sched_post(EventType type, uint32_t arg) {
+    return sched_push(type, arg, false);
+}
+
+bool sched_signal(EventType type) {
+    return sched_push(type, 0, true);
+}
+
+void sched_set_timeout(Task *task, uint32_t timeout_ms) {
+    task->has_deadline = timeout_ms != SCHED_FOREVER;
+    task->deadline_ms = sched_now_ms() + timeout_ms;
+}
+
+bool sched_next_deadline(uint32_t *deadline_ms) {
+    bool found = false;
+    for (Task *task = tasks; task != NULL; task = task->next) {
+        if (!task->has_deadline) continue;
+        if (!found || (int32_t) (task->deadline_ms - *deadline_ms) < 0) *deadline_ms = task->deadline_ms;
+        found = true;
+    }
+    return found;
+}
+
+bool sched_run_once(void) {
+    Event event;
+    if (sched_pop(&event)) {
+        uint32_t latency = (uint32_t) sched_now_us() - event.posted_us;
+        stats.dispatched++;
+        stats.last_latency_us = latency;
+        if (latency > stats.max_latency_us) stats.max_latency_us = latency;
+
+        for (Task *task = tasks; task != NULL; task = task->next) {
+            if (task->events & EVENT_BIT(event.type)) sched_dispatch(task, &event);
+        }
+        return true;
+    }
+
+    Task *due = sched_due_task(sched_now_ms());
+    if (due != NULL) {
+        Event timeout = {EVENT_TIMEOUT, 0, (uint32_t) sched_now_us()};
+        stats.timeouts++;
+        sched_dispatch(due, &timeout);
+        return true;
+    }
+    return false;
+}
+
+void sched_run(void) {
+    while (true) {
+        if (sched_run_once()) continue;
+
+        sched_idle();
+
+#if !PICO_ON_DEVICE
+        // o simulador não tem mais nada agendado: nenhuma tarefa acordaria
+        uint32_t deadline_ms;
+        if (head == tail && !sched_next_deadline(&deadline_ms)) return;
+#endif
+    }
+}
+
+void sched_get_stats(SchedStats *out) {
+    uint32_t interrupts = sched_lock();
+    *out = stats;
+    sched_unlock(interrupts);
+}
@@ -0,0 +1,139 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+// inclusão de bibliotecas
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file sched.h
+ *
+ * @brief Agendador cooperativo orientado a eventos: fila de eventos alimentada por interrupções,
+ * prazos e callbacks do lwIP, e tarefas sem pilha própria que rodam até o próximo ponto de espera.
+ *
+ * @note Uma tarefa é uma função void f(Task *task, const Event *event) escrita entre TASK_BEGIN() e
+ * TASK_END(), com as esperas explícitas TASK_WAIT(ms), TASK_WAIT_EVENT(tipo) e TASK_YIELD(). Cada
+ * espera retorna da função e guarda o ponto de retomada (switch na linha, como nas protothreads):
+ * variáveis locais não sobrevivem a uma espera, o que precisa persistir fica em static ou global.
+ *
+ * Um evento é entregue, na ordem em que chegou, a todas as tarefas inscritas no seu tipo; uma entrega
+ * cancela o prazo da espera em andamento (o prazo vale para a espera atual). Sem eventos nem prazos
+ * vencidos o núcleo dorme em hal_wait_for_event até a próxima interrupção ou o próximo prazo; sched_post
+ * chama hal_signal_event, então um evento postado entre a verificação da fila e a espera não se perde.
+ *
+ * sched_post pode ser chamada de interrupções e de callbacks do lwIP: a vaga na fila é reservada com
+ * as interrupções desligadas por alguns ciclos. sched_signal não duplica um evento igual que ainda
+ * esteja na fila (avisos de rede repetidos viram um só).
+ *
+ * Fora do dispositivo (PICO_ON_DEVICE = 0) o relógio é o virtual da HAL (hal_host.c), avançado com
+ * sched_clock_advance_ms ou pela espera ociosa: tools/sched_sim.c roda só as tarefas de exemplo com
+ * sched_run_once e tools/station_sim.c roda a estação inteira, os dois sem esperar tempo real.
+ */
+
+// eventos da estação (os bits das máscaras de inscrição)
+typedef enum {
+    EVENT_TIMEOUT,              // prazo da espera vencido (entregue só à tarefa que esperava)
+    EVENT_EDGE,                 // bordas dos botões anotadas pela interrupção (para o módulo de entrada)
+    EVENT_INPUT,                // gesto de entrada (arg = INPUT_EVENT_ARG(entrada, gesto))
+    EVENT_READ,                 // pedido de leitura dos sensores
+    EVENT_SAMPLE,               // leitura registrada (arg = o DHT11 respondeu)
+    EVENT_NETWORK,              // atividade de rede: enlace, conexão ou lote confirmado
+    EVENT_SERIAL,               // caracteres recebidos no terminal serial
+    EVENT_NUM_TYPES
+} EventType;
+
+#define EVENT_BIT(type) (1u << (type))
+
+// eventos aguardando entrega
+#define SCHED_QUEUE_SIZE 16
+
+// espera sem prazo
+#define SCHED_FOREVER UINT32_MAX
+
+typedef struct {
+    uint8_t type;
+    uint32_t arg;
+    uint32_t posted_us;         // instante da postagem (32 bits do timer), para a latência de entrega
+} Event;
+
+typedef struct Task Task;
+typedef void (*TaskFn)(Task *task, const Event *event);
+
+struct Task {
+    const char *name;
+    TaskFn run;
+    uint32_t events;            // máscara dos eventos entregues à tarefa
+    uint16_t resume;            // ponto de retomada (0 = início)
+    bool has_deadline;
+    uint32_t deadline_ms;       // prazo da espera em andamento
+    uint32_t runs;              // vezes que a tarefa rodou
+    uint32_t max_run_us;        // maior tempo de uma execução até a espera seguinte
+    Task *next;
+};
+
+// estatísticas do agendador
+typedef struct {
+    uint32_t posted;            // eventos postados
+    uint32_t coalesced;         // sinais descartados por já haver um igual na fila
+    uint32_t dropped;           // eventos descartados com a fila cheia
+    uint32_t dispatched;        // eventos entregues
+    uint32_t timeouts;          // prazos vencidos
+    uint32_t wakeups;           // saídas da espera ociosa
+    uint32_t last_latency_us;   // da postagem até a entrega, no último evento
+    uint32_t max_latency_us;    // maior latência de entrega
+    uint64_t idle_us;           // tempo dormindo
+    uint64_t started_us;        // início do agendador (para a carga da CPU)
+} SchedStats;
+
+// definição das funções
+
+// registra uma tarefa inscrita nos eventos da máscara; ela roda uma vez logo no início, até a primeira espera
+void sched_add(Task *task, const char *name, TaskFn run, uint32_t events);
+// posta um evento (pode ser chamada de interrupções); false com a fila cheia
+bool sched_post(EventType type, uint32_t arg);
+// posta um evento sem argumento, a menos que um igual ainda esteja na fila
+bool sched_signal(EventType type);
+// entrega um evento ou um prazo vencido; false se não havia nada a fazer
+bool sched_run_once(void);
+// laço do agendador: entrega eventos e prazos e dorme quando não há o que fazer (no dispositivo não
+// retorna; com o relógio virtual salta até o próximo prazo e retorna quando nada mais pode acontecer)
+void sched_run(void);
+// relógio do agendador, em ms
+uint32_t sched_now_ms(void);
+// prazo mais próximo entre as tarefas; false se nenhuma espera tem prazo
+bool sched_next_deadline(uint32_t *deadline_ms);
+// avança o relógio virtual (só fora do dispositivo)
+void sched_clock_advance_ms(uint32_t ms);
+// copia as estatísticas do agendador
+void sched_get_stats(SchedStats *out);
+
+// uso interno das macros: prazo da próxima espera
+void sched_set_timeout(Task *task, uint32_t timeout_ms);
+
+// corpo da tarefa (os parâmetros devem se chamar task e event)
+#define TASK_BEGIN() switch (task->resume) { case 0:
+#define TASK_END() } task->resume = 0
+
+// espera o próximo evento entregue à tarefa ou o prazo (timeout_ms, ou SCHED_FOREVER)
+#define TASK_WAIT(timeout_ms)                                                                   \
+    do {                                                                                        \
+        sched_set_timeout(task, (timeout_ms));                                                  \
+        task->resume = __LINE__;                                                                \
+        return;                                                                                 \
+        case __LINE__:;                                                                         \
+    } while (0)
+
+// espera um evento de um tipo; os demais entregues à tarefa nesse meio tempo são ignorados
+#define TASK_WAIT_EVENT(wanted)                                                                 \
+    do {                                                                                        \
+        sched_set_timeout(task, SCHED_FOREVER);                                                 \
+        task->resume = __LINE__;                                                                \
+        return;                                                                                 \
+        case __LINE__:                                                                          \
+        if (event->type != (wanted)) return;                                                    \
+    } while (0)
+
+// devolve a vez: a tarefa volta a rodar depois dos eventos já na fila
+#define TASK_YIELD() TASK_WAIT(0)
+
+#endif
@@ -0,0 +1,61 @@
+#include "datagram.h"
+
+// implementação das funções
+
+// Lê e escreve inteiros little-endian
+static void datagram_put_u32(uint8_t *buffer, uint32_t value) {
+    buffer[0] = value;
+    buffer[1] = value >> 8;
+    buffer[2] = value >> 16;
+    buffer[3] = value >> 24;
+}
+
+static uint32_t datagram_get_u32(const uint8_t *buffer) {
+    return (uint32_t) buffer[0] | ((uint32_t) buffer[1] << 8) | ((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+}
+
+void datagram_write_header(uint8_t *buffer, const DatagramHeader *header) {
+    buffer[0] = DATAGRAM_MAGIC;
+    buffer[1] = header->type;
+    buffer[2] = header->station_id;
+    buffer[3] = header->station_id >> 8;
+    datagram_put_u32(buffer + 4, header->seq);
+    buffer[8] = header->count;
+    buffer[9] = header->flags;
+}
+
+bool datagram_read_header(const uint8_t *buffer, size_t length, DatagramHeader *header) {
+    if (length < DATAGRAM_HEADER_SIZE || buffer[0] != DATAGRAM_MAGIC) return false;
+
+    header->type = buffer[1];
+    header->station_id = buffer[2] | (buffer[3] << 8);
+    header->seq = datagram_get_u32(buffer + 4);
+    header->count = buffer[8];
+    header->flags = buffer[9];
+
+    switch (header->type) {
+        case DATAGRAM_TYPE_DATA:
+            return length >= DATAGRAM_HEADER_SIZE + (size_t) header->count * DATAGRAM_RECORD_SIZE;
+        case DATAGRAM_TYPE_ACK:
+        case DATAGRAM_TYPE_NACK:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void datagram_write_record(uint8_t *buffer, uint8_t index, uint32_t seq, const SensorSample *sample, uint8_t channels) {
+    uint8_t *record = buffer + DATAGRAM_HEADER_SIZE + index * DATAGRAM_RECORD_SIZE;
+
+    datagram_put_u32(record, seq);
+    record[4] = channels;
+    sample_pack(sample, record + 5);
+}
+
+void datagram_read_record(const uint8_t *buffer, uint8_t index, uint32_t *seq, SensorSample *sample, uint8_t *channels) {
+    const uint8_t *record = buffer + DATAGRAM_HEADER_SIZE + index * DATAGRAM_RECORD_SIZE;
+
+    *seq = datagram_get_u32(record);
+    *channels = record[4];
+    sample_unpack(sample, record + 5);
+}
@@ -0,0 +1,66 @@
+#ifndef DATAGRAM_H
+#define DATAGRAM_H
+
+// inclusão de bibliotecas
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sample.h"
+
+/**
+ * @file datagram.h
+ *
+ * @brief Formato dos datagramas do transporte UDP, comum ao firmware e ao receptor no computador.
+ *
+ * @note Todos os campos são little-endian. Cabeçalho (DATAGRAM_HEADER_SIZE bytes):
+ *
+ *     0     magic (DATAGRAM_MAGIC)
+ *     1     tipo (DATAGRAM_TYPE_*)
+ *     2-3   id da estação
+ *     4-7   sequência do datagrama (contador do transporte, começa em 1 a cada boot)
+ *     8     quantidade de registros
+ *     9     flags (DATAGRAM_FLAG_*)
+ *
+ * Um datagrama DATA traz em seguida os registros das amostras (DATAGRAM_RECORD_SIZE bytes cada):
+ * sequência da amostra na fila (4), máscara de canais (1) e a amostra compactada (SAMPLE_PACKED_SIZE).
+ * ACK e NACK são só o cabeçalho, com a sequência do datagrama confirmado ou perdido.
+ */
+
+#define DATAGRAM_MAGIC 0xE5
+
+// tipos de datagrama
+#define DATAGRAM_TYPE_DATA 1        // estação -> receptor: amostras
+#define DATAGRAM_TYPE_ACK 2         // receptor -> estação: datagrama recebido
+#define DATAGRAM_TYPE_NACK 3        // receptor -> estação: datagrama perdido (lacuna na sequência)
+
+// flags
+#define DATAGRAM_FLAG_ACK_REQUEST 0x01  // a estação espera ACK/NACK deste datagrama
+
+#define DATAGRAM_HEADER_SIZE 10
+#define DATAGRAM_RECORD_SIZE (4 + 1 + SAMPLE_PACKED_SIZE)
+
+// maior datagrama enviado (abaixo do MTU, em um único pbuf)
+#define DATAGRAM_MAX_SIZE 512
+#define DATAGRAM_MAX_RECORDS ((DATAGRAM_MAX_SIZE - DATAGRAM_HEADER_SIZE) / DATAGRAM_RECORD_SIZE)
+
+// cabeçalho decodificado
+typedef struct {
+    uint8_t type;
+    uint8_t flags;
+    uint16_t station_id;
+    uint32_t seq;
+    uint8_t count;
+} DatagramHeader;
+
+// definição das funções
+
+// escreve o cabeçalho no início do buffer
+void datagram_write_header(uint8_t *buffer, const DatagramHeader *header);
+// lê e valida o cabeçalho (magic, tipo e tamanho dos registros); retorna false se o datagrama é inválido
+bool datagram_read_header(const uint8_t *buffer, size_t length, DatagramHeader *header);
+// escreve o registro de índice index
+void datagram_write_record(uint8_t *buffer, uint8_t index, uint32_t seq, const SensorSample *sample, uint8_t channels);
+// lê o registro de índice index (o cabeçalho já deve ter sido validado)
+void datagram_read_record(const uint8_t *buffer, uint8_t index, uint32_t *seq, SensorSample *sample, uint8_t *channels);
+
+#endif
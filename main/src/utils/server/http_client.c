@@ -0,0 +1,621 @@
+#include "http_client.h"
+#include "format.h"
+#include "prof.h"
+#include "log.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if HTTP_CLIENT_TLS
+#include <malloc.h>
+#include "lwip/altcp_tls.h"
+#include "mbedtls/ssl.h"
+#endif
+
+// intervalo do callback de poll do lwIP (em unidades de 500 ms)
+#define HTTP_CLIENT_POLL_INTERVAL 4
+
+// espaço reservado para os cabeçalhos da requisição
+#define HTTP_CLIENT_HEADER_MAX 192
+
+// tamanho da maior linha de status/cabeçalho interpretada (o restante é ignorado)
+#define HTTP_CLIENT_LINE_MAX 96
+
+// estados do interpretador incremental de respostas
+typedef enum {
+    PARSE_STATUS_LINE,
+    PARSE_HEADERS,
+    PARSE_BODY,
+    PARSE_CHUNK_SIZE,
+    PARSE_CHUNK_DATA,
+    PARSE_CHUNK_END,
+    PARSE_TRAILER
+} HttpParseState;
+
+// requisição aguardando resposta
+typedef struct {
+    http_client_done_fn done;
+    void *arg;
+    uint32_t sent_ms;
+} HttpPendingRequest;
+
+// nome do servidor da conexão atual (cabeçalho Host)
+static char server_host[64];
+
+// estado da conexão
+static struct altcp_pcb *client_pcb = NULL;
+static bool connected = false;
+static bool close_after_response = false;   // servidor pediu "Connection: close" ou respondeu HTTP/1.0
+static uint32_t connection_unacked = 0;     // bytes escritos na conexão atual ainda não confirmados pelo TCP
+static bool connection_aborted = false;     // o pcb foi abortado: o callback do lwIP em andamento retorna ERR_ABRT
+
+// final fixo dos cabeçalhos enviados pelo caminho sem cópia
+static const char header_tail[] = "\r\nConnection: keep-alive\r\n\r\n";
+
+// requisições em voo (fila circular, respostas chegam na mesma ordem)
+static HttpPendingRequest pending[HTTP_CLIENT_MAX_PIPELINE];
+static uint8_t pending_head = 0;
+static uint8_t pending_count = 0;
+
+// estado do interpretador de respostas
+static HttpParseState parse_state = PARSE_STATUS_LINE;
+static char line[HTTP_CLIENT_LINE_MAX];
+static uint8_t line_length = 0;
+static int response_status = 0;
+static uint32_t body_remaining = 0;
+static bool chunked = false;
+
+static HttpClientStats stats;
+
+// aviso de conexão estabelecida ou perdida (gerenciador de conexão)
+static http_client_connection_fn connection_listener = NULL;
+
+#if HTTP_CLIENT_TLS
+// configuração TLS (CA do servidor) e sessão da última conexão, oferecida ao servidor na próxima
+// para retomar a sessão sem refazer a troca de chaves (só se a próxima conexão for com o mesmo servidor)
+static struct altcp_tls_config *tls_config = NULL;
+static struct altcp_tls_session *tls_session = NULL;
+static char tls_session_host[sizeof(server_host)];
+static bool tls_session_valid = false;
+static bool tls_session_offered = false;
+
+// medição do handshake da conexão em andamento
+static uint32_t connect_started_ms = 0;
+static uint32_t heap_before_connect = 0;
+#endif
+
+// encerra a requisição mais antiga com o status informado
+static void http_client_complete(int status) {
+    if (pending_count == 0) return;
+
+    HttpPendingRequest request = pending[pending_head];
+    pending_head = (pending_head + 1) % HTTP_CLIENT_MAX_PIPELINE;
+    pending_count--;
+
+    if (status > 0) {
+        stats.responses++;
+    } else {
+        stats.errors++;
+    }
+    if (request.done != NULL) request.done(status, request.arg);
+}
+
+// encerra com erro todas as requisições em voo
+static void http_client_fail_all(int status) {
+    while (pending_count > 0) {
+        http_client_complete(status);
+    }
+}
+
+static void http_client_reset_parser(void) {
+    parse_state = PARSE_STATUS_LINE;
+    line_length = 0;
+    response_status = 0;
+    body_remaining = 0;
+    chunked = false;
+}
+
+// desfaz o estado da conexão (o pcb já foi fechado ou liberado); was_open indica que havia uma
+// tentativa ou uma conexão, da qual o gerenciador é avisado
+static void http_client_reset_connection(bool was_open, int status) {
+#if HTTP_CLIENT_TLS
+    // handshake falhou com a sessão oferecida: a próxima tentativa faz o handshake completo
+    if (was_open && !connected && tls_session_offered) tls_session_valid = false;
+#endif
+
+    client_pcb = NULL;
+    connected = false;
+    close_after_response = false;
+    connection_unacked = 0;
+    http_client_reset_parser();
+    http_client_fail_all(status);
+
+    if (was_open && connection_listener != NULL) connection_listener(false);
+}
+
+// desfaz a conexão atual; abort = true quando chamado de dentro de um callback que retornará ERR_ABRT.
+// Retorna true se o pcb foi abortado (dentro de um callback do lwIP, ele precisa retornar ERR_ABRT)
+static bool http_client_drop(bool abort, int status) {
+    bool was_open = client_pcb != NULL || connected;
+    bool aborted = false;
+
+    if (client_pcb != NULL) {
+        altcp_arg(client_pcb, NULL);
+        altcp_recv(client_pcb, NULL);
+        altcp_sent(client_pcb, NULL);
+        altcp_err(client_pcb, NULL);
+        altcp_poll(client_pcb, NULL, 0);
+
+        // com bytes ainda não confirmados, altcp_close manteria segmentos apontando para buffers
+        // (sem cópia) que o chamador vai reaproveitar após o callback de conclusão: aborta a conexão
+        if (abort || connection_unacked > 0 || altcp_close(client_pcb) != ERR_OK) {
+            altcp_abort(client_pcb);
+            aborted = true;
+            connection_aborted = true;
+        }
+    }
+
+    http_client_reset_connection(was_open, status);
+    return aborted;
+}
+
+// compara o início de uma linha sem diferenciar maiúsculas de minúsculas
+static bool line_starts_with(const char *text, const char *prefix) {
+    while (*prefix) {
+        if (tolower((unsigned char) *text++) != *prefix++) return false;
+    }
+    return true;
+}
+
+static const char *header_value(const char *header) {
+    const char *value = strchr(header, ':');
+    if (value == NULL) return "";
+    value++;
+    while (*value == ' ' || *value == '\t') value++;
+    return value;
+}
+
+// conclui a resposta atual; retorna false se a conexão precisou ser fechada
+static bool http_client_response_done(void) {
+    int status = response_status;
+    http_client_reset_parser();
+    http_client_complete(status);
+
+    if (close_after_response) {
+        http_client_drop(false, HTTP_CLIENT_ERR_CONNECTION);
+        return false;
+    }
+    return true;
+}
+
+// interpreta uma linha completa; retorna false em caso de resposta malformada
+static bool http_client_parse_line(void) {
+    switch (parse_state) {
+        case PARSE_STATUS_LINE:
+            // "HTTP/1.1 200 OK"
+            if (!line_starts_with(line, "http/1.")) return false;
+            close_after_response = line[7] == '0';
+            response_status = atoi(line + 9);
+            if (response_status < 100) return false;
+            parse_state = PARSE_HEADERS;
+            return true;
+
+        case PARSE_HEADERS:
+            if (line_length > 0) {
+                if (line_starts_with(line, "content-length:")) {
+                    body_remaining = strtoul(header_value(line), NULL, 10);
+                } else if (line_starts_with(line, "transfer-encoding:")) {
+                    chunked = line_starts_with(header_value(line), "chunked");
+                } else if (line_starts_with(line, "connection:")) {
+                    const char *value = header_value(line);
+                    if (line_starts_with(value, "close")) close_after_response = true;
+                    if (line_starts_with(value, "keep-alive")) close_after_response = false;
+                }
+                return true;
+            }
+
+            // linha vazia: fim dos cabeçalhos
+            if (chunked) {
+                parse_state = PARSE_CHUNK_SIZE;
+            } else if (body_remaining > 0) {
+                parse_state = PARSE_BODY;
+            } else {
+                http_client_response_done();
+            }
+            return true;
+
+        case PARSE_CHUNK_SIZE:
+            body_remaining = strtoul(line, NULL, 16);
+            parse_state = body_remaining > 0 ? PARSE_CHUNK_DATA : PARSE_TRAILER;
+            return true;
+
+        case PARSE_CHUNK_END:
+            parse_state = PARSE_CHUNK_SIZE;
+            return true;
+
+        case PARSE_TRAILER:
+            if (line_length == 0) http_client_response_done();
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// consome os bytes recebidos; retorna false se a resposta for inválida
+static bool http_client_parse(const uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length && client_pcb != NULL; i++) {
+        // corpo da resposta: descartado, apenas contado
+        if (parse_state == PARSE_BODY || parse_state == PARSE_CHUNK_DATA) {
+            uint32_t available = length - i;
+            uint32_t skip = available < body_remaining ? available : body_remaining;
+            body_remaining -= skip;
+            i += skip - 1;
+
+            if (body_remaining == 0) {
+                if (parse_state == PARSE_CHUNK_DATA) {
+                    parse_state = PARSE_CHUNK_END;
+                } else {
+                    http_client_response_done();
+                }
+            }
+            continue;
+        }
+
+        char c = (char) data[i];
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (line_length < HTTP_CLIENT_LINE_MAX - 1) line[line_length++] = c;
+            continue;
+        }
+
+        line[line_length] = '\0';
+        if (pending_count == 0 || !http_client_parse_line()) return false;
+        line_length = 0;
+    }
+    return true;
+}
+
+// callback de dados recebidos do servidor
+static err_t http_client_recv(void *arg, struct altcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    if (p == NULL) {
+        // servidor fechou a conexão (com bytes ainda não confirmados, o pcb é abortado)
+        return http_client_drop(false, HTTP_CLIENT_ERR_CONNECTION) ? ERR_ABRT : ERR_OK;
+    }
+
+    // a interpretação pode derrubar a conexão ("Connection: close" com bytes não confirmados, ou um
+    // novo envio com erro feito pelo callback de conclusão): depois de um abort, retorna ERR_ABRT
+    connection_aborted = false;
+    bool valid = true;
+    for (struct pbuf *q = p; q != NULL && valid && client_pcb != NULL; q = q->next) {
+        valid = http_client_parse((const uint8_t *) q->payload, q->len);
+    }
+
+    // a conexão pode ter sido fechada durante a interpretação ("Connection: close")
+    if (client_pcb == tpcb) altcp_recved(tpcb, p->tot_len);
+    pbuf_free(p);
+
+    if (connection_aborted) return ERR_ABRT;
+    if (!valid) {
+        // com a conexão já fechada durante a interpretação não há mais nada a abortar
+        if (client_pcb != tpcb) return ERR_OK;
+        http_client_drop(true, HTTP_CLIENT_ERR_PARSE);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+// callback de confirmação dos bytes enviados (libera espaço na janela de envio)
+static err_t http_client_sent(void *arg, struct altcp_pcb *tpcb, u16_t len) {
+    stats.bytes_acked += len;
+    connection_unacked = len >= connection_unacked ? 0 : connection_unacked - len;
+    return ERR_OK;
+}
+
+// callback periódico: expira requisições sem resposta
+static err_t http_client_poll(void *arg, struct altcp_pcb *tpcb) {
+    if (pending_count == 0) return ERR_OK;
+
+    uint32_t now = hal_time_ms();
+    if (now - pending[pending_head].sent_ms > HTTP_CLIENT_TIMEOUT_MS) {
+        LOG_WARN("HTTP: tempo de resposta esgotado\n");
+        http_client_drop(true, HTTP_CLIENT_ERR_TIMEOUT);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+// callback de erro: o pcb já foi liberado pelo lwIP; havia uma tentativa ou conexão em andamento
+// (o callback é removido ao desfazer a conexão), então o gerenciador é sempre avisado
+static void http_client_error(void *arg, err_t err) {
+    LOG_WARN("HTTP: erro na conexao TCP (%d)\n", err);
+    http_client_reset_connection(true, HTTP_CLIENT_ERR_CONNECTION);
+}
+
+#if HTTP_CLIENT_TLS
+// Handshake concluído: mede a duração e a RAM ocupada pelo TLS e guarda a sessão para a próxima conexão
+static void http_client_tls_established(void) {
+    uint32_t elapsed = hal_time_ms() - connect_started_ms;
+    struct mallinfo heap = mallinfo();
+
+    if (tls_session_offered) {
+        stats.tls_resumed_handshakes++;
+        stats.tls_resumed_ms = elapsed;
+    } else {
+        stats.tls_full_handshakes++;
+        stats.tls_full_ms = elapsed;
+    }
+    stats.tls_heap_bytes = (uint32_t) heap.uordblks - heap_before_connect;
+    if ((uint32_t) heap.arena > stats.tls_heap_peak) stats.tls_heap_peak = heap.arena;
+
+    if (tls_session == NULL) tls_session = altcp_tls_alloc_session();
+    tls_session_valid = tls_session != NULL && altcp_tls_get_session(client_pcb, tls_session) == ERR_OK;
+    memcpy(tls_session_host, server_host, sizeof(tls_session_host));
+
+    LOG_INFO("TLS: handshake %s em %lu ms, %lu bytes de heap\n", tls_session_offered ? "retomado" : "completo",
+             (unsigned long) elapsed, (unsigned long) stats.tls_heap_bytes);
+}
+#endif
+
+// callback de conexão estabelecida (com TLS, após o handshake)
+static err_t http_client_connected(void *arg, struct altcp_pcb *tpcb, err_t err) {
+    if (err != ERR_OK) {
+        http_client_drop(true, HTTP_CLIENT_ERR_CONNECTION);
+        return ERR_ABRT;
+    }
+
+#if HTTP_CLIENT_TLS
+    http_client_tls_established();
+#endif
+    connected = true;
+    stats.connects++;
+    LOG_INFO("HTTP: conectado ao servidor (%lu conexoes)\n", (unsigned long) stats.connects);
+    if (connection_listener != NULL) connection_listener(true);
+    return ERR_OK;
+}
+
+// implementação das funções
+
+void http_client_init(void) {
+    memset(&stats, 0, sizeof(stats));
+    http_client_reset_parser();
+}
+
+#if HTTP_CLIENT_TLS
+bool http_client_set_tls(const uint8_t *ca_cert, size_t ca_cert_length) {
+    if (tls_config != NULL) altcp_tls_free_config(tls_config);
+    tls_config = altcp_tls_create_config_client(ca_cert, ca_cert_length);
+    tls_session_valid = false;
+    return tls_config != NULL;
+}
+#endif
+
+void http_client_set_connection_listener(http_client_connection_fn listener) {
+    connection_listener = listener;
+}
+
+bool http_client_connect(const char *host, const ip_addr_t *address, uint16_t port) {
+    if (client_pcb != NULL) return true;    // conexão já existe ou está em andamento
+
+    strncpy(server_host, host, sizeof(server_host) - 1);
+    server_host[sizeof(server_host) - 1] = '\0';
+
+#if HTTP_CLIENT_TLS
+    if (tls_config == NULL) {
+        LOG_ERROR("HTTP: TLS nao configurado\n");
+        return false;
+    }
+    connect_started_ms = hal_time_ms();
+    heap_before_connect = mallinfo().uordblks;
+    client_pcb = altcp_tls_new(tls_config, IPADDR_TYPE_ANY);
+#else
+    client_pcb = altcp_new(NULL);
+#endif
+    if (client_pcb == NULL) {
+        LOG_ERROR("HTTP: falha ao criar pcb\n");
+        return false;
+    }
+
+#if HTTP_CLIENT_TLS
+    // SNI e verificação do nome no certificado pelo servidor desta conexão; a sessão anterior só é
+    // oferecida para retomada se foi negociada com ele (outro servidor não a reconheceria, ou pior, a
+    // aceitaria sem o certificado ter sido conferido para o novo nome)
+    mbedtls_ssl_set_hostname(altcp_tls_context(client_pcb), server_host);
+    tls_session_offered = tls_session_valid && strcmp(tls_session_host, server_host) == 0
+        && altcp_tls_set_session(client_pcb, tls_session) == ERR_OK;
+#endif
+
+    altcp_err(client_pcb, http_client_error);
+    altcp_recv(client_pcb, http_client_recv);
+    altcp_sent(client_pcb, http_client_sent);
+    altcp_poll(client_pcb, http_client_poll, HTTP_CLIENT_POLL_INTERVAL);
+
+    err_t connect_err = altcp_connect(client_pcb, address, port, http_client_connected);
+    if (connect_err != ERR_OK) {
+        LOG_WARN("HTTP: falha ao conectar (%d)\n", connect_err);
+        http_client_drop(true, HTTP_CLIENT_ERR_CONNECTION);
+        return false;
+    }
+    return true;
+}
+
+bool http_client_is_connected(void) {
+    return client_pcb != NULL && connected;
+}
+
+bool http_client_can_send(uint16_t length) {
+    if (!http_client_is_connected() || pending_count == HTTP_CLIENT_MAX_PIPELINE) return false;
+
+    // só escreve se a requisição inteira couber na janela de envio e na fila de segmentos do lwIP
+    return altcp_sndbuf(client_pcb) >= length + HTTP_CLIENT_HEADER_MAX
+        && altcp_sndqueuelen(client_pcb) + 4 < TCP_SND_QUEUELEN;
+}
+
+// escreve na conexão atual (todas as escritas passam por aqui, medidas pela sonda do TCP)
+static err_t http_client_write(const void *data, u16_t length, u8_t flags) {
+    PROF_SCOPE(PROF_TCP_WRITE);
+    return altcp_write(client_pcb, data, length, flags);
+}
+
+// escreve os cabeçalhos de uma requisição POST; body_length < 0 indica corpo chunked
+static bool http_client_write_headers(const char *path, const char *content_type, int body_length) {
+    char headers[HTTP_CLIENT_HEADER_MAX];
+    char length_header[32];
+    if (body_length >= 0) {
+        snprintf(length_header, sizeof(length_header), "Content-Length: %d", body_length);
+    } else {
+        snprintf(length_header, sizeof(length_header), "Transfer-Encoding: chunked");
+    }
+
+    int header_length = snprintf(headers, sizeof(headers),
+        "POST %s HTTP/1.1\r\n"
+        "Host: %s\r\n"
+        "Content-Type: %s\r\n"
+        "%s\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n",
+        path, server_host, content_type, length_header);
+    if (header_length >= (int) sizeof(headers)) return false;
+
+    if (http_client_write(headers, header_length, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) != ERR_OK) {
+        return false;
+    }
+    stats.bytes_sent += header_length;
+    connection_unacked += header_length;
+    return true;
+}
+
+// registra a requisição escrita na fila de requisições aguardando resposta
+static void http_client_track(http_client_done_fn done, void *arg) {
+    uint8_t slot = (pending_head + pending_count) % HTTP_CLIENT_MAX_PIPELINE;
+    pending[slot].done = done;
+    pending[slot].arg = arg;
+    pending[slot].sent_ms = hal_time_ms();
+    pending_count++;
+    stats.requests++;
+}
+
+bool http_client_post(const char *path, const char *content_type, const char *body, uint16_t body_length,
+                      http_client_done_fn done, void *arg) {
+    if (!http_client_can_send(body_length)) return false;
+
+    if (!http_client_write_headers(path, content_type, body_length)
+        || http_client_write(body, body_length, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+        // cabeçalho pode ter sido escrito sem o corpo: a conexão não é mais utilizável
+        LOG_WARN("HTTP: erro ao escrever requisicao\n");
+        http_client_drop(false, HTTP_CLIENT_ERR_CONNECTION);
+        return false;
+    }
+
+    stats.bytes_sent += body_length;
+    connection_unacked += body_length;
+    http_client_track(done, arg);
+    altcp_output(client_pcb);
+    return true;
+}
+
+bool http_client_template_init(HttpRequestTemplate *request_template, const char *path, const char *content_type) {
+    int length = snprintf(request_template->prefix, sizeof(request_template->prefix),
+        "POST %s HTTP/1.1\r\n"
+        "Host: %s\r\n"
+        "Content-Type: %s\r\n"
+        "Content-Length: ",
+        path, server_host, content_type);
+    if (length >= (int) sizeof(request_template->prefix)) {
+        request_template->prefix_length = 0;
+        return false;
+    }
+
+    request_template->prefix_length = length;
+    return true;
+}
+
+bool http_client_post_zero_copy(const HttpRequestTemplate *request_template, const char *body, uint16_t body_length,
+                                http_client_done_fn done, void *arg) {
+    if (request_template->prefix_length == 0 || !http_client_can_send(body_length)) return false;
+
+    // único trecho dinâmico dos cabeçalhos: os dígitos do Content-Length (copiados, poucos bytes)
+    char digits[6];
+    int digits_length = format_uint(digits, sizeof(digits), body_length, 0);
+
+    // cabeçalhos fixos e corpo são referenciados sem cópia (pbufs do tipo ROM/REF)
+    if (http_client_write(request_template->prefix, request_template->prefix_length, TCP_WRITE_FLAG_MORE) != ERR_OK
+        || http_client_write(digits, digits_length, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) != ERR_OK
+        || http_client_write(header_tail, sizeof(header_tail) - 1, TCP_WRITE_FLAG_MORE) != ERR_OK
+        || http_client_write(body, body_length, 0) != ERR_OK) {
+        LOG_WARN("HTTP: erro ao escrever requisicao\n");
+        http_client_drop(true, HTTP_CLIENT_ERR_CONNECTION);
+        return false;
+    }
+
+    uint32_t written = request_template->prefix_length + digits_length + sizeof(header_tail) - 1 + body_length;
+    stats.bytes_sent += written;
+    connection_unacked += written;
+    http_client_track(done, arg);
+    altcp_output(client_pcb);
+    return true;
+}
+
+bool http_client_begin_chunked(const char *path, const char *content_type, uint16_t body_estimate,
+                               http_client_done_fn done, void *arg) {
+    if (!http_client_can_send(body_estimate)) return false;
+
+    if (!http_client_write_headers(path, content_type, -1)) {
+        LOG_WARN("HTTP: erro ao escrever requisicao\n");
+        http_client_drop(false, HTTP_CLIENT_ERR_CONNECTION);
+        return false;
+    }
+
+    // a requisição já conta como em voo: um erro no meio do corpo encerra a conexão e a completa com erro
+    http_client_track(done, arg);
+    return true;
+}
+
+bool http_client_write_chunk(const char *data, uint16_t length) {
+    if (client_pcb == NULL) return false;
+    if (length == 0) return true;   // pedaço vazio encerraria o corpo
+
+    char size_line[8];
+    int size_length = snprintf(size_line, sizeof(size_line), "%X\r\n", length);
+    if (http_client_write(size_line, size_length, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) != ERR_OK
+        || http_client_write(data, length, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) != ERR_OK
+        || http_client_write("\r\n", 2, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) != ERR_OK) {
+        LOG_WARN("HTTP: erro ao escrever pedaco do corpo\n");
+        http_client_drop(false, HTTP_CLIENT_ERR_CONNECTION);
+        return false;
+    }
+
+    stats.bytes_sent += size_length + length + 2;
+    connection_unacked += size_length + length + 2;
+    return true;
+}
+
+bool http_client_end_chunked(void) {
+    if (client_pcb == NULL) return false;
+
+    if (http_client_write("0\r\n\r\n", 5, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+        http_client_drop(false, HTTP_CLIENT_ERR_CONNECTION);
+        return false;
+    }
+
+    stats.bytes_sent += 5;
+    connection_unacked += 5;
+    altcp_output(client_pcb);
+    return true;
+}
+
+uint8_t http_client_pending(void) {
+    return pending_count;
+}
+
+uint32_t http_client_unacked(void) {
+    return connection_unacked;
+}
+
+void http_client_close(void) {
+    http_client_drop(false, HTTP_CLIENT_ERR_CONNECTION);
+}
+
+void http_client_get_stats(HttpClientStats *out) {
+    *out = stats;
+}
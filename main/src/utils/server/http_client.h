@@ -0,0 +1,119 @@
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+#include "lwip/altcp.h"
+
+/**
+ * @file http_client.h
+ *
+ * @brief Cliente HTTP/1.1 leve sobre a API altcp do lwIP (TCP puro ou TLS).
+ *
+ * @note Mantém uma conexão persistente (keep-alive) com o servidor, interpreta a linha de status e os
+ * cabeçalhos da resposta de forma incremental, chama um callback de conclusão por requisição e só
+ * escreve no TCP quando há espaço na janela de envio (altcp_sndbuf), contabilizando os bytes
+ * confirmados em altcp_sent. Várias requisições podem ficar em voo ao mesmo tempo (pipelining).
+ *
+ * Com HTTP_CLIENT_TLS a conexão é cifrada (altcp_tls) e a sessão TLS da conexão anterior é oferecida
+ * a cada reconexão, para que a troca de chaves completa (segundos de CPU no Cortex-M0+) aconteça uma
+ * vez por sessão e não a cada envio. Os dados passam a ser copiados para os registros TLS, então o
+ * envio "sem cópia" só evita a cópia para o heap do lwIP.
+ *
+ * @warning Os callbacks de conclusão são executados no contexto do lwIP.
+ */
+
+// HTTPS: conexão sobre altcp_tls (mbedTLS) com retomada de sessão; ligado no build com -DSTATION_TLS=ON
+#ifndef HTTP_CLIENT_TLS
+#define HTTP_CLIENT_TLS 0
+#endif
+
+// quantidade máxima de requisições em voo na mesma conexão (1 = sem pipelining)
+#ifndef HTTP_CLIENT_MAX_PIPELINE
+#define HTTP_CLIENT_MAX_PIPELINE 2
+#endif
+
+// tamanho máximo dos cabeçalhos fixos de uma rota (HttpRequestTemplate)
+#define HTTP_CLIENT_TEMPLATE_MAX 160
+
+// tempo máximo aguardando a resposta de uma requisição
+#define HTTP_CLIENT_TIMEOUT_MS 10000
+
+// códigos de erro repassados ao callback no lugar do status HTTP
+#define HTTP_CLIENT_ERR_CONNECTION -1   // conexão caiu antes da resposta
+#define HTTP_CLIENT_ERR_TIMEOUT -2      // servidor não respondeu a tempo
+#define HTTP_CLIENT_ERR_PARSE -3        // resposta malformada
+
+// callback de conclusão: status HTTP (200, 404, ...) ou um dos erros acima
+typedef void (*http_client_done_fn)(int status, void *arg);
+
+// cabeçalhos fixos de uma rota, montados uma única vez e enviados sem cópia
+typedef struct {
+    char prefix[HTTP_CLIENT_TEMPLATE_MAX];  // "POST <path> HTTP/1.1 ... Content-Length: "
+    uint16_t prefix_length;
+} HttpRequestTemplate;
+
+// aviso de conexão estabelecida (true) ou perdida/falha na tentativa (false)
+typedef void (*http_client_connection_fn)(bool connected);
+
+// estatísticas do cliente
+typedef struct {
+    uint32_t connects;          // conexões abertas (a primeira e as reconexões)
+    uint32_t requests;          // requisições escritas no TCP
+    uint32_t responses;         // respostas completas recebidas
+    uint32_t errors;            // requisições encerradas com erro
+    uint32_t bytes_sent;        // bytes de requisição escritos
+    uint32_t bytes_acked;       // bytes confirmados pelo TCP
+    uint32_t tls_full_handshakes;       // handshakes TLS completos (troca de chaves)
+    uint32_t tls_resumed_handshakes;    // handshakes com a sessão anterior oferecida para retomada
+    uint32_t tls_full_ms;               // duração do último handshake completo (conexão TCP + TLS)
+    uint32_t tls_resumed_ms;            // duração do último handshake retomado
+    uint32_t tls_heap_bytes;            // heap ocupado pela conexão TLS após o handshake
+    uint32_t tls_heap_peak;             // maior tamanho do heap (arena do malloc) observado
+} HttpClientStats;
+
+// definição das funções
+
+// inicializa o cliente (estatísticas e interpretador de respostas)
+void http_client_init(void);
+#if HTTP_CLIENT_TLS
+// configura o TLS com o certificado da CA do servidor (PEM com o '\0' final ou DER)
+bool http_client_set_tls(const uint8_t *ca_cert, size_t ca_cert_length);
+#endif
+// registra quem deve ser avisado quando a conexão é estabelecida ou perdida
+void http_client_set_connection_listener(http_client_connection_fn listener);
+// inicia a conexão com o servidor host, no endereço informado, se ainda não existir (não bloqueia);
+// host é usado no cabeçalho Host das requisições dessa conexão. Retorna false se a tentativa falhou de imediato
+bool http_client_connect(const char *host, const ip_addr_t *address, uint16_t port);
+// indica se a conexão está estabelecida
+bool http_client_is_connected(void);
+// indica se uma nova requisição com o tamanho informado pode ser escrita agora
+bool http_client_can_send(uint16_t length);
+// escreve uma requisição POST; retorna false se não houver conexão, espaço na janela ou vaga no pipeline
+bool http_client_post(const char *path, const char *content_type, const char *body, uint16_t body_length,
+                      http_client_done_fn done, void *arg);
+// monta os cabeçalhos fixos de uma rota para o servidor da conexão atual (deve ser chamada depois de
+// http_client_connect e remontada quando a conexão seguinte for com outro servidor)
+bool http_client_template_init(HttpRequestTemplate *request_template, const char *path, const char *content_type);
+// escreve um POST sem copiar cabeçalhos nem corpo para o heap do lwIP: o template e o corpo são
+// referenciados diretamente pelos segmentos TCP e precisam continuar válidos e inalterados até o
+// callback de conclusão (que só ocorre depois que o TCP confirmou todos os bytes ou que a conexão caiu)
+bool http_client_post_zero_copy(const HttpRequestTemplate *request_template, const char *body, uint16_t body_length,
+                                http_client_done_fn done, void *arg);
+// inicia um POST com corpo em "Transfer-Encoding: chunked"; body_estimate é usado para checar a janela de envio
+bool http_client_begin_chunked(const char *path, const char *content_type, uint16_t body_estimate,
+                               http_client_done_fn done, void *arg);
+// escreve um pedaço do corpo do POST em andamento
+bool http_client_write_chunk(const char *data, uint16_t length);
+// encerra o corpo do POST em andamento e envia a requisição
+bool http_client_end_chunked(void);
+// quantidade de requisições aguardando resposta
+uint8_t http_client_pending(void);
+// bytes escritos na conexão atual ainda não confirmados pelo TCP (podem referenciar buffers sem cópia)
+uint32_t http_client_unacked(void);
+// fecha a conexão (as requisições em voo terminam com erro)
+void http_client_close(void);
+// copia as estatísticas do cliente
+void http_client_get_stats(HttpClientStats *out);
+
+#endif
@@ -0,0 +1,171 @@
+#include "mqtt_transport.h"
+
+#if SERVER_USE_MQTT
+
+#include <stdio.h>
+#include <string.h>
+#include "lwip/apps/mqtt.h"
+#include "lwip/ip_addr.h"
+#include "log.h"
+
+// publicação em voo
+typedef struct {
+    mqtt_transport_done_fn done;
+    void *arg;
+    uint32_t sent_ms;
+    bool used;
+} MqttTransportSlot;
+
+// cliente do lwIP e dados da conexão
+static mqtt_client_t *client = NULL;
+static struct mqtt_connect_client_info_t client_info;
+static bool connected = false;
+static bool connecting = false;
+
+// janela de publicações
+static MqttTransportSlot slots[MQTT_TRANSPORT_WINDOW];
+static uint8_t slots_used = 0;
+
+static MqttTransportStats stats;
+
+// aviso de conexão aceita ou perdida (gerenciador de conexão)
+static mqtt_transport_connection_fn connection_listener = NULL;
+
+// implementação das funções
+
+// Libera a vaga de uma publicação, contabiliza a latência e avisa o chamador
+static void mqtt_transport_finish(MqttTransportSlot *slot, int result) {
+    uint32_t latency = hal_time_ms() - slot->sent_ms;
+    mqtt_transport_done_fn done = slot->done;
+    void *arg = slot->arg;
+
+    slot->used = false;
+    slots_used--;
+
+    if (result == 0) {
+        stats.completed++;
+        stats.latency_sum_ms += latency;
+        if (stats.completed == 1 || latency < stats.latency_min_ms) stats.latency_min_ms = latency;
+        if (latency > stats.latency_max_ms) stats.latency_max_ms = latency;
+    } else {
+        stats.errors++;
+    }
+
+    if (done) done(result, arg);
+}
+
+// Callback do lwIP ao concluir uma publicação (PUBACK, envio no QoS 0 ou timeout)
+static void mqtt_transport_published(void *arg, err_t err) {
+    MqttTransportSlot *slot = arg;
+    if (!slot->used) return;
+
+    if (err == ERR_OK) mqtt_transport_finish(slot, 0);
+    else mqtt_transport_finish(slot, err == ERR_TIMEOUT ? MQTT_TRANSPORT_ERR_TIMEOUT : MQTT_TRANSPORT_ERR_CONNECTION);
+}
+
+// Encerra com erro as publicações em voo (o lwIP já descartou os pedidos pendentes)
+static void mqtt_transport_fail_all(void) {
+    for (int i = 0; i < MQTT_TRANSPORT_WINDOW; i++) {
+        if (slots[i].used) mqtt_transport_finish(&slots[i], MQTT_TRANSPORT_ERR_CONNECTION);
+    }
+}
+
+// Callback do lwIP na aceitação da conexão ou na queda dela
+static void mqtt_transport_connection(mqtt_client_t *mqtt_client, void *arg, mqtt_connection_status_t status) {
+    connecting = false;
+
+    if (status == MQTT_CONNECT_ACCEPTED) {
+        connected = true;
+        stats.connects++;
+        LOG_INFO("MQTT: conectado ao broker (%lu conexoes)\n", (unsigned long) stats.connects);
+        if (connection_listener != NULL) connection_listener(true);
+        return;
+    }
+
+    LOG_WARN("MQTT: conexao encerrada (%d)\n", status);
+    connected = false;
+    mqtt_transport_fail_all();
+    if (connection_listener != NULL) connection_listener(false);
+}
+
+void mqtt_transport_init(const char *client_id, uint16_t keep_alive_s) {
+    memset(&client_info, 0, sizeof(client_info));
+    client_info.client_id = client_id;
+    client_info.keep_alive = keep_alive_s;
+
+    memset(&stats, 0, sizeof(stats));
+    if (client == NULL) client = mqtt_client_new();
+}
+
+void mqtt_transport_set_connection_listener(mqtt_transport_connection_fn listener) {
+    connection_listener = listener;
+}
+
+bool mqtt_transport_connect(const ip_addr_t *address, uint16_t port) {
+    if (client == NULL) return false;
+    if (connected || connecting) return true;
+
+    err_t err = mqtt_client_connect(client, address, port, mqtt_transport_connection, NULL, &client_info);
+    if (err != ERR_OK) {
+        LOG_WARN("MQTT: falha ao conectar (%d)\n", err);
+        return false;
+    }
+    connecting = true;
+    return true;
+}
+
+void mqtt_transport_close(void) {
+    if (client == NULL || (!connected && !connecting)) return;
+
+    // mqtt_disconnect não chama o callback de conexão: o estado é desfeito aqui
+    mqtt_disconnect(client);
+    connected = false;
+    connecting = false;
+    mqtt_transport_fail_all();
+}
+
+bool mqtt_transport_is_connected(void) {
+    return connected;
+}
+
+bool mqtt_transport_can_publish(void) {
+    return connected && slots_used < MQTT_TRANSPORT_WINDOW;
+}
+
+bool mqtt_transport_publish(const char *topic, const void *payload, uint16_t length, uint8_t qos,
+                            mqtt_transport_done_fn done, void *arg) {
+    if (!mqtt_transport_can_publish()) return false;
+
+    MqttTransportSlot *slot = NULL;
+    for (int i = 0; i < MQTT_TRANSPORT_WINDOW && slot == NULL; i++) {
+        if (!slots[i].used) slot = &slots[i];
+    }
+
+    // ERR_MEM: buffer de saída ou fila de pedidos do lwIP cheios, tenta de novo depois
+    err_t err = mqtt_publish(client, topic, payload, length, qos, 0, mqtt_transport_published, slot);
+    if (err != ERR_OK) {
+        if (err != ERR_MEM) LOG_WARN("MQTT: erro ao publicar (%d)\n", err);
+        return false;
+    }
+
+    slot->done = done;
+    slot->arg = arg;
+    slot->sent_ms = hal_time_ms();
+    slot->used = true;
+    slots_used++;
+
+    // cabeçalho fixo (2) + tamanho do tópico (2) + tópico + packet id (QoS > 0) + payload
+    stats.published++;
+    stats.bytes_sent += 2 + 2 + strlen(topic) + (qos > 0 ? 2 : 0) + length;
+    return true;
+}
+
+uint8_t mqtt_transport_pending(void) {
+    return slots_used;
+}
+
+void mqtt_transport_get_stats(MqttTransportStats *out) {
+    *out = stats;
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef MQTT_TRANSPORT_H
+#define MQTT_TRANSPORT_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+#include "lwip/ip_addr.h"
+
+/**
+ * @file mqtt_transport.h
+ *
+ * @brief Publicação MQTT 3.1.1 sobre o app MQTT do lwIP (lwip/apps/mqtt.h).
+ *
+ * @note Mantém a conexão com o broker (com keep-alive feito pelo próprio lwIP) e uma janela de
+ * até MQTT_TRANSPORT_WINDOW publicações em voo. Cada publicação tem um callback de conclusão:
+ * com QoS 1 ele é chamado no PUBACK do broker; com QoS 0, quando o TCP terminou de enviar.
+ * Se a conexão cair, as publicações em voo são encerradas com MQTT_TRANSPORT_ERR_CONNECTION
+ * (o lwIP descarta os pedidos pendentes sem avisar).
+ *
+ * Só é compilado com SERVER_USE_MQTT (ver server.h).
+ *
+ * @warning Os callbacks de conclusão são executados no contexto do lwIP.
+ */
+
+// publicações em voo (deve ser <= MQTT_REQ_MAX_IN_FLIGHT do lwIP)
+#ifndef MQTT_TRANSPORT_WINDOW
+#define MQTT_TRANSPORT_WINDOW 4
+#endif
+
+// códigos repassados ao callback de conclusão (0 = publicação concluída)
+#define MQTT_TRANSPORT_ERR_CONNECTION -1    // conexão caiu antes da confirmação
+#define MQTT_TRANSPORT_ERR_TIMEOUT -2       // broker não confirmou a tempo
+
+// callback de conclusão de uma publicação
+typedef void (*mqtt_transport_done_fn)(int result, void *arg);
+
+// aviso de conexão aceita pelo broker (true) ou perdida/recusada (false)
+typedef void (*mqtt_transport_connection_fn)(bool connected);
+
+// estatísticas do transporte
+typedef struct {
+    uint32_t connects;          // conexões aceitas pelo broker
+    uint32_t published;         // publicações entregues ao lwIP
+    uint32_t completed;         // publicações concluídas com sucesso
+    uint32_t errors;            // publicações encerradas com erro
+    uint32_t bytes_sent;        // bytes dos pacotes PUBLISH
+    uint32_t latency_min_ms;    // menor tempo entre publicar e concluir
+    uint32_t latency_max_ms;    // maior tempo entre publicar e concluir
+    uint32_t latency_sum_ms;    // soma dos tempos (média = soma / completed)
+} MqttTransportStats;
+
+// definição das funções
+
+// configura o client id e o keep-alive
+void mqtt_transport_init(const char *client_id, uint16_t keep_alive_s);
+// registra quem deve ser avisado quando a conexão é aceita ou perdida
+void mqtt_transport_set_connection_listener(mqtt_transport_connection_fn listener);
+// inicia a conexão com o broker no endereço informado se ainda não existir (não bloqueia); false se a
+// tentativa falhou de imediato
+bool mqtt_transport_connect(const ip_addr_t *address, uint16_t port);
+// encerra a conexão ou a tentativa em andamento; as publicações em voo falham
+void mqtt_transport_close(void);
+// indica se o broker aceitou a conexão
+bool mqtt_transport_is_connected(void);
+// indica se há conexão e vaga na janela de publicações
+bool mqtt_transport_can_publish(void);
+// publica uma mensagem (o payload é copiado); retorna false se não houver conexão, vaga na janela
+// ou espaço no buffer de saída do lwIP, caso em que deve ser tentada de novo mais tarde
+bool mqtt_transport_publish(const char *topic, const void *payload, uint16_t length, uint8_t qos,
+                            mqtt_transport_done_fn done, void *arg);
+// quantidade de publicações em voo
+uint8_t mqtt_transport_pending(void);
+// copia as estatísticas do transporte
+void mqtt_transport_get_stats(MqttTransportStats *out);
+
+#endif
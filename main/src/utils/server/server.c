@@ -1,145 +1,253 @@
 // inclusions libraries
 #include "server.h"
-
-// tcp_pcb struct to stablish connection
-struct tcp_pcb *pcb = NULL;
-
-// variables and definition to control connetion attemps
-bool have_connection = false;
-#define MAX_RETRIES 5
-int retries = 0;
+#include "server_common.h"
+#include "http_client.h"
+#include "server_payload.h"
+#include "cbor.h"
+#include "wifi.h"
+#include "log.h"
+#include "sched.h"
+#include "hal.h"
+
+// transporte HTTP; com SERVER_USE_MQTT ou SERVER_USE_UDP as mesmas funções vêm de server_mqtt.c ou server_udp.c
+#if !SERVER_USE_MQTT && !SERVER_USE_UDP
+
+// conexão com o servidor: tentativas, backoff e circuit breaker ficam no gerenciador
+static ConnectionManager connection;
+
+// servidores de ingestão (resolvidos por DNS, com failover)
+static const char *const hosts[] = {SERVER_HOSTS};
+static Upstream upstream;
+
+// resultados dos lotes em voo, na ordem de envio (preenchidos pelo callback do cliente HTTP,
+// executado no contexto do lwIP, e consumidos no laço principal)
+static volatile int batch_results[QUEUE_MAX_IN_FLIGHT];
+static volatile uint8_t results_written = 0;
+static uint8_t results_read = 0;
+
+// geração dos lotes: incrementada quando os lotes em voo são devolvidos à fila, para que
+// respostas atrasadas de lotes já descartados sejam ignoradas
+static uint32_t batch_generation = 0;
+
+// amostras de cada lote em voo (para a medição de vazão)
+static uint16_t batch_samples[QUEUE_MAX_IN_FLIGHT];
+
+// corpos dos lotes em voo: referenciados pelo TCP sem cópia, cada um só é reaproveitado depois
+// que o lote correspondente foi concluído (os lotes são concluídos na ordem de envio)
+static char bodies[QUEUE_MAX_IN_FLIGHT][SERVER_BODY_SIZE];
+static uint8_t next_body = 0;
+
+// rota de ingestão de um formato do corpo
+typedef struct {
+    const char *path;
+    const char *content_type;
+    server_payload_batch_fn format;
+    uint16_t entry_max;         // maior amostra codificada, para estimar o espaço no envio
+} ServerEndpoint;
+
+// formato atual e cabeçalhos fixos de cada rota, com o Host do servidor em uso. Requisições em voo
+// referenciam o template sem cópia: ele só é remontado quando uma conexão com outro servidor é
+// estabelecida, e nesse ponto nada mais o referencia (a conexão anterior foi fechada com todos os
+// bytes confirmados ou abortada)
+static ServerEncoding encoding = SERVER_ENCODING;
+static HttpRequestTemplate ingest_templates[SERVER_NUM_ENCODINGS];
+static const char *templates_host = NULL;
 
 // implementation functions
 
+// Callback de conclusão de um lote (status HTTP ou erro de transporte)
+static void server_batch_done(int status, void *arg) {
+    if ((uint32_t) (uintptr_t) arg != batch_generation) return;    // lote já devolvido à fila
 
-// Callback para a resposta do servidor
-err_t server_tcp_client_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
-    if (p == NULL) {
-        printf("Connection closed by the server.\n");
-        tcp_close(tpcb);
-        have_connection = false;
-        pcb = NULL;
-        return ERR_OK;
+    batch_results[results_written % QUEUE_MAX_IN_FLIGHT] = status;
+    results_written++;
+    sched_signal(EVENT_NETWORK);
+}
+
+// rotas de ingestão, indexadas pelo formato
+static const ServerEndpoint endpoints[SERVER_NUM_ENCODINGS] = {
+    [SERVER_ENCODING_JSON] = {SERVER_PATH, "application/json", server_payload_batch_json, SERVER_ENTRY_MAX},
+    [SERVER_ENCODING_CBOR] = {SERVER_PATH_CBOR, "application/cbor", server_payload_batch_cbor, CBOR_SAMPLE_MAX},
+};
+
+// Envia um lote: sem cópia quando o corpo cabe no buffer do lote, ou em pedaços (chunked, copiados
+// para o lwIP) quando não cabe
+static bool server_send_batch(const QueueEntry *entries, uint16_t count) {
+    const ServerEndpoint *endpoint = &endpoints[encoding];
+    void *generation = (void *) (uintptr_t) batch_generation;
+    char *body = bodies[next_body];
+    uint16_t next = 0;
+    int length = endpoint->format(body, SERVER_BODY_SIZE, entries, count, &next);
+
+    if (next == count) {
+        if (!http_client_post_zero_copy(&ingest_templates[encoding], body, length, server_batch_done, generation)) return false;
+        next_body = (next_body + 1) % QUEUE_MAX_IN_FLIGHT;
+        return true;
     }
 
-    tcp_recved(tpcb, p->tot_len);
-    pbuf_free(p);
-    return ERR_OK;
+    // lote grande: o corpo é enviado em pedaços, reaproveitando o mesmo buffer
+    if (!http_client_begin_chunked(endpoint->path, endpoint->content_type, count * endpoint->entry_max, server_batch_done, generation)) {
+        return false;
+    }
+    while (length > 0) {
+        if (!http_client_write_chunk(body, length)) return false;
+        length = next < count ? endpoint->format(body, SERVER_BODY_SIZE, entries, count, &next) : 0;
+    }
+    if (!http_client_end_chunked()) return false;
+    next_body = (next_body + 1) % QUEUE_MAX_IN_FLIGHT;
+    return true;
 }
 
-// Callback para erro na conexão TCP
-void server_tcp_client_error(void *arg, err_t err) {
-    printf("TCP connection error (%d). Trying to reconnect..\n", err);
-    pcb = NULL;
-    have_connection = false;
+// Devolve todos os lotes em voo para a fila
+static void server_reset_batches() {
+    // requisições que ainda estão na conexão, ou bytes já respondidos mas ainda não confirmados pelo
+    // TCP, referenciam os buffers dos lotes: a conexão é derrubada antes de os buffers serem reaproveitados
+    if (http_client_pending() > 0 || http_client_unacked() > 0) http_client_close();
+
+    queue_nack();
+    batch_generation++;
+    results_read = results_written = 0;
+    next_body = 0;
 }
 
-// Fechar conexão TCP
-void server_close_tcp_connection() {
-    if (pcb != NULL) {
-        tcp_close(pcb);
-        pcb = NULL;
-        have_connection = false;
-        printf("TCP connection closed.\n");
+// Trata as respostas dos lotes em voo, na ordem em que foram enviados
+static void server_handle_results() {
+    while (results_read != results_written) {
+        int status = batch_results[results_read % QUEUE_MAX_IN_FLIGHT];
+        uint16_t samples = batch_samples[0];
+        results_read++;
+
+        if (status >= 200 && status < 300) {
+            queue_ack();
+            server_samples_delivered(samples);
+            for (int i = 0; i + 1 < QUEUE_MAX_IN_FLIGHT; i++) batch_samples[i] = batch_samples[i + 1];
+            continue;
+        }
+
+        // lote recusado ou perdido: ele e os seguintes voltam para a fila e serão reenviados em ordem
+        LOG_WARN("Lote nao confirmado (%d), sera reenviado\n", status);
+        server_reset_batches();
+        break;
     }
 }
 
-// Callback para sucesso na conexão com o servidor
-err_t server_tcp_connected(void *arg, struct tcp_pcb *tpcb, err_t err) {
-    if (err != ERR_OK) {
-        printf("Falha ao conectar: %d\n", err);
-        tcp_abort(tpcb);
-        pcb = NULL;
-        return err;
+// Fim da consulta DNS do servidor em uso: inicia a conexão ou encerra a tentativa com falha
+static void server_upstream_ready(const ip_addr_t *address) {
+    if (address == NULL || !http_client_connect(upstream_host(&upstream), address, SERVER_PORT)) connection_lost(&connection);
+}
+
+// Inicia uma tentativa: com o endereço em cache a conexão começa na hora; sem ele, quando o DNS responder
+static bool server_connect(void) {
+    ip_addr_t address;
+    switch (upstream_resolve(&upstream, &address, server_upstream_ready)) {
+        case UPSTREAM_READY: return http_client_connect(upstream_host(&upstream), &address, SERVER_PORT);
+        case UPSTREAM_PENDING: return true;
+        default: return false;
     }
+}
+
+// Aborta a tentativa em andamento (consulta DNS ou conexão)
+static void server_abort(void) {
+    upstream_abort(&upstream);
+    http_client_close();
+}
 
-    printf("Conexão estabelecida com sucesso!\n");
-    have_connection = true;
+// Aviso do transporte: conexão estabelecida ou perdida (contexto do lwIP)
+static void server_connection_event(bool connected) {
+    if (connected) {
+        // conexão com outro servidor (failover): os cabeçalhos fixos passam a levar o novo Host
+        const char *host = upstream_host(&upstream);
+        if (host != templates_host) {
+            for (int i = 0; i < SERVER_NUM_ENCODINGS; i++) {
+                http_client_template_init(&ingest_templates[i], endpoints[i].path, endpoints[i].content_type);
+            }
+            templates_host = host;
+        }
+        upstream_succeeded(&upstream);
+        connection_connected(&connection);
+        sched_signal(EVENT_NETWORK);
+        return;
+    }
+    // falha na tentativa (não a queda de uma conexão estabelecida): conta contra o servidor em uso
+    if (connection_state(&connection) == CONNECTION_CONNECTING) upstream_failed(&upstream);
+    connection_lost(&connection);
+}
 
-    // Define callback de recv aqui
-    tcp_recv(tpcb, server_tcp_client_recv);
+void server_init() {
+    hal_lwip_begin();
+    upstream_init(&upstream, hosts, sizeof(hosts) / sizeof(hosts[0]));
+    connection_init(&connection, "HTTP", server_connect, server_abort);
+    http_client_set_connection_listener(server_connection_event);
+    http_client_init();
+#if HTTP_CLIENT_TLS
+    // o PEM é passado com o '\0' final, como o mbedTLS exige
+    if (!http_client_set_tls((const uint8_t *) SERVER_TLS_CA_CERT, sizeof(SERVER_TLS_CA_CERT))) {
+        LOG_ERROR("HTTP: certificado da CA invalido\n");
+    }
+#endif
+    hal_lwip_end();
+}
 
-    return ERR_OK;
+void server_set_encoding(ServerEncoding new_encoding) {
+    // lotes já em voo seguem com o formato antigo; os próximos usam a nova rota
+    if (new_encoding < SERVER_NUM_ENCODINGS) encoding = new_encoding;
 }
 
-// Cria conexão com o servidor
-void server_create_tcp_connection() {
-    if (pcb != NULL) return;    // conexão já existe
-    retries++;
+void server_transport_collect(uint32_t now_ms) {
+    // tratando o resultado dos lotes em voo
+    server_handle_results();
+}
 
-    // configuração do servidor
-    ip_addr_t server_ip;
-    server_ip.addr = ipaddr_addr(SERVER_IP);
+void server_transport_send(uint32_t now_ms) {
+    uint16_t batch_max_samples = server_batch_max_samples();
 
-    // criando pdb
-    pcb = tcp_new();
-    if (!pcb) {
-        printf("Failed to create pcb\n");
+    // sem conexão: o gerenciador inicia ou agenda a tentativa (com o Wi-Fi no ar); o laço principal segue sem esperar
+    if (!http_client_is_connected()) {
+        if (wifi_is_connected()) connection_request(&connection);
         return;
     }
 
-    tcp_err(pcb, server_tcp_client_error);  // registrando um callback para erro de conexão
-
-    // tentando se conectar ao servidor
-    err_t connect_err = tcp_connect(pcb, &server_ip, SERVER_PORT, NULL);
-    if (connect_err == ERR_OK) {
-        printf("Conected to server!\n");
-        have_connection = true;
-        tcp_recv(pcb, server_tcp_client_recv);
-    } else {
-        printf("Connection failed (%d). Attempted %d/%d\n", connect_err, retries, MAX_RETRIES);
-        tcp_abort(pcb);
-        pcb = NULL;
+    // drenando o backlog em lotes, com até QUEUE_MAX_IN_FLIGHT requisições em voo (pipelining)
+    while (queue_in_flight() < QUEUE_MAX_IN_FLIGHT && http_client_can_send(batch_max_samples * endpoints[encoding].entry_max)) {
+        static QueueEntry entries[QUEUE_BATCH_SIZE];
+        uint8_t slot = queue_in_flight();
+        uint16_t count = queue_next_batch(entries, batch_max_samples);
+        if (count == 0) break;
+
+        if (!server_send_batch(entries, count)) {
+            LOG_WARN("Erro ao enviar lote de %d amostras\n", count);
+            server_reset_batches();
+            break;
+        }
+        batch_samples[slot] = count;
     }
 }
 
-void server_send_data(int temperature, int humidity, float pollutionLevel) {
-    // estabelecer uma conexão com o servidor
-    while (pcb == NULL || !have_connection) {
-        if (retries >= MAX_RETRIES) {
-            printf("Error: Connection could not be re-established after %d attempts.\n", MAX_RETRIES);
-            return;  // Aborts if the maximum number of reconnection attempts is reached
-        }
+ConnectionState server_connection_state() {
+    return connection_state(&connection);
+}
 
-        printf("Connection lost. Trying to reconnect... (%d/%d)\n", retries, MAX_RETRIES);
-        server_create_tcp_connection();  // Attempts to reconnect
-        sleep_ms(1000);
-    }
+uint32_t server_connection_retry_in_ms() {
+    return connection_retry_in_ms(&connection);
+}
 
-    retries = 0;
-    
-    // Preparando o corpo da requisição
-    char json_request[256];
-    snprintf(json_request, sizeof(json_request),
-    "{\n"
-    "\"temperature\" : %d,\n"
-    "\"humidity\" : %d,\n"
-    "\"pollutionLevel\" : %.1f\n"
-    "}", temperature, humidity, pollutionLevel);
-
-    // Montando requisição
-    char request[521];
-    snprintf(request, sizeof(request),  
-    "POST /api/sensors-data HTTP/1.1\r\n"
-    "Host: %s\r\n"
-    "Content-Type: application/json\r\n"
-    "Content-Length: %d\r\n"
-    "\r\n"
-    "%s"
-    "\r\n",
-    SERVER_IP, strlen(json_request), json_request);
-
-    // Escrevendo a requisição
-    if (tcp_write(pcb, request, strlen(request), TCP_WRITE_FLAG_COPY) != ERR_OK) {
-        printf("Erro ao enviar dados\n");
-        tcp_abort(pcb);
-        return;
-    }
+const Upstream *server_upstream() {
+    return &upstream;
+}
 
-    // Enviando a requisição
-    if (tcp_output(pcb) != ERR_OK) {
-        printf("Erro ao enviar dados (tcp_output)\n");
-        tcp_abort(pcb);
-        return;
-    }
-}
\ No newline at end of file
+void server_disconnect() {
+    hal_lwip_begin();
+    connection_release(&connection);
+    server_abort();
+    hal_lwip_end();
+}
+
+uint32_t server_bytes_per_sample() {
+    if (server_samples_acked() == 0) return 0;
+
+    HttpClientStats stats;
+    http_client_get_stats(&stats);
+    return stats.bytes_sent / server_samples_acked();
+}
+
+#endif
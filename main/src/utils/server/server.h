@@ -3,20 +3,128 @@
 
 // inclusão de bibliotecas
 #include <string.h>
-#include "pico/stdlib.h"
+#include "hal.h"
 #include "lwip/tcp.h"
 #include "lwip/dns.h"
+#include "queue.h"
+#include "connection.h"
+#include "upstream.h"
 
-// configuração servidor
-#define SERVER_IP "IP SERVIDOR (ipv4 caso esteja rodando localmente)"
+// servidores de ingestão em ordem de preferência, separados por vírgula: nomes (resolvidos por DNS)
+// ou IPv4 em texto; quando um deles falha, o próximo é usado (ver upstream.h). O primeiro também vai
+// no cabeçalho Host das requisições HTTP
+#ifndef SERVER_HOSTS
+#define SERVER_HOSTS "IP SERVIDOR (ipv4 ou nome do servidor)"
+#endif
+#ifndef SERVER_PORT
 #define SERVER_PORT 8080
+#endif
+
+// HTTPS (build com -DSTATION_TLS=ON, normalmente com SERVER_PORT 443): certificado da CA que assinou o
+// certificado do servidor, em PEM; o nome em SERVER_HOSTS precisa constar no certificado
+#define SERVER_TLS_CA_CERT "CERTIFICADO DA CA DO SERVIDOR (PEM)"
+
+// transporte das amostras: HTTP (server.c, padrão), MQTT (server_mqtt.c) ou UDP (server_udp.c),
+// escolhido no build com -DSTATION_TRANSPORT=MQTT ou -DSTATION_TRANSPORT=UDP no CMake
+#ifndef SERVER_USE_MQTT
+#define SERVER_USE_MQTT 0
+#endif
+#ifndef SERVER_USE_UDP
+#define SERVER_USE_UDP 0
+#endif
+
+// configuração do MQTT: broker nos mesmos servidores, um tópico por estação e canal
+// ("<raiz>/<estação>/<canal>") e o id da estação também como client id
+#define SERVER_MQTT_PORT 1883
+#define SERVER_MQTT_TOPIC_ROOT "estacao"
+#define SERVER_MQTT_STATION_ID "estacao-01"
+#define SERVER_MQTT_TOPIC_TEMPERATURE "temperatura"
+#define SERVER_MQTT_TOPIC_HUMIDITY "umidade"
+#define SERVER_MQTT_TOPIC_POLLUTION "poluicao"
+#define SERVER_MQTT_TOPIC_MAX 64
+#define SERVER_MQTT_KEEP_ALIVE_S 60
+// QoS das publicações (0 ou 1)
+#ifndef SERVER_MQTT_QOS
+#define SERVER_MQTT_QOS 1
+#endif
+
+// configuração do UDP: receptor nos mesmos servidores; com SERVER_UDP_ACK = 0 os datagramas
+// são enviados sem confirmação (perdas são aceitas), com 1 o receptor confirma cada datagrama e
+// avisa lacunas (NACK), e os lotes perdidos são reenviados
+#define SERVER_UDP_PORT 9000
+#define SERVER_UDP_STATION_ID 1
+#ifndef SERVER_UDP_ACK
+#define SERVER_UDP_ACK 0
+#endif
+#define SERVER_UDP_ACK_TIMEOUT_MS 2000
+
+// rotas de ingestão das amostras, uma por formato do corpo
+#define SERVER_PATH "/api/sensors-data"
+#define SERVER_PATH_CBOR "/api/sensors-data/cbor"
+
+// formato do corpo das requisições (cada um com sua rota e seu Content-Type)
+typedef enum {
+    SERVER_ENCODING_JSON,       // array JSON, application/json
+    SERVER_ENCODING_CBOR,       // array CBOR (ver cbor.h), application/cbor; ~3x menor que o JSON
+    SERVER_NUM_ENCODINGS
+} ServerEncoding;
+
+// formato usado desde a inicialização
+#ifndef SERVER_ENCODING
+#define SERVER_ENCODING SERVER_ENCODING_JSON
+#endif
+
+// tamanho do buffer do corpo de cada lote em voo (lotes maiores são enviados em pedaços,
+// com Transfer-Encoding: chunked); fica em RAM estática, fora do heap do lwIP
+#define SERVER_BODY_SIZE 2048
+// maior objeto JSON de uma amostra
+#define SERVER_ENTRY_MAX 112
+
+// limites padrão do lote: envia ao acumular SERVER_BATCH_MIN_SAMPLES amostras ou quando a mais antiga
+// completar SERVER_BATCH_MAX_AGE_S segundos, com no máximo SERVER_BATCH_MAX_SAMPLES por requisição
+#ifndef SERVER_BATCH_MIN_SAMPLES
+#define SERVER_BATCH_MIN_SAMPLES 8
+#endif
+#ifndef SERVER_BATCH_MAX_AGE_S
+#define SERVER_BATCH_MAX_AGE_S 300
+#endif
+#ifndef SERVER_BATCH_MAX_SAMPLES
+#define SERVER_BATCH_MAX_SAMPLES 24
+#endif
+
+// máscara de canais incluídos no corpo da requisição (mesma ordem dos canais do histórico)
+#define SERVER_CHANNEL_TEMPERATURE (1u << 0)
+#define SERVER_CHANNEL_HUMIDITY (1u << 1)
+#define SERVER_CHANNEL_POLLUTION (1u << 2)
+#define SERVER_ALL_CHANNELS (SERVER_CHANNEL_TEMPERATURE | SERVER_CHANNEL_HUMIDITY | SERVER_CHANNEL_POLLUTION)
 
 // definitions functions
-void server_create_tcp_connection();
-void server_close_tcp_connection();
-void server_tcp_client_error(void *arg, err_t err);
-err_t server_tcp_client_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
 
-void server_send_data(int temperature, int humidity, float pollutionLevel);
+// configura o cliente HTTP persistente com o endereço do servidor
+void server_init();
+// envia (em lotes) as amostras pendentes na fila; deve ser chamada periodicamente no laço principal
+void server_process_queue();
+// troca o formato (e a rota) dos próximos lotes
+void server_set_encoding(ServerEncoding encoding);
+// envia tudo o que estiver pendente sem esperar pelos limites do lote (janela de envio do rádio)
+void server_flush();
+// fecha a conexão com o servidor e suspende as tentativas até o próximo envio (rádio sendo desligado)
+void server_disconnect();
+// altera os limites do lote em tempo de execução (min_samples = 1 desliga o acúmulo)
+void server_set_batching(uint16_t min_samples, uint16_t max_samples, uint32_t max_age_s);
+// quantidade mínima de amostras por lote (limite atual de server_set_batching)
+uint16_t server_batch_min_samples(void);
+// idade máxima da amostra mais antiga do lote, em segundos (limite atual de server_set_batching)
+uint32_t server_batch_max_age_s(void);
+// estado da conexão com o servidor (o UDP não tem conexão e fica sempre em CONNECTION_IDLE)
+ConnectionState server_connection_state();
+// tempo até a próxima tentativa de conexão agendada (0 se não houver)
+uint32_t server_connection_retry_in_ms();
+// lista de servidores de ingestão (servidor em uso e estatísticas do DNS)
+const Upstream *server_upstream();
+// bytes de HTTP escritos por amostra confirmada (cabeçalhos + corpo)
+uint32_t server_bytes_per_sample();
+// amostras confirmadas e tempo decorrido desde o início do backlog atual (vazão do backfill)
+void server_get_backfill_rate(uint32_t *samples, uint32_t *elapsed_ms);
 
 #endif
@@ -0,0 +1,103 @@
+// inclusions libraries
+#include "server_common.h"
+#include "log.h"
+#include "hal.h"
+
+// limites do lote, ajustáveis em tempo de execução
+static uint16_t batch_min_samples = SERVER_BATCH_MIN_SAMPLES;
+static uint16_t batch_max_samples = SERVER_BATCH_MAX_SAMPLES;
+static uint32_t batch_max_age_s = SERVER_BATCH_MAX_AGE_S;
+
+// envio de tudo o que estiver pendente pedido por server_flush (vale até a fila esvaziar)
+static bool flush_requested = false;
+
+// medição de vazão do backfill
+static uint32_t samples_sent = 0;
+static uint32_t backlog_started_ms = 0;
+
+// amostras confirmadas desde a inicialização (para calcular bytes por amostra)
+static uint32_t samples_acked = 0;
+
+// implementation functions
+
+bool server_batch_due(uint32_t now_ms) {
+    if (flush_requested || queue_pending() >= batch_min_samples) return true;
+
+    uint32_t oldest_s;
+    if (!queue_oldest_timestamp(&oldest_s)) return true;    // backlog antigo, vindo da flash
+    return now_ms / 1000 - oldest_s >= batch_max_age_s;
+}
+
+uint16_t server_batch_min_samples(void) {
+    return batch_min_samples;
+}
+
+uint32_t server_batch_max_age_s(void) {
+    return batch_max_age_s;
+}
+
+uint16_t server_batch_max_samples(void) {
+    return batch_max_samples;
+}
+
+void server_samples_delivered(uint16_t samples) {
+    samples_sent += samples;
+    samples_acked += samples;
+}
+
+uint32_t server_samples_acked(void) {
+    return samples_acked;
+}
+
+// Corpo de server_process_queue, executado com o lwIP travado
+static void server_process_queue_locked() {
+    uint32_t now = hal_time_ms();
+
+    // tratando o resultado dos lotes em voo
+    server_transport_collect(now);
+
+    // nada pendente: encerra a medição do backfill
+    if (queue_pending() == 0) {
+        if (backlog_started_ms != 0 && samples_sent > 0) {
+            uint32_t elapsed = now - backlog_started_ms;
+            LOG_INFO("Backfill concluido: %lu amostras em %lu ms\n", (unsigned long) samples_sent, (unsigned long) elapsed);
+        }
+        backlog_started_ms = 0;
+        samples_sent = 0;
+        flush_requested = false;
+        return;
+    }
+    if (backlog_started_ms == 0) backlog_started_ms = now;
+
+    // aguardando acumular amostras suficientes (ou a amostra mais antiga envelhecer)
+    if (queue_in_flight() == 0 && !server_batch_due(now)) return;
+
+    server_transport_send(now);
+}
+
+void server_process_queue() {
+    // o lwIP roda em segundo plano (cyw43_arch_lwip_threadsafe_background): as chamadas feitas
+    // a partir do laço principal precisam travá-lo, o que também serializa os callbacks
+    hal_lwip_begin();
+    server_process_queue_locked();
+    hal_lwip_end();
+}
+
+void server_get_backfill_rate(uint32_t *samples, uint32_t *elapsed_ms) {
+    *samples = samples_sent;
+    *elapsed_ms = backlog_started_ms != 0 ? hal_time_ms() - backlog_started_ms : 0;
+}
+
+void server_flush() {
+    flush_requested = true;
+}
+
+void server_set_batching(uint16_t min_samples, uint16_t max_samples, uint32_t max_age_s) {
+    if (max_samples == 0 || max_samples > QUEUE_BATCH_SIZE) max_samples = QUEUE_BATCH_SIZE;
+    if (min_samples == 0) min_samples = 1;
+    if (min_samples > max_samples) min_samples = max_samples;
+
+    batch_min_samples = min_samples;
+    batch_max_samples = max_samples;
+    batch_max_age_s = max_age_s;
+}
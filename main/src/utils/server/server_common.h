@@ -0,0 +1,34 @@
+#ifndef SERVER_COMMON_H
+#define SERVER_COMMON_H
+
+// inclusão de bibliotecas
+#include "server.h"
+
+/**
+ * @file server_common.h
+ *
+ * @brief Parte de server.h comum aos transportes (HTTP, MQTT e UDP): política do lote, envio
+ * pedido por server_flush, medição do backfill e o ciclo de server_process_queue com o lwIP travado.
+ *
+ * @note Cada transporte implementa os dois passos do ciclo: server_transport_collect trata as
+ * confirmações dos lotes em voo e server_transport_send envia os próximos lotes. O envio só é chamado
+ * quando há amostras pendentes e um lote em voo ou um lote novo devido (server_batch_due).
+ */
+
+// definição das funções
+
+// passo do transporte: trata as confirmações (ou falhas) dos lotes em voo, com o lwIP travado
+void server_transport_collect(uint32_t now_ms);
+// passo do transporte: envia os próximos lotes, com o lwIP travado
+void server_transport_send(uint32_t now_ms);
+
+// indica se o lote pendente já deve ser enviado (quantidade mínima de amostras ou idade máxima atingida)
+bool server_batch_due(uint32_t now_ms);
+// maior quantidade de amostras por lote (limite atual de server_set_batching)
+uint16_t server_batch_max_samples(void);
+// registra amostras confirmadas pelo servidor (vazão do backfill e bytes por amostra)
+void server_samples_delivered(uint16_t samples);
+// amostras confirmadas desde a inicialização
+uint32_t server_samples_acked(void);
+
+#endif
@@ -0,0 +1,209 @@
+// inclusions libraries
+#include "server.h"
+#include "server_common.h"
+#include "server_payload.h"
+#include "mqtt_transport.h"
+#include "format.h"
+#include "wifi.h"
+#include "log.h"
+#include "sched.h"
+#include "hal.h"
+
+// transporte MQTT: cada amostra da fila vira uma mensagem por canal, no tópico do canal
+#if SERVER_USE_MQTT
+
+// canais publicados, na ordem dos bits de SERVER_CHANNEL_*
+#define SERVER_MQTT_CHANNELS 3
+
+// conexão com o servidor: tentativas, backoff e circuit breaker ficam no gerenciador
+static ConnectionManager connection;
+
+// servidores de ingestão (resolvidos por DNS, com failover)
+static const char *const hosts[] = {SERVER_HOSTS};
+static Upstream upstream;
+
+// tópicos de cada canal, montados na inicialização
+static const char *channel_topics[SERVER_MQTT_CHANNELS] = {
+    SERVER_MQTT_TOPIC_TEMPERATURE, SERVER_MQTT_TOPIC_HUMIDITY, SERVER_MQTT_TOPIC_POLLUTION
+};
+static char topics[SERVER_MQTT_CHANNELS][SERVER_MQTT_TOPIC_MAX];
+
+// formato do payload de cada mensagem
+static ServerEncoding encoding = SERVER_ENCODING;
+
+// lote em publicação: confirmado na fila quando todas as suas mensagens forem concluídas
+static QueueEntry batch[QUEUE_BATCH_SIZE];
+static uint16_t batch_count = 0;            // 0 = nenhum lote em publicação
+static uint16_t batch_next = 0;             // próxima amostra a publicar
+static uint8_t channel_next = 0;            // próximo canal da amostra batch_next
+static volatile uint16_t batch_outstanding = 0;     // mensagens publicadas e ainda não concluídas
+static volatile bool batch_failed = false;
+
+// geração do lote: conclusões atrasadas de um lote já devolvido à fila são ignoradas
+static uint32_t batch_generation = 0;
+
+// implementation functions
+
+// Callback de conclusão de uma mensagem (executado no contexto do lwIP)
+static void server_message_done(int result, void *arg) {
+    if ((uint32_t) (uintptr_t) arg != batch_generation) return;
+
+    batch_outstanding--;
+    if (result != 0) batch_failed = true;
+
+    // lote concluído: a tarefa de rede encerra o lote e publica o próximo sem esperar o período
+    if (batch_outstanding == 0) sched_signal(EVENT_NETWORK);
+}
+
+// Encerra o lote em publicação quando todas as mensagens enviadas foram concluídas
+static void server_finish_batch() {
+    if (batch_count == 0 || batch_outstanding > 0) return;
+    if (!batch_failed && batch_next < batch_count) return;
+
+    if (batch_failed) {
+        // o lote volta inteiro para a fila; mensagens já entregues serão repetidas (o seq permite descartá-las)
+        LOG_WARN("Lote MQTT nao confirmado, sera republicado\n");
+        queue_nack();
+        batch_generation++;
+    } else {
+        queue_ack();
+        server_samples_delivered(batch_count);
+    }
+    batch_count = 0;
+}
+
+// Publica as próximas mensagens do lote enquanto houver vaga na janela
+static void server_publish_batch() {
+    while (batch_next < batch_count && !batch_failed && mqtt_transport_can_publish()) {
+        const QueueEntry *entry = &batch[batch_next];
+
+        // próximo canal presente na máscara da amostra
+        while (channel_next < SERVER_MQTT_CHANNELS && !(entry->channels & (1u << channel_next))) channel_next++;
+        if (channel_next == SERVER_MQTT_CHANNELS) {
+            batch_next++;
+            channel_next = 0;
+            continue;
+        }
+
+        // a mensagem leva só o canal do tópico, com o seq e o timestamp da amostra
+        QueueEntry message = *entry;
+        message.channels = 1u << channel_next;
+
+        char payload[SERVER_ENTRY_MAX];
+        int length = encoding == SERVER_ENCODING_CBOR
+            ? server_payload_entry_cbor(payload, sizeof(payload), &message)
+            : server_payload_entry_json(payload, sizeof(payload), &message);
+
+        batch_outstanding++;
+        if (!mqtt_transport_publish(topics[channel_next], payload, length, SERVER_MQTT_QOS,
+                                    server_message_done, (void *) (uintptr_t) batch_generation)) {
+            batch_outstanding--;
+            break;
+        }
+        channel_next++;
+    }
+}
+
+// Fim da consulta DNS do servidor em uso: inicia a conexão ou encerra a tentativa com falha
+static void server_upstream_ready(const ip_addr_t *address) {
+    if (address == NULL || !mqtt_transport_connect(address, SERVER_MQTT_PORT)) connection_lost(&connection);
+}
+
+// Inicia uma tentativa: com o endereço em cache a conexão começa na hora; sem ele, quando o DNS responder
+static bool server_connect(void) {
+    ip_addr_t address;
+    switch (upstream_resolve(&upstream, &address, server_upstream_ready)) {
+        case UPSTREAM_READY: return mqtt_transport_connect(&address, SERVER_MQTT_PORT);
+        case UPSTREAM_PENDING: return true;
+        default: return false;
+    }
+}
+
+// Aborta a tentativa em andamento (consulta DNS ou conexão)
+static void server_abort(void) {
+    upstream_abort(&upstream);
+    mqtt_transport_close();
+}
+
+// Aviso do transporte: conexão estabelecida ou perdida (contexto do lwIP)
+static void server_connection_event(bool connected) {
+    if (connected) {
+        upstream_succeeded(&upstream);
+        connection_connected(&connection);
+        sched_signal(EVENT_NETWORK);
+        return;
+    }
+    // falha na tentativa (não a queda de uma conexão estabelecida): conta contra o servidor em uso
+    if (connection_state(&connection) == CONNECTION_CONNECTING) upstream_failed(&upstream);
+    connection_lost(&connection);
+}
+
+void server_init() {
+    for (int i = 0; i < SERVER_MQTT_CHANNELS; i++) {
+        format_line(topics[i], sizeof(topics[i]), SERVER_MQTT_TOPIC_ROOT "/" SERVER_MQTT_STATION_ID "/", channel_topics[i], "");
+    }
+
+    hal_lwip_begin();
+    upstream_init(&upstream, hosts, sizeof(hosts) / sizeof(hosts[0]));
+    connection_init(&connection, "MQTT", server_connect, server_abort);
+    mqtt_transport_set_connection_listener(server_connection_event);
+    mqtt_transport_init(SERVER_MQTT_STATION_ID, SERVER_MQTT_KEEP_ALIVE_S);
+    hal_lwip_end();
+}
+
+void server_set_encoding(ServerEncoding new_encoding) {
+    if (new_encoding < SERVER_NUM_ENCODINGS) encoding = new_encoding;
+}
+
+void server_transport_collect(uint32_t now_ms) {
+    // tratando o lote em publicação
+    server_finish_batch();
+}
+
+void server_transport_send(uint32_t now_ms) {
+    // sem conexão: o gerenciador inicia ou agenda a tentativa (com o Wi-Fi no ar); o laço principal segue sem esperar
+    if (!mqtt_transport_is_connected()) {
+        if (wifi_is_connected()) connection_request(&connection);
+        return;
+    }
+
+    // próximo lote da fila
+    if (batch_count == 0) {
+        batch_count = queue_next_batch(batch, server_batch_max_samples());
+        batch_next = 0;
+        channel_next = 0;
+        batch_outstanding = 0;
+        batch_failed = false;
+    }
+
+    server_publish_batch();
+}
+
+ConnectionState server_connection_state() {
+    return connection_state(&connection);
+}
+
+uint32_t server_connection_retry_in_ms() {
+    return connection_retry_in_ms(&connection);
+}
+
+const Upstream *server_upstream() {
+    return &upstream;
+}
+
+void server_disconnect() {
+    hal_lwip_begin();
+    connection_release(&connection);
+    server_abort();
+    hal_lwip_end();
+}
+
+uint32_t server_bytes_per_sample() {
+    if (server_samples_acked() == 0) return 0;
+
+    MqttTransportStats stats;
+    mqtt_transport_get_stats(&stats);
+    return stats.bytes_sent / server_samples_acked();
+}
+
+#endif
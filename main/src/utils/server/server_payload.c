@@ -0,0 +1,95 @@
+// inclusions libraries
+#include "server_payload.h"
+#include "format.h"
+#include "cbor.h"
+#include "prof.h"
+
+// implementation functions
+
+// Acumula o tamanho de um trecho formatado; falha se o trecho não coube
+static bool server_append(int *length, int written) {
+    if (written < 0) return false;
+    *length += written;
+    return true;
+}
+
+// Formata uma amostra como objeto JSON diretamente no buffer; retorna o tamanho ou -1 se não couber
+int server_payload_entry_json(char *buffer, size_t size, const QueueEntry *entry) {
+    PROF_SCOPE(PROF_JSON_FORMAT);
+    int length = 0;
+
+    // cada trecho é escrito logo após o anterior; os números são convertidos sem printf
+    bool fits = server_append(&length, format_str(buffer, size, "{\"seq\":"))
+        && server_append(&length, format_uint(buffer + length, size - length, entry->seq, 0))
+        && server_append(&length, format_str(buffer + length, size - length, ",\"timestamp\":"))
+        && server_append(&length, format_uint(buffer + length, size - length, entry->sample.timestamp_s, 0))
+        && server_append(&length, format_str(buffer + length, size - length, ",\"boot\":"))
+        && server_append(&length, format_uint(buffer + length, size - length, entry->sample.boot, 0));
+
+    if (fits && entry->channels & SERVER_CHANNEL_TEMPERATURE) {
+        fits = server_append(&length, format_str(buffer + length, size - length, ",\"temperature\":"))
+            && server_append(&length, format_int(buffer + length, size - length, entry->sample.temperature, 0));
+    }
+    if (fits && entry->channels & SERVER_CHANNEL_HUMIDITY) {
+        fits = server_append(&length, format_str(buffer + length, size - length, ",\"humidity\":"))
+            && server_append(&length, format_int(buffer + length, size - length, entry->sample.humidity, 0));
+    }
+    if (fits && entry->channels & SERVER_CHANNEL_POLLUTION) {
+        fits = server_append(&length, format_str(buffer + length, size - length, ",\"pollutionLevel\":"))
+            && server_append(&length, format_fixed(buffer + length, size - length, entry->sample.pollution_x10, 1, 0));
+    }
+    if (fits) {
+        fits = server_append(&length, format_str(buffer + length, size - length, "}"));
+    }
+    return fits ? length : -1;
+}
+
+// Formata uma amostra como mapa CBOR; retorna o tamanho ou -1 se não couber
+int server_payload_entry_cbor(char *buffer, size_t size, const QueueEntry *entry) {
+    CborWriter writer;
+    cbor_writer_init(&writer, (uint8_t *) buffer, size);
+    cbor_put_sample(&writer, entry->seq, &entry->sample, entry->channels);
+    return writer.overflow ? -1 : (int) writer.length;
+}
+
+// Formata, em uma única passada e direto no buffer de envio, o trecho do array JSON que couber a partir
+// da amostra *next; abre o array na primeira amostra e o fecha quando todas couberem. Retorna o tamanho.
+int server_payload_batch_json(char *buffer, size_t size, const QueueEntry *entries, uint16_t count, uint16_t *next) {
+    int length = 0;
+
+    while (*next < count) {
+        // reserva 1 byte para o ']' final; uma amostra que não cabe é descartada sem mover o tamanho
+        if (length + 2 >= (int) size) break;
+        buffer[length] = *next == 0 ? '[' : ',';
+
+        int item_length = server_payload_entry_json(buffer + length + 1, size - length - 2, &entries[*next]);
+        if (item_length < 0) break;
+
+        length += 1 + item_length;
+        (*next)++;
+    }
+
+    if (*next == count) buffer[length++] = ']';
+    return length;
+}
+
+// Mesmo que server_payload_batch_json, em CBOR: o array tem tamanho definido (count), então o
+// cabeçalho vai no primeiro trecho e nada precisa ser escrito ao final
+int server_payload_batch_cbor(char *buffer, size_t size, const QueueEntry *entries, uint16_t count, uint16_t *next) {
+    CborWriter writer;
+    cbor_writer_init(&writer, (uint8_t *) buffer, size);
+
+    if (*next == 0) cbor_put_array(&writer, count);
+
+    while (*next < count && !writer.overflow) {
+        // uma amostra que não cabe é descartada sem mover o tamanho
+        size_t length = writer.length;
+        cbor_put_sample(&writer, entries[*next].seq, &entries[*next].sample, entries[*next].channels);
+        if (writer.overflow) {
+            writer.length = length;
+            break;
+        }
+        (*next)++;
+    }
+    return writer.length;
+}
@@ -0,0 +1,32 @@
+#ifndef SERVER_PAYLOAD_H
+#define SERVER_PAYLOAD_H
+
+// inclusão de bibliotecas
+#include <stddef.h>
+#include "server.h"
+
+/**
+ * @file server_payload.h
+ *
+ * @brief Serialização das amostras da fila (JSON ou CBOR), comum aos transportes HTTP e MQTT.
+ *
+ * @note Tudo é escrito direto no buffer do chamador, sem printf. Os formatadores de lote escrevem o
+ * trecho que couber a partir da amostra *next e avançam *next, para que um lote maior que o buffer
+ * possa ser enviado em pedaços.
+ */
+
+// formata o trecho do lote que couber no buffer a partir da amostra *next; retorna o tamanho
+typedef int (*server_payload_batch_fn)(char *buffer, size_t size, const QueueEntry *entries, uint16_t count, uint16_t *next);
+
+// definitions functions
+
+// uma amostra como objeto JSON; retorna o tamanho ou -1 se não couber
+int server_payload_entry_json(char *buffer, size_t size, const QueueEntry *entry);
+// uma amostra como mapa CBOR; retorna o tamanho ou -1 se não couber
+int server_payload_entry_cbor(char *buffer, size_t size, const QueueEntry *entry);
+// trecho de um lote como array JSON
+int server_payload_batch_json(char *buffer, size_t size, const QueueEntry *entries, uint16_t count, uint16_t *next);
+// trecho de um lote como array CBOR de tamanho definido
+int server_payload_batch_cbor(char *buffer, size_t size, const QueueEntry *entries, uint16_t count, uint16_t *next);
+
+#endif
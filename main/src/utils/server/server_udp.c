@@ -0,0 +1,224 @@
+// inclusions libraries
+#include "server.h"
+#include "server_common.h"
+#include "server_udp.h"
+#include "datagram.h"
+#include "lwip/udp.h"
+#include "wifi.h"
+#include "log.h"
+#include "sched.h"
+#include "hal.h"
+
+// transporte UDP: cada lote da fila vira um datagrama com a sequência de cada amostra
+#if SERVER_USE_UDP
+
+// socket e destino
+static struct udp_pcb *udp_pcb = NULL;
+static ip_addr_t receiver_address;
+
+// receptores (resolvidos por DNS; com confirmação, o timeout troca de receptor)
+static const char *const hosts[] = {SERVER_HOSTS};
+static Upstream upstream;
+
+// datagramas enviados por chamada de server_process_queue, para não esgotar os pbufs no backfill
+// (o heap do lwIP é dimensionado para esta rajada em lwipopts.h)
+#define SERVER_UDP_BURST 4
+
+// sequência do próximo datagrama
+static uint32_t datagram_seq = 1;
+
+// datagramas aguardando confirmação, na ordem dos lotes em voo da fila (só com SERVER_UDP_ACK)
+typedef struct {
+    uint32_t seq;
+    uint32_t sent_ms;
+    uint16_t samples;
+    volatile bool acked;
+} ServerUdpPending;
+
+static ServerUdpPending pending[QUEUE_MAX_IN_FLIGHT];
+static uint8_t pending_count = 0;
+static volatile bool nack_received = false;
+
+static ServerUdpStats stats;
+
+// implementation functions
+
+// Callback de recepção (contexto do lwIP): ACK ou NACK de um datagrama em voo
+static void server_udp_received(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port) {
+    uint8_t buffer[DATAGRAM_HEADER_SIZE];
+    DatagramHeader header;
+
+    if (p->tot_len >= DATAGRAM_HEADER_SIZE) {
+        pbuf_copy_partial(p, buffer, DATAGRAM_HEADER_SIZE, 0);
+
+        if (datagram_read_header(buffer, DATAGRAM_HEADER_SIZE, &header) && header.station_id == SERVER_UDP_STATION_ID) {
+            for (int i = 0; i < pending_count; i++) {
+                if (pending[i].seq != header.seq) continue;
+
+                if (header.type == DATAGRAM_TYPE_ACK) {
+                    pending[i].acked = true;
+                    stats.acks++;
+                    sched_signal(EVENT_NETWORK);
+                } else if (header.type == DATAGRAM_TYPE_NACK) {
+                    nack_received = true;
+                    stats.nacks++;
+                }
+            }
+        }
+    }
+    pbuf_free(p);
+}
+
+// Monta o datagrama direto no pbuf e o envia; retorna a sequência usada ou 0 em caso de falha
+static uint32_t server_send_datagram(const QueueEntry *entries, uint16_t count) {
+    uint16_t length = DATAGRAM_HEADER_SIZE + count * DATAGRAM_RECORD_SIZE;
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, length, PBUF_RAM);
+    if (p == NULL) {
+        stats.send_errors++;
+        return 0;
+    }
+
+    DatagramHeader header = {
+        .type = DATAGRAM_TYPE_DATA,
+        .flags = SERVER_UDP_ACK ? DATAGRAM_FLAG_ACK_REQUEST : 0,
+        .station_id = SERVER_UDP_STATION_ID,
+        .seq = datagram_seq,
+        .count = count,
+    };
+    datagram_write_header(p->payload, &header);
+    for (uint16_t i = 0; i < count; i++) {
+        datagram_write_record(p->payload, i, entries[i].seq, &entries[i].sample, entries[i].channels);
+    }
+
+    err_t err = udp_sendto(udp_pcb, p, &receiver_address, SERVER_UDP_PORT);
+    pbuf_free(p);
+    if (err != ERR_OK) {
+        stats.send_errors++;
+        return 0;
+    }
+
+    stats.datagrams++;
+    stats.bytes_sent += length;
+    return datagram_seq++;
+}
+
+// Confirma na fila os lotes já confirmados pelo receptor (em ordem) e devolve os demais em caso de
+// NACK ou de timeout do mais antigo
+static void server_handle_acks(uint32_t now_ms) {
+    while (pending_count > 0 && pending[0].acked) {
+        upstream_succeeded(&upstream);
+        queue_ack();
+        server_samples_delivered(pending[0].samples);
+        for (int i = 0; i + 1 < pending_count; i++) {
+            pending[i].seq = pending[i + 1].seq;
+            pending[i].sent_ms = pending[i + 1].sent_ms;
+            pending[i].samples = pending[i + 1].samples;
+            pending[i].acked = pending[i + 1].acked;
+        }
+        pending_count--;
+    }
+
+    bool timed_out = pending_count > 0 && now_ms - pending[0].sent_ms >= SERVER_UDP_ACK_TIMEOUT_MS;
+    if (timed_out) {
+        stats.timeouts++;
+        upstream_failed(&upstream);
+    }
+
+    if (pending_count > 0 && (nack_received || timed_out)) {
+        // go-back-N: os lotes em voo voltam para a fila e são reenviados em novos datagramas
+        queue_nack();
+        pending_count = 0;
+    }
+    nack_received = false;
+}
+
+void server_init() {
+    hal_lwip_begin();
+    upstream_init(&upstream, hosts, sizeof(hosts) / sizeof(hosts[0]));
+    udp_pcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+    if (udp_pcb != NULL) {
+        // porta local qualquer; as respostas (ACK/NACK) voltam para ela
+        udp_bind(udp_pcb, IP_ANY_TYPE, 0);
+        udp_recv(udp_pcb, server_udp_received, NULL);
+    } else {
+        LOG_ERROR("UDP: falha ao criar pcb\n");
+    }
+    hal_lwip_end();
+}
+
+void server_set_encoding(ServerEncoding new_encoding) {
+    // o datagrama tem formato binário próprio (datagram.h): o formato do corpo não se aplica
+}
+
+void server_transport_collect(uint32_t now_ms) {
+    if (SERVER_UDP_ACK) server_handle_acks(now_ms);
+}
+
+void server_transport_send(uint32_t now_ms) {
+    if (udp_pcb == NULL || !wifi_is_connected()) return;
+
+    // endereço do receptor em cache; sem ele, a consulta DNS segue e o envio fica para o próximo ciclo
+    if (upstream_resolve(&upstream, &receiver_address, NULL) != UPSTREAM_READY) return;
+
+    uint16_t max_samples = server_batch_max_samples();
+    if (max_samples > DATAGRAM_MAX_RECORDS) max_samples = DATAGRAM_MAX_RECORDS;
+
+    // sem confirmação, até SERVER_UDP_BURST datagramas por ciclo; com confirmação, até QUEUE_MAX_IN_FLIGHT em voo
+    for (int sent = 0; sent < SERVER_UDP_BURST && queue_in_flight() < QUEUE_MAX_IN_FLIGHT; sent++) {
+        static QueueEntry entries[QUEUE_BATCH_SIZE];
+        uint16_t count = queue_next_batch(entries, max_samples);
+        if (count == 0) break;
+
+        uint32_t seq = server_send_datagram(entries, count);
+        if (seq == 0) {
+            // sem rota ou sem memória: o lote volta para a fila e é tentado no próximo ciclo
+            queue_nack();
+            pending_count = 0;
+            break;
+        }
+
+        if (!SERVER_UDP_ACK) {
+            queue_ack();
+            server_samples_delivered(count);
+            continue;
+        }
+
+        pending[pending_count].seq = seq;
+        pending[pending_count].sent_ms = now_ms;
+        pending[pending_count].samples = count;
+        pending[pending_count].acked = false;
+        pending_count++;
+    }
+}
+
+ConnectionState server_connection_state() {
+    return CONNECTION_IDLE;
+}
+
+uint32_t server_connection_retry_in_ms() {
+    return 0;
+}
+
+const Upstream *server_upstream() {
+    return &upstream;
+}
+
+void server_disconnect() {
+    // sem conexão a fechar: os datagramas ainda sem ACK voltam para a fila agora, em vez de ficarem em
+    // voo (e travarem o envio) até o timeout na próxima janela do rádio
+    hal_lwip_begin();
+    queue_nack();
+    pending_count = 0;
+    nack_received = false;
+    hal_lwip_end();
+}
+
+uint32_t server_bytes_per_sample() {
+    return server_samples_acked() > 0 ? stats.bytes_sent / server_samples_acked() : 0;
+}
+
+void server_udp_get_stats(ServerUdpStats *out) {
+    *out = stats;
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef SERVER_UDP_H
+#define SERVER_UDP_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+
+/**
+ * @file server_udp.h
+ *
+ * @brief Estatísticas do transporte UDP (server_udp.c, compilado com SERVER_USE_UDP).
+ *
+ * @note Cada lote da fila vira um datagrama (ver datagram.h). Sem confirmação, o lote é dado como
+ * entregue assim que o datagrama sai; com SERVER_UDP_ACK, até QUEUE_MAX_IN_FLIGHT datagramas ficam
+ * aguardando ACK e um NACK ou o timeout devolve os lotes em voo para a fila.
+ */
+
+// estatísticas do transporte
+typedef struct {
+    uint32_t datagrams;         // datagramas enviados
+    uint32_t send_errors;       // falhas de envio (sem rota, sem memória)
+    uint32_t acks;              // ACKs recebidos
+    uint32_t nacks;             // NACKs recebidos
+    uint32_t timeouts;          // datagramas sem resposta dentro de SERVER_UDP_ACK_TIMEOUT_MS
+    uint32_t bytes_sent;        // bytes de payload UDP enviados
+} ServerUdpStats;
+
+// definitions functions
+
+// copia as estatísticas do transporte
+void server_udp_get_stats(ServerUdpStats *out);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef FLASH_PORT_H
+#define FLASH_PORT_H
+
+// inclusão de bibliotecas
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file flash_port.h
+ *
+ * @brief Camada de acesso à região de flash reservada para o armazenamento de amostras.
+ *
+ * @note No Pico W a implementação usa hardware_flash sobre a QSPI (flash_port_pico.c). Fora do
+ * dispositivo a mesma interface é atendida por um simulador baseado em arquivo (flash_port_host.c),
+ * que reproduz a semântica de uma NOR flash: o apagamento deixa os bytes em 0xFF e a programação
+ * só consegue levar bits de 1 para 0.
+ */
+
+// granularidade de apagamento e de programação da flash
+#define FLASH_PORT_SECTOR_SIZE 4096
+#define FLASH_PORT_PAGE_SIZE 256
+
+// definição das funções
+
+// prepara a região reservada com o tamanho informado (múltiplo de FLASH_PORT_SECTOR_SIZE)
+bool flash_port_init(uint32_t region_size);
+// lê bytes da região (offset relativo ao início da região)
+void flash_port_read(uint32_t offset, void *dst, size_t len);
+// programa páginas inteiras (offset e len múltiplos de FLASH_PORT_PAGE_SIZE)
+bool flash_port_program(uint32_t offset, const void *src, size_t len);
+// apaga um setor inteiro (offset múltiplo de FLASH_PORT_SECTOR_SIZE)
+bool flash_port_erase(uint32_t offset);
+// relógio em microssegundos usado para medir as operações
+uint64_t flash_port_time_us(void);
+
+#endif
@@ -0,0 +1,92 @@
+#include "flash_port.h"
+
+#if !PICO_ON_DEVICE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// arquivo que guarda o conteúdo da flash simulada (pode ser trocado pela variável de ambiente STATION_FLASH_SIM)
+#define FLASH_PORT_SIM_PATH "flash_sim.bin"
+
+static FILE *sim_file = NULL;
+static uint32_t region_length = 0;
+
+// implementação das funções
+
+bool flash_port_init(uint32_t region_size) {
+    const char *path = getenv("STATION_FLASH_SIM");
+    if (path == NULL) path = FLASH_PORT_SIM_PATH;
+
+    if (sim_file != NULL) fclose(sim_file);
+    region_length = region_size;
+
+    // reaproveita o conteúdo anterior, como aconteceria após reiniciar a placa
+    sim_file = fopen(path, "r+b");
+    if (sim_file == NULL) {
+        sim_file = fopen(path, "w+b");
+        if (sim_file == NULL) return false;
+    }
+
+    // completa o arquivo com 0xFF (flash apagada) até o tamanho da região
+    fseek(sim_file, 0, SEEK_END);
+    uint32_t size = (uint32_t) ftell(sim_file);
+    uint8_t erased[FLASH_PORT_PAGE_SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    while (size < region_size) {
+        size_t chunk = region_size - size < sizeof(erased) ? region_size - size : sizeof(erased);
+        fwrite(erased, 1, chunk, sim_file);
+        size += chunk;
+    }
+    fflush(sim_file);
+    return true;
+}
+
+void flash_port_read(uint32_t offset, void *dst, size_t len) {
+    fseek(sim_file, offset, SEEK_SET);
+    if (fread(dst, 1, len, sim_file) != len) {
+        memset(dst, 0xFF, len);
+    }
+}
+
+bool flash_port_program(uint32_t offset, const void *src, size_t len) {
+    if (offset % FLASH_PORT_PAGE_SIZE != 0 || len % FLASH_PORT_PAGE_SIZE != 0 || offset + len > region_length) {
+        return false;
+    }
+
+    // como na NOR flash, a programação só zera bits: o resultado é o AND com o conteúdo atual
+    const uint8_t *data = (const uint8_t *) src;
+    uint8_t page[FLASH_PORT_PAGE_SIZE];
+    for (size_t done = 0; done < len; done += FLASH_PORT_PAGE_SIZE) {
+        flash_port_read(offset + done, page, FLASH_PORT_PAGE_SIZE);
+        for (int i = 0; i < FLASH_PORT_PAGE_SIZE; i++) {
+            page[i] &= data[done + i];
+        }
+        fseek(sim_file, offset + done, SEEK_SET);
+        fwrite(page, 1, FLASH_PORT_PAGE_SIZE, sim_file);
+    }
+    fflush(sim_file);
+    return true;
+}
+
+bool flash_port_erase(uint32_t offset) {
+    if (offset % FLASH_PORT_SECTOR_SIZE != 0 || offset + FLASH_PORT_SECTOR_SIZE > region_length) {
+        return false;
+    }
+
+    uint8_t erased[FLASH_PORT_SECTOR_SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    fseek(sim_file, offset, SEEK_SET);
+    fwrite(erased, 1, sizeof(erased), sim_file);
+    fflush(sim_file);
+    return true;
+}
+
+uint64_t flash_port_time_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000u + now.tv_nsec / 1000;
+}
+
+#endif
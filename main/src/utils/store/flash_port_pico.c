@@ -0,0 +1,67 @@
+#include "flash_port.h"
+
+#if PICO_ON_DEVICE
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+
+// a região reservada fica no final da flash, longe do binário da aplicação
+static uint32_t region_base = 0;
+static uint32_t region_length = 0;
+
+// parâmetros repassados às operações executadas com a XIP desabilitada
+typedef struct {
+    uint32_t offset;
+    const uint8_t *data;
+    size_t len;
+} FlashPortOperation;
+
+// callbacks executados por flash_safe_execute (interrupções e o outro núcleo ficam pausados)
+static void flash_port_do_erase(void *param) {
+    FlashPortOperation *op = (FlashPortOperation *) param;
+    flash_range_erase(op->offset, FLASH_PORT_SECTOR_SIZE);
+}
+
+static void flash_port_do_program(void *param) {
+    FlashPortOperation *op = (FlashPortOperation *) param;
+    flash_range_program(op->offset, op->data, op->len);
+}
+
+// implementação das funções
+
+bool flash_port_init(uint32_t region_size) {
+    if (region_size == 0 || region_size % FLASH_SECTOR_SIZE != 0 || region_size > PICO_FLASH_SIZE_BYTES) {
+        return false;
+    }
+
+    region_base = PICO_FLASH_SIZE_BYTES - region_size;
+    region_length = region_size;
+    return true;
+}
+
+void flash_port_read(uint32_t offset, void *dst, size_t len) {
+    // a flash é mapeada na memória pela XIP, então a leitura é um memcpy
+    memcpy(dst, (const void *) (XIP_BASE + region_base + offset), len);
+}
+
+bool flash_port_program(uint32_t offset, const void *src, size_t len) {
+    if (offset + len > region_length) return false;
+
+    FlashPortOperation op = { .offset = region_base + offset, .data = src, .len = len };
+    return flash_safe_execute(flash_port_do_program, &op, UINT32_MAX) == PICO_OK;
+}
+
+bool flash_port_erase(uint32_t offset) {
+    if (offset + FLASH_PORT_SECTOR_SIZE > region_length) return false;
+
+    FlashPortOperation op = { .offset = region_base + offset };
+    return flash_safe_execute(flash_port_do_erase, &op, UINT32_MAX) == PICO_OK;
+}
+
+uint64_t flash_port_time_us(void) {
+    return time_us_64();
+}
+
+#endif
@@ -0,0 +1,377 @@
+#include "store.h"
+#include <string.h>
+
+// identificação dos cabeçalhos e tipos de registro
+#define STORE_SEGMENT_MAGIC 0x4753474Cu     // "LGSG"
+#define STORE_RECORD_DATA 0xA5
+#define STORE_RECORD_ACK 0xAC
+#define STORE_RECORD_BOOT 0xB0
+#define STORE_RECORD_FREE 0xFF              // byte apagado: fim dos registros do segmento
+
+// cabeçalho gravado no início de cada segmento
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;           // sequência do segmento (cresce a cada segmento aberto)
+    uint32_t erase_count;   // quantas vezes o setor já foi apagado
+    uint32_t first_seq;     // sequência do primeiro registro de dados do segmento
+    uint32_t acked_seq;     // última confirmação conhecida quando o segmento foi aberto
+    uint32_t crc;           // CRC dos campos anteriores
+} StoreSegmentHeader;
+
+// cabeçalho de cada registro (o payload segue logo após, alinhado em 4 bytes)
+typedef struct {
+    uint8_t type;
+    uint8_t len;
+    uint16_t crc;           // CRC-16 da sequência e do payload
+    uint32_t seq;           // sequência do dado (sequência confirmada nos registros de ack, boot nos de boot)
+} StoreRecordHeader;
+
+#define STORE_FIRST_RECORD_OFFSET sizeof(StoreSegmentHeader)
+#define STORE_ALIGN4(value) (((value) + 3u) & ~3u)
+
+// estado em RAM do log (montado a partir da flash)
+static uint32_t segment_seq[STORE_SEGMENT_COUNT];       // 0 = segmento livre/inválido
+static uint32_t segment_first_seq[STORE_SEGMENT_COUNT];
+static uint32_t segment_erases[STORE_SEGMENT_COUNT];
+static uint16_t head_segment = 0;       // segmento em escrita
+static uint32_t head_offset = 0;        // próxima posição livre no segmento em escrita
+static uint32_t last_segment_seq = 0;   // sequência do segmento mais recente
+static uint32_t next_seq = 1;           // sequência do próximo registro de dados
+static uint32_t acked_seq = 0;          // última sequência confirmada
+static uint32_t boot_id = 0;            // boot atual (0 = ainda não montado)
+static bool mounted = false;
+static StoreStats stats;
+
+// página usada para montar as gravações (a flash só aceita páginas inteiras)
+static uint8_t page_buffer[FLASH_PORT_PAGE_SIZE];
+
+// CRC-16/CCITT (bit a bit, sem tabela, para economizar flash)
+static uint16_t crc16_update(uint16_t crc, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t) data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint32_t segment_header_crc(const StoreSegmentHeader *header) {
+    uint16_t crc = crc16_update(0xFFFF, (const uint8_t *) header, offsetof(StoreSegmentHeader, crc));
+    return 0x5A5A0000u | crc;
+}
+
+static uint16_t record_crc(uint32_t seq, const uint8_t *payload, uint8_t len) {
+    uint16_t crc = crc16_update(0xFFFF, (const uint8_t *) &seq, sizeof(seq));
+    return crc16_update(crc, payload, len);
+}
+
+static uint32_t segment_address(uint16_t segment) {
+    return (uint32_t) segment * STORE_SEGMENT_SIZE;
+}
+
+// grava bytes em qualquer posição ainda apagada: as páginas afetadas são programadas com 0xFF
+// fora do trecho desejado, o que não altera o conteúdo já gravado na NOR flash
+static bool store_program(uint32_t address, const void *data, size_t len) {
+    const uint8_t *bytes = (const uint8_t *) data;
+    uint64_t start = flash_port_time_us();
+
+    while (len > 0) {
+        uint32_t page = address & ~(uint32_t) (FLASH_PORT_PAGE_SIZE - 1);
+        uint32_t in_page = address - page;
+        size_t chunk = FLASH_PORT_PAGE_SIZE - in_page;
+        if (chunk > len) chunk = len;
+
+        memset(page_buffer, 0xFF, sizeof(page_buffer));
+        memcpy(page_buffer + in_page, bytes, chunk);
+        if (!flash_port_program(page, page_buffer, FLASH_PORT_PAGE_SIZE)) return false;
+
+        address += chunk;
+        bytes += chunk;
+        len -= chunk;
+        stats.bytes_written += chunk;
+    }
+
+    stats.write_us += flash_port_time_us() - start;
+    return true;
+}
+
+static bool store_write_record(uint8_t type, uint32_t seq, const uint8_t *payload, uint8_t len);
+
+// atualiza o menor e o maior contador de apagamentos
+static void store_update_wear(void) {
+    stats.min_erase_count = UINT32_MAX;
+    stats.max_erase_count = 0;
+    for (int segment = 0; segment < STORE_SEGMENT_COUNT; segment++) {
+        if (segment_erases[segment] < stats.min_erase_count) stats.min_erase_count = segment_erases[segment];
+        if (segment_erases[segment] > stats.max_erase_count) stats.max_erase_count = segment_erases[segment];
+    }
+}
+
+// apaga o próximo segmento do rodízio e o torna o segmento em escrita
+static bool store_open_segment(uint16_t segment) {
+    // ao reciclar um segmento com dados não confirmados, esses dados são perdidos: o log passa a
+    // começar no próximo segmento válido do rodízio (um segmento inválido no caminho já estava perdido)
+    if (segment_seq[segment] != 0) {
+        uint16_t following = (segment + 1) % STORE_SEGMENT_COUNT;
+        while (following != segment && segment_seq[following] == 0) following = (following + 1) % STORE_SEGMENT_COUNT;
+        uint32_t reclaimed_until = following != segment
+            ? segment_first_seq[following] - 1
+            : next_seq - 1;
+        if (reclaimed_until > acked_seq) {
+            stats.dropped += reclaimed_until - acked_seq;
+            acked_seq = reclaimed_until;
+        }
+    }
+
+    if (!flash_port_erase(segment_address(segment))) return false;
+    segment_erases[segment]++;
+    stats.erases++;
+
+    StoreSegmentHeader header = {
+        .magic = STORE_SEGMENT_MAGIC,
+        .seq = last_segment_seq + 1,
+        .erase_count = segment_erases[segment],
+        .first_seq = next_seq,
+        .acked_seq = acked_seq,
+    };
+    header.crc = segment_header_crc(&header);
+    if (!store_program(segment_address(segment), &header, sizeof(header))) return false;
+
+    last_segment_seq = header.seq;
+    segment_seq[segment] = header.seq;
+    segment_first_seq[segment] = header.first_seq;
+    head_segment = segment;
+    head_offset = STORE_FIRST_RECORD_OFFSET;
+    store_update_wear();
+
+    // todo segmento começa com o boot atual, para que o segmento em escrita sempre o tenha na montagem
+    return boot_id == 0 || store_write_record(STORE_RECORD_BOOT, boot_id, NULL, 0);
+}
+
+// lê e valida um registro; retorna o tamanho ocupado no segmento (0 = fim ou registro inválido)
+static uint32_t store_read_record(uint16_t segment, uint32_t offset, StoreRecordHeader *header, uint8_t *payload) {
+    if (offset + sizeof(StoreRecordHeader) > STORE_SEGMENT_SIZE) return 0;
+
+    flash_port_read(segment_address(segment) + offset, header, sizeof(StoreRecordHeader));
+    if (header->type == STORE_RECORD_FREE) return 0;
+
+    uint32_t size = STORE_ALIGN4(sizeof(StoreRecordHeader) + header->len);
+    bool valid = (header->type == STORE_RECORD_DATA || header->type == STORE_RECORD_ACK || header->type == STORE_RECORD_BOOT)
+              && header->len <= STORE_MAX_PAYLOAD
+              && offset + size <= STORE_SEGMENT_SIZE;
+    if (valid) {
+        flash_port_read(segment_address(segment) + offset + sizeof(StoreRecordHeader), payload, header->len);
+        valid = record_crc(header->seq, payload, header->len) == header->crc;
+    }
+    if (!valid) {
+        stats.corrupted++;
+        return 0;
+    }
+
+    return size;
+}
+
+// indica se o trecho está todo apagado (0xFF)
+static bool store_erased(uint32_t address, uint32_t len) {
+    while (len > 0) {
+        uint32_t chunk = len < sizeof(page_buffer) ? len : sizeof(page_buffer);
+        flash_port_read(address, page_buffer, chunk);
+        for (uint32_t i = 0; i < chunk; i++) {
+            if (page_buffer[i] != 0xFF) return false;
+        }
+        address += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+// grava um registro no segmento em escrita, abrindo o próximo segmento se não houver espaço
+static bool store_write_record(uint8_t type, uint32_t seq, const uint8_t *payload, uint8_t len) {
+    uint32_t size = STORE_ALIGN4(sizeof(StoreRecordHeader) + len);
+    if (head_offset + size > STORE_SEGMENT_SIZE) {
+        if (!store_open_segment((head_segment + 1) % STORE_SEGMENT_COUNT)) return false;
+    }
+
+    StoreRecordHeader header = {
+        .type = type,
+        .len = len,
+        .crc = record_crc(seq, payload, len),
+        .seq = seq,
+    };
+
+    // payload primeiro e cabeçalho por último: um registro interrompido por falta de energia
+    // fica com o tipo em 0xFF ou com CRC inválido e é ignorado na montagem
+    uint32_t address = segment_address(head_segment) + head_offset;
+    if (len > 0 && !store_program(address + sizeof(header), payload, len)) return false;
+    if (!store_program(address, &header, sizeof(header))) return false;
+
+    head_offset += size;
+    stats.appends++;
+    return true;
+}
+
+// implementação das funções
+
+bool store_mount(void) {
+    uint64_t start = flash_port_time_us();
+    mounted = false;
+    memset(&stats, 0, sizeof(stats));
+
+    if (!flash_port_init(STORE_REGION_SIZE)) return false;
+
+    // varre apenas os cabeçalhos dos segmentos
+    last_segment_seq = 0;
+    acked_seq = 0;
+    next_seq = 1;
+    boot_id = 0;
+    for (uint16_t segment = 0; segment < STORE_SEGMENT_COUNT; segment++) {
+        StoreSegmentHeader header;
+        flash_port_read(segment_address(segment), &header, sizeof(header));
+
+        bool valid = header.magic == STORE_SEGMENT_MAGIC && header.crc == segment_header_crc(&header);
+        segment_seq[segment] = valid ? header.seq : 0;
+        segment_first_seq[segment] = valid ? header.first_seq : 0;
+        segment_erases[segment] = header.magic == STORE_SEGMENT_MAGIC ? header.erase_count : 0;
+        if (!valid) continue;
+
+        if (header.seq > last_segment_seq) {
+            last_segment_seq = header.seq;
+            head_segment = segment;
+        }
+        if (header.acked_seq > acked_seq) acked_seq = header.acked_seq;
+    }
+
+    // região vazia: começa o log no primeiro segmento, no primeiro boot
+    if (last_segment_seq == 0) {
+        boot_id = 1;
+        if (!store_open_segment(0)) return false;
+    } else {
+        // percorre os registros do segmento mais recente para achar o ponto de escrita
+        next_seq = segment_first_seq[head_segment];
+        head_offset = STORE_FIRST_RECORD_OFFSET;
+
+        StoreRecordHeader header;
+        uint8_t payload[STORE_MAX_PAYLOAD];
+        while (true) {
+            uint32_t size = store_read_record(head_segment, head_offset, &header, payload);
+            if (size == 0) break;
+
+            if (header.type == STORE_RECORD_DATA && header.seq >= next_seq) next_seq = header.seq + 1;
+            if (header.type == STORE_RECORD_ACK && header.seq > acked_seq) acked_seq = header.seq;
+            if (header.type == STORE_RECORD_BOOT && header.seq > boot_id) boot_id = header.seq;
+            head_offset += size;
+        }
+
+        // um registro corrompido, ou o payload de um registro interrompido antes do cabeçalho, não pode
+        // ser sobrescrito (a programação só zera bits): com qualquer byte gravado após o último registro
+        // válido o segmento é encerrado
+        if (!store_erased(segment_address(head_segment) + head_offset, STORE_SEGMENT_SIZE - head_offset)) {
+            head_offset = STORE_SEGMENT_SIZE;
+        }
+        store_update_wear();
+
+        // novo boot: gravado no segmento em escrita ou no início do próximo, se ele estiver cheio
+        boot_id++;
+        bool written = head_offset + sizeof(StoreRecordHeader) > STORE_SEGMENT_SIZE
+            ? store_open_segment((head_segment + 1) % STORE_SEGMENT_COUNT)
+            : store_write_record(STORE_RECORD_BOOT, boot_id, NULL, 0);
+        if (!written) return false;
+    }
+
+    if (acked_seq >= next_seq) acked_seq = next_seq - 1;
+    stats.mount_us = flash_port_time_us() - start;
+    mounted = true;
+    return true;
+}
+
+bool store_append(uint32_t seq, const uint8_t *payload, uint8_t len) {
+    if (!mounted || len > STORE_MAX_PAYLOAD || seq < next_seq) return false;
+    if (!store_write_record(STORE_RECORD_DATA, seq, payload, len)) return false;
+    next_seq = seq + 1;
+    return true;
+}
+
+bool store_ack(uint32_t seq) {
+    if (!mounted) return false;
+    if (seq >= next_seq) seq = next_seq - 1;
+    if (seq <= acked_seq) return true;
+
+    if (!store_write_record(STORE_RECORD_ACK, seq, NULL, 0)) return false;
+    acked_seq = seq;
+    return true;
+}
+
+uint32_t store_acked_seq(void) {
+    return acked_seq;
+}
+
+uint32_t store_next_seq(void) {
+    return next_seq;
+}
+
+uint32_t store_boot_id(void) {
+    return boot_id;
+}
+
+uint32_t store_pending(void) {
+    return next_seq - 1 - acked_seq;
+}
+
+void store_cursor_begin(StoreCursor *cursor) {
+    // começa pelo segmento válido mais antigo (menor sequência de segmento)
+    uint32_t oldest = UINT32_MAX;
+    cursor->segment = head_segment;
+    for (uint16_t segment = 0; segment < STORE_SEGMENT_COUNT; segment++) {
+        if (segment_seq[segment] != 0 && segment_seq[segment] < oldest) {
+            oldest = segment_seq[segment];
+            cursor->segment = segment;
+        }
+    }
+
+    // pula segmentos inteiros que já foram confirmados
+    while (cursor->segment != head_segment) {
+        uint16_t following = (cursor->segment + 1) % STORE_SEGMENT_COUNT;
+        if (segment_seq[following] == 0 || segment_first_seq[following] - 1 > acked_seq) break;
+        cursor->segment = following;
+    }
+
+    cursor->offset = STORE_FIRST_RECORD_OFFSET;
+    cursor->done = !mounted;
+}
+
+bool store_read_next(StoreCursor *cursor, uint8_t *payload, uint8_t *len, uint32_t *seq) {
+    StoreRecordHeader header;
+
+    while (!cursor->done) {
+        uint32_t size = 0;
+        bool in_head = cursor->segment == head_segment;
+        if (!in_head || cursor->offset < head_offset) {
+            size = store_read_record(cursor->segment, cursor->offset, &header, payload);
+        }
+
+        // fim do segmento: avança para o próximo do rodízio, até chegar no segmento em escrita
+        if (size == 0) {
+            if (in_head) {
+                cursor->done = true;
+                break;
+            }
+            cursor->segment = (cursor->segment + 1) % STORE_SEGMENT_COUNT;
+            cursor->offset = STORE_FIRST_RECORD_OFFSET;
+            continue;
+        }
+
+        cursor->offset += size;
+        if (header.type == STORE_RECORD_DATA && header.seq > acked_seq) {
+            *len = header.len;
+            *seq = header.seq;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void store_get_stats(StoreStats *out) {
+    *out = stats;
+}
@@ -0,0 +1,75 @@
+#ifndef STORE_H
+#define STORE_H
+
+// inclusão de bibliotecas
+#include <stdint.h>
+#include <stdbool.h>
+#include "flash_port.h"
+
+/**
+ * @file store.h
+ *
+ * @brief Armazenamento de registros em log (append-only) na flash do Pico W.
+ *
+ * @note A região reservada é dividida em segmentos do tamanho de um setor. Cada segmento começa com
+ * um cabeçalho (sequência do segmento, contador de apagamentos, primeira sequência de dados e a última
+ * confirmação conhecida) seguido pelos registros, cada um com sequência e CRC próprios. Os segmentos
+ * são usados em rodízio circular, o que distribui os apagamentos igualmente (wear leveling), e a
+ * montagem lê apenas os cabeçalhos dos segmentos e os registros do segmento mais recente. Cada
+ * montagem grava um registro de boot com o contador de boots, repetido no início de todo segmento
+ * aberto, para que o segmento mais recente sempre tenha o último valor.
+ */
+
+// configuração da região reservada no final da flash
+#define STORE_SEGMENT_SIZE FLASH_PORT_SECTOR_SIZE
+#define STORE_SEGMENT_COUNT 64      // 64 x 4 KB = 256 KB
+#define STORE_REGION_SIZE (STORE_SEGMENT_SIZE * STORE_SEGMENT_COUNT)
+
+// maior payload aceito por registro
+#define STORE_MAX_PAYLOAD 64
+
+// posição de leitura no log, usada para percorrer os registros ainda não confirmados
+typedef struct {
+    uint16_t segment;   // segmento atual
+    uint16_t offset;    // deslocamento dentro do segmento
+    bool done;          // leitura chegou ao fim do log
+} StoreCursor;
+
+// estatísticas para medir desempenho e desgaste
+typedef struct {
+    uint32_t mount_us;          // duração da última montagem
+    uint32_t appends;           // registros gravados desde a montagem
+    uint32_t bytes_written;     // bytes gravados desde a montagem (incluindo cabeçalhos)
+    uint64_t write_us;          // tempo total gasto gravando desde a montagem
+    uint32_t erases;            // apagamentos desde a montagem
+    uint32_t min_erase_count;   // menor contador de apagamentos entre os segmentos
+    uint32_t max_erase_count;   // maior contador de apagamentos entre os segmentos
+    uint32_t dropped;           // registros não confirmados perdidos por falta de espaço
+    uint32_t corrupted;         // registros descartados por CRC inválido
+} StoreStats;
+
+// definição das funções
+
+// monta o log: lê os cabeçalhos dos segmentos e encontra o ponto de escrita (formata a região se necessário)
+bool store_mount(void);
+// grava um novo registro de dados com a sequência informada, que deve ser maior do que a de todos os
+// registros já gravados (uma sequência cuja gravação falhou fica como lacuna no log)
+bool store_append(uint32_t seq, const uint8_t *payload, uint8_t len);
+// confirma (remove logicamente) todos os registros de dados até a sequência informada
+bool store_ack(uint32_t seq);
+// última sequência confirmada
+uint32_t store_acked_seq(void);
+// menor sequência aceita pela próxima gravação
+uint32_t store_next_seq(void);
+// identificador do boot atual, incrementado e gravado no log a cada montagem (começa em 1)
+uint32_t store_boot_id(void);
+// quantidade de registros de dados ainda não confirmados (lacunas de gravações que falharam incluídas)
+uint32_t store_pending(void);
+// posiciona o cursor no registro não confirmado mais antigo
+void store_cursor_begin(StoreCursor *cursor);
+// lê o próximo registro não confirmado; retorna false ao chegar no fim do log
+bool store_read_next(StoreCursor *cursor, uint8_t *payload, uint8_t *len, uint32_t *seq);
+// copia as estatísticas de uso da flash
+void store_get_stats(StoreStats *out);
+
+#endif
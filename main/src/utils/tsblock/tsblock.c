@@ -0,0 +1,237 @@
+#include "tsblock.h"
+#include <string.h>
+
+// capacidade do fluxo de bits de um bloco
+#define TSBLOCK_BITS ((TSBLOCK_SIZE - TSBLOCK_HEADER_SIZE) * 8u)
+
+// faixas de codificação: prefixo (em bits), tamanho do prefixo e bits de payload
+typedef struct {
+    uint8_t prefix;
+    uint8_t prefix_bits;
+    uint8_t payload_bits;
+} TsBlockBucket;
+
+// delta-do-delta dos timestamps: '0' = intervalo constante
+static const TsBlockBucket timestamp_buckets[] = {
+    { 0x2, 2, 7 },      // '10'   + 7 bits
+    { 0x6, 3, 9 },      // '110'  + 9 bits
+    { 0xE, 4, 12 },     // '1110' + 12 bits
+    { 0xF, 4, 32 },     // '1111' + 32 bits
+};
+
+// delta dos canais: '0' = valor repetido
+static const TsBlockBucket value_buckets[] = {
+    { 0x2, 2, 3 },      // '10'   + 3 bits
+    { 0x6, 3, 6 },      // '110'  + 6 bits
+    { 0xE, 4, 10 },     // '1110' + 10 bits
+    { 0xF, 4, 17 },     // '1111' + 17 bits (qualquer diferença entre valores de 16 bits)
+};
+
+#define TSBLOCK_NUM_BUCKETS 4
+
+// zigzag: leva inteiros com sinal pequenos para inteiros sem sinal pequenos
+static uint32_t zigzag_encode(int32_t value) {
+    return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value) {
+    return (int32_t) (value >> 1) ^ -(int32_t) (value & 1);
+}
+
+// escolhe a menor faixa que comporta o valor; retorna o total de bits necessários
+static uint8_t bucket_select(const TsBlockBucket *buckets, uint32_t zigzag, const TsBlockBucket **selected) {
+    *selected = NULL;
+    if (zigzag == 0) return 1;
+
+    for (int i = 0; i < TSBLOCK_NUM_BUCKETS; i++) {
+        if (buckets[i].payload_bits >= 32 || zigzag < (1u << buckets[i].payload_bits)) {
+            *selected = &buckets[i];
+            return buckets[i].prefix_bits + buckets[i].payload_bits;
+        }
+    }
+    return 0;
+}
+
+// escreve bits no fluxo (mais significativo primeiro)
+static void bits_write(uint8_t *stream, uint32_t *bit_pos, uint32_t value, uint8_t bits) {
+    for (int bit = bits - 1; bit >= 0; bit--) {
+        if (value & (1u << bit)) {
+            stream[*bit_pos >> 3] |= 0x80 >> (*bit_pos & 7);
+        }
+        (*bit_pos)++;
+    }
+}
+
+static uint32_t bits_read(const uint8_t *stream, uint32_t *bit_pos, uint8_t bits) {
+    uint32_t value = 0;
+    for (uint8_t bit = 0; bit < bits; bit++) {
+        value = (value << 1) | ((stream[*bit_pos >> 3] >> (7 - (*bit_pos & 7))) & 1);
+        (*bit_pos)++;
+    }
+    return value;
+}
+
+static void bucket_write(uint8_t *stream, uint32_t *bit_pos, const TsBlockBucket *bucket, uint32_t zigzag) {
+    if (bucket == NULL) {
+        bits_write(stream, bit_pos, 0, 1);
+        return;
+    }
+    bits_write(stream, bit_pos, bucket->prefix, bucket->prefix_bits);
+    bits_write(stream, bit_pos, zigzag, bucket->payload_bits);
+}
+
+// lê o prefixo unário ('0', '10', '110', '1110', '1111') e o payload correspondente
+static uint32_t bucket_read(const uint8_t *stream, uint32_t *bit_pos, const TsBlockBucket *buckets) {
+    int ones = 0;
+    while (ones < TSBLOCK_NUM_BUCKETS && bits_read(stream, bit_pos, 1) == 1) {
+        ones++;
+    }
+    if (ones == 0) return 0;
+    return bits_read(stream, bit_pos, buckets[ones - 1].payload_bits);
+}
+
+static void block_set_count(uint8_t *block, uint16_t count) {
+    block[0] = count;
+    block[1] = count >> 8;
+}
+
+// implementação das funções
+
+void tsblock_encoder_init(TsBlockEncoder *encoder, uint8_t *block) {
+    memset(block, 0, TSBLOCK_SIZE);
+    encoder->block = block;
+    encoder->count = 0;
+    encoder->bit_pos = 0;
+    encoder->previous_delta = 0;
+}
+
+bool tsblock_encoder_append(TsBlockEncoder *encoder, const SensorSample *sample) {
+    // a primeira amostra vai completa no cabeçalho
+    if (encoder->count == 0) {
+        sample_pack(sample, encoder->block + 2);
+        encoder->previous = *sample;
+        encoder->count = 1;
+        block_set_count(encoder->block, 1);
+        return true;
+    }
+
+    const SensorSample *previous = &encoder->previous;
+    int32_t delta = (int32_t) (sample->timestamp_s - previous->timestamp_s);
+    uint32_t values[4] = {
+        zigzag_encode(delta - encoder->previous_delta),
+        zigzag_encode((int32_t) sample->temperature - previous->temperature),
+        zigzag_encode((int32_t) sample->humidity - previous->humidity),
+        zigzag_encode((int32_t) sample->pollution_x10 - previous->pollution_x10),
+    };
+
+    // calcula o custo antes de escrever, para nunca deixar uma amostra pela metade no bloco
+    const TsBlockBucket *buckets[4];
+    uint32_t bits = bucket_select(timestamp_buckets, values[0], &buckets[0]);
+    for (int channel = 1; channel < 4; channel++) {
+        bits += bucket_select(value_buckets, values[channel], &buckets[channel]);
+    }
+    if (encoder->bit_pos + bits > TSBLOCK_BITS || encoder->count == UINT16_MAX) return false;
+
+    uint8_t *stream = encoder->block + TSBLOCK_HEADER_SIZE;
+    for (int channel = 0; channel < 4; channel++) {
+        bucket_write(stream, &encoder->bit_pos, buckets[channel], values[channel]);
+    }
+
+    encoder->previous = *sample;
+    encoder->previous_delta = delta;
+    encoder->count++;
+    block_set_count(encoder->block, encoder->count);
+    return true;
+}
+
+uint16_t tsblock_encoder_size(const TsBlockEncoder *encoder) {
+    return TSBLOCK_HEADER_SIZE + (encoder->bit_pos + 7) / 8;
+}
+
+void tsblock_decoder_init(TsBlockDecoder *decoder, const uint8_t *block) {
+    decoder->block = block;
+    decoder->count = tsblock_count(block);
+    decoder->index = 0;
+    decoder->bit_pos = 0;
+    decoder->previous_delta = 0;
+}
+
+bool tsblock_decoder_next(TsBlockDecoder *decoder, SensorSample *sample) {
+    if (decoder->index >= decoder->count) return false;
+
+    if (decoder->index == 0) {
+        sample_unpack(&decoder->previous, decoder->block + 2);
+    } else {
+        const uint8_t *stream = decoder->block + TSBLOCK_HEADER_SIZE;
+        SensorSample *previous = &decoder->previous;
+
+        int32_t delta = decoder->previous_delta + zigzag_decode(bucket_read(stream, &decoder->bit_pos, timestamp_buckets));
+        previous->timestamp_s += delta;
+        previous->temperature += zigzag_decode(bucket_read(stream, &decoder->bit_pos, value_buckets));
+        previous->humidity += zigzag_decode(bucket_read(stream, &decoder->bit_pos, value_buckets));
+        previous->pollution_x10 += zigzag_decode(bucket_read(stream, &decoder->bit_pos, value_buckets));
+        decoder->previous_delta = delta;
+    }
+
+    *sample = decoder->previous;
+    decoder->index++;
+    return true;
+}
+
+uint16_t tsblock_count(const uint8_t *block) {
+    return (uint16_t) (block[0] | (block[1] << 8));
+}
+
+uint32_t tsblock_first_timestamp(const uint8_t *block) {
+    SensorSample first;
+    sample_unpack(&first, block + 2);
+    return first.timestamp_s;
+}
+
+// histórico comprimido em RAM: buffer circular de blocos
+static uint8_t ring_blocks[TSBLOCK_RING_BLOCKS][TSBLOCK_SIZE];
+static uint16_t ring_head = 0;      // bloco em preenchimento
+static uint16_t ring_blocks_used = 0;
+static TsBlockEncoder ring_encoder;
+
+void tsblock_ring_init(void) {
+    ring_head = 0;
+    ring_blocks_used = 0;
+}
+
+void tsblock_ring_append(const SensorSample *sample) {
+    if (ring_blocks_used > 0 && tsblock_encoder_append(&ring_encoder, sample)) return;
+
+    // bloco atual cheio (ou histórico vazio): passa para o próximo, reciclando o mais antigo
+    if (ring_blocks_used > 0) ring_head = (ring_head + 1) % TSBLOCK_RING_BLOCKS;
+    if (ring_blocks_used < TSBLOCK_RING_BLOCKS) ring_blocks_used++;
+
+    tsblock_encoder_init(&ring_encoder, ring_blocks[ring_head]);
+    tsblock_encoder_append(&ring_encoder, sample);
+}
+
+uint16_t tsblock_ring_count(void) {
+    return ring_blocks_used;
+}
+
+const uint8_t *tsblock_ring_get(uint16_t index) {
+    if (index >= ring_blocks_used) return NULL;
+    uint16_t oldest = (ring_head + TSBLOCK_RING_BLOCKS + 1 - ring_blocks_used) % TSBLOCK_RING_BLOCKS;
+    return ring_blocks[(oldest + index) % TSBLOCK_RING_BLOCKS];
+}
+
+uint16_t tsblock_ring_find(uint32_t timestamp_s) {
+    uint16_t low = 0;
+    uint16_t high = ring_blocks_used;
+
+    // último bloco cujo início é menor ou igual ao timestamp procurado
+    while (high - low > 1) {
+        uint16_t middle = (low + high) / 2;
+        if (tsblock_first_timestamp(tsblock_ring_get(middle)) <= timestamp_s) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
@@ -0,0 +1,77 @@
+#ifndef TSBLOCK_H
+#define TSBLOCK_H
+
+// inclusão de bibliotecas
+#include <stdint.h>
+#include <stdbool.h>
+#include "sample.h"
+
+/**
+ * @file tsblock.h
+ *
+ * @brief Compressão de séries temporais em blocos de tamanho fixo (no estilo do Gorilla).
+ *
+ * @note Cada bloco guarda a primeira amostra completa e, em seguida, um fluxo de bits com o
+ * delta-do-delta dos timestamps e o delta de cada canal, codificados com prefixos de tamanho
+ * variável (um único bit quando nada mudou). Os blocos são independentes: qualquer bloco pode
+ * ser decodificado sozinho ou enviado como está.
+ */
+
+// tamanho de cada bloco em bytes
+#define TSBLOCK_SIZE 256
+
+// quantidade de blocos mantidos no histórico em RAM
+#define TSBLOCK_RING_BLOCKS 16
+
+// cabeçalho do bloco: quantidade de amostras (2 bytes) + primeira amostra compactada
+#define TSBLOCK_HEADER_SIZE (2 + SAMPLE_PACKED_SIZE)
+
+// codificador incremental de um bloco
+typedef struct {
+    uint8_t *block;             // bloco sendo preenchido
+    uint16_t count;             // amostras no bloco
+    uint32_t bit_pos;           // próxima posição livre no fluxo de bits
+    SensorSample previous;      // última amostra codificada
+    int32_t previous_delta;     // último delta de timestamp
+} TsBlockEncoder;
+
+// decodificador incremental de um bloco
+typedef struct {
+    const uint8_t *block;
+    uint16_t count;             // amostras no bloco
+    uint16_t index;             // próxima amostra a decodificar
+    uint32_t bit_pos;
+    SensorSample previous;
+    int32_t previous_delta;
+} TsBlockDecoder;
+
+// definição das funções
+
+// inicia a codificação em um bloco vazio
+void tsblock_encoder_init(TsBlockEncoder *encoder, uint8_t *block);
+// adiciona uma amostra ao bloco; retorna false se o bloco está cheio (a amostra não é gravada)
+bool tsblock_encoder_append(TsBlockEncoder *encoder, const SensorSample *sample);
+// quantidade de bytes usados do bloco
+uint16_t tsblock_encoder_size(const TsBlockEncoder *encoder);
+
+// inicia a leitura de um bloco
+void tsblock_decoder_init(TsBlockDecoder *decoder, const uint8_t *block);
+// decodifica a próxima amostra; retorna false ao fim do bloco
+bool tsblock_decoder_next(TsBlockDecoder *decoder, SensorSample *sample);
+// quantidade de amostras de um bloco
+uint16_t tsblock_count(const uint8_t *block);
+// timestamp da primeira amostra de um bloco
+uint32_t tsblock_first_timestamp(const uint8_t *block);
+
+// limpa o histórico comprimido em RAM
+void tsblock_ring_init(void);
+// adiciona uma amostra ao histórico (o bloco mais antigo é reciclado quando o histórico enche)
+void tsblock_ring_append(const SensorSample *sample);
+// quantidade de blocos no histórico (inclusive o bloco em preenchimento)
+uint16_t tsblock_ring_count(void);
+// bloco do histórico por idade (0 = mais antigo)
+const uint8_t *tsblock_ring_get(uint16_t index);
+// índice do bloco que contém o timestamp informado (busca binária pelo início dos blocos)
+uint16_t tsblock_ring_find(uint32_t timestamp_s);
+
+#endif
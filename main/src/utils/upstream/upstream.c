@@ -0,0 +1,158 @@
+#include "upstream.h"
+#include <stdio.h>
+#include <string.h>
+#include "lwip/dns.h"
+#include "log.h"
+
+// implementação das funções
+
+static uint32_t upstream_now_ms(void) {
+    return hal_time_ms();
+}
+
+// Indica se o servidor pode ser usado (nunca saiu de uso ou o tempo fora já passou)
+static bool upstream_available(const UpstreamHost *host, uint32_t now_ms) {
+    return host->down_until_ms == 0 || (int32_t) (now_ms - host->down_until_ms) >= 0;
+}
+
+// Escolhe o servidor em uso: o primeiro disponível na ordem da lista ou, com todos fora de uso,
+// o que volta primeiro
+static void upstream_select(Upstream *upstream) {
+    uint32_t now = upstream_now_ms();
+    uint8_t chosen = 0;
+
+    while (chosen < upstream->count && !upstream_available(&upstream->hosts[chosen], now)) chosen++;
+    if (chosen == upstream->count) {
+        chosen = 0;
+        for (uint8_t i = 1; i < upstream->count; i++) {
+            if ((int32_t) (upstream->hosts[i].down_until_ms - upstream->hosts[chosen].down_until_ms) < 0) chosen = i;
+        }
+    }
+
+    if (chosen != upstream->current) {
+        LOG_INFO("Servidor: trocando %s por %s\n", upstream->hosts[upstream->current].host, upstream->hosts[chosen].host);
+        upstream->current = chosen;
+        upstream->ready = NULL;
+        upstream->stats.failovers++;
+    }
+}
+
+// Callback do DNS do lwIP: guarda o endereço e avisa quem espera pelo servidor em uso
+static void upstream_dns_found(const char *name, const ip_addr_t *ipaddr, void *arg) {
+    Upstream *upstream = arg;
+
+    for (uint8_t i = 0; i < upstream->count; i++) {
+        UpstreamHost *host = &upstream->hosts[i];
+        if (!host->resolving || strcmp(host->host, name) != 0) continue;
+
+        host->resolving = false;
+        if (ipaddr != NULL) {
+            host->address = *ipaddr;
+            host->has_address = true;
+            host->resolved_ms = upstream_now_ms();
+        } else {
+            // renovação sem resposta: o endereço anterior continua em uso
+            upstream->stats.dns_failures++;
+            LOG_WARN("DNS: falha ao resolver %s\n", host->host);
+        }
+
+        if (i != upstream->current || upstream->ready == NULL) continue;
+        upstream_ready_fn ready = upstream->ready;
+        upstream->ready = NULL;
+        if (ipaddr == NULL) upstream_failed(upstream);
+        ready(ipaddr != NULL ? &host->address : NULL);
+    }
+}
+
+void upstream_init(Upstream *upstream, const char *const *hosts, uint8_t count) {
+    memset(upstream, 0, sizeof(*upstream));
+    upstream->count = count < UPSTREAM_MAX_HOSTS ? count : UPSTREAM_MAX_HOSTS;
+
+    for (uint8_t i = 0; i < upstream->count; i++) {
+        UpstreamHost *host = &upstream->hosts[i];
+        host->host = hosts[i];
+        // IP em texto: endereço fixo, sem DNS
+        host->literal = ipaddr_aton(hosts[i], &host->address);
+        host->has_address = host->literal;
+    }
+}
+
+UpstreamResult upstream_resolve(Upstream *upstream, ip_addr_t *address, upstream_ready_fn ready) {
+    if (upstream->count == 0) return UPSTREAM_ERROR;
+
+    upstream_select(upstream);
+    UpstreamHost *host = &upstream->hosts[upstream->current];
+    uint32_t now = upstream_now_ms();
+    upstream->ready = NULL;
+
+    if (host->literal) {
+        *address = host->address;
+        return UPSTREAM_READY;
+    }
+
+    // primeira resolução ou renovação: o lwIP responde na hora enquanto o registro em sua tabela
+    // estiver dentro do TTL; caso contrário a consulta segue em segundo plano
+    if (!host->resolving && (!host->has_address || now - host->resolved_ms >= UPSTREAM_REFRESH_MS)) {
+        ip_addr_t resolved;
+        upstream->stats.lookups++;
+        err_t err = dns_gethostbyname(host->host, &resolved, upstream_dns_found, upstream);
+
+        if (err == ERR_OK) {
+            host->address = resolved;
+            host->has_address = true;
+            host->resolved_ms = now;
+        } else if (err == ERR_INPROGRESS) {
+            host->resolving = true;
+        } else if (!host->has_address) {
+            LOG_WARN("DNS: erro ao consultar %s (%d)\n", host->host, err);
+            upstream->stats.dns_failures++;
+            upstream_failed(upstream);
+            return UPSTREAM_ERROR;
+        }
+    }
+
+    if (host->has_address) {
+        upstream->stats.cache_hits++;
+        *address = host->address;
+        return UPSTREAM_READY;
+    }
+
+    upstream->ready = ready;
+    return UPSTREAM_PENDING;
+}
+
+void upstream_abort(Upstream *upstream) {
+    if (upstream->ready == NULL) return;
+
+    // a resposta que ainda chegar só atualiza o cache
+    upstream->ready = NULL;
+    upstream_failed(upstream);
+}
+
+void upstream_succeeded(Upstream *upstream) {
+    UpstreamHost *host = &upstream->hosts[upstream->current];
+    host->failures = 0;
+    host->down_until_ms = 0;
+}
+
+void upstream_failed(Upstream *upstream) {
+    if (upstream->count == 0) return;
+
+    UpstreamHost *host = &upstream->hosts[upstream->current];
+    if (host->failures < UINT8_MAX) host->failures++;
+    if (host->failures < UPSTREAM_FAILOVER_THRESHOLD) return;
+
+    host->down_until_ms = (upstream_now_ms() + UPSTREAM_HOLD_DOWN_MS) | 1;    // 0 é reservado para "disponível"
+    if (upstream->count > 1) {
+        LOG_WARN("Servidor: %s fora de uso por %lu s (%u falhas seguidas)\n", host->host,
+                 (unsigned long) (UPSTREAM_HOLD_DOWN_MS / 1000), host->failures);
+    }
+}
+
+const char *upstream_host(const Upstream *upstream) {
+    return upstream->count > 0 ? upstream->hosts[upstream->current].host : "";
+}
+
+void upstream_get_stats(const Upstream *upstream, UpstreamStats *out) {
+    *out = upstream->stats;
+}
@@ -0,0 +1,94 @@
+#ifndef UPSTREAM_H
+#define UPSTREAM_H
+
+// inclusão de bibliotecas
+#include "hal.h"
+#include "lwip/ip_addr.h"
+
+/**
+ * @file upstream.h
+ *
+ * @brief Lista de servidores (nomes ou IPv4 em texto) com resolução DNS em cache e failover.
+ *
+ * @note Os nomes são resolvidos com dns_gethostbyname, de forma assíncrona. Depois da primeira
+ * resolução o endereço fica em cache e é entregue na hora: a cada UPSTREAM_REFRESH_MS o nome é
+ * consultado de novo em segundo plano, e a conexão segue com o endereço anterior até a resposta
+ * chegar. A validade (TTL) de cada registro é respeitada pela tabela de DNS do lwIP, que responde
+ * sem ir à rede enquanto o registro é válido.
+ *
+ * Cada servidor acumula as falhas seguidas informadas pelo transporte; com UPSTREAM_FAILOVER_THRESHOLD
+ * falhas ele fica fora de uso por UPSTREAM_HOLD_DOWN_MS e o próximo da lista é usado. Na próxima
+ * conexão o primeiro servidor disponível, na ordem da lista, volta a ser o preferido.
+ *
+ * @warning Todas as funções devem ser chamadas com o lwIP travado (hal_lwip_begin/end) ou
+ * de dentro de um callback do lwIP.
+ */
+
+// quantidade máxima de servidores na lista
+#define UPSTREAM_MAX_HOSTS 4
+
+// intervalo entre as consultas de renovação do endereço em cache
+#define UPSTREAM_REFRESH_MS 60000
+
+// falhas seguidas que tiram um servidor de uso e tempo que ele fica fora
+#define UPSTREAM_FAILOVER_THRESHOLD 2
+#define UPSTREAM_HOLD_DOWN_MS 60000
+
+// resultado de upstream_resolve
+typedef enum {
+    UPSTREAM_READY,             // endereço disponível (cache ou IP literal)
+    UPSTREAM_PENDING,           // consulta DNS em andamento: o callback será chamado
+    UPSTREAM_ERROR              // não foi possível consultar o DNS
+} UpstreamResult;
+
+// aviso de fim da consulta DNS: endereço do servidor ou NULL se o nome não foi resolvido
+typedef void (*upstream_ready_fn)(const ip_addr_t *address);
+
+// estado de um servidor da lista
+typedef struct {
+    const char *host;
+    ip_addr_t address;
+    bool has_address;           // endereço conhecido (resolvido ou IP literal)
+    bool literal;               // IP em texto: nunca consulta o DNS
+    bool resolving;             // consulta DNS em andamento
+    uint32_t resolved_ms;       // instante da última resolução
+    uint8_t failures;           // falhas seguidas
+    uint32_t down_until_ms;     // fora de uso até este instante (0 = disponível)
+} UpstreamHost;
+
+// estatísticas da lista
+typedef struct {
+    uint32_t lookups;           // consultas enviadas ao DNS (primeira resolução e renovações)
+    uint32_t cache_hits;        // endereços entregues sem esperar pelo DNS
+    uint32_t dns_failures;      // consultas sem resposta ou com erro
+    uint32_t failovers;         // trocas do servidor em uso
+} UpstreamStats;
+
+// lista de servidores
+typedef struct {
+    UpstreamHost hosts[UPSTREAM_MAX_HOSTS];
+    uint8_t count;
+    uint8_t current;            // servidor em uso
+    upstream_ready_fn ready;    // quem espera a consulta do servidor em uso (NULL = ninguém)
+    UpstreamStats stats;
+} Upstream;
+
+// definição das funções
+
+// configura a lista (os nomes precisam continuar válidos, normalmente são literais)
+void upstream_init(Upstream *upstream, const char *const *hosts, uint8_t count);
+// escolhe o servidor e entrega o endereço em cache; sem cache, consulta o DNS e chama ready ao fim
+// (ready pode ser NULL para apenas tentar de novo mais tarde)
+UpstreamResult upstream_resolve(Upstream *upstream, ip_addr_t *address, upstream_ready_fn ready);
+// desiste da consulta em andamento (tempo esgotado): conta como falha do servidor
+void upstream_abort(Upstream *upstream);
+// informa que a conexão com o servidor em uso foi estabelecida
+void upstream_succeeded(Upstream *upstream);
+// informa que a conexão com o servidor em uso falhou
+void upstream_failed(Upstream *upstream);
+// nome do servidor em uso
+const char *upstream_host(const Upstream *upstream);
+// copia as estatísticas da lista
+void upstream_get_stats(const Upstream *upstream, UpstreamStats *out);
+
+#endif
@@ -19,10 +19,30 @@
 #define MEM_LIBC_MALLOC             0
 #endif
 #define MEM_ALIGNMENT               4
+#if SERVER_USE_UDP
+// transporte UDP: os datagramas (PBUF_RAM de até DATAGRAM_MAX_SIZE = 512 bytes, até SERVER_UDP_BURST = 4
+// por ciclo) saem do heap e podem ficar retidos na fila do ARP enquanto o receptor é resolvido
+#define MEM_SIZE                    (4000 + 4 * 600)
+#else
 #define MEM_SIZE                    4000
+#endif
 #define MEMP_NUM_TCP_SEG            32
+// conexão com o servidor + conexões da API local (e pcbs em TIME_WAIT)
+#define MEMP_NUM_TCP_PCB            8
 #define MEMP_NUM_ARP_QUEUE          10
+// DHCP, DNS e o socket do transporte UDP, com uma vaga livre
+#define MEMP_NUM_UDP_PCB            4
 #define PBUF_POOL_SIZE              24
+// timers (sys_timeout) pendentes ao mesmo tempo: os cíclicos do próprio lwIP mais os da estação, o
+// wifi_poll e os dois de cada gerenciador de conexão (próxima tentativa e limite da tentativa), o do
+// Wi-Fi e o do servidor (mais o timer cíclico do cliente MQTT do lwIP, com esse transporte); sem vaga o
+// sys_timeout falha e a tentativa nunca seria refeita
+#if SERVER_USE_MQTT
+#define STATION_NUM_SYS_TIMEOUT     (1 + 2 * 2 + 1)
+#else
+#define STATION_NUM_SYS_TIMEOUT     (1 + 2 * 2)
+#endif
+#define MEMP_NUM_SYS_TIMEOUT        (LWIP_NUM_SYS_TIMEOUT_INTERNAL + STATION_NUM_SYS_TIMEOUT)
 #define LWIP_ARP                    1
 #define LWIP_ETHERNET               1
 #define LWIP_ICMP                   1
@@ -35,9 +55,12 @@
 #define LWIP_NETIF_LINK_CALLBACK    1
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETCONN                0
-#define MEM_STATS                   0
+// contadores de uso e de falha do heap e dos pools, lidos pela telemetria de memória (memstat);
+// sem depuração os demais contadores ficam desligados
+#define LWIP_STATS                  1
+#define MEM_STATS                   1
+#define MEMP_STATS                  1
 #define SYS_STATS                   0
-#define MEMP_STATS                  0
 #define LINK_STATS                  0
 // #define ETH_PAD_SIZE                2
 #define LWIP_CHKSUM_ALGORITHM       3
@@ -47,14 +70,29 @@
 #define LWIP_UDP                    1
 #define LWIP_DNS                    1
 #define LWIP_TCP_KEEPALIVE          1
+
+#if HTTP_CLIENT_TLS
+// HTTPS no cliente HTTP: altcp com TLS (mbedTLS, configurado em mbedtls_config.h); o certificado do
+// servidor precisa ser válido para a CA configurada e para o nome do servidor
+#define LWIP_ALTCP                  1
+#define LWIP_ALTCP_TLS              1
+#define LWIP_ALTCP_TLS_MBEDTLS      1
+#define ALTCP_MBEDTLS_AUTHMODE      MBEDTLS_SSL_VERIFY_REQUIRED
+#endif
 #define LWIP_NETIF_TX_SINGLE_PBUF   1
 #define DHCP_DOES_ARP_CHECK         0
 #define LWIP_DHCP_DOES_ACD_CHECK    0
 
 #ifndef NDEBUG
 #define LWIP_DEBUG                  1
-#define LWIP_STATS                  1
 #define LWIP_STATS_DISPLAY          1
+#else
+#define ETHARP_STATS                0
+#define IP_STATS                    0
+#define IPFRAG_STATS                0
+#define ICMP_STATS                  0
+#define UDP_STATS                   0
+#define TCP_STATS                   0
 #endif
 
 #define ETHARP_DEBUG                LWIP_DBG_OFF
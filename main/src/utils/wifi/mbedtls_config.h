@@ -0,0 +1,71 @@
+#ifndef MBEDTLS_CONFIG_H
+#define MBEDTLS_CONFIG_H
+
+// Configuração do mbedTLS para o HTTPS do cliente HTTP (build com -DSTATION_TLS=ON): apenas cliente
+// TLS 1.2 com ECDHE e AES-GCM, retomada de sessão (id de sessão e session tickets) e o mínimo de
+// tabelas em RAM. Baseada na configuração dos exemplos de TLS do SDK do Pico.
+
+// alguns fontes do mbedTLS usam INT_MAX sem incluir limits.h
+#include <limits.h>
+
+// entropia vem do gerador do RP2040 (pico_rand), não de /dev/urandom
+#define MBEDTLS_NO_PLATFORM_ENTROPY
+#define MBEDTLS_ENTROPY_HARDWARE_ALT
+
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+#define MBEDTLS_HAVE_TIME
+
+// registros enviados são pequenos (lotes de até SERVER_BODY_SIZE); os recebidos seguem o padrão de
+// 16 KiB, já que o servidor pode não negociar fragmentos menores
+#define MBEDTLS_SSL_OUT_CONTENT_LEN 2048
+
+// protocolo e retomada de sessão
+#define MBEDTLS_SSL_PROTO_TLS1_2
+#define MBEDTLS_SSL_CLI_C
+#define MBEDTLS_SSL_TLS_C
+#define MBEDTLS_SSL_SERVER_NAME_INDICATION
+#define MBEDTLS_SSL_SESSION_TICKETS
+
+// troca de chaves e cifras
+#define MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED
+#define MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED
+#define MBEDTLS_ECP_DP_SECP256R1_ENABLED
+#define MBEDTLS_ECP_DP_SECP384R1_ENABLED
+#define MBEDTLS_ECP_NIST_OPTIM
+#define MBEDTLS_ECDH_C
+#define MBEDTLS_ECDSA_C
+#define MBEDTLS_ECP_C
+#define MBEDTLS_RSA_C
+#define MBEDTLS_PKCS1_V15
+#define MBEDTLS_AES_C
+#define MBEDTLS_AES_FEWER_TABLES
+#define MBEDTLS_GCM_C
+#define MBEDTLS_CIPHER_C
+#define MBEDTLS_BIGNUM_C
+#define MBEDTLS_CTR_DRBG_C
+#define MBEDTLS_ENTROPY_C
+
+// hashes
+#define MBEDTLS_MD_C
+#define MBEDTLS_SHA1_C
+#define MBEDTLS_SHA224_C
+#define MBEDTLS_SHA256_C
+#define MBEDTLS_SHA256_SMALLER
+#define MBEDTLS_SHA384_C
+#define MBEDTLS_SHA512_C
+
+// certificados (CA em PEM)
+#define MBEDTLS_X509_CRT_PARSE_C
+#define MBEDTLS_X509_USE_C
+#define MBEDTLS_PK_C
+#define MBEDTLS_PK_PARSE_C
+#define MBEDTLS_PEM_PARSE_C
+#define MBEDTLS_BASE64_C
+#define MBEDTLS_ASN1_PARSE_C
+#define MBEDTLS_ASN1_WRITE_C
+#define MBEDTLS_OID_C
+
+#define MBEDTLS_PLATFORM_C
+#define MBEDTLS_ERROR_C
+
+#endif
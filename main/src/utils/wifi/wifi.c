@@ -1,25 +1,218 @@
 #include "wifi.h"
+#include <stdio.h>
+#include <string.h>
+#include "lwip/timeouts.h"
+#include "log.h"
+#include "sched.h"
+
+// tentativas, backoff e circuit breaker da associação
+static ConnectionManager connection;
+
+// enlace associado e com IP
+static bool connected = false;
+
+// AP da última associação bem-sucedida, usado para pular a varredura na próxima
+static uint8_t cached_bssid[6];
+static uint32_t cached_channel;
+static bool cached_valid = false;
+// a próxima tentativa começa pelo AP guardado (falso depois de uma tentativa rápida que esgotou o tempo)
+static bool next_fast = true;
+
+// tentativa em andamento
+static bool fast_attempt = false;
+static uint32_t attempt_started_ms = 0;
+
+// contabilidade do tempo com o rádio ativo, em horas desde o boot
+#define WIFI_HOUR_MS 3600000u
+static bool radio_on = false;
+static uint32_t radio_accounted_ms = 0;     // até onde o tempo já foi contabilizado
+static uint32_t hour_started_ms = 0;
+
+static WifiStats stats = {0};
 
 // implementação das funções
 
-int wifi_connect() {
+static uint32_t wifi_now_ms(void) {
+    return hal_time_ms();
+}
+
+// Contabiliza o tempo com o rádio ativo até agora, fechando as horas que terminaram no caminho
+static void wifi_account_radio(void) {
+    uint32_t now = wifi_now_ms();
+
+    while (true) {
+        uint32_t hour_end = hour_started_ms + WIFI_HOUR_MS;
+        bool hour_over = (int32_t) (now - hour_end) >= 0;
+        uint32_t until = hour_over ? hour_end : now;
+
+        if (radio_on) {
+            stats.radio_on_ms += until - radio_accounted_ms;
+            stats.radio_on_hour_ms += until - radio_accounted_ms;
+        }
+        radio_accounted_ms = until;
+        if (!hour_over) break;
+
+        stats.radio_on_last_hour_ms = stats.radio_on_hour_ms;
+        stats.radio_on_hour_ms = 0;
+        stats.hours++;
+        hour_started_ms = hour_end;
+    }
+}
+
+// Guarda BSSID e canal do AP em que a estação acabou de se associar (a varredura pode ter achado outro)
+static void wifi_remember_ap(void) {
+    cached_valid = hal_net_get_ap(cached_bssid, &cached_channel);
+    next_fast = true;
+}
+
+// Pede a associação ao driver: direto ao AP guardado ou com varredura completa
+static bool wifi_join(bool fast) {
+    fast_attempt = fast;
+    int err = hal_net_join(WIFI_SSID, WIFI_PASS, WIFI_AUTH, fast ? cached_bssid : NULL,
+                           fast ? cached_channel : HAL_NET_CHANNEL_ANY);
+    if (err != 0) LOG_WARN("Wi-Fi: erro ao iniciar a associacao (%d)\n", err);
+    return err == 0;
+}
+
+// Inicia uma tentativa: pelo AP guardado quando houver, senão com varredura completa
+static bool wifi_start(void) {
+    attempt_started_ms = wifi_now_ms();
+    return wifi_join(cached_valid && next_fast);
+}
+
+// Desiste da tentativa em andamento; o cache continua valendo (o AP pode só estar fora do ar), mas
+// se a tentativa rápida esgotou o tempo a seguinte começa pela varredura
+static void wifi_abort(void) {
+    hal_net_leave();
+    if (fast_attempt) stats.fast_join_failures++;
+    next_fast = !fast_attempt;
+}
+
+// Confere o estado do driver e avisa o gerenciador das mudanças
+static void wifi_check(void) {
+    ConnectionState state = connection_state(&connection);
+    HalLinkStatus status = hal_net_link_status();
 
-    int connected;
-    // inicialização do chip
-    if (cyw43_arch_init()) {
-        printf("Wi-fi init failed.\n");
-        return 1;
+    if (state == CONNECTION_CONNECTING && status == HAL_LINK_UP) {
+        stats.last_join_ms = wifi_now_ms() - attempt_started_ms;
+        if (fast_attempt) stats.fast_joins++;
+        else stats.full_joins++;
+        wifi_remember_ap();
+        connected = true;
+        LOG_INFO("Wi-Fi: conectado em %lu ms (%s), %lu ms desde o boot\n", (unsigned long) stats.last_join_ms,
+                 fast_attempt ? "AP guardado" : "varredura completa", (unsigned long) wifi_now_ms());
+        // o endereço vai byte a byte: o texto de ip4addr_ntoa não sobrevive até a formatação do log
+        const ip4_addr_t *address = netif_ip4_addr(hal_net_netif());
+        LOG_INFO("Wi-Fi: IP %u.%u.%u.%u\n", ip4_addr1(address), ip4_addr2(address), ip4_addr3(address), ip4_addr4(address));
+        connection_connected(&connection);
+        sched_signal(EVENT_NETWORK);
+    } else if (state == CONNECTION_CONNECTING
+               && (status == HAL_LINK_FAIL || status == HAL_LINK_NONET || status == HAL_LINK_BADAUTH)) {
+        LOG_WARN("Wi-Fi: falha na associacao (%s)\n", status == HAL_LINK_BADAUTH ? "senha recusada"
+                 : status == HAL_LINK_NONET ? "rede nao encontrada" : "erro");
+        // senha recusada: o AP guardado pode ser outro, com a mesma rede; a próxima faz a varredura
+        if (status == HAL_LINK_BADAUTH) {
+            cached_valid = false;
+        } else if (fast_attempt) {
+            // o AP guardado não respondeu: a mesma tentativa segue com a varredura completa
+            stats.fast_join_failures++;
+            hal_net_leave();
+            if (wifi_join(false)) return;
+        }
+        wifi_abort();
+        connection_lost(&connection);
+    } else if (state == CONNECTION_CONNECTED && status != HAL_LINK_UP) {
+        // queda do enlace: o gerenciador agenda a reassociação (primeiro ao AP guardado)
+        stats.link_losses++;
+        connected = false;
+        LOG_WARN("Wi-Fi: enlace perdido, reconectando em segundo plano\n");
+        hal_net_leave();
+        connection_lost(&connection);
     }
+}
 
-    // ativa o modo cliente do wifi
-    cyw43_arch_enable_sta_mode();
+// Callbacks de status (IP) e de enlace da netif: reação imediata às mudanças
+static void wifi_netif_changed(struct netif *netif) {
+    wifi_check();
+}
 
-    // tentando se conectar em até 10s
-    printf("Connecting Wifi...\n");
-    connected = cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_AES_PSK, 10000);
-    
-    // exibe status de conexão no terminal e retorna o estado
-    char *message_log = connected == 0? "Wifi conected!\n" : "Failed to connect.\n";
-    printf(message_log);
+// Registra os callbacks na netif (de novo a cada vez que a interface é ligada)
+static void wifi_watch_netif(void) {
+    struct netif *netif = hal_net_netif();
+    netif_set_status_callback(netif, wifi_netif_changed);
+    netif_set_link_callback(netif, wifi_netif_changed);
+}
+
+// Verificação periódica, para o caso de alguma mudança não gerar callback
+static void wifi_poll(void *arg) {
+    wifi_check();
+    sys_timeout(WIFI_POLL_MS, wifi_poll, NULL);
+}
+
+bool wifi_init() {
+    // inicialização do chip, em modo cliente
+    if (!hal_net_init()) {
+        LOG_ERROR("Wi-fi init failed.\n");
+        return false;
+    }
+
+    hal_lwip_begin();
+    connection_init(&connection, "Wi-Fi", wifi_start, wifi_abort);
+    wifi_watch_netif();
+
+    connection_request(&connection);
+    sys_timeout(WIFI_POLL_MS, wifi_poll, NULL);
+    hal_lwip_end();
+
+    radio_on = true;
+    radio_accounted_ms = hour_started_ms = wifi_now_ms();
+
+    LOG_INFO("Connecting Wifi...\n");
+    return true;
+}
+
+bool wifi_is_connected() {
     return connected;
-}
\ No newline at end of file
+}
+
+ConnectionState wifi_connection_state() {
+    return connection_state(&connection);
+}
+
+uint32_t wifi_retry_in_ms() {
+    return connection_retry_in_ms(&connection);
+}
+
+void wifi_suspend() {
+    if (!radio_on) return;
+    wifi_account_radio();
+    radio_on = false;
+
+    hal_lwip_begin();
+    connection_release(&connection);
+    connected = false;
+    // a interface é desligada, não só desassociada: sem associação o chip ainda manteria o rádio ligado
+    hal_net_set_power(false);
+    hal_lwip_end();
+}
+
+void wifi_resume() {
+    if (radio_on) return;
+    wifi_account_radio();
+    radio_on = true;
+
+    hal_lwip_begin();
+    hal_net_set_power(true);
+    wifi_watch_netif();
+    connection_request(&connection);
+    hal_lwip_end();
+}
+
+bool wifi_radio_on() {
+    return radio_on;
+}
+
+void wifi_get_stats(WifiStats *out) {
+    wifi_account_radio();
+    *out = stats;
+}
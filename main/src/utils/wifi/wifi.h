@@ -2,14 +2,74 @@
 #define WIFI_H
 
 // inclusão de bibliotecas
-#include "pico/cyw43_arch.h"
+#include "hal.h"
 #include "lwip/netif.h"
+#include "connection.h"
+
+/**
+ * @file wifi.h
+ *
+ * @brief Supervisor do enlace Wi-Fi: conexão e reconexão em segundo plano, sem bloquear o laço principal.
+ *
+ * @note A associação é iniciada com hal_net_join e acompanhada pelos callbacks de status e de enlace
+ * da netif (LWIP_NETIF_STATUS_CALLBACK e LWIP_NETIF_LINK_CALLBACK), com uma verificação periódica do
+ * estado do driver como garantia. As tentativas, o backoff e o circuit breaker ficam com o gerenciador
+ * de conexão (connection.h), o mesmo usado pelos transportes.
+ *
+ * Depois da primeira associação o BSSID e o canal do AP ficam guardados: a reassociação após uma
+ * queda vai direto ao AP conhecido, sem varrer todos os canais. Se o AP guardado não responder, a
+ * mesma tentativa segue com a varredura completa, que acha o AP se ele só mudou de canal e atualiza o
+ * cache; um AP fora do ar não apaga o cache, e a tentativa seguinte volta a começar por ele (se a
+ * tentativa rápida esgotar o tempo, a seguinte é a varredura). O cache só é descartado quando a senha
+ * é recusada.
+ *
+ * Leitura dos sensores e display seguem normalmente sem rede; os transportes consultam
+ * wifi_is_connected() antes de tentar falar com o servidor.
+ *
+ * No modo de ciclo de trabalho (radio.h) o enlace é desfeito entre as janelas de envio com
+ * wifi_suspend: a estação sai da rede e a interface do chip é desligada até wifi_resume. O tempo
+ * com o rádio ativo é contabilizado por hora, nos dois modos, para o dimensionamento de painel e
+ * bateria em estações remotas.
+ */
 
 // wifi credenciais
 #define WIFI_SSID "SUA REDE WIFI"
 #define WIFI_PASS "SUA SENHA"
+#define WIFI_AUTH HAL_NET_AUTH_WPA2
+
+// intervalo da verificação periódica do estado do driver
+#define WIFI_POLL_MS 500
+
+// estatísticas do enlace
+typedef struct {
+    uint32_t full_joins;            // associações com varredura completa
+    uint32_t fast_joins;            // reassociações direto ao AP guardado (BSSID e canal)
+    uint32_t fast_join_failures;    // reassociações rápidas que falharam (seguidas da varredura)
+    uint32_t link_losses;           // quedas do enlace já estabelecido
+    uint32_t last_join_ms;          // duração da última conexão (do início da tentativa até ter IP)
+    uint64_t radio_on_ms;           // tempo total com o rádio ativo desde o boot
+    uint32_t radio_on_hour_ms;      // tempo com o rádio ativo na hora corrente
+    uint32_t radio_on_last_hour_ms; // tempo com o rádio ativo na última hora completa
+    uint32_t hours;                 // horas completas desde o boot
+} WifiStats;
 
 // definição das funções
-int wifi_connect();
 
-#endif
\ No newline at end of file
+// inicializa o chip e começa a conectar em segundo plano; false se o chip não pôde ser iniciado
+bool wifi_init();
+// enlace associado e com IP
+bool wifi_is_connected();
+// estado do gerenciador de conexão do enlace
+ConnectionState wifi_connection_state();
+// tempo até a próxima tentativa agendada (0 se não houver)
+uint32_t wifi_retry_in_ms();
+// desfaz o enlace, desliga a interface e suspende as tentativas até wifi_resume (entre janelas de envio)
+void wifi_suspend();
+// volta a conectar (primeiro direto ao AP guardado)
+void wifi_resume();
+// rádio ativo (não suspenso)
+bool wifi_radio_on();
+// copia as estatísticas do enlace
+void wifi_get_stats(WifiStats *out);
+
+#endif
@@ -0,0 +1,167 @@
+// Conferência (no computador) do codificador CBOR das amostras.
+//
+// Codifica lotes com o mesmo escritor usado no firmware, decodifica com o leitor e compara
+// amostra a amostra; confere também exemplos da RFC 8949 e imprime o tamanho do lote em CBOR
+// contra o mesmo lote no JSON enviado pelo servidor.
+//
+// Compilação (a partir de main/tools):
+//     gcc -O2 -I../src/utils/sample -I../src/utils/cbor -o cbor_check
+//         cbor_check.c ../src/utils/cbor/cbor.c ../src/utils/sample/sample.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cbor.h"
+
+#define CHECK_BATCHES 1000
+#define CHECK_BATCH_SIZE 24
+
+// exemplos do apêndice A da RFC 8949
+static int check_vectors(void) {
+    static const struct {
+        int32_t value;
+        uint8_t bytes[5];
+        size_t length;
+    } ints[] = {
+        {0, {0x00}, 1}, {23, {0x17}, 1}, {24, {0x18, 0x18}, 2}, {100, {0x18, 0x64}, 2},
+        {1000, {0x19, 0x03, 0xE8}, 3}, {1000000, {0x1A, 0x00, 0x0F, 0x42, 0x40}, 5},
+        {-1, {0x20}, 1}, {-10, {0x29}, 1}, {-100, {0x38, 0x63}, 2}, {-1000, {0x39, 0x03, 0xE7}, 3},
+    };
+    int failures = 0;
+    uint8_t buffer[16];
+    CborWriter writer;
+    CborReader reader;
+
+    for (size_t i = 0; i < sizeof(ints) / sizeof(ints[0]); i++) {
+        cbor_writer_init(&writer, buffer, sizeof(buffer));
+        cbor_put_int(&writer, ints[i].value);
+        if (writer.length != ints[i].length || memcmp(buffer, ints[i].bytes, ints[i].length) != 0) {
+            printf("inteiro %d codificado errado\n", ints[i].value);
+            failures++;
+        }
+
+        int64_t value;
+        cbor_reader_init(&reader, ints[i].bytes, ints[i].length);
+        if (!cbor_read_int(&reader, &value) || value != ints[i].value) {
+            printf("inteiro %d decodificado errado\n", ints[i].value);
+            failures++;
+        }
+    }
+
+    // 273.15 como fração decimal: C4 82 21 19 6AB3
+    static const uint8_t decimal[] = {0xC4, 0x82, 0x21, 0x19, 0x6A, 0xB3};
+    cbor_writer_init(&writer, buffer, sizeof(buffer));
+    cbor_put_decimal(&writer, 27315, -2);
+    int64_t mantissa, exponent;
+    cbor_reader_init(&reader, decimal, sizeof(decimal));
+    if (writer.length != sizeof(decimal) || memcmp(buffer, decimal, sizeof(decimal)) != 0
+        || !cbor_read_decimal(&reader, &mantissa, &exponent) || mantissa != 27315 || exponent != -2) {
+        printf("fracao decimal 273.15 errada\n");
+        failures++;
+    }
+
+    // buffer pequeno: overflow sinalizado, nada escrito além do tamanho
+    cbor_writer_init(&writer, buffer, 2);
+    cbor_put_uint(&writer, 1000);
+    if (!writer.overflow || writer.length != 0) {
+        printf("overflow nao sinalizado\n");
+        failures++;
+    }
+
+    // leitura truncada
+    cbor_reader_init(&reader, decimal, 4);
+    if (cbor_read_decimal(&reader, &mantissa, &exponent) || !reader.error) {
+        printf("item truncado aceito\n");
+        failures++;
+    }
+    return failures;
+}
+
+// tamanho do objeto JSON que o servidor enviaria para a mesma amostra
+static size_t json_size(uint32_t seq, const SensorSample *sample, uint8_t channels) {
+    char buffer[128];
+    int length = snprintf(buffer, sizeof(buffer), "{\"seq\":%u,\"timestamp\":%u,\"boot\":%u", seq, sample->timestamp_s,
+                          sample->boot);
+    if (channels & CBOR_CHANNEL_TEMPERATURE) length += snprintf(buffer + length, sizeof(buffer) - length, ",\"temperature\":%d", sample->temperature);
+    if (channels & CBOR_CHANNEL_HUMIDITY) length += snprintf(buffer + length, sizeof(buffer) - length, ",\"humidity\":%d", sample->humidity);
+    if (channels & CBOR_CHANNEL_POLLUTION) {
+        length += snprintf(buffer + length, sizeof(buffer) - length, ",\"pollutionLevel\":%u.%u",
+                           sample->pollution_x10 / 10, sample->pollution_x10 % 10);
+    }
+    return length + 2;  // '}' e ',' ou ']'
+}
+
+int main(void) {
+    int failures = check_vectors();
+
+    uint8_t buffer[CHECK_BATCH_SIZE * CBOR_SAMPLE_MAX + 8];
+    uint32_t seq = 1000;
+    uint32_t timestamp = 86400 * 40;
+    size_t cbor_bytes = 0, json_bytes = 0, samples = 0;
+    srand(1);
+
+    for (int batch = 0; batch < CHECK_BATCHES; batch++) {
+        SensorSample sent[CHECK_BATCH_SIZE];
+        uint8_t channels[CHECK_BATCH_SIZE];
+        int count = 1 + rand() % CHECK_BATCH_SIZE;
+
+        CborWriter writer;
+        cbor_writer_init(&writer, buffer, sizeof(buffer));
+        cbor_put_array(&writer, count);
+        for (int i = 0; i < count; i++) {
+            timestamp += 55 + rand() % 10;
+            sample_make(&sent[i], timestamp, -5 + rand() % 45, 20 + rand() % 80, (rand() % 10001) / 100.0f);
+            sent[i].boot = 1 + batch / 100;
+            // metade dos lotes com todos os canais, a outra metade com a máscara do report
+            channels[i] = batch % 2 ? 7 : 1 + rand() % 7;
+            cbor_put_sample(&writer, seq + i, &sent[i], channels[i]);
+            json_bytes += json_size(seq + i, &sent[i], channels[i]);
+        }
+        json_bytes += 1;
+        cbor_bytes += writer.length;
+        samples += count;
+
+        if (writer.overflow) {
+            printf("lote %d nao coube em %zu bytes\n", batch, sizeof(buffer));
+            failures++;
+            continue;
+        }
+
+        CborReader reader;
+        CborType type;
+        uint64_t items;
+        cbor_reader_init(&reader, buffer, writer.length);
+        if (!cbor_read_head(&reader, &type, &items) || type != CBOR_TYPE_ARRAY || items != (uint64_t) count) {
+            printf("lote %d: cabecalho do array invalido\n", batch);
+            failures++;
+            continue;
+        }
+        for (int i = 0; i < count; i++) {
+            uint32_t received_seq;
+            uint8_t received_channels;
+            SensorSample received;
+            if (!cbor_read_sample(&reader, &received_seq, &received, &received_channels)
+                || received_seq != seq + i || received_channels != channels[i]
+                || received.timestamp_s != sent[i].timestamp_s || received.boot != sent[i].boot
+                || ((channels[i] & CBOR_CHANNEL_TEMPERATURE) && received.temperature != sent[i].temperature)
+                || ((channels[i] & CBOR_CHANNEL_HUMIDITY) && received.humidity != sent[i].humidity)
+                || ((channels[i] & CBOR_CHANNEL_POLLUTION) && received.pollution_x10 != sent[i].pollution_x10)) {
+                printf("lote %d, amostra %d: divergencia\n", batch, i);
+                failures++;
+                break;
+            }
+        }
+        if (reader.position != writer.length) {
+            printf("lote %d: sobraram %zu bytes\n", batch, writer.length - reader.position);
+            failures++;
+        }
+        seq += count;
+    }
+
+    printf("%zu amostras em %d lotes: CBOR %.1f bytes/amostra, JSON %.1f bytes/amostra (%.2fx)\n",
+           samples, CHECK_BATCHES, (double) cbor_bytes / samples, (double) json_bytes / samples,
+           (double) json_bytes / cbor_bytes);
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures != 0;
+}
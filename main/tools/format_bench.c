@@ -0,0 +1,171 @@
+// Benchmark (no computador) da biblioteca format contra o snprintf.
+//
+// Confere que as saídas coincidem com as do snprintf para inteiros, ponto fixo e floats nos
+// intervalos lidos pela estação, e mede o tempo por conversão. No RP2040 a diferença é bem
+// maior que no computador, já que lá o "%f" roda sobre float emulado em software.
+//
+// Os tempos passam pela biblioteca prof (a mesma das sondas do dispositivo): cada medida é a média
+// de um bloco de BENCH_CHUNK conversões, e com --hist os histogramas de cada coluna são exibidos.
+//
+// Compilação (a partir de main/tools):
+//     gcc -O2 -I../src/utils/format -I../src/utils/prof -o format_bench format_bench.c
+//         ../src/utils/format/format.c ../src/utils/prof/prof.c
+// Uso:
+//     ./format_bench [--hist]
+//
+// Tamanho do binário no dispositivo: compare a saída de `arm-none-eabi-size main.elf` do build
+// com e sem PICO_PRINTF_SUPPORT_FLOAT=0 (definido no CMakeLists.txt).
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "format.h"
+#include "prof.h"
+
+#define BENCH_ROUNDS 2000000
+#define BENCH_CHUNK 1000
+
+// mede o comando em blocos de BENCH_CHUNK repetições (i = índice da repetição), guardando no
+// histograma o tempo médio por repetição de cada bloco
+#define BENCH_MEASURE(histogram, ...)                                                   \
+    do {                                                                                \
+        prof_histogram_reset(&(histogram));                                             \
+        for (uint32_t chunk = 0; chunk < BENCH_ROUNDS; chunk += BENCH_CHUNK) {          \
+            uint64_t chunk_start = prof_now_ns();                                       \
+            for (uint32_t i = chunk; i < chunk + BENCH_CHUNK; i++) { __VA_ARGS__; }     \
+            prof_histogram_record(&(histogram), (prof_now_ns() - chunk_start) / BENCH_CHUNK); \
+        }                                                                               \
+    } while (0)
+
+// tempo médio por repetição, em ns
+static double average_ns(const ProfHistogram *histogram) {
+    return histogram->count ? (double) histogram->total_ns / histogram->count : 0;
+}
+
+// valores de teste: leituras típicas e extremos
+static int32_t int_value(uint32_t i) {
+    switch (i % 4) {
+        case 0: return (int32_t) (i % 101) - 20;              // temperatura/umidade
+        case 1: return (int32_t) (i * 2654435761u);           // 32 bits quaisquer
+        case 2: return i % 3 ? INT32_MIN : INT32_MAX;
+        default: return (int32_t) (i % 100000);               // sequências e timestamps
+    }
+}
+
+static float float_value(uint32_t i) {
+    return ((int32_t) (i % 200001) - 100000) / 997.0f;       // -100..100, sem dígitos "redondos"
+}
+
+// compara as duas implementações; floats podem diferir em empates exatos (o printf arredonda
+// pelo valor binário exato, a biblioteca soma 0.5 em float), então só esses são tolerados
+static int check(void) {
+    char expected[32];
+    char actual[32];
+    uint32_t mismatches = 0;
+    uint32_t ties = 0;
+
+    for (uint32_t i = 0; i < 200000; i++) {
+        int32_t value = int_value(i);
+        uint8_t width = i % 8;
+
+        snprintf(expected, sizeof(expected), "%*d", width, value);
+        int length = format_int(actual, sizeof(actual), value, width);
+        if (strcmp(expected, actual) != 0 || length != (int) strlen(expected)) {
+            if (mismatches++ < 5) printf("int   %d: '%s' != '%s'\n", value, expected, actual);
+        }
+
+        snprintf(expected, sizeof(expected), "%*u", width, (uint32_t) value);
+        format_uint(actual, sizeof(actual), (uint32_t) value, width);
+        if (strcmp(expected, actual) != 0) {
+            if (mismatches++ < 5) printf("uint  %u: '%s' != '%s'\n", (uint32_t) value, expected, actual);
+        }
+
+        int32_t tenths = value % 100000;
+        snprintf(expected, sizeof(expected), "%s%d.%d", tenths < 0 ? "-" : "", abs(tenths) / 10, abs(tenths) % 10);
+        format_fixed(actual, sizeof(actual), tenths, 1, 0);
+        if (strcmp(expected, actual) != 0) {
+            if (mismatches++ < 5) printf("fixed %d: '%s' != '%s'\n", tenths, expected, actual);
+        }
+
+        float real = float_value(i);
+        uint8_t precision = i % 4;
+        snprintf(expected, sizeof(expected), "%.*f", precision, real);
+        format_float(actual, sizeof(actual), real, precision, 0);
+        if (strcmp(expected, actual) != 0) {
+            // empate no arredondamento: aceito se a diferença for de uma unidade na última casa
+            double unit = 1.0;
+            for (uint8_t p = 0; p < precision; p++) unit /= 10;
+            double difference = strtod(expected, NULL) - strtod(actual, NULL);
+            if (difference < 0) difference = -difference;
+
+            if (difference < unit * 1.01) {
+                ties++;
+            } else if (mismatches++ < 5) {
+                printf("float %.9g (%u casas): '%s' != '%s'\n", real, precision, expected, actual);
+            }
+        }
+    }
+
+    // buffer pequeno demais: falha explícita, buffer vazio
+    if (format_int(actual, 3, 1234, 0) != -1 || actual[0] != '\0') mismatches++;
+    if (format_line(actual, 8, "Umidade: ", "61", " %") != -1) mismatches++;
+
+    // zero com e sem sinal e um negativo que arredonda para zero: o sinal segue o do printf
+    static const float zeros[] = {0.0f, -0.0f, -0.04f};
+    for (size_t i = 0; i < sizeof(zeros) / sizeof(zeros[0]); i++) {
+        snprintf(expected, sizeof(expected), "%.1f", zeros[i]);
+        format_float(actual, sizeof(actual), zeros[i], 1, 0);
+        if (strcmp(expected, actual) != 0 && mismatches++ < 5) printf("zero: '%s' != '%s'\n", expected, actual);
+    }
+
+    printf("Conferencia: %u divergencias, %u arredondamentos de empate diferentes do printf\n", mismatches, ties);
+    return mismatches == 0;
+}
+
+int main(int argc, char **argv) {
+    if (!check()) return 1;
+
+    bool show_histograms = argc > 1 && strcmp(argv[1], "--hist") == 0;
+    char buffer[32];
+    volatile int sink = 0;
+    static ProfHistogram printf_ns[4];
+    static ProfHistogram format_ns[4];
+    static const char *const names[4] = {
+        "inteiro (%d)", "ponto fixo (poluicao no JSON)", "float (%.1f, tela do display)", "linha do display",
+    };
+
+    BENCH_MEASURE(printf_ns[0], sink += snprintf(buffer, sizeof(buffer), "%d", int_value(i)));
+    BENCH_MEASURE(format_ns[0], sink += format_int(buffer, sizeof(buffer), int_value(i), 0));
+
+    BENCH_MEASURE(printf_ns[1], uint16_t tenths = i % 1001; sink += snprintf(buffer, sizeof(buffer), "%u.%u", tenths / 10, tenths % 10));
+    BENCH_MEASURE(format_ns[1], sink += format_fixed(buffer, sizeof(buffer), i % 1001, 1, 0));
+
+    BENCH_MEASURE(printf_ns[2], sink += snprintf(buffer, sizeof(buffer), "%.1f", float_value(i)));
+    BENCH_MEASURE(format_ns[2], sink += format_float(buffer, sizeof(buffer), float_value(i), 1, 0));
+
+    BENCH_MEASURE(printf_ns[3], sink += snprintf(buffer, sizeof(buffer), "Umidade: %d %%", int_value(i) % 101));
+    BENCH_MEASURE(format_ns[3],
+        char number[12];
+        format_int(number, sizeof(number), int_value(i) % 101, 0);
+        sink += format_line(buffer, sizeof(buffer), "Umidade: ", number, " %"));
+
+    printf("\n%-34s %10s %10s\n", "conversao", "snprintf", "format");
+    for (int i = 0; i < 4; i++) {
+        printf("%-34s %8.1fns %8.1fns\n", names[i], average_ns(&printf_ns[i]), average_ns(&format_ns[i]));
+    }
+
+    if (show_histograms) {
+        for (int i = 0; i < 4; i++) {
+            printf("\n%s\n", names[i]);
+            prof_histogram_print("  snprintf", &printf_ns[i]);
+            prof_histogram_print("  format", &format_ns[i]);
+        }
+    }
+
+    return sink == 0;
+}
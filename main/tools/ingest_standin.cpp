@@ -0,0 +1,204 @@
+// Servidor HTTP local que substitui o backend de ingestão durante os testes de bancada.
+//
+// Aceita POST /api/sensors-data (JSON ou lote JSON) e /api/sensors-data/cbor (lote CBOR, decodificado
+// com o mesmo cbor.c do firmware), responde 200 mantendo a conexão aberta
+// e imprime a cada segundo: requisições/s, amostras/s, conexões abertas (reconexões),
+// sequências duplicadas e bytes recebidos por amostra.
+//
+// Compilação (no computador, não na placa):
+//     gcc -O2 -c -I../src/utils/sample -I../src/utils/cbor ../src/utils/cbor/cbor.c ../src/utils/sample/sample.c
+//     g++ -std=c++17 -O2 -I../src/utils/sample -I../src/utils/cbor -o ingest_standin ingest_standin.cpp cbor.o sample.o
+// Uso:
+//     ./ingest_standin [porta] [--close]
+//         --close  fecha a conexão após cada resposta (comportamento de um servidor sem keep-alive)
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "cbor.h"
+}
+
+namespace {
+
+struct Connection {
+    std::string buffer;
+};
+
+struct Counters {
+    unsigned long requests = 0;
+    unsigned long samples = 0;
+    unsigned long connections = 0;
+    unsigned long duplicates = 0;
+    unsigned long bytes = 0;
+};
+
+// conta as amostras de um corpo JSON e registra as sequências recebidas
+unsigned long count_samples(const std::string &body, std::set<unsigned long> &seen, Counters &counters) {
+    unsigned long samples = 0;
+    size_t pos = 0;
+    while ((pos = body.find("\"seq\"", pos)) != std::string::npos) {
+        pos = body.find(':', pos);
+        if (pos == std::string::npos) break;
+        unsigned long seq = std::strtoul(body.c_str() + pos + 1, nullptr, 10);
+        if (!seen.insert(seq).second) counters.duplicates++;
+        samples++;
+    }
+    // corpo sem sequência (formato antigo): uma amostra por objeto
+    if (samples == 0) {
+        for (char c : body) samples += c == '{';
+    }
+    return samples;
+}
+
+// conta as amostras de um lote CBOR e registra as sequências recebidas; lote malformado conta zero
+unsigned long count_samples_cbor(const std::string &body, std::set<unsigned long> &seen, Counters &counters) {
+    CborReader reader;
+    CborType type;
+    uint64_t items;
+    cbor_reader_init(&reader, reinterpret_cast<const uint8_t *>(body.data()), body.size());
+    if (!cbor_read_head(&reader, &type, &items) || type != CBOR_TYPE_ARRAY) {
+        std::printf("lote CBOR invalido\n");
+        return 0;
+    }
+
+    unsigned long samples = 0;
+    for (uint64_t i = 0; i < items; i++) {
+        uint32_t seq;
+        uint8_t channels;
+        SensorSample sample;
+        if (!cbor_read_sample(&reader, &seq, &sample, &channels)) {
+            std::printf("amostra CBOR invalida (%lu de %lu)\n", (unsigned long) i, (unsigned long) items);
+            break;
+        }
+        if (!seen.insert(seq).second) counters.duplicates++;
+        samples++;
+    }
+    return samples;
+}
+
+// extrai uma requisição completa do buffer; retorna false se ainda faltam bytes
+bool take_request(std::string &buffer, std::string &body, bool &cbor) {
+    size_t end = buffer.find("\r\n\r\n");
+    if (end == std::string::npos) return false;
+
+    size_t length = 0;
+    size_t header = buffer.find("Content-Length:");
+    if (header != std::string::npos && header < end) {
+        length = std::strtoul(buffer.c_str() + header + 15, nullptr, 10);
+    }
+    if (buffer.size() < end + 4 + length) return false;
+
+    size_t content_type = buffer.find("Content-Type: application/cbor");
+    cbor = content_type != std::string::npos && content_type < end;
+
+    body = buffer.substr(end + 4, length);
+    buffer.erase(0, end + 4 + length);
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int port = 8080;
+    bool close_after_response = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--close") == 0) close_after_response = true;
+        else port = std::atoi(argv[i]);
+    }
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int enable = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(listener, 16) < 0) {
+        std::perror("bind/listen");
+        return 1;
+    }
+    std::printf("ingest stand-in ouvindo na porta %d%s\n", port, close_after_response ? " (sem keep-alive)" : "");
+
+    static const char response_keep_alive[] = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n";
+    static const char response_close[] = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+    std::map<int, Connection> connections;
+    std::set<unsigned long> seen;
+    Counters total, window;
+    auto window_start = std::chrono::steady_clock::now();
+
+    while (true) {
+        std::vector<pollfd> fds{{listener, POLLIN, 0}};
+        for (auto &entry : connections) fds.push_back({entry.first, POLLIN, 0});
+        poll(fds.data(), fds.size(), 200);
+
+        if (fds[0].revents & POLLIN) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client >= 0) {
+                connections[client] = Connection{};
+                window.connections++;
+            }
+        }
+
+        for (size_t i = 1; i < fds.size(); i++) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            int fd = fds[i].fd;
+            char chunk[2048];
+            ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+            bool closed = received <= 0;
+
+            if (!closed) {
+                window.bytes += received;
+                Connection &connection = connections[fd];
+                connection.buffer.append(chunk, received);
+
+                std::string body;
+                bool cbor;
+                while (!closed && take_request(connection.buffer, body, cbor)) {
+                    window.requests++;
+                    window.samples += cbor ? count_samples_cbor(body, seen, window) : count_samples(body, seen, window);
+                    const char *response = close_after_response ? response_close : response_keep_alive;
+                    send(fd, response, std::strlen(response), MSG_NOSIGNAL);
+                    closed = close_after_response;
+                }
+            }
+
+            if (closed) {
+                close(fd);
+                connections.erase(fd);
+            }
+        }
+
+        // relatório a cada segundo
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - window_start).count();
+        if (elapsed >= 1.0) {
+            if (window.bytes > 0 || window.connections > 0) {
+                total.requests += window.requests;
+                total.samples += window.samples;
+                total.connections += window.connections;
+                total.duplicates += window.duplicates;
+                total.bytes += window.bytes;
+                std::printf("%.1f req/s | %.1f amostras/s | conexoes %lu (total %lu) | duplicadas %lu | %.1f bytes/amostra\n",
+                            window.requests / elapsed, window.samples / elapsed, window.connections, total.connections,
+                            total.duplicates, total.samples ? double(total.bytes) / total.samples : 0.0);
+                std::fflush(stdout);
+            }
+            window = Counters{};
+            window_start = now;
+        }
+    }
+}
@@ -0,0 +1,257 @@
+// Broker MQTT 3.1.1 mínimo que substitui o broker real durante os testes de bancada.
+//
+// Aceita CONNECT, PUBLISH com QoS 0 e 1 (responde PUBACK), PINGREQ, SUBSCRIBE (sem repassar
+// mensagens) e DISCONNECT. Decodifica o seq de cada mensagem (payload JSON ou CBOR, com o mesmo
+// cbor.c do firmware) e imprime a cada segundo: mensagens/s, conexões, mensagens duplicadas por
+// tópico e bytes por mensagem. A latência até o PUBACK é medida e impressa pela própria estação.
+//
+// Compilação (no computador, não na placa):
+//     gcc -O2 -c -I../src/utils/sample -I../src/utils/cbor ../src/utils/cbor/cbor.c ../src/utils/sample/sample.c
+//     g++ -std=c++17 -O2 -I../src/utils/sample -I../src/utils/cbor -o mqtt_broker_standin mqtt_broker_standin.cpp cbor.o sample.o
+// Uso:
+//     ./mqtt_broker_standin [porta] [--puback-delay ms]
+//         --puback-delay  atrasa cada PUBACK (simula a latência de um broker remoto)
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include "cbor.h"
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// tipos de pacote do MQTT 3.1.1 (4 bits mais altos do primeiro byte)
+enum PacketType {
+    CONNECT = 1,
+    CONNACK = 2,
+    PUBLISH = 3,
+    PUBACK = 4,
+    SUBSCRIBE = 8,
+    SUBACK = 9,
+    PINGREQ = 12,
+    PINGRESP = 13,
+    DISCONNECT = 14,
+};
+
+struct Connection {
+    std::string buffer;
+};
+
+// PUBACK aguardando o atraso configurado
+struct DelayedAck {
+    Clock::time_point due;
+    int fd;
+    std::string packet;
+};
+
+struct Counters {
+    unsigned long messages = 0;
+    unsigned long qos1 = 0;
+    unsigned long connections = 0;
+    unsigned long duplicates = 0;
+    unsigned long bytes = 0;
+};
+
+// seq de um payload JSON ({"seq":N,...}) ou CBOR (mapa com a chave CBOR_KEY_SEQ); -1 se ausente
+long payload_seq(const std::string &payload) {
+    if (!payload.empty() && payload[0] == '{') {
+        size_t pos = payload.find("\"seq\":");
+        return pos == std::string::npos ? -1 : std::strtol(payload.c_str() + pos + 6, nullptr, 10);
+    }
+
+    CborReader reader;
+    uint32_t seq;
+    uint8_t channels;
+    SensorSample sample;
+    cbor_reader_init(&reader, reinterpret_cast<const uint8_t *>(payload.data()), payload.size());
+    return cbor_read_sample(&reader, &seq, &sample, &channels) ? long(seq) : -1;
+}
+
+// extrai um pacote completo do buffer; retorna false se ainda faltam bytes
+bool take_packet(std::string &buffer, uint8_t &header, std::string &body) {
+    // tamanho restante: até 4 bytes de 7 bits, o bit mais alto indica continuação
+    size_t length = 0;
+    size_t position = 1;
+    for (int shift = 0; ; shift += 7, position++) {
+        if (position >= buffer.size()) return false;
+        uint8_t byte = buffer[position];
+        length |= size_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+        if (shift == 21) {
+            buffer.clear();     // tamanho inválido: descarta tudo
+            return false;
+        }
+    }
+    if (buffer.size() < position + 1 + length) return false;
+
+    header = buffer[0];
+    body = buffer.substr(position + 1, length);
+    buffer.erase(0, position + 1 + length);
+    return true;
+}
+
+uint16_t read_u16(const std::string &data, size_t position) {
+    return (uint8_t(data[position]) << 8) | uint8_t(data[position + 1]);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int port = 1883;
+    int puback_delay_ms = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--puback-delay") == 0 && i + 1 < argc) puback_delay_ms = std::atoi(argv[++i]);
+        else port = std::atoi(argv[i]);
+    }
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int enable = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(listener, 16) < 0) {
+        std::perror("bind/listen");
+        return 1;
+    }
+    std::printf("broker MQTT stand-in ouvindo na porta %d (PUBACK com %d ms de atraso)\n", port, puback_delay_ms);
+
+    std::map<int, Connection> connections;
+    std::set<std::pair<std::string, long>> seen;
+    std::map<std::string, unsigned long> per_topic;
+    std::deque<DelayedAck> delayed;
+    Counters total, window;
+    auto window_start = Clock::now();
+
+    while (true) {
+        std::vector<pollfd> fds{{listener, POLLIN, 0}};
+        for (auto &entry : connections) fds.push_back({entry.first, POLLIN, 0});
+        poll(fds.data(), fds.size(), delayed.empty() ? 200 : 1);
+
+        if (fds[0].revents & POLLIN) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client >= 0) {
+                connections[client] = Connection{};
+                window.connections++;
+            }
+        }
+
+        for (size_t i = 1; i < fds.size(); i++) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            int fd = fds[i].fd;
+            char chunk[2048];
+            ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+            bool closed = received <= 0;
+
+            if (!closed) {
+                window.bytes += received;
+                Connection &connection = connections[fd];
+                connection.buffer.append(chunk, received);
+
+                uint8_t header;
+                std::string body;
+                while (!closed && take_packet(connection.buffer, header, body)) {
+                    std::string reply;
+
+                    switch (header >> 4) {
+                        case CONNECT: {
+                            // nome do protocolo (2 + 4), nível (1), flags (1), keep-alive (2), client id
+                            uint8_t flags = body.size() > 7 ? uint8_t(body[7]) : 0;
+                            std::string client_id = body.size() > 11 ? body.substr(12, read_u16(body, 10)) : "";
+                            std::printf("CONNECT de '%s' (clean session %d)\n", client_id.c_str(), (flags >> 1) & 1);
+                            reply = std::string("\x20\x02\x00\x00", 4);
+                            break;
+                        }
+                        case PUBLISH: {
+                            uint8_t qos = (header >> 1) & 3;
+                            uint16_t topic_length = read_u16(body, 0);
+                            std::string topic = body.substr(2, topic_length);
+                            size_t position = 2 + topic_length;
+                            if (qos > 0) {
+                                reply = std::string("\x40\x02", 2) + body.substr(position, 2);
+                                position += 2;
+                                window.qos1++;
+                            }
+
+                            long seq = payload_seq(body.substr(position));
+                            if (seq >= 0 && !seen.insert({topic, seq}).second) window.duplicates++;
+                            per_topic[topic]++;
+                            window.messages++;
+
+                            if (!reply.empty() && puback_delay_ms > 0) {
+                                delayed.push_back({Clock::now() + std::chrono::milliseconds(puback_delay_ms), fd, reply});
+                                reply.clear();
+                            }
+                            break;
+                        }
+                        case SUBSCRIBE: {
+                            // concede QoS 0 a cada filtro (a mensagem não é repassada)
+                            reply = std::string("\x90\x03", 2) + body.substr(0, 2) + std::string("\x00", 1);
+                            break;
+                        }
+                        case PINGREQ:
+                            reply = std::string("\xD0\x00", 2);
+                            break;
+                        case DISCONNECT:
+                            closed = true;
+                            break;
+                        default:
+                            break;
+                    }
+
+                    if (!reply.empty()) send(fd, reply.data(), reply.size(), MSG_NOSIGNAL);
+                }
+            }
+
+            if (closed) {
+                close(fd);
+                connections.erase(fd);
+            }
+        }
+
+        // PUBACKs atrasados que venceram (de conexões que ainda existem)
+        auto now = Clock::now();
+        while (!delayed.empty() && delayed.front().due <= now) {
+            const DelayedAck &ack = delayed.front();
+            if (connections.count(ack.fd)) send(ack.fd, ack.packet.data(), ack.packet.size(), MSG_NOSIGNAL);
+            delayed.pop_front();
+        }
+
+        // relatório a cada segundo
+        double elapsed = std::chrono::duration<double>(now - window_start).count();
+        if (elapsed >= 1.0) {
+            if (window.bytes > 0 || window.connections > 0) {
+                total.messages += window.messages;
+                total.connections += window.connections;
+                total.duplicates += window.duplicates;
+                total.bytes += window.bytes;
+                std::printf("%.1f msg/s (%lu QoS 1) | conexoes %lu (total %lu) | duplicadas %lu | %.1f bytes/msg | topicos:",
+                            window.messages / elapsed, window.qos1, window.connections, total.connections,
+                            total.duplicates, total.messages ? double(total.bytes) / total.messages : 0.0);
+                for (auto &entry : per_topic) std::printf(" %s=%lu", entry.first.c_str(), entry.second);
+                std::printf("\n");
+                std::fflush(stdout);
+            }
+            window = Counters{};
+            window_start = now;
+        }
+    }
+}
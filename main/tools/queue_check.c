@@ -0,0 +1,177 @@
+// Conferência (no computador) da fila de envio (src/utils/queue) com o spill para a flash.
+//
+// A fila roda sobre o log da flash (store) e a porta de flash do simulador, numa flash nova a cada
+// conferência. São conferidos: o caso da RAM cheia com a entrada mais antiga num lote em voo (a amostra
+// nova fica só na flash e precisa entrar no lote seguinte, em ordem, em vez de ser pulada e descartada
+// pela confirmação) e uma sequência aleatória de leituras, lotes, confirmações e devoluções, em que
+// todo lote deve continuar a sequência sem lacunas e, no fim, tudo o que foi enfileirado deve ter sido
+// confirmado exatamente uma vez.
+//
+// Compilação (a partir de main/tools):
+//     gcc -O2 -I../src/utils/hal -I../src/utils/sample -I../src/utils/store -I../src/utils/queue
+//         -o queue_check queue_check.c ../src/utils/queue/queue.c ../src/utils/sample/sample.c
+//         ../src/utils/store/store.c ../src/utils/store/flash_port_host.c
+// Uso:
+//     ./queue_check
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "queue.h"
+#include "store.h"
+
+// arquivo da flash simulada, apagado antes de cada conferência
+#define CHECK_FLASH_PATH "queue_check_flash.bin"
+
+#define CHECK_RANDOM_STEPS 200000
+// passos, em média, entre o início e o fim de uma falta do servidor
+#define CHECK_OUTAGE_EVERY 300
+
+// amostras enfileiradas (a de número n tem timestamp n, para conferir o conteúdo de cada lote)
+static uint32_t pushed = 0;
+// última sequência confirmada e lotes em voo (última sequência de cada um)
+static uint32_t acked = 0;
+static uint32_t inflight_last[QUEUE_MAX_IN_FLIGHT];
+static uint8_t inflight = 0;
+
+// Flash nova, montada, e fila vazia
+static bool fresh_queue(void) {
+    remove(CHECK_FLASH_PATH);
+    if (!store_mount()) return false;
+    queue_init();
+    pushed = 0;
+    acked = 0;
+    inflight = 0;
+    return true;
+}
+
+static void push(void) {
+    SensorSample sample;
+    pushed++;
+    sample_make(&sample, pushed, 20, 50, 10.0f);
+    queue_push(&sample, 0x7);
+}
+
+// Separa o próximo lote e confere que ele continua a sequência sem lacunas; retorna o tamanho do
+// lote ou -1 se algo divergir
+static int next_batch(uint16_t max_entries) {
+    QueueEntry entries[QUEUE_BATCH_SIZE];
+    uint16_t count = queue_next_batch(entries, max_entries);
+    if (count == 0) return 0;
+
+    uint32_t expected = inflight > 0 ? inflight_last[inflight - 1] + 1 : acked + 1;
+    for (uint16_t i = 0; i < count; i++) {
+        if (entries[i].seq != expected + i || entries[i].sample.timestamp_s != expected + i) {
+            printf("lote com a sequencia %lu (timestamp %lu) no lugar de %lu\n", (unsigned long) entries[i].seq,
+                   (unsigned long) entries[i].sample.timestamp_s, (unsigned long) (expected + i));
+            return -1;
+        }
+    }
+    inflight_last[inflight++] = entries[count - 1].seq;
+    return count;
+}
+
+static void ack(void) {
+    if (inflight == 0) return;
+    queue_ack();
+    acked = inflight_last[0];
+    inflight--;
+    memmove(inflight_last, inflight_last + 1, inflight * sizeof(inflight_last[0]));
+}
+
+static void nack(void) {
+    queue_nack();
+    inflight = 0;
+}
+
+// Envia e confirma tudo o que falta; confere que todas as amostras foram confirmadas e a fila esvaziou
+static int drain(void) {
+    for (uint32_t guard = 0; guard < pushed + 2; guard++) {
+        int count = next_batch(QUEUE_BATCH_SIZE);
+        if (count < 0) return 1;
+        if (count == 0 && inflight == 0) break;
+        ack();
+    }
+    if (acked != pushed || queue_pending() != 0) {
+        printf("%lu de %lu amostras confirmadas, %lu pendentes\n", (unsigned long) acked, (unsigned long) pushed,
+               (unsigned long) queue_pending());
+        return 1;
+    }
+    return 0;
+}
+
+// RAM cheia com a entrada mais antiga em voo: as amostras seguintes ficam só na flash, depois da
+// última entrada em RAM, e a próxima já volta para a RAM; o lote seguinte precisa incluir a lacuna
+static int check_full_ring_in_flight(void) {
+    if (!fresh_queue()) return 1;
+
+    for (uint32_t i = 0; i < QUEUE_CAPACITY; i++) push();
+    if (next_batch(QUEUE_BATCH_SIZE) < 0) return 1;
+    push();     // só na flash: a entrada mais antiga da RAM está em voo
+    push();
+    if (next_batch(QUEUE_BATCH_SIZE) < 0) return 1;
+    ack();
+    push();     // de volta à RAM, com as duas anteriores faltando nela
+    if (next_batch(QUEUE_BATCH_SIZE) < 0) return 1;
+    ack();
+    ack();
+    return drain();
+}
+
+// leituras, lotes de tamanhos variados, confirmações e devoluções em ordem aleatória, com períodos sem
+// resposta do servidor (a RAM enche com lotes em voo) que terminam com a confirmação ou a devolução deles
+static int check_random(void) {
+    if (!fresh_queue()) return 1;
+    srand(1);
+
+    bool outage = false;
+    for (uint32_t step = 0; step < CHECK_RANDOM_STEPS; step++) {
+        if (rand() % CHECK_OUTAGE_EVERY == 0) {
+            outage = !outage;
+            // o servidor volta: o lote mais antigo que ficou em voo é confirmado ou todos são devolvidos
+            if (!outage) {
+                if (rand() % 2) ack();
+                else nack();
+            }
+        }
+
+        int action = rand() % 10;
+        if (action < 4) {
+            push();
+        } else if (action < 7) {
+            if (next_batch(1 + rand() % QUEUE_BATCH_SIZE) < 0) return 1;
+        } else if (outage) {
+            continue;
+        } else if (action < 9) {
+            ack();
+        } else {
+            nack();
+        }
+    }
+    return drain();
+}
+
+int main(void) {
+    static const struct {
+        const char *name;
+        int (*run)(void);
+    } checks[] = {
+        {"RAM cheia com o lote mais antigo em voo", check_full_ring_in_flight},
+        {"sequencia aleatoria", check_random},
+    };
+    int failures = 0;
+
+    setenv("STATION_FLASH_SIM", CHECK_FLASH_PATH, 1);
+    for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+        int result = checks[i].run();
+        printf("%-45s %s\n", checks[i].name, result ? "FALHOU" : "ok");
+        failures += result;
+    }
+    remove(CHECK_FLASH_PATH);
+
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures != 0;
+}
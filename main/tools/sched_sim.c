@@ -0,0 +1,280 @@
+// Simulação (no computador) do agendador orientado a eventos, com relógio virtual.
+//
+// Roda o mesmo agendador do firmware (src/utils/sched) com tarefas equivalentes às da estação:
+// interface (botão pede leitura e avança as telas), sensores, rede e terminal, com o custo das
+// operações lentas (leitura do DHT11, envio do framebuffer ao display) simulado no relógio virtual.
+// Os toques no botão chegam como interrupções no meio desse trabalho. O mesmo roteiro de toques é
+// aplicado ao laço antigo (estado global consultado a cada sleep_ms(1000) e telas redesenhadas sem
+// parar enquanto exibidas), para comparar a latência do botão até a tela e a carga da CPU.
+//
+// Compilação (a partir de main/tools):
+//     gcc -O2 -I../src/utils/sched -I../src/utils/hal -o sched_sim sched_sim.c ../src/utils/sched/sched.c ../src/utils/hal/hal_host.c
+// Uso:
+//     ./sched_sim [horas simuladas]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sched.h"
+
+// custos simulados (ms)
+#define SIM_READ_MS 25              // pulso de início e 40 bits do DHT11, ADC do MQ-135
+#define SIM_DRAW_MS 25              // 1 KB de framebuffer pelo I2C a 400 kHz
+#define SIM_NETWORK_MS 1            // radio_update e server_process_queue sem envio
+#define SIM_CONSOLE_MS 1            // memória, comandos e log
+#define SIM_LOOP_SLEEP_MS 1000      // sleep_ms do laço antigo
+#define SIM_PERIOD_MS 1000          // período das tarefas de rede e do terminal
+
+#define SIM_MAX_PRESSES 4096
+#define SIM_SCREENS 3
+
+// roteiro de toques (ms)
+static uint32_t presses[SIM_MAX_PRESSES];
+static int press_count = 0;
+static int press_next = 0;
+
+// medições do modelo com eventos
+static uint64_t busy_ms = 0;
+static uint32_t screens_drawn = 0;
+static uint64_t latency_total_us = 0;
+static uint32_t latency_max_us = 0;
+static uint32_t button_posted_us = 0;
+static int current_info = 0;
+
+// Gerador pseudoaleatório determinístico (LCG)
+static uint32_t sim_random(void) {
+    static uint32_t state = 12345;
+    state = state * 1103515245u + 12345u;
+    return state >> 8;
+}
+
+// Toques com intervalo de 0,5 a 20 s ao longo da simulação
+static void sim_make_presses(uint32_t duration_ms) {
+    uint32_t at = 2000;
+    while (press_count < SIM_MAX_PRESSES && at < duration_ms) {
+        presses[press_count++] = at;
+        at += 500 + sim_random() % 19500;
+    }
+}
+
+// Interrupção do botão: posta os toques que já aconteceram no relógio virtual
+static void sim_irq(void) {
+    while (press_next < press_count && presses[press_next] <= sched_now_ms()) {
+        sched_post(EVENT_INPUT, 0);
+        press_next++;
+    }
+}
+
+// Trabalho ocupando a CPU por ms, com as interrupções chegando no meio dele
+static void sim_work(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        sched_clock_advance_ms(1);
+        sim_irq();
+    }
+    busy_ms += ms;
+}
+
+static void sim_screen(void) {
+    sim_work(SIM_DRAW_MS);
+    uint32_t latency = (uint32_t) sched_now_ms() * 1000 - button_posted_us;
+    latency_total_us += latency;
+    if (latency > latency_max_us) latency_max_us = latency;
+    screens_drawn++;
+}
+
+static void ui_task_run(Task *task, const Event *event) {
+    TASK_BEGIN();
+    while (true) {
+        TASK_WAIT_EVENT(EVENT_INPUT);
+        button_posted_us = event->posted_us;
+        sched_post(EVENT_READ, 0);
+        TASK_WAIT_EVENT(EVENT_SAMPLE);
+
+        for (current_info = 0; current_info < SIM_SCREENS; current_info++) {
+            sim_screen();
+            TASK_WAIT_EVENT(EVENT_INPUT);
+            button_posted_us = event->posted_us;
+        }
+        current_info = 0;
+        sim_screen();
+    }
+    TASK_END();
+}
+
+static void sensor_task_run(Task *task, const Event *event) {
+    TASK_BEGIN();
+    while (true) {
+        TASK_WAIT_EVENT(EVENT_READ);
+        sim_work(SIM_READ_MS);
+        sched_post(EVENT_SAMPLE, 1);
+    }
+    TASK_END();
+}
+
+static void network_task_run(Task *task, const Event *event) {
+    TASK_BEGIN();
+    while (true) {
+        sim_work(SIM_NETWORK_MS);
+        TASK_WAIT(SIM_PERIOD_MS);
+    }
+    TASK_END();
+}
+
+static void console_task_run(Task *task, const Event *event) {
+    TASK_BEGIN();
+    while (true) {
+        sim_work(SIM_CONSOLE_MS);
+        TASK_WAIT(SIM_PERIOD_MS);
+    }
+    TASK_END();
+}
+
+// Modelo com eventos: o agendador do firmware, dormindo até o próximo prazo ou toque
+static uint32_t simulate_events(uint32_t duration_ms, uint32_t *wakeups) {
+    static Task ui_task, sensor_task, network_task, console_task;
+    sched_add(&ui_task, "interface", ui_task_run, EVENT_BIT(EVENT_INPUT) | EVENT_BIT(EVENT_SAMPLE));
+    sched_add(&sensor_task, "sensores", sensor_task_run, EVENT_BIT(EVENT_READ));
+    sched_add(&network_task, "rede", network_task_run, EVENT_BIT(EVENT_SAMPLE) | EVENT_BIT(EVENT_NETWORK));
+    sched_add(&console_task, "terminal", console_task_run, EVENT_BIT(EVENT_SAMPLE) | EVENT_BIT(EVENT_SERIAL));
+
+    *wakeups = 0;
+    while (sched_now_ms() < duration_ms) {
+        sim_irq();
+        if (sched_run_once()) continue;
+
+        // ocioso: o __wfe() termina no próximo prazo ou na próxima interrupção
+        uint32_t wake_ms = duration_ms;
+        uint32_t deadline_ms;
+        if (sched_next_deadline(&deadline_ms) && deadline_ms < wake_ms) wake_ms = deadline_ms;
+        if (press_next < press_count && presses[press_next] < wake_ms) wake_ms = presses[press_next];
+        if (wake_ms > sched_now_ms()) sched_clock_advance_ms(wake_ms - sched_now_ms());
+        (*wakeups)++;
+    }
+    return screens_drawn;
+}
+
+// Modelo antigo: estado global consultado a cada volta do laço, com sleep_ms(1000) no fim
+static void simulate_polled(uint32_t duration_ms, double *latency_mean_ms, uint32_t *latency_max_ms, double *load,
+                            uint32_t *screens) {
+    uint64_t now = 0;
+    uint64_t busy = 0;
+    uint64_t latency_total = 0;
+    int next = 0;
+    *latency_max_ms = 0;
+    *screens = 0;
+
+    while (now < duration_ms) {
+        // toque durante o sleep (estado IDLE): percebido só na próxima volta
+        if (next < press_count && presses[next] <= now) {
+            uint32_t pressed = presses[next++];
+            now += SIM_READ_MS;
+            busy += SIM_READ_MS;
+
+            // show_data_on_display: redesenha a tela atual sem parar até o terceiro toque
+            uint32_t shown_press = pressed;
+            for (int info = 0; info < SIM_SCREENS; info++) {
+                now += SIM_DRAW_MS;
+                busy += SIM_DRAW_MS;
+                uint32_t latency = (uint32_t) (now - shown_press);
+                latency_total += latency;
+                if (latency > *latency_max_ms) *latency_max_ms = latency;
+                (*screens)++;
+
+                if (next >= press_count) {
+                    // sem mais toques: a tela fica sendo redesenhada até o fim da simulação
+                    busy += duration_ms > now ? duration_ms - now : 0;
+                    now = duration_ms;
+                    shown_press = 0;
+                    break;
+                }
+                // a tela é redesenhada até o toque; o toque muda a tela no redesenho seguinte
+                uint64_t press_at = presses[next] > now ? presses[next] : now;
+                uint64_t redraws = (press_at - now + SIM_DRAW_MS - 1) / SIM_DRAW_MS;
+                busy += redraws * SIM_DRAW_MS;
+                now += redraws * SIM_DRAW_MS;
+                shown_press = presses[next++];
+            }
+
+            if (shown_press == 0) break;
+
+            // tela inicial
+            now += SIM_DRAW_MS;
+            busy += SIM_DRAW_MS;
+            uint32_t latency = (uint32_t) (now - shown_press);
+            latency_total += latency;
+            if (latency > *latency_max_ms) *latency_max_ms = latency;
+            (*screens)++;
+        }
+
+        // envio da fila, terminal e o sleep do fim da volta
+        now += SIM_NETWORK_MS + SIM_CONSOLE_MS;
+        busy += SIM_NETWORK_MS + SIM_CONSOLE_MS;
+        now += SIM_LOOP_SLEEP_MS;
+    }
+
+    *latency_mean_ms = *screens ? (double) latency_total / *screens : 0;
+    *load = (double) busy / (now > 0 ? now : 1);
+}
+
+// Conferências do agendador isolado: ordem de entrega, sinais agrupados e prazos
+static bool check(void) {
+    SchedStats before;
+    sched_get_stats(&before);
+
+    sched_signal(EVENT_NETWORK);
+    sched_signal(EVENT_NETWORK);
+    SchedStats after;
+    sched_get_stats(&after);
+    if (after.coalesced != before.coalesced + 1) {
+        printf("FALHA: sinais iguais na fila deveriam ser agrupados\n");
+        return false;
+    }
+
+    // a fila cheia descarta e conta
+    for (int i = 0; i < SCHED_QUEUE_SIZE + 4; i++) sched_post(EVENT_SERIAL, i);
+    sched_get_stats(&after);
+    if (after.dropped < before.dropped + 4) {
+        printf("FALHA: fila cheia deveria descartar eventos\n");
+        return false;
+    }
+    while (sched_run_once()) {
+        uint32_t deadline_ms;
+        if (sched_next_deadline(&deadline_ms) && deadline_ms > sched_now_ms()) break;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    uint32_t hours = argc > 1 ? (uint32_t) atoi(argv[1]) : 1;
+    uint32_t duration_ms = (hours > 0 ? hours : 1) * 3600000u;
+    sim_make_presses(duration_ms);
+
+    double polled_mean_ms, polled_load;
+    uint32_t polled_max_ms, polled_screens;
+    simulate_polled(duration_ms, &polled_mean_ms, &polled_max_ms, &polled_load, &polled_screens);
+
+    uint32_t wakeups;
+    uint32_t screens = simulate_events(duration_ms, &wakeups);
+    double events_load = (double) busy_ms / sched_now_ms();
+
+    printf("%lu toques em %lu h\n", (unsigned long) press_count, (unsigned long) hours);
+    printf("%-18s %8s %12s %12s %10s\n", "modelo", "telas", "media", "max", "carga CPU");
+    printf("%-18s %8lu %10.1fms %10lums %9.1f%%\n", "laco com sleep", (unsigned long) polled_screens, polled_mean_ms,
+           (unsigned long) polled_max_ms, polled_load * 100);
+    printf("%-18s %8lu %10.1fms %10.1fms %9.1f%%\n", "eventos", (unsigned long) screens,
+           screens ? latency_total_us / 1000.0 / screens : 0, latency_max_us / 1000.0, events_load * 100);
+
+    SchedStats stats;
+    sched_get_stats(&stats);
+    printf("agendador: %lu eventos, %lu prazos, %lu despertares, latencia de entrega max %lu us\n",
+           (unsigned long) stats.dispatched, (unsigned long) stats.timeouts, (unsigned long) wakeups,
+           (unsigned long) stats.max_latency_us);
+
+    if (!check()) return 1;
+    if (screens == 0 || latency_max_us / 1000 > SIM_READ_MS + 2 * SIM_DRAW_MS) {
+        printf("FALHA: latencia do botao acima de uma leitura e duas telas\n");
+        return 1;
+    }
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,198 @@
+// Simulação (no computador) da estação inteira, com relógio virtual.
+//
+// Compila o main.c e todos os módulos do firmware sobre a HAL do computador (src/utils/hal/hal_host.c e
+// hal_net_host.c): o DHT11 responde com a forma de onda completa, lida pelo mesmo bit-banging, o MQ-135
+// devolve valores roteirizados no ADC, o display é emulado a partir dos comandos do SSD1306 e o lwIP é
+// ligado a sockets do sistema, então as amostras chegam a um servidor local de verdade. O roteiro clica
+// no botão do joystick a cada período (cada clique pede uma leitura), segue uma curva diária de
+// temperatura e umidade, deixa o DHT11 mudo de vez em quando e, com --outages, derruba o AP por alguns
+// minutos a cada 6 h. Sem CPU ocupada o relógio salta direto para o próximo prazo, então um dia da
+// estação roda em segundos; no fim é impresso o resumo (aceleração sobre o tempo real, amostras enviadas
+// e confirmadas, agendador, entradas, Wi-Fi) e a última tela do display.
+//
+// O servidor é o tools/ingest_standin (HTTP na porta 8080) ou, com -DSERVER_USE_UDP=1, o
+// tools/udp_receiver. MQTT e TLS não rodam no simulador. A API local da porta 80 fica na 10080.
+//
+// Compilação (a partir de main/tools):
+//     gcc -O2 -DSERVER_HOSTS='"127.0.0.1"' -I../src/utils/hal/host $(find ../src -maxdepth 2 -type d | sed 's/^/-I/') -o station_sim station_sim.c $(find ../src/utils ../src/drivers -name '*.c') -lm
+// Uso:
+//     ./station_sim [horas simuladas] [--period s] [--outages] [--offline] [--quiet]
+//         --period   intervalo entre as leituras pedidas pelo botão (padrão: 60 s)
+//         --outages  AP fora do ar por 10 min a cada 6 h
+//         --offline  sem servidor: não exige amostras confirmadas
+//         --quiet    descarta o terminal da estação (só o resumo é impresso)
+//     A flash simulada fica em station_sim_flash.bin (apagada no início) ou em $STATION_FLASH_SIM.
+
+#define _GNU_SOURCE
+
+#if SERVER_USE_MQTT || HTTP_CLIENT_TLS
+#error "o simulador da estação não suporta MQTT nem TLS"
+#endif
+
+// a aplicação da estação, com o main renomeado
+#define main station_main
+#include "../src/main.c"
+#undef main
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// roteiro
+#define SIM_DEFAULT_PERIOD_S 60
+#define SIM_PRESS_MS 80                 // tempo com o botão apertado em cada clique
+#define SIM_MUTE_EVERY 50               // a cada tantas leituras o DHT11 não responde
+#define SIM_OUTAGE_EVERY_MS (6 * 3600000ull)
+#define SIM_OUTAGE_MS (10 * 60000ull)
+#define SIM_DAY_MS (24 * 3600000.0)
+
+// canal do ADC do MQ-135
+#define SIM_MQ135_ADC 2
+
+#define SIM_FLASH_PATH "station_sim_flash.bin"
+
+static uint64_t sim_end_us = 0;
+static uint64_t sim_period_us = 0;
+static bool sim_outages = false;
+static bool sim_offline = false;
+
+static uint32_t sim_clicks = 0;
+static uint32_t sim_outages_done = 0;
+static FILE *sim_summary = NULL;
+static struct timespec sim_real_started;
+
+// Valores dos sensores no instante do clique: curva diária e ar pior no horário de pico
+static void sim_set_sensors(uint64_t now_us) {
+    double phase = 2 * M_PI * (now_us / 1000.0) / SIM_DAY_MS;
+    int temperature = (int) lround(24 + 6 * sin(phase));
+    int humidity = (int) lround(60 - 15 * sin(phase));
+    bool responding = sim_clicks % SIM_MUTE_EVERY != SIM_MUTE_EVERY - 1;
+
+    hal_sim_set_dht11(DHT_PIN, temperature, humidity, responding);
+    hal_sim_set_adc(SIM_MQ135_ADC, (uint16_t) lround(900 + 600 * (0.5 + 0.5 * sin(2 * phase))));
+}
+
+static void sim_release(void *arg) {
+    (void) arg;
+    hal_sim_set_button(JOYSTICK_SW, false);
+}
+
+static void sim_click(void *arg) {
+    (void) arg;
+    uint64_t now = hal_time_us_64();
+
+    sim_set_sensors(now);
+    hal_sim_set_button(JOYSTICK_SW, true);
+    hal_sim_schedule(now + SIM_PRESS_MS * 1000ull, sim_release, NULL);
+    sim_clicks++;
+
+    hal_sim_schedule(now + sim_period_us, sim_click, NULL);
+}
+
+static void sim_ap_up(void *arg) {
+    (void) arg;
+    hal_sim_set_ap(true);
+}
+
+static void sim_ap_down(void *arg) {
+    (void) arg;
+    uint64_t now = hal_time_us_64();
+
+    hal_sim_set_ap(false);
+    sim_outages_done++;
+    hal_sim_schedule(now + SIM_OUTAGE_MS * 1000, sim_ap_up, NULL);
+    hal_sim_schedule(now + SIM_OUTAGE_EVERY_MS * 1000, sim_ap_down, NULL);
+}
+
+// Fim do roteiro: resumo e saída (o agendador da estação não retorna com tarefas periódicas)
+static void sim_finish(void *arg) {
+    (void) arg;
+    struct timespec real_now;
+    clock_gettime(CLOCK_MONOTONIC, &real_now);
+    double real_s = (real_now.tv_sec - sim_real_started.tv_sec) + (real_now.tv_nsec - sim_real_started.tv_nsec) / 1e9;
+    double virtual_s = hal_time_us_64() / 1e6;
+
+    log_flush();
+    fflush(stdout);
+
+    QueueStats queue;
+    SchedStats sched;
+    InputStats input;
+    WifiStats wifi;
+    queue_get_stats(&queue);
+    sched_get_stats(&sched);
+    input_get_stats(&input);
+    wifi_get_stats(&wifi);
+
+    fprintf(sim_summary, "\n==== SIMULACAO ====\n");
+    fprintf(sim_summary, "tempo: %.0f s simulados em %.2f s reais (%.0fx), CPU ociosa %.2f%%\n", virtual_s, real_s,
+            real_s > 0 ? virtual_s / real_s : 0, virtual_s > 0 ? hal_sim_idle_us() / 1e4 / virtual_s : 0);
+    fprintf(sim_summary, "roteiro: %lu cliques, %lu quedas do AP\n", (unsigned long) sim_clicks, (unsigned long) sim_outages_done);
+    fprintf(sim_summary, "fila: %lu amostras, %lu confirmadas em %lu lotes, %lu reenvios, %lu descartadas\n",
+            (unsigned long) queue.pushed, (unsigned long) queue.acked, (unsigned long) queue.batches,
+            (unsigned long) queue.retries, (unsigned long) queue.dropped);
+    fprintf(sim_summary, "agendador: %lu eventos, %lu prazos, %lu despertares, latencia de entrega max %lu us\n",
+            (unsigned long) sched.dispatched, (unsigned long) sched.timeouts, (unsigned long) sched.wakeups,
+            (unsigned long) sched.max_latency_us);
+    fprintf(sim_summary, "entradas: %lu bordas, %lu gestos, %lu bounces\n", (unsigned long) input.edges,
+            (unsigned long) input.gestures, (unsigned long) input.bounces);
+    fprintf(sim_summary, "wi-fi: %lu associacoes completas, %lu rapidas, %lu quedas do enlace\n",
+            (unsigned long) wifi.full_joins, (unsigned long) wifi.fast_joins, (unsigned long) wifi.link_losses);
+    fprintf(sim_summary, "display: %llu bytes pelo I2C, ultima tela:\n", (unsigned long long) hal_sim_display_bytes());
+    hal_sim_display_dump(sim_summary);
+
+    int status = 0;
+    if (queue.pushed == 0) {
+        fprintf(sim_summary, "FALHA: nenhuma amostra registrada\n");
+        status = 1;
+    } else if (!sim_offline && queue.acked == 0) {
+        fprintf(sim_summary, "FALHA: nenhuma amostra confirmada pelo servidor\n");
+        status = 1;
+    } else {
+        fprintf(sim_summary, "ok\n");
+    }
+    fflush(sim_summary);
+    exit(status);
+}
+
+int main(int argc, char **argv) {
+    double hours = 1;
+    double period_s = SIM_DEFAULT_PERIOD_S;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--period") == 0 && i + 1 < argc) period_s = atof(argv[++i]);
+        else if (strcmp(argv[i], "--outages") == 0) sim_outages = true;
+        else if (strcmp(argv[i], "--offline") == 0) sim_offline = true;
+        else if (strcmp(argv[i], "--quiet") == 0) quiet = true;
+        else hours = atof(argv[i]);
+    }
+    if (hours <= 0) hours = 1;
+    if (period_s < 1) period_s = 1;
+    sim_end_us = (uint64_t) (hours * 3600e6);
+    sim_period_us = (uint64_t) (period_s * 1e6);
+
+    // flash simulada nova a cada execução, para resultados comparáveis
+    if (getenv("STATION_FLASH_SIM") == NULL) {
+        remove(SIM_FLASH_PATH);
+        setenv("STATION_FLASH_SIM", SIM_FLASH_PATH, 0);
+    }
+
+    // o resumo vai para a saída original, mesmo com o terminal da estação descartado
+    sim_summary = fdopen(dup(STDOUT_FILENO), "w");
+    if (quiet) freopen("/dev/null", "w", stdout);
+
+    // boot com o sensor respondendo e o ar no meio da escala
+    sim_set_sensors(0);
+    hal_sim_schedule(sim_period_us, sim_click, NULL);
+    if (sim_outages) hal_sim_schedule(SIM_OUTAGE_EVERY_MS * 1000, sim_ap_down, NULL);
+    hal_sim_schedule(sim_end_us, sim_finish, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &sim_real_started);
+    station_main();
+
+    // só chega aqui se nada mais puder acontecer antes do fim do roteiro
+    sim_finish(NULL);
+    return 0;
+}
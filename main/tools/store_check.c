@@ -0,0 +1,432 @@
+// Conferência e benchmark (no computador) do log de registros na flash (src/utils/store).
+//
+// O store roda sobre uma porta de flash em RAM, com a semântica da NOR flash (apagamento em 0xFF,
+// programação só zera bits) e com queda de energia simulada: a porta pode ser cortada numa
+// programação qualquer, que fica pela metade ou nem acontece, e a "placa" é remontada em seguida.
+// São conferidos: gravação e leitura de volta, remontagem, rodízio com reciclagem de segmentos,
+// montagem após gravação interrompida (antes, no meio do payload e no meio do cabeçalho), rejeição
+// de registro com CRC inválido e reciclagem quando o segmento seguinte está inválido (o log deve
+// recomeçar no próximo segmento válido, sem descartar o restante do backlog).
+//
+// O benchmark mede a vazão de gravação, os bytes e páginas programadas por registro, os
+// apagamentos e o desgaste, e o tempo de montagem; o tempo no dispositivo é estimado pelas
+// operações contadas com os tempos típicos da flash do Pico W (W25Q16JV).
+//
+// Compilação (a partir de main/tools):
+//     gcc -O2 -I../src/utils/store -o store_check store_check.c ../src/utils/store/store.c
+// Uso:
+//     ./store_check
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "store.h"
+
+// tempos típicos do W25Q16JV: programação de uma página e apagamento de um setor
+#define CHECK_PAGE_PROGRAM_US 400
+#define CHECK_SECTOR_ERASE_US 45000
+
+// tamanho do registro gravado pela fila (amostra compactada + máscara de canais)
+#define CHECK_RECORD_SIZE 13
+
+#define CHECK_BENCH_RECORDS 200000
+#define CHECK_BENCH_ACK_EVERY 10
+
+// flash simulada em RAM
+static uint8_t flash[STORE_REGION_SIZE];
+static uint32_t region_length = 0;
+
+// operações contadas desde o último port_reset_counters
+static uint64_t programs = 0;
+static uint64_t erases = 0;
+static uint64_t bytes_read = 0;
+
+// queda de energia: programações que ainda completam antes do corte (-1 = sem corte); com torn, a
+// programação cortada grava só a primeira metade dos bytes; depois do corte nada mais é gravado
+static int32_t cut_after = -1;
+static bool torn = false;
+static bool powered = true;
+
+// porta de flash em RAM
+
+bool flash_port_init(uint32_t region_size) {
+    // reinicialização da placa: a energia volta, o conteúdo da flash permanece
+    region_length = region_size;
+    powered = true;
+    cut_after = -1;
+    return region_size <= sizeof(flash);
+}
+
+void flash_port_read(uint32_t offset, void *dst, size_t len) {
+    memcpy(dst, flash + offset, len);
+    bytes_read += len;
+}
+
+bool flash_port_program(uint32_t offset, const void *src, size_t len) {
+    if (!powered || offset % FLASH_PORT_PAGE_SIZE != 0 || len % FLASH_PORT_PAGE_SIZE != 0 || offset + len > region_length) {
+        return false;
+    }
+
+    size_t applied = len;
+    if (cut_after == 0) {
+        powered = false;
+        applied = torn ? len / 2 : 0;
+    } else if (cut_after > 0) {
+        cut_after--;
+    }
+
+    const uint8_t *data = (const uint8_t *) src;
+    for (size_t i = 0; i < applied; i++) flash[offset + i] &= data[i];
+    programs++;
+    return powered;
+}
+
+bool flash_port_erase(uint32_t offset) {
+    if (!powered || offset % FLASH_PORT_SECTOR_SIZE != 0 || offset + FLASH_PORT_SECTOR_SIZE > region_length) {
+        return false;
+    }
+    memset(flash + offset, 0xFF, FLASH_PORT_SECTOR_SIZE);
+    erases++;
+    return true;
+}
+
+uint64_t flash_port_time_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000u + now.tv_nsec / 1000;
+}
+
+// Região inteira apagada, como numa placa nova
+static void port_format(void) {
+    memset(flash, 0xFF, sizeof(flash));
+}
+
+static void port_reset_counters(void) {
+    programs = erases = bytes_read = 0;
+}
+
+// sequências gravadas com um payload alternativo: o registro perdido numa queda de energia tem a
+// mesma sequência do que é gravado depois da remontagem, e só com conteúdos diferentes uma gravação
+// por cima do payload órfão aparece na leitura
+static uint32_t salted_from = 0;
+static uint32_t salted_until = 0;
+
+// Payload único de cada sequência (bytes sem zeros, para que um bit invertido sempre seja visível)
+static void make_payload(uint32_t seq, uint8_t *payload, uint8_t len) {
+    for (uint8_t i = 0; i < len; i++) payload[i] = (uint8_t) (0x80 | ((seq >> (i % 4 * 8)) + i * 37));
+    if (len >= 4) memcpy(payload, &seq, 4);
+    if (seq >= salted_from && seq <= salted_until) {
+        for (uint8_t i = 0; i < len; i++) payload[i] ^= 0x2A;
+    }
+}
+
+static uint8_t payload_len(uint32_t seq) {
+    return (uint8_t) (4 + seq % (STORE_MAX_PAYLOAD - 3));
+}
+
+// Lê todo o backlog e confere sequências contíguas a partir de first_seq e os payloads;
+// retorna a quantidade de registros lidos ou -1 se algo divergir
+static int read_back(uint32_t first_seq, uint8_t fixed_len) {
+    StoreCursor cursor;
+    uint8_t payload[STORE_MAX_PAYLOAD], expected[STORE_MAX_PAYLOAD];
+    uint8_t len;
+    uint32_t seq, wanted = first_seq;
+    int count = 0;
+
+    store_cursor_begin(&cursor);
+    while (store_read_next(&cursor, payload, &len, &seq)) {
+        uint8_t expected_len = fixed_len ? fixed_len : payload_len(seq);
+        make_payload(seq, expected, expected_len);
+        if (seq != wanted || len != expected_len || memcmp(payload, expected, len) != 0) {
+            printf("  registro %u lido errado (esperado %u)\n", seq, wanted);
+            return -1;
+        }
+        wanted++;
+        count++;
+    }
+    return count;
+}
+
+// Grava o registro da sequência; retorna a sequência (0 em erro)
+static uint32_t append(uint32_t seq, uint8_t fixed_len) {
+    uint8_t payload[STORE_MAX_PAYLOAD];
+    uint8_t len = fixed_len ? fixed_len : payload_len(seq);
+    make_payload(seq, payload, len);
+    return store_append(seq, payload, len) ? seq : 0;
+}
+
+// gravação, leitura de volta, confirmação e remontagem (que conta um novo boot)
+static int check_append_read(void) {
+    int failures = 0;
+    port_format();
+    if (!store_mount()) return 1;
+
+    for (uint32_t seq = 1; seq <= 500; seq++) {
+        if (append(seq, 0) != seq) {
+            printf("  gravacao %u falhou\n", seq);
+            return 1;
+        }
+    }
+    if (read_back(1, 0) != 500) failures++;
+
+    store_ack(200);
+    if (store_pending() != 300 || read_back(201, 0) != 300) failures++;
+
+    // remontagem: confirmação e ponto de escrita recuperados da flash
+    if (!store_mount() || store_acked_seq() != 200 || store_pending() != 300 || read_back(201, 0) != 300
+        || store_boot_id() != 2) {
+        printf("  estado perdido na remontagem\n");
+        failures++;
+    }
+    if (append(501, 0) != 501 || read_back(201, 0) != 301) failures++;
+    return failures;
+}
+
+// rodízio: sem confirmações o segmento mais antigo é reciclado e o backlog restante continua legível;
+// com confirmações nada é descartado e o desgaste fica igual entre os segmentos
+static int check_wrap(void) {
+    int failures = 0;
+    StoreStats stats;
+    uint32_t total = 20000;
+
+    port_format();
+    store_mount();
+    for (uint32_t seq = 1; seq <= total; seq++) {
+        if (append(seq, CHECK_RECORD_SIZE) != seq) {
+            printf("  gravacao %u falhou\n", seq);
+            return 1;
+        }
+    }
+    store_get_stats(&stats);
+    uint32_t acked = store_acked_seq();
+    if (stats.dropped == 0 || stats.dropped != acked || store_pending() != total - acked
+        || read_back(acked + 1, CHECK_RECORD_SIZE) != (int) (total - acked)) {
+        printf("  reciclagem sem confirmacoes: %u descartados, %u pendentes\n", stats.dropped, store_pending());
+        failures++;
+    }
+    // o boot sobrevive à reciclagem do segmento em que a montagem o gravou
+    if (!store_mount() || store_acked_seq() != acked || read_back(acked + 1, CHECK_RECORD_SIZE) != (int) (total - acked)
+        || store_boot_id() != 2) {
+        printf("  backlog ou boot perdido na remontagem apos o rodizio\n");
+        failures++;
+    }
+
+    port_format();
+    store_mount();
+    for (uint32_t seq = 1; seq <= 5 * total; seq++) {
+        append(seq, CHECK_RECORD_SIZE);
+        if (seq % 100 == 0) store_ack(seq - 50);
+    }
+    store_get_stats(&stats);
+    if (stats.dropped != 0 || stats.max_erase_count - stats.min_erase_count > 1) {
+        printf("  com confirmacoes: %u descartados, apagamentos entre %u e %u\n", stats.dropped,
+               stats.min_erase_count, stats.max_erase_count);
+        failures++;
+    }
+    return failures;
+}
+
+// queda de energia em cada ponto de uma gravação: a montagem seguinte preserva o que foi gravado e
+// as próximas gravações continuam legíveis (o registro interrompido é perdido)
+static int check_power_loss(void) {
+    int failures = 0;
+
+    for (int cut = 0; cut < 3; cut++) {
+        for (int half = 0; half < 2; half++) {
+            port_format();
+            store_mount();
+            uint32_t seq = 1;
+            for (; seq <= 10; seq++) append(seq, CHECK_RECORD_SIZE);
+
+            // corte na programação de número cut a partir daqui (payload, cabeçalho ou registro seguinte)
+            cut_after = cut;
+            torn = half;
+            salted_from = seq;
+            salted_until = UINT32_MAX;
+            while (append(seq, CHECK_RECORD_SIZE) == seq) seq++;
+
+            // o registro interrompido pode ter chegado inteiro à flash (só a confirmação do corte
+            // se perdeu) ou ter sumido, mas nunca aparece corrompido
+            StoreStats stats;
+            if (!store_mount()) {
+                failures++;
+                continue;
+            }
+            store_get_stats(&stats);
+            uint32_t kept = store_next_seq() - 1;
+            salted_until = kept;
+            if (kept < seq - 1 || kept > seq || store_pending() != kept || read_back(1, CHECK_RECORD_SIZE) != (int) kept) {
+                printf("  corte %d%s: %u pendentes, esperado %u ou %u\n", cut, half ? " pela metade" : "", store_pending(),
+                       seq - 1, seq);
+                failures++;
+                continue;
+            }
+
+            // as gravações seguintes recebem as sequências seguintes e continuam legíveis após outra remontagem
+            for (uint32_t i = 1; i <= 5; i++) append(kept + i, CHECK_RECORD_SIZE);
+            store_mount();
+            if (read_back(1, CHECK_RECORD_SIZE) != (int) kept + 5) {
+                printf("  corte %d%s: gravacoes apos a remontagem ilegiveis (%u registros corrompidos)\n", cut,
+                       half ? " pela metade" : "", stats.corrupted);
+                failures++;
+            }
+        }
+    }
+    salted_from = salted_until = 0;
+    return failures;
+}
+
+// Procura o payload da sequência na flash; retorna o deslocamento ou -1
+static long find_payload(uint32_t seq, uint8_t len) {
+    uint8_t payload[STORE_MAX_PAYLOAD];
+    make_payload(seq, payload, len);
+    for (long offset = 0; offset + len <= (long) sizeof(flash); offset++) {
+        if (memcmp(flash + offset, payload, len) == 0) return offset;
+    }
+    return -1;
+}
+
+// bit invertido num registro: o registro não é entregue, o CRC inválido é contado e a leitura segue
+// no segmento seguinte (o restante do segmento corrompido é pulado)
+static int check_crc(void) {
+    port_format();
+    store_mount();
+    for (uint32_t seq = 1; seq <= 300; seq++) append(seq, CHECK_RECORD_SIZE);
+
+    long offset = find_payload(50, CHECK_RECORD_SIZE);
+    if (offset < 0) return 1;
+    flash[offset + 5] ^= 0x10;
+
+    StoreCursor cursor;
+    StoreStats stats;
+    uint8_t payload[STORE_MAX_PAYLOAD], expected[STORE_MAX_PAYLOAD], len;
+    uint32_t seq, last = 0, count = 0;
+    bool bad = false;
+    store_cursor_begin(&cursor);
+    while (store_read_next(&cursor, payload, &len, &seq)) {
+        make_payload(seq, expected, CHECK_RECORD_SIZE);
+        if (seq == 50 || seq <= last || memcmp(payload, expected, len) != 0) bad = true;
+        last = seq;
+        count++;
+    }
+    store_get_stats(&stats);
+    if (bad || stats.corrupted == 0 || last != 300 || count < 49) {
+        printf("  CRC: %u registros lidos, ultimo %u, %u corrompidos\n", count, last, stats.corrupted);
+        return 1;
+    }
+    return 0;
+}
+
+// reciclagem com o segmento seguinte inválido (cabeçalho corrompido): o log passa a começar no
+// próximo segmento válido e só os dois segmentos perdidos são descartados
+static int check_reclaim_invalid_following(void) {
+    uint32_t first_seq[STORE_SEGMENT_COUNT + 1];
+    StoreStats stats;
+
+    port_format();
+    store_mount();
+    port_reset_counters();
+
+    // preenche todos os segmentos, anotando a primeira sequência de cada um
+    first_seq[0] = 1;
+    uint32_t seq = 1;
+    uint64_t opened = 0;
+    while (true) {
+        uint64_t before = erases;
+        if (append(seq, CHECK_RECORD_SIZE) != seq) return 1;
+        if (erases != before) {
+            if (++opened == STORE_SEGMENT_COUNT) break;     // o segmento 0 acabou de ser reciclado
+            first_seq[opened] = seq;
+        }
+        seq++;
+    }
+
+    // volta ao estado anterior à reciclagem: refaz tudo, parando um registro antes
+    uint32_t last_before_wrap = seq - 1;
+    port_format();
+    store_mount();
+    for (uint32_t i = 1; i <= last_before_wrap; i++) append(i, CHECK_RECORD_SIZE);
+
+    // cabeçalho do segmento 1 corrompido e remontagem
+    flash[1 * STORE_SEGMENT_SIZE] ^= 0x01;
+    store_mount();
+
+    // a próxima gravação recicla o segmento 0
+    if (append(last_before_wrap + 1, CHECK_RECORD_SIZE) != last_before_wrap + 1) return 1;
+    store_get_stats(&stats);
+
+    uint32_t boundary = first_seq[2] - 1;
+    uint32_t expected_pending = last_before_wrap + 1 - boundary;
+    if (store_acked_seq() != boundary || store_pending() != expected_pending
+        || read_back(first_seq[2], CHECK_RECORD_SIZE) != (int) expected_pending) {
+        printf("  reciclagem com segmento seguinte invalido: confirmado ate %u (esperado %u), %u pendentes (esperado %u)\n",
+               store_acked_seq(), boundary, store_pending(), expected_pending);
+        return 1;
+    }
+    return 0;
+}
+
+// vazão de gravação, páginas e apagamentos por registro, desgaste e tempo de montagem
+static void bench(void) {
+    StoreStats stats;
+
+    port_format();
+    port_reset_counters();
+    store_mount();
+    store_get_stats(&stats);
+    uint32_t empty_mount_us = stats.mount_us;
+    uint64_t empty_mount_read = bytes_read;
+
+    port_reset_counters();
+    uint64_t started = flash_port_time_us();
+    for (uint32_t seq = 1; seq <= CHECK_BENCH_RECORDS; seq++) {
+        append(seq, CHECK_RECORD_SIZE);
+        if (seq % CHECK_BENCH_ACK_EVERY == 0) store_ack(seq);
+    }
+    uint64_t elapsed = flash_port_time_us() - started;
+    store_get_stats(&stats);
+
+    double device_us = (double) programs * CHECK_PAGE_PROGRAM_US + (double) erases * CHECK_SECTOR_ERASE_US;
+    printf("gravacao: %u registros de %u bytes (ack a cada %u), %.0f ns/registro no computador\n",
+           CHECK_BENCH_RECORDS, CHECK_RECORD_SIZE, CHECK_BENCH_ACK_EVERY, elapsed * 1000.0 / CHECK_BENCH_RECORDS);
+    printf("  %.1f bytes e %.2f paginas programadas por registro, %.2f apagamentos a cada 1000 registros\n",
+           (double) stats.bytes_written / CHECK_BENCH_RECORDS, (double) programs / CHECK_BENCH_RECORDS,
+           erases * 1000.0 / CHECK_BENCH_RECORDS);
+    printf("  desgaste: apagamentos por segmento entre %u e %u\n", stats.min_erase_count, stats.max_erase_count);
+    printf("  estimativa no dispositivo: %.0f us/registro (%.0f registros/s)\n", device_us / CHECK_BENCH_RECORDS,
+           CHECK_BENCH_RECORDS / (device_us / 1e6));
+
+    port_reset_counters();
+    store_mount();
+    store_get_stats(&stats);
+    printf("montagem: vazia %u us (%llu bytes lidos), com o log cheio %u us (%llu bytes lidos)\n", empty_mount_us,
+           (unsigned long long) empty_mount_read, stats.mount_us, (unsigned long long) bytes_read);
+}
+
+int main(void) {
+    static const struct {
+        const char *name;
+        int (*run)(void);
+    } checks[] = {
+        {"gravacao e leitura", check_append_read},
+        {"rodizio", check_wrap},
+        {"queda de energia", check_power_loss},
+        {"CRC invalido", check_crc},
+        {"reciclagem com segmento seguinte invalido", check_reclaim_invalid_following},
+    };
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+        int result = checks[i].run();
+        printf("%-45s %s\n", checks[i].name, result ? "FALHOU" : "ok");
+        failures += result;
+    }
+
+    bench();
+    printf("%s (%d falhas)\n", failures ? "FALHOU" : "OK", failures);
+    return failures != 0;
+}
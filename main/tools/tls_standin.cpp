@@ -0,0 +1,223 @@
+// Terminador TLS local que fica na frente do ingest_standin durante os testes de bancada do HTTPS.
+//
+// Aceita conexões TLS 1.2 (o mesmo protocolo configurado no mbedtls_config.h da placa), repassa o
+// tráfego decifrado para o ingest_standin e, para cada conexão, imprime a duração do handshake do lado
+// do servidor e se a sessão foi retomada (id de sessão ou session ticket). O resumo acumulado mostra
+// quantos handshakes completos e retomados ocorreram, para conferir os números que a placa imprime
+// (linha "TLS:" no terminal serial: duração medida na placa e heap ocupado pelo mbedTLS).
+//
+// Certificado de teste (o nome ou IP usado em SERVER_HOSTS precisa constar no subjectAltName; o próprio
+// cert.pem vai em SERVER_TLS_CA_CERT):
+//     openssl req -x509 -newkey ec -pkeyopt ec_paramgen_curve:prime256v1 -nodes -days 365
+//         -keyout key.pem -out cert.pem -subj /CN=estacao-teste -addext subjectAltName=IP:192.168.0.10
+//
+// Compilação (no computador, não na placa):
+//     g++ -std=c++17 -O2 -pthread -o tls_standin tls_standin.cpp -lssl -lcrypto
+// Uso:
+//     ./tls_standin cert.pem key.pem [porta TLS, padrão 8443] [porta do ingest_standin, padrão 8080]
+//     ./tls_standin --probe host porta cert.pem [conexões]
+//         --probe  cliente de teste: conecta várias vezes reaproveitando a sessão e mostra a duração
+//                  do handshake completo e dos retomados
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Summary {
+    std::mutex lock;
+    unsigned full = 0;
+    unsigned resumed = 0;
+    double full_ms = 0;
+    double resumed_ms = 0;
+};
+
+Summary summary;
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int connect_to(const char *host, int port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &address.sin_addr) != 1) return -1;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool write_all(int fd, const char *data, ssize_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written <= 0) return false;
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+// Atende uma conexão: handshake, depois repasse nos dois sentidos até um dos lados fechar
+void serve(int client_fd, SSL_CTX *context, int backend_port, unsigned id) {
+    SSL *ssl = SSL_new(context);
+    SSL_set_fd(ssl, client_fd);
+
+    auto start = Clock::now();
+    if (SSL_accept(ssl) <= 0) {
+        std::printf("conexao %u: handshake falhou\n", id);
+        ERR_print_errors_fp(stdout);
+        SSL_free(ssl);
+        close(client_fd);
+        return;
+    }
+    double ms = elapsed_ms(start);
+    bool resumed = SSL_session_reused(ssl);
+
+    {
+        std::lock_guard<std::mutex> guard(summary.lock);
+        if (resumed) {
+            summary.resumed++;
+            summary.resumed_ms += ms;
+        } else {
+            summary.full++;
+            summary.full_ms += ms;
+        }
+        std::printf("conexao %u: handshake %s em %.1f ms (%s) | completos %u (media %.1f ms), retomados %u (media %.1f ms)\n",
+                    id, resumed ? "retomado" : "completo", ms, SSL_get_cipher(ssl),
+                    summary.full, summary.full ? summary.full_ms / summary.full : 0.0,
+                    summary.resumed, summary.resumed ? summary.resumed_ms / summary.resumed : 0.0);
+        std::fflush(stdout);
+    }
+
+    int backend_fd = connect_to("127.0.0.1", backend_port);
+    if (backend_fd < 0) std::printf("conexao %u: ingest_standin indisponivel na porta %d\n", id, backend_port);
+
+    char buffer[16384];
+    while (backend_fd >= 0) {
+        // dados já decifrados e guardados pelo OpenSSL não aparecem no poll
+        if (SSL_pending(ssl) == 0) {
+            pollfd fds[2] = {{client_fd, POLLIN, 0}, {backend_fd, POLLIN, 0}};
+            if (poll(fds, 2, -1) < 0) break;
+            if (fds[1].revents & (POLLIN | POLLHUP)) {
+                ssize_t length = read(backend_fd, buffer, sizeof(buffer));
+                if (length <= 0 || SSL_write(ssl, buffer, length) <= 0) break;
+            }
+            if (!(fds[0].revents & (POLLIN | POLLHUP))) continue;
+        }
+        int length = SSL_read(ssl, buffer, sizeof(buffer));
+        if (length <= 0 || !write_all(backend_fd, buffer, length)) break;
+    }
+
+    if (backend_fd >= 0) close(backend_fd);
+    SSL_shutdown(ssl);
+    SSL_free(ssl);
+    close(client_fd);
+}
+
+int run_server(const char *cert, const char *key, int port, int backend_port) {
+    SSL_CTX *context = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_set_min_proto_version(context, TLS1_2_VERSION);
+    SSL_CTX_set_max_proto_version(context, TLS1_2_VERSION);
+    if (SSL_CTX_use_certificate_chain_file(context, cert) != 1 || SSL_CTX_use_PrivateKey_file(context, key, SSL_FILETYPE_PEM) != 1) {
+        ERR_print_errors_fp(stderr);
+        return 1;
+    }
+
+    // cache de sessões no servidor (retomada por id) e session tickets (retomada sem estado no servidor)
+    static const unsigned char session_context[] = "estacao";
+    SSL_CTX_set_session_id_context(context, session_context, sizeof(session_context) - 1);
+    SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port);
+    if (bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listen_fd, 8) != 0) {
+        std::perror("bind");
+        return 1;
+    }
+    std::printf("TLS na porta %d, repassando para o ingest_standin na porta %d\n", port, backend_port);
+
+    for (unsigned id = 1;; id++) {
+        int client_fd = accept(listen_fd, nullptr, nullptr);
+        if (client_fd < 0) continue;
+        std::thread(serve, client_fd, context, backend_port, id).detach();
+    }
+}
+
+// Cliente de teste: um handshake completo seguido de handshakes oferecendo a sessão anterior
+int run_probe(const char *host, int port, const char *ca, int connections) {
+    SSL_CTX *context = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_max_proto_version(context, TLS1_2_VERSION);
+    SSL_CTX_set_verify(context, SSL_VERIFY_PEER, nullptr);
+    if (SSL_CTX_load_verify_locations(context, ca, nullptr) != 1) {
+        ERR_print_errors_fp(stderr);
+        return 1;
+    }
+
+    SSL_SESSION *session = nullptr;
+    for (int i = 0; i < connections; i++) {
+        int fd = connect_to(host, port);
+        if (fd < 0) {
+            std::perror("connect");
+            return 1;
+        }
+        SSL *ssl = SSL_new(context);
+        SSL_set_fd(ssl, fd);
+        if (session != nullptr) SSL_set_session(ssl, session);
+
+        auto start = Clock::now();
+        if (SSL_connect(ssl) <= 0) {
+            ERR_print_errors_fp(stderr);
+            return 1;
+        }
+        std::printf("handshake %d: %s em %.2f ms\n", i + 1, SSL_session_reused(ssl) ? "retomado" : "completo", elapsed_ms(start));
+
+        if (session != nullptr) SSL_SESSION_free(session);
+        session = SSL_get1_session(ssl);
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+        close(fd);
+    }
+    if (session != nullptr) SSL_SESSION_free(session);
+    SSL_CTX_free(context);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc >= 5 && std::strcmp(argv[1], "--probe") == 0) {
+        return run_probe(argv[2], std::atoi(argv[3]), argv[4], argc > 5 ? std::atoi(argv[5]) : 5);
+    }
+    if (argc < 3) {
+        std::fprintf(stderr, "uso: %s cert.pem key.pem [porta] [porta do ingest_standin]\n"
+                             "     %s --probe host porta cert.pem [conexoes]\n", argv[0], argv[0]);
+        return 1;
+    }
+    return run_server(argv[1], argv[2], argc > 3 ? std::atoi(argv[3]) : 8443, argc > 4 ? std::atoi(argv[4]) : 8080);
+}
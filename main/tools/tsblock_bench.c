@@ -0,0 +1,128 @@
+// Benchmark (no computador) do codec de séries temporais tsblock com traços realistas da estação.
+//
+// Gera três dias de leituras a cada 60 s (com jitter do laço principal): temperatura e umidade
+// com ciclo diário e ruído quantizado na resolução do DHT11, e poluição do MQ-135 com deriva lenta,
+// ruído do ADC e picos ocasionais. Verifica a decodificação e mede bytes por amostra e velocidade.
+//
+// Os tempos passam pela biblioteca prof (a mesma das sondas do dispositivo): cada rodada entra no
+// histograma com o tempo médio por amostra, e com --hist os histogramas são exibidos.
+//
+// Compilação (a partir de main/tools):
+//     gcc -O2 -I../src/utils/sample -I../src/utils/tsblock -I../src/utils/prof -o tsblock_bench
+//         tsblock_bench.c ../src/utils/tsblock/tsblock.c ../src/utils/sample/sample.c ../src/utils/prof/prof.c -lm
+// Uso:
+//     ./tsblock_bench [--hist]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tsblock.h"
+#include "prof.h"
+
+#define BENCH_SAMPLES (3 * 24 * 60)
+#define BENCH_ROUNDS 200
+#define BENCH_PI 3.14159265358979f
+
+// ruído gaussiano simples (Box-Muller)
+static float gaussian(void) {
+    float u1 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+    float u2 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * BENCH_PI * u2);
+}
+
+static void generate_trace(SensorSample *samples, int count) {
+    uint32_t timestamp = 1000;
+    float gas = 25.0f;
+
+    for (int i = 0; i < count; i++) {
+        float day = 2.0f * BENCH_PI * timestamp / 86400.0f;
+        float temperature = 23.0f + 6.0f * sinf(day) + 0.4f * gaussian();
+        float humidity = 60.0f - 15.0f * sinf(day) + 1.0f * gaussian();
+
+        gas += 0.02f * gaussian();
+        float pollution = gas + 0.3f * gaussian() + (rand() % 500 == 0 ? 20.0f : 0.0f);
+
+        sample_make(&samples[i], timestamp, (int) lroundf(temperature), (int) lroundf(humidity), pollution);
+        timestamp += 60 + (rand() % 5 == 0 ? 1 : 0);  // jitter do laço de 1 s
+    }
+}
+
+int main(int argc, char **argv) {
+    static SensorSample samples[BENCH_SAMPLES];
+    static SensorSample decoded[BENCH_SAMPLES];
+    static uint8_t blocks[BENCH_SAMPLES][TSBLOCK_SIZE];
+
+    srand(42);
+    generate_trace(samples, BENCH_SAMPLES);
+
+    // compressão
+    ProfHistogram encode_histogram;
+    prof_histogram_reset(&encode_histogram);
+    int block_count = 0;
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t start = prof_now_ns();
+        TsBlockEncoder encoder;
+        block_count = 0;
+        tsblock_encoder_init(&encoder, blocks[block_count++]);
+        for (int i = 0; i < BENCH_SAMPLES; i++) {
+            if (!tsblock_encoder_append(&encoder, &samples[i])) {
+                tsblock_encoder_init(&encoder, blocks[block_count++]);
+                tsblock_encoder_append(&encoder, &samples[i]);
+            }
+        }
+        prof_histogram_record(&encode_histogram, (prof_now_ns() - start) / BENCH_SAMPLES);
+    }
+    double encode_ns = (double) encode_histogram.total_ns / encode_histogram.count;
+
+    // descompressão (cada bloco decodificado de forma independente)
+    ProfHistogram decode_histogram;
+    prof_histogram_reset(&decode_histogram);
+    int decoded_count = 0;
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        uint64_t start = prof_now_ns();
+        decoded_count = 0;
+        for (int block = 0; block < block_count; block++) {
+            TsBlockDecoder decoder;
+            tsblock_decoder_init(&decoder, blocks[block]);
+            while (tsblock_decoder_next(&decoder, &decoded[decoded_count])) decoded_count++;
+        }
+        prof_histogram_record(&decode_histogram, (prof_now_ns() - start) / BENCH_SAMPLES);
+    }
+    double decode_ns = (double) decode_histogram.total_ns / decode_histogram.count;
+
+    if (decoded_count != BENCH_SAMPLES || memcmp(samples, decoded, sizeof(samples)) != 0) {
+        printf("ERRO: decodificacao diferente da entrada\n");
+        return 1;
+    }
+
+    double compressed = (double) block_count * TSBLOCK_SIZE;
+    double json = 0;
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        char buffer[128];
+        json += snprintf(buffer, sizeof(buffer), "{\"timestamp\":%u,\"temperature\":%d,\"humidity\":%d,\"pollutionLevel\":%u.%u}",
+            samples[i].timestamp_s, samples[i].temperature, samples[i].humidity,
+            samples[i].pollution_x10 / 10, samples[i].pollution_x10 % 10);
+    }
+
+    printf("amostras: %d em %d blocos de %d bytes (%.1f amostras/bloco)\n",
+        BENCH_SAMPLES, block_count, TSBLOCK_SIZE, (double) BENCH_SAMPLES / block_count);
+    printf("bytes/amostra: tsblock %.2f | compactado %d | JSON %.1f\n",
+        compressed / BENCH_SAMPLES, SAMPLE_PACKED_SIZE, json / BENCH_SAMPLES);
+    printf("taxa: %.1fx sobre o formato compactado, %.1fx sobre JSON\n",
+        SAMPLE_PACKED_SIZE * BENCH_SAMPLES / compressed, json / compressed);
+    printf("historico em %d blocos (%d bytes de RAM): %.1f horas a cada 60 s\n",
+        TSBLOCK_RING_BLOCKS, TSBLOCK_RING_BLOCKS * TSBLOCK_SIZE,
+        TSBLOCK_RING_BLOCKS * ((double) BENCH_SAMPLES / block_count) / 60.0);
+    printf("codificacao %.1f ns/amostra | decodificacao %.1f ns/amostra\n", encode_ns, decode_ns);
+
+    if (argc > 1 && strcmp(argv[1], "--hist") == 0) {
+        prof_histogram_print("codificacao (ns/amostra por rodada)", &encode_histogram);
+        prof_histogram_print("decodificacao (ns/amostra por rodada)", &decode_histogram);
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+// Receptor UDP local para o transporte UDP da estação, para comparar com o caminho TCP.
+//
+// Decodifica os datagramas com o mesmo datagram.c do firmware e imprime a cada segundo, por
+// estação: pacotes/s, amostras/s, datagramas perdidos (lacunas ainda abertas), reordenados
+// (chegaram depois de um posterior), duplicados e amostras repetidas.
+//
+// Com --ack responde ACK a cada datagrama que pede confirmação e NACK para cada lacuna detectada,
+// como o backend faria no modo com confirmação (SERVER_UDP_ACK). --drop descarta uma fração dos
+// datagramas recebidos para simular perdas no enlace.
+//
+// Compilação (no computador, não na placa):
+//     gcc -O2 -c -I../src/utils/sample -I../src/utils/server ../src/utils/server/datagram.c ../src/utils/sample/sample.c
+//     g++ -std=c++17 -O2 -I../src/utils/sample -I../src/utils/server -o udp_receiver udp_receiver.cpp datagram.o sample.o
+// Uso:
+//     ./udp_receiver [porta] [--ack] [--drop porcentagem]
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+
+extern "C" {
+#include "datagram.h"
+}
+
+namespace {
+
+struct Counters {
+    unsigned long packets = 0;
+    unsigned long samples = 0;
+    unsigned long bytes = 0;
+    unsigned long reordered = 0;
+    unsigned long duplicates = 0;
+    unsigned long repeated_samples = 0;
+};
+
+// estado de uma estação
+struct Station {
+    uint32_t highest = 0;               // maior sequência de datagrama recebida
+    std::set<uint32_t> missing;         // lacunas ainda não preenchidas
+    std::set<uint32_t> samples;         // sequências de amostras já recebidas
+    Counters window;
+    Counters total;
+};
+
+void send_control(int fd, const sockaddr_in &to, uint8_t type, uint16_t station, uint32_t seq) {
+    uint8_t buffer[DATAGRAM_HEADER_SIZE];
+    DatagramHeader header{};
+    header.type = type;
+    header.station_id = station;
+    header.seq = seq;
+    datagram_write_header(buffer, &header);
+    sendto(fd, buffer, sizeof(buffer), 0, reinterpret_cast<const sockaddr *>(&to), sizeof(to));
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    int port = 9000;
+    bool send_acks = false;
+    double drop = 0.0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--ack") == 0) send_acks = true;
+        else if (std::strcmp(argv[i], "--drop") == 0 && i + 1 < argc) drop = std::atof(argv[++i]) / 100.0;
+        else port = std::atoi(argv[i]);
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+        std::perror("bind");
+        return 1;
+    }
+    std::printf("receptor UDP na porta %d%s, descarte simulado %.1f%%\n", port, send_acks ? " (ACK/NACK)" : "", drop * 100);
+
+    std::map<uint16_t, Station> stations;
+    auto window_start = std::chrono::steady_clock::now();
+
+    while (true) {
+        pollfd poll_fd{fd, POLLIN, 0};
+        poll(&poll_fd, 1, 200);
+
+        if (poll_fd.revents & POLLIN) {
+            uint8_t buffer[2048];
+            sockaddr_in from{};
+            socklen_t from_length = sizeof(from);
+            ssize_t received = recvfrom(fd, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr *>(&from), &from_length);
+
+            DatagramHeader header;
+            bool dropped = drop > 0 && std::rand() < drop * RAND_MAX;
+            if (received > 0 && !dropped && datagram_read_header(buffer, received, &header) && header.type == DATAGRAM_TYPE_DATA) {
+                Station &station = stations[header.station_id];
+
+                // a estação reiniciou: a sequência dos datagramas recomeça em 1
+                if (header.seq == 1 && station.highest > 1) {
+                    std::printf("estacao %u reiniciou\n", header.station_id);
+                    station.highest = 0;
+                    station.missing.clear();
+                }
+
+                bool duplicate = false;
+                if (header.seq > station.highest) {
+                    for (uint32_t seq = station.highest + 1; seq < header.seq; seq++) {
+                        station.missing.insert(seq);
+                        if (send_acks) send_control(fd, from, DATAGRAM_TYPE_NACK, header.station_id, seq);
+                    }
+                    station.highest = header.seq;
+                } else if (station.missing.erase(header.seq)) {
+                    station.window.reordered++;
+                } else {
+                    duplicate = true;
+                    station.window.duplicates++;
+                }
+
+                if (!duplicate) {
+                    station.window.packets++;
+                    station.window.bytes += received;
+                    for (uint8_t i = 0; i < header.count; i++) {
+                        uint32_t seq;
+                        uint8_t channels;
+                        SensorSample sample;
+                        datagram_read_record(buffer, i, &seq, &sample, &channels);
+                        if (!station.samples.insert(seq).second) station.window.repeated_samples++;
+                        station.window.samples++;
+                    }
+                }
+
+                if (send_acks && (header.flags & DATAGRAM_FLAG_ACK_REQUEST)) {
+                    send_control(fd, from, DATAGRAM_TYPE_ACK, header.station_id, header.seq);
+                }
+            }
+        }
+
+        // relatório a cada segundo
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - window_start).count();
+        if (elapsed >= 1.0) {
+            for (auto &entry : stations) {
+                Station &station = entry.second;
+                Counters &window = station.window;
+                if (window.packets == 0 && window.duplicates == 0) continue;
+
+                station.total.packets += window.packets;
+                station.total.samples += window.samples;
+                station.total.bytes += window.bytes;
+                station.total.reordered += window.reordered;
+                station.total.duplicates += window.duplicates;
+                station.total.repeated_samples += window.repeated_samples;
+                double loss = station.highest ? 100.0 * station.missing.size() / station.highest : 0.0;
+                std::printf("estacao %u: %.1f pacotes/s | %.1f amostras/s | perdidos %zu (%.2f%%) | reordenados %lu | "
+                            "duplicados %lu | amostras repetidas %lu | %.1f bytes/amostra\n",
+                            entry.first, window.packets / elapsed, window.samples / elapsed, station.missing.size(), loss,
+                            station.total.reordered, station.total.duplicates, station.total.repeated_samples,
+                            station.total.samples ? double(station.total.bytes) / station.total.samples : 0.0);
+                window = Counters{};
+            }
+            std::fflush(stdout);
+            window_start = now;
+        }
+    }
+}